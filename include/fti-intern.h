@@ -19,6 +19,7 @@
 #include <stdint.h>
 #include <unistd.h>
 #include <stdbool.h>
+#include <pthread.h>
 #include <mpi.h>
 
 #ifdef ENABLE_HDF5  // --> If HDF5 is installed
@@ -117,6 +118,10 @@
 #define TYPES_DIMENSION_MAX 32
 /** Maximum number of fields (i.e. members) in an user-defined type         **/
 #define TYPES_FIELDS_MAX 128
+/** Number of blocks in flight per direction in pipelined transfers       **/
+#define FTI_PIPELINE_DEPTH 4
+/** Number of blocks carried by one ring message in the L3 encoding       **/
+#define FTI_RS_BLOCKS_PER_MSG 4
 
 #ifdef __cplusplus
 extern "C" {
@@ -140,7 +145,7 @@ extern "C" {
 
     typedef struct FTIT_datasetInfo {
         int varID;
-        uint32_t varSize;
+        uint64_t varSize;
     } FTIT_datasetInfo;
 
     typedef struct FTIT_dcpConfigurationPosix {
@@ -150,22 +155,72 @@ extern "C" {
         unsigned int StackSize;
         uint32_t BlockSize;
         unsigned int cachedCkpt;
+        unsigned int CompactLayers;   /**< layers merged in the background */
+        unsigned int CompactRatio;    /**< % of the base written in layers */
     } FTIT_dcpConfigurationPosix;
 
     typedef struct FTIT_dcpExecutionPosix {
         int nbLayerReco;
         int nbVarReco;
         unsigned int Counter;
-        uint32_t FileSize;
-        uint32_t dataSize;
-        uint32_t dcpSize;
-        uint32_t LayerSize[MAX_STACK_SIZE];
+        uint64_t FileSize;
+        uint64_t layerStart;     // file size before the last layer
+        bool pending;            // TRUE until the last layer is committed
+        uint64_t dataSize;
+        uint64_t dcpSize;
+        uint64_t LayerSize[MAX_STACK_SIZE];
         FTIT_datasetInfo datasetInfo[MAX_STACK_SIZE][FTI_BUFS];
         char LayerHash[MAX_STACK_SIZE*MD5_DIGEST_STRING_LENGTH];
     } FTIT_dcpExecutionPosix;
 
+    /** @typedef    FTIT_dcpBlockIndex
+     *  @brief      Newest copy of every block of a variable in a dCP file.
+     */
+    typedef struct FTIT_dcpBlockIndex {
+        int id;                      /**< variable ID                         */
+        uint64_t size;               /**< variable size in bytes              */
+        int64_t nbBlocks;            /**< number of blocks of 'size' bytes    */
+        int64_t* pos;                /**< file offset per block, -1 if none   */
+    } FTIT_dcpBlockIndex;
+
+    /** @typedef    FTIT_dcpCompaction
+     *  @brief      Background merge of the layers of a dCP POSIX file.
+     *
+     *  A helper thread merges the layers of the current file into a new
+     *  base file. The next dCP checkpoint adopts the new file and appends
+     *  its layer to it, the old file is removed once that layer is written.
+     */
+    typedef struct FTIT_dcpCompaction {
+        bool active;                 /**< TRUE if a merge was started         */
+        bool adopted;                /**< TRUE if 'oldFileId' must be removed */
+        bool threaded;               /**< TRUE if 'thread' must be joined     */
+        int result;                  /**< result of the merge                 */
+        int oldFileId;               /**< ID of the merged file               */
+        pthread_t thread;            /**< merging thread                      */
+        char src[FTI_BUFS];          /**< file whose layers are merged        */
+        char dst[FTI_BUFS];          /**< new base, renamed when adopted      */
+        uint32_t blockSize;          /**< dCP block size                      */
+        unsigned int stackSize;      /**< dCP stack size                      */
+        int ckptId;                  /**< checkpoint ID of the new base       */
+        int nbLayer;                 /**< number of layers of 'src'           */
+        uint64_t layerSize[MAX_STACK_SIZE];
+        int nbVar;                   /**< number of variables of the base     */
+        FTIT_dcpBlockIndex* vars;    /**< variables in the order of the base  */
+        uint64_t baseSize;           /**< size of the new base layer          */
+        char baseHash[MD5_DIGEST_STRING_LENGTH];
+    } FTIT_dcpCompaction;
+
+    /** @typedef    FTIT_dcpIoStats
+     *  @brief      I/O counters of the last dCP checkpoint.
+     */
+    typedef struct FTIT_dcpIoStats {
+        uint64_t nbRuns;             /**< dirty block runs found              */
+        uint64_t nbCalls;            /**< write system calls issued           */
+        uint64_t bytes;              /**< bytes written (with bridged gaps)   */
+    } FTIT_dcpIoStats;
+
     typedef struct FTIT_dcpDatasetPosix {
-        uint32_t hashDataSize;
+        uint64_t hashDataSize;
         unsigned char* currentHashArray;
         unsigned char* oldHashArray;
     } FTIT_dcpDatasetPosix;
@@ -275,8 +330,8 @@ extern "C" {
         bool hasCkpt;         /**< indicates if container is stored in ckpt   */
         uintptr_t dptr;       /**< data pointer offset                        */
         uintptr_t fptr;       /**< file pointer offset                        */
-        int32_t chunksize;    /**< chunk size of variable in this block       */
-        int32_t containersize;/**< cont size stored of variable in this block */
+        int64_t chunksize;    /**< chunk size of variable in this block       */
+        int64_t containersize;/**< cont size stored of variable in this block */
         unsigned char hash[MD5_DIGEST_LENGTH];  /**< hash of variable chunk   */
         unsigned char myhash[MD5_DIGEST_LENGTH];/**< hash of this structure   */
         bool update;    /**< TRUE if struct needs to be updated in ckpt file  */
@@ -293,7 +348,7 @@ extern "C" {
      */
     typedef struct FTIFF_db {
         int numvars;          /**< number of protected variables in datablock */
-        int32_t dbsize;       /**< size of metadata + data for block in bytes */
+        int64_t dbsize;       /**< size of metadata + data for block in bytes */
         unsigned char myhash[MD5_DIGEST_LENGTH]; /**< hash of variable chunk  */
         bool update;     /**< TRUE if struct needs to be updated in ckpt file */
         bool finalized;             /**< TRUE if block is stored in cp file   */
@@ -430,11 +485,48 @@ extern "C" {
     typedef enum {
         FTI_ATTRIBUTE_NAME = 1 << 0,
         FTI_ATTRIBUTE_DIM  = 1 << 1,
+        FTI_ATTRIBUTE_COMPRESSION = 1 << 2,
+        FTI_ATTRIBUTE_DCP_TRACK = 1 << 3,
     } FTIT_attributeFlag;
 
+    /** Compression codecs of the checkpoint data. */
+    typedef enum {
+        FTI_CODEC_DEFAULT = -1,     /**< As set in the configuration file */
+        FTI_CODEC_NONE = 0,         /**< Not compressed                   */
+        FTI_CODEC_LZ4 = 1,
+        FTI_CODEC_ZSTD = 2,
+        FTI_CODEC_ZLIB = 3,
+    } FTIT_codec;
+
+    /** Error bound of the lossy compression of floating-point data. */
+    typedef enum {
+        FTI_ERROR_NONE = 0,         /**< Lossless                         */
+        FTI_ERROR_ABS = 1,          /**< Absolute error bound             */
+        FTI_ERROR_REL = 2,          /**< Bound relative to value range    */
+    } FTIT_errorMode;
+
+    /** @typedef    FTIT_compression
+     *  @brief      Compression of a dataset.
+     *
+     *  The level is passed to the codec, 0 selects the codec default. With
+     *  shuffle set, the bytes of the elements are grouped by significance
+     *  before compression, which suits floating-point data. With an error
+     *  mode set, FTI_SFLT and FTI_DBLE datasets are quantized so that every
+     *  recovered element is within the error bound of the stored one.
+     */
+    typedef struct FTIT_compression {
+        int codec;                  /**< FTIT_codec value                 */
+        int level;                  /**< Compression level                */
+        bool shuffle;               /**< TRUE to shuffle the elements     */
+        int errorMode;              /**< FTIT_errorMode value             */
+        double errorBound;          /**< Error bound of the lossy mode    */
+    } FTIT_compression;
+
     typedef struct FTIT_attribute {
         FTIT_dimension dim;
         char name[FTI_BUFS];
+        FTIT_compression compression;
+        bool untracked;             /**< TRUE if 'dcp_track' skips it     */
     } FTIT_attribute;
 
     /** @typedef    FTIT_dataset
@@ -449,10 +541,12 @@ extern "C" {
         int dimLength[32];                 /**< Lenght of each dimention     */
         bool recovered;                    /**< True if metadata restored    */
         bool isDevicePtr;                  /**< True if on device memory     */
-        int32_t count;                     /**< nb of elements in dataset    */
-        int32_t size;                      /**< size of the data             */
-        int32_t sizeStored;                /**< size of the data in last CP  */
+        int64_t count;                     /**< nb of elements in dataset    */
+        int64_t size;                      /**< size of the data             */
+        int64_t sizeStored;                /**< size of the data in last CP  */
         size_t filePos;                    /**< offset of buffer in CP file  */
+        int64_t fileSize;                  /**< bytes of buffer in CP file   */
+        int fileCodec;                     /**< codec of buffer in CP file   */
         FTIT_attribute attribute;
         FTIT_sharedData sharedData;        /**< Info if dataset is subset    */
         FTIT_dcpDatasetPosix dcpInfoPosix; /**< dCP info for posix I/O       */
@@ -473,9 +567,9 @@ extern "C" {
         int level;                            /**< checkpoint level           */
         int ckptId;                           /**< Current Ckpt ID            */
         int ckptIdL4;                         /**< Current L4 Ckpt ID         */
-        int32_t maxFs;                        /**< Maximum file size.         */
-        int32_t fs;                           /**< File size.                 */
-        int32_t pfs;                          /**< Partner file size.         */
+        int64_t maxFs;                        /**< Maximum file size.         */
+        int64_t fs;                           /**< File size.                 */
+        int64_t pfs;                          /**< Partner file size.         */
         char ckptFile[FTI_BUFS];              /**< Ckpt file name. [FTI_BUFS] */
     } FTIT_metadata;
 
@@ -489,14 +583,20 @@ extern "C" {
         bool dcpFtiff;                    /**< Enable differential ckpt.      */
         bool dcpPosix;                    /**< Enable differential ckpt.      */
         bool keepL4Ckpt;                  /**< TRUE if l4 ckpts to keep       */
+        bool verifyOnLoad;                /**< TRUE to hash ckpt. at loading  */
         bool keepHeadsAlive;              /**< TRUE if heads return           */
+        bool asyncCkpt;                   /**< TRUE if background writer      */
         int dcpMode;                      /**< dCP mode.                      */
         int dcpBlockSize;                 /**< Block size for dCP hash        */
+        int dcpThreads;                   /**< Threads used for dCP hashing.  */
+        bool dcpTrack;                    /**< TRUE if dirty pages tracked.   */
         char cfgFile[FTI_BUFS];           /**< Configuration file name.       */
         int saveLastCkpt;                 /**< TRUE to save last checkpoint.  */
         int verbosity;                    /**< Verbosity level.               */
         int blockSize;                    /**< Communication block size.      */
         int transferSize;                 /**< Transfer size local to PFS     */
+        bool flushDirectIo;               /**< TRUE if L4 flush uses O_DIRECT */
+        bool mpiioCollective;             /**< TRUE if MPI-IO writes at close */
         int maxVarId;
 #ifdef LUSTRE
         int stripeUnit;                    /**< Striping Unit for Lustre FS   */
@@ -509,12 +609,32 @@ extern "C" {
         int generalTag;                    /**< MPI tag for general comm.     */
         int test;                          /**< TRUE if local test.           */
         int l3WordSize;                    /**< RS encoding word size.        */
+        int l3Threads;                     /**< Threads used for RS decoding. */
+        int headThreads;                   /**< Ranks post-processed at once. */
+        int headSleep;                     /**< Longest idle sleep in usec.   */
+        int recoThreads;                   /**< Threads reading on restart.   */
+        int compressThreads;               /**< Threads compressing data.     */
+        int compressChunk;                 /**< Size of a compressed chunk.   */
+        int integrity;                     /**< Scheme of the checksums.      */
+        int integrityChunk;                /**< Chunk size of the tree hash.  */
+        int integrityThreads;              /**< Threads hashing the chunks.   */
+        int l4Aggregation;                 /**< Ranks per aggregated L4 file. */
+        int l4AggAlign;                    /**< Alignment of the L4 extents.  */
+        FTIT_compression compression;      /**< Default compression.          */
         int ioMode;                        /**< IO mode for L4 ckpt.          */
+        int metaFormat;                    /**< Format of the group metadata. */
+        int ckptSched;                     /**< Fixed or adaptive intervals.  */
         bool h5SingleFileEnable;           /**< TRUE if VPR enabled           */
         bool h5SingleFileKeep;             /**< TRUE if VPR files to keep     */
         bool h5SingleFileIsInline;         /**< Indicator if HDF5 single file */
         char h5SingleFileDir[FTI_BUFS];    /**< HDF5 single file dir          */
         char h5SingleFilePrefix[FTI_BUFS]; /**< HDF5 single file prefix       */
+        bool h5SingleFileChunk;            /**< Chunk VPR datasets by subset  */
+        char h5SingleFileHints[FTI_BUFS];  /**< MPI-IO hints of the VPR file  */
+        int64_t h5ChunkSize;               /**< Target HDF5 chunk size        */
+        bool h5Checksum;                   /**< Fletcher32 on HDF5 chunks     */
+        int64_t h5Alignment;               /**< HDF5 object alignment         */
+        int64_t h5MetaBlock;               /**< HDF5 metadata block size      */
         char stageDir[FTI_BUFS];           /**< Staging directory.            */
         char localDir[FTI_BUFS];           /**< Local directory.              */
         char glbalDir[FTI_BUFS];           /**< Global directory.             */
@@ -578,6 +698,7 @@ extern "C" {
         int ckptCnt;                /**< Checkpoint counter.                  */
         int ckptDcpIntv;            /**< Checkpoint interval.                 */
         int ckptDcpCnt;             /**< Checkpoint counter.                  */
+        int mtbf;                   /**< MTBF of level failures in minutes.   */
         bool localReplica;          /**< True if rank has local replica of CP */
     } FTIT_checkpoint;
 
@@ -619,7 +740,7 @@ extern "C" {
                 void *write_info);
         int(*finCKPT)   (void *fileDesc);
         size_t(*getPos) (void *fileDesc);
-        void(*finIntegrity) (unsigned char *, void*);
+        void(*finIntegrity) (char *, void*);
     }FTIT_IO;
 
     typedef struct FTIT_mqueue FTIT_mqueue;
@@ -650,6 +771,77 @@ extern "C" {
         FTIT_Datatype *types;          /**< All FTI_Types registered        */
     } FTIT_DataTypes;
 
+    /** @typedef    FTIT_asyncInfo
+     *  @brief      Meta Information needed for asynchronous checkpoints.
+     *
+     *  The protected datasets are copied into 'arena' and the copies are
+     *  written by a background thread. The checkpoint is committed
+     *  (metadata and post-processing) when the thread is joined.
+     */
+    typedef struct FTIT_asyncInfo {
+        int16_t status;              /**< idle or active (not yet committed)  */
+        int result;                  /**< result of the background write      */
+        int done;                    /**< TRUE if background write finished   */
+        bool isThreaded;             /**< TRUE if the writer thread is alive  */
+        unsigned int nbVar;          /**< nb of datasets in the snapshot      */
+        size_t arenaSize;            /**< size of the staging arena in bytes  */
+        void* arena;                 /**< staging arena holding the snapshot  */
+        FTIT_dataset* snapshot;      /**< dataset copies pointing into arena  */
+        int64_t ckptSize;            /**< protected bytes of the snapshot     */
+        unsigned int nbLive;         /**< nb of datasets saved in 'live'      */
+        FTIT_dataset* live;          /**< datasets protected during commit    */
+        int64_t liveSize;            /**< protected bytes during commit       */
+        char integrity[MD5_DIGEST_STRING_LENGTH]; /**< checksum of the file */
+        double t0;                   /**< timing for CP statistics            */
+        double t1;                   /**< timing for CP statistics            */
+        double t2;                   /**< timing for CP statistics            */
+        pthread_t thread;            /**< background writer                   */
+        pthread_mutex_t lock;        /**< protects 'done'                     */
+        FTIT_configuration* conf;    /**< handles used by the writer thread   */
+        FTIT_execution* exec;
+        FTIT_topology* topo;
+        FTIT_checkpoint* ckpt;
+        FTIT_keymap* data;
+        FTIT_IO* io;
+    } FTIT_asyncInfo;
+
+    /** @typedef    FTIT_schedInfo
+     *  @brief      State of the adaptive checkpoint scheduler.
+     *
+     *  The scheduler keeps the mean cost of every level and the compute
+     *  time elapsed since the last checkpoint covering the level. Intervals
+     *  and times are given in seconds, a negative interval disables a level.
+     */
+    typedef struct FTIT_schedInfo {
+        double cost[5];              /**< mean cost per level, <0 if unknown  */
+        double intv[5];              /**< planned ckpt. interval per level    */
+        double clock[5];             /**< compute time since last ckpt.       */
+        double dcpClock;             /**< compute time since last L4 dCP      */
+        double tick;                 /**< time between two scheduling checks  */
+        unsigned int lastIcnt;       /**< iteration of the last check         */
+    } FTIT_schedInfo;
+
+    /** @typedef    FTIT_metaExchange
+     *  @brief      State of the group metadata exchange.
+     *
+     *  The variable records of the group members are sent to the group
+     *  rank 0 while the checkpoint data is written. A member only sends
+     *  its records again if they changed since the previous checkpoint,
+     *  the group rank 0 keeps the last records received from every member.
+     */
+    typedef struct FTIT_metaExchange {
+        int16_t status;              /**< idle, posted or completed           */
+        bool hasCrc;                 /**< TRUE if records were sent before    */
+        uint32_t crc;                /**< CRC32C of the last records sent     */
+        int nbVar;                   /**< nb of datasets in the local records */
+        void* section;               /**< local records in flight             */
+        int* counts;                 /**< bytes from every member (rank 0)    */
+        int* displs;                 /**< receive displacements   (rank 0)    */
+        void* recv;                  /**< receive buffer          (rank 0)    */
+        void** cache;                /**< last records of every member        */
+        MPI_Request req;             /**< pending gather                      */
+    } FTIT_metaExchange;
+
     /** @typedef    FTIT_execution
      *  @brief      Execution metadata.
      *
@@ -678,28 +870,36 @@ extern "C" {
         unsigned int ckptId;                /**< Checkpoint ID.               */
         unsigned int ckptNext;              /**< Iteration for next CP.       */
         unsigned int ckptLast;              /**< Iteration for last CP.       */
-        int32_t ckptSize;                   /**< Checkpoint size.             */
+        int64_t ckptSize;                   /**< Checkpoint size.             */
         unsigned int nbVar;                 /**< nb of protected variables    */
         unsigned int nbVarStored;           /**< nb prot. var. stored in CP   */
         int nbGroup;                        /**< Number of protected groups.  */
         int initSCES;                       /**< TRUE if FTI initialized.     */
         char h5SingleFileLast[FTI_BUFS];    /**< Last HDF5 single file name   */
         char h5SingleFileReco[FTI_BUFS];    /**< HDF5 single fn from recovery */
-        unsigned char integrity[MD5_DIGEST_LENGTH];
+        char integrity[MD5_DIGEST_STRING_LENGTH]; /**< Checksum of ckpt.   */
         FTIT_mqueue mqueue;
         FTIT_metadata ckptMeta;             /**< Metadata for each ckpt level */
+        bool recoDeferred;                  /**< TRUE if hashed at loading    */
+        char recoChecksum[MD5_DIGEST_STRING_LENGTH]; /**< Hash to verify.     */
         FTIFF_db *firstdb;                  /**< Pointer to first datablock   */
         FTIFF_db *lastdb;                   /**< Pointer to first datablock   */
         FTIFF_metaInfo FTIFFMeta;           /**< File meta data for FTI-FF    */
+        FTIT_dcpIoStats dcpIo;              /**< I/O counters for FTI-FF dCP  */
         FTIT_DataTypes datatypes;           /**< Pointer to FTI_Types         */
         FTIT_H5Group** H5groups;            /**< HDF5 root group.             */
         FTIT_globalDataset* globalDatasets; /**< ptr to first global dataset  */
         FTIT_StageInfo* stageInfo;          /**< root of staging requests     */
         FTIT_iCPInfo iCPInfo;               /**< meta info iCP                */
+        FTIT_asyncInfo asyncInfo;           /**< meta info async. ckpt.       */
+        FTIT_metaExchange metaXchg;         /**< group metadata exchange      */
+        FTIT_schedInfo sched;               /**< adaptive ckpt. scheduler     */
         MPI_Comm globalComm;                /**< Global communicator.         */
         MPI_Comm groupComm;                 /**< Group communicator.          */
         MPI_Comm nodeComm;
+        MPI_Comm aggComm;                   /**< L4 aggregation group.        */
         FTIT_dcpExecutionPosix dcpInfoPosix; /**< dCP info for posix I/O  */
+        FTIT_dcpCompaction dcpCompact;      /**< dCP POSIX layer merging      */
         int fastForward;            /**< Fast forward rate for ckpt intervals */
         /** A function pointer pointing to the function which actually the
          * checkpoint file. Noticeably We need 2 function pointers, One for the
@@ -0,0 +1,867 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  FTI - A multi-level checkpointing library for C/C++/Fortran applications
+ *
+ *  Revision 1.0 : Fault Tolerance Interface (FTI)
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *  list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors
+ *  may be used to endorse or promote products derived from this software without
+ *  specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  @file   compress.c
+ *  @date   October, 2026
+ *  @brief  Chunked, multi-threaded compression of the checkpoint data.
+ *
+ *  A compressed dataset is cut in chunks of 'compression_chunk' bytes. The
+ *  threads of the hashing engine compress a batch of chunks at once, which
+ *  are then written in order. The compressed sizes of the chunks and a
+ *  trailer follow the chunks, so a dataset is written in a single pass:
+ *
+ *      chunk[0] | ... | chunk[n-1] | size[0] ... size[n-1] | trailer
+ *
+ *  A chunk that does not shrink is stored as it is, which is flagged in
+ *  its size. Floating-point data may be byte-shuffled before compression:
+ *  the bytes of equal significance of all elements are stored together,
+ *  so exponents and high mantissa bytes form long compressible runs.
+ *
+ *  The metadata records the codec and the bytes a dataset takes in the
+ *  file. Recovery reads these bytes at once and decompresses the chunks
+ *  in parallel directly into the dataset.
+ *
+ *  Floating-point datasets may be compressed with an error bound. Every
+ *  element is predicted from the previous recovered element of its chunk
+ *  and the difference is quantized in steps of twice the bound. Elements
+ *  that cannot be quantized within the bound are kept exactly. A lossy
+ *  chunk is then compressed without loss by the codec:
+ *
+ *      outliers | codes[0] ... codes[m-1] | outlier values
+ */
+
+#include <math.h>
+
+#include "../interface.h"
+#include "compress.h"
+
+#ifdef FTI_LZ4
+#   include <lz4.h>
+#endif
+#ifdef FTI_ZSTD
+#   include <zstd.h>
+#endif
+#ifndef FTI_NOZLIB
+#   include <zlib.h>
+#endif
+
+#define FTI_COMPRESS_MAGIC "FTIZ"
+
+/** Flag of the chunk sizes, set if the chunk is stored uncompressed. */
+#define FTI_CHUNK_RAW (1ULL << 63)
+
+/** Datasets smaller than this are not worth the chunk index. */
+#define FTI_COMPRESS_MIN_SIZE 1024
+
+/** Quantization code of an element stored exactly. */
+#define FTI_LOSSY_OUTLIER INT32_MIN
+
+/** Largest quantization code, far from overflowing the code type. */
+#define FTI_LOSSY_MAX_CODE (1 << 30)
+
+/** Trailer of a compressed dataset. */
+typedef struct FTIT_compressTrailer {
+    uint64_t rawSize;           /**< Size of the dataset.                 */
+    uint64_t nbChunks;          /**< Number of chunks.                    */
+    double errorBound;          /**< Absolute error bound if lossy.       */
+    uint32_t chunkSize;         /**< Uncompressed size of a chunk.        */
+    int32_t codec;              /**< Codec of the chunks.                 */
+    int32_t shuffle;            /**< Element size if shuffled, else 0.    */
+    int32_t lossy;              /**< Element size if lossy, else 0.       */
+    int32_t reserved;           /**< Padding.                             */
+    char magic[4];              /**< FTI_COMPRESS_MAGIC.                  */
+} FTIT_compressTrailer;
+
+/** Compression settings of the configuration file. */
+static struct {
+    bool enabled;               /**< TRUE if the I/O mode supports it.    */
+    int codec;                  /**< Codec of datasets without attribute. */
+    int level;                  /**< Level of these datasets.             */
+    bool shuffle;               /**< TRUE to shuffle their float data.    */
+    uint32_t chunkSize;         /**< Uncompressed size of a chunk.        */
+} compressConf;
+
+/** Chunks processed by the threads of the hashing engine. */
+typedef struct FTIT_compressJob {
+    const unsigned char* src;   /**< Dataset or compressed data.          */
+    unsigned char* dest;        /**< Output slots or dataset.             */
+    uint64_t size;              /**< Size of the dataset.                 */
+    uint32_t chunkSize;         /**< Uncompressed size of a chunk.        */
+    int codec;                  /**< Codec of the chunks.                 */
+    int level;                  /**< Compression level.                   */
+    int shuffle;                /**< Element size if shuffled, else 0.    */
+    int lossy;                  /**< Element size if lossy, else 0.       */
+    double errorBound;          /**< Absolute error bound if lossy.       */
+    int64_t first;              /**< First chunk of the batch.            */
+    uint64_t bound;             /**< Capacity of an output slot.          */
+    uint64_t* sizes;            /**< Compressed size of every chunk.      */
+    uint64_t* offsets;          /**< Offset of every compressed chunk.    */
+    int failed;                 /**< Set if a chunk failed.               */
+} FTIT_compressJob;
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Sets the compression of the datasets without attribute.
+  @param      FTI_Conf        Configuration metadata.
+  @return     integer         FTI_SCES if successful.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_InitCompression(FTIT_configuration* FTI_Conf) {
+    compressConf.enabled = (FTI_Conf->ioMode == FTI_IO_POSIX);
+    compressConf.codec = FTI_Conf->compression.codec;
+    compressConf.level = FTI_Conf->compression.level;
+    compressConf.shuffle = FTI_Conf->compression.shuffle;
+    compressConf.chunkSize = FTI_Conf->compressChunk;
+    return FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Checks if FTI was built with a codec.
+  @param      codec           Codec.
+  @return     bool            TRUE if the codec can be used.
+ **/
+/*-------------------------------------------------------------------------*/
+bool FTI_CodecAvailable(int codec) {
+    switch (codec) {
+        case FTI_CODEC_DEFAULT:
+        case FTI_CODEC_NONE:
+            return true;
+#ifdef FTI_LZ4
+        case FTI_CODEC_LZ4:
+            return true;
+#endif
+#ifdef FTI_ZSTD
+        case FTI_CODEC_ZSTD:
+            return true;
+#endif
+#ifndef FTI_NOZLIB
+        case FTI_CODEC_ZLIB:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Returns the name of a codec.
+  @param      codec           Codec.
+  @return     const char*     Name of the codec.
+ **/
+/*-------------------------------------------------------------------------*/
+const char* FTI_CodecName(int codec) {
+    switch (codec) {
+        case FTI_CODEC_NONE:
+            return "none";
+        case FTI_CODEC_LZ4:
+            return "LZ4";
+        case FTI_CODEC_ZSTD:
+            return "Zstandard";
+        case FTI_CODEC_ZLIB:
+            return "zlib";
+        default:
+            return "unknown";
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Returns the largest compressed size of a chunk.
+  @param      codec           Codec.
+  @param      size            Size of the chunk.
+  @return     uint64_t        Capacity of the output buffer.
+ **/
+/*-------------------------------------------------------------------------*/
+static uint64_t FTI_CodecBound(int codec, uint64_t size) {
+    switch (codec) {
+#ifdef FTI_LZ4
+        case FTI_CODEC_LZ4:
+            return LZ4_compressBound((int) size);
+#endif
+#ifdef FTI_ZSTD
+        case FTI_CODEC_ZSTD:
+            return ZSTD_compressBound(size);
+#endif
+#ifndef FTI_NOZLIB
+        case FTI_CODEC_ZLIB:
+            return compressBound(size);
+#endif
+        default:
+            return size;
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Compresses a chunk.
+  @param      codec           Codec.
+  @param      level           Compression level, 0 for the codec default.
+  @param      src             Chunk.
+  @param      size            Size of the chunk.
+  @param      dest            Output buffer.
+  @param      cap             Capacity of the output buffer.
+  @return     uint64_t        Compressed size, 0 if the chunk does not shrink.
+ **/
+/*-------------------------------------------------------------------------*/
+static uint64_t FTI_CodecCompress(int codec, int level, const void* src,
+ uint64_t size, void* dest, uint64_t cap) {
+    uint64_t res = 0;
+    switch (codec) {
+#ifdef FTI_LZ4
+        case FTI_CODEC_LZ4: {
+            // the level is the acceleration of the fast mode
+            int n = LZ4_compress_fast((const char*) src, (char*) dest,
+             (int) size, (int) cap, (level > 0) ? level : 1);
+            res = (n > 0) ? n : 0;
+            break;
+        }
+#endif
+#ifdef FTI_ZSTD
+        case FTI_CODEC_ZSTD: {
+            // 3 is the default level of Zstandard
+            size_t n = ZSTD_compress(dest, cap, src, size,
+             (level != 0) ? level : 3);
+            res = ZSTD_isError(n) ? 0 : n;
+            break;
+        }
+#endif
+#ifndef FTI_NOZLIB
+        case FTI_CODEC_ZLIB: {
+            uLongf n = cap;
+            res = (compress2((Bytef*) dest, &n, (const Bytef*) src, size,
+             (level != 0) ? level : Z_DEFAULT_COMPRESSION) == Z_OK) ? n : 0;
+            break;
+        }
+#endif
+        default:
+            break;
+    }
+    return (res < size) ? res : 0;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Decompresses a chunk.
+  @param      codec           Codec.
+  @param      src             Compressed chunk.
+  @param      size            Size of the compressed chunk.
+  @param      dest            Output buffer.
+  @param      cap             Capacity of the output buffer.
+  @return     uint64_t        Uncompressed size, 0 on error.
+ **/
+/*-------------------------------------------------------------------------*/
+static uint64_t FTI_CodecDecompress(int codec, const void* src,
+ uint64_t size, void* dest, uint64_t cap) {
+    switch (codec) {
+#ifdef FTI_LZ4
+        case FTI_CODEC_LZ4: {
+            int n = LZ4_decompress_safe((const char*) src, (char*) dest,
+             (int) size, (int) cap);
+            return (n > 0) ? n : 0;
+        }
+#endif
+#ifdef FTI_ZSTD
+        case FTI_CODEC_ZSTD: {
+            size_t n = ZSTD_decompress(dest, cap, src, size);
+            return ZSTD_isError(n) ? 0 : n;
+        }
+#endif
+#ifndef FTI_NOZLIB
+        case FTI_CODEC_ZLIB: {
+            uLongf n = cap;
+            return (uncompress((Bytef*) dest, &n, (const Bytef*) src, size)
+             == Z_OK) ? n : 0;
+        }
+#endif
+        default:
+            return 0;
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Groups the bytes of equal significance of the elements.
+  @param      src             Elements.
+  @param      dest            Shuffled bytes.
+  @param      size            Size in bytes.
+  @param      eleSize         Size of an element.
+
+  Trailing bytes of an incomplete element are copied as they are.
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_Shuffle(const unsigned char* src, unsigned char* dest,
+ uint64_t size, int eleSize) {
+    uint64_t n = size / eleSize, i;
+    int b;
+    for (i = 0; i < n; i++) {
+        for (b = 0; b < eleSize; b++) {
+            dest[b * n + i] = src[i * eleSize + b];
+        }
+    }
+    memcpy(dest + n * eleSize, src + n * eleSize, size - n * eleSize);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Restores the elements shuffled by FTI_Shuffle.
+  @param      src             Shuffled bytes.
+  @param      dest            Elements.
+  @param      size            Size in bytes.
+  @param      eleSize         Size of an element.
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_Unshuffle(const unsigned char* src, unsigned char* dest,
+ uint64_t size, int eleSize) {
+    uint64_t n = size / eleSize, i;
+    int b;
+    for (i = 0; i < n; i++) {
+        for (b = 0; b < eleSize; b++) {
+            dest[i * eleSize + b] = src[b * n + i];
+        }
+    }
+    memcpy(dest + n * eleSize, src + n * eleSize, size - n * eleSize);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Returns the largest lossy encoding of a chunk.
+  @param      size            Size of the chunk.
+  @param      eleSize         Size of an element.
+  @return     uint64_t        Size if all elements are outliers.
+ **/
+/*-------------------------------------------------------------------------*/
+static uint64_t FTI_LossyBound(uint64_t size, int eleSize) {
+    return sizeof(uint32_t) + (size / eleSize) * (sizeof(int32_t) + eleSize);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Recovers an element from its prediction and code.
+  @param      pred            Prediction, the previous recovered element.
+  @param      code            Quantization code.
+  @param      step            Quantization step.
+  @return     double          Recovered element.
+
+  Never inlined, so compression and recovery round the same operations and
+  the bound checked at compression holds for the recovered data.
+ **/
+/*-------------------------------------------------------------------------*/
+static __attribute__((noinline)) double FTI_LossyValue(double pred,
+ int32_t code, double step) {
+    return pred + step * code;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Quantizes a chunk of floating-point elements.
+  @param      src             Elements.
+  @param      size            Size in bytes.
+  @param      eleSize         Size of an element, 4 or 8.
+  @param      bound           Absolute error bound.
+  @param      dest            Encoded chunk.
+  @return     uint64_t        Size of the encoded chunk.
+ **/
+/*-------------------------------------------------------------------------*/
+static uint64_t FTI_LossyEncode(const unsigned char* src, uint64_t size,
+ int eleSize, double bound, unsigned char* dest) {
+    uint64_t n = size / eleSize, i, nbOutliers = 0;
+    int32_t* codes = (int32_t*) (dest + sizeof(uint32_t));
+    unsigned char* outliers = (unsigned char*) (codes + n);
+    double step = 2 * bound, pred = 0;
+
+    for (i = 0; i < n; i++) {
+        double x = (eleSize == sizeof(float)) ?
+         ((const float*) src)[i] : ((const double*) src)[i];
+        double q = nearbyint((x - pred) / step);
+        if (isfinite(q) && fabs(q) < FTI_LOSSY_MAX_CODE) {
+            double r = FTI_LossyValue(pred, (int32_t) q, step);
+            if (eleSize == sizeof(float)) {
+                r = (float) r;
+            }
+            if (fabs(r - x) <= bound) {
+                codes[i] = (int32_t) q;
+                pred = r;
+                continue;
+            }
+        }
+        codes[i] = FTI_LOSSY_OUTLIER;
+        memcpy(outliers + nbOutliers * eleSize, src + i * eleSize, eleSize);
+        nbOutliers++;
+        pred = isfinite(x) ? x : 0;
+    }
+    *(uint32_t*) dest = nbOutliers;
+    return sizeof(uint32_t) + n * sizeof(int32_t) + nbOutliers * eleSize;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Recovers a chunk of floating-point elements.
+  @param      src             Encoded chunk.
+  @param      srcSize         Size of the encoded chunk.
+  @param      dest            Elements.
+  @param      size            Size in bytes.
+  @param      eleSize         Size of an element, 4 or 8.
+  @param      bound           Absolute error bound.
+  @return     integer         FTI_SCES if successful.
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_LossyDecode(const unsigned char* src, uint64_t srcSize,
+ unsigned char* dest, uint64_t size, int eleSize, double bound) {
+    uint64_t n = size / eleSize, i, nbOutliers = 0;
+    if (srcSize < sizeof(uint32_t) + n * sizeof(int32_t) ||
+     srcSize != sizeof(uint32_t) + n * sizeof(int32_t) +
+     (uint64_t) *(const uint32_t*) src * eleSize) {
+        return FTI_NSCS;
+    }
+    const int32_t* codes = (const int32_t*) (src + sizeof(uint32_t));
+    const unsigned char* outliers = (const unsigned char*) (codes + n);
+    double step = 2 * bound, pred = 0;
+
+    for (i = 0; i < n; i++) {
+        if (codes[i] == FTI_LOSSY_OUTLIER) {
+            memcpy(dest + i * eleSize, outliers + nbOutliers * eleSize,
+             eleSize);
+            nbOutliers++;
+            double x = (eleSize == sizeof(float)) ?
+             ((float*) dest)[i] : ((double*) dest)[i];
+            pred = isfinite(x) ? x : 0;
+        } else if (eleSize == sizeof(float)) {
+            float r = FTI_LossyValue(pred, codes[i], step);
+            ((float*) dest)[i] = r;
+            pred = r;
+        } else {
+            double r = FTI_LossyValue(pred, codes[i], step);
+            ((double*) dest)[i] = r;
+            pred = r;
+        }
+    }
+    return FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Returns the codec compressing the lossy chunks.
+  @return     integer         Best codec available, or FTI_CODEC_NONE.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_LossyCodec() {
+    int codecs[] = { FTI_CODEC_ZSTD, FTI_CODEC_LZ4, FTI_CODEC_ZLIB };
+    int nbCodecs = sizeof(codecs) / sizeof(codecs[0]), i;
+    for (i = 0; i < nbCodecs; i++) {
+        if (FTI_CodecAvailable(codecs[i])) {
+            return codecs[i];
+        }
+    }
+    return FTI_CODEC_NONE;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Returns the compression of a dataset.
+  @param      data            Dataset.
+  @param      comp            Codec, level and shuffling (out).
+  @return     bool            TRUE if the dataset is compressed.
+
+  Datasets without compression attribute use the settings of the
+  configuration file, where shuffling only applies to floating-point
+  types. The lossy mode only applies to FTI_SFLT and FTI_DBLE datasets
+  and picks a codec if none is set. Device datasets are never compressed.
+ **/
+/*-------------------------------------------------------------------------*/
+bool FTI_CompressionOf(const FTIT_dataset* data, FTIT_compression* comp) {
+    if (!compressConf.enabled || data->isDevicePtr ||
+     data->size < FTI_COMPRESS_MIN_SIZE) {
+        return false;
+    }
+    *comp = data->attribute.compression;
+    if (comp->codec == FTI_CODEC_DEFAULT) {
+        bool isFloat = data->type && (data->type->id == FTI_SFLT ||
+         data->type->id == FTI_DBLE || data->type->id == FTI_LDBE);
+        comp->codec = compressConf.codec;
+        comp->level = compressConf.level;
+        comp->shuffle = compressConf.shuffle && isFloat;
+    }
+    if (comp->errorMode != FTI_ERROR_NONE) {
+        if (!data->type || (data->type->id != FTI_SFLT &&
+         data->type->id != FTI_DBLE)) {
+            comp->errorMode = FTI_ERROR_NONE;
+        } else if (comp->codec == FTI_CODEC_NONE) {
+            comp->codec = FTI_LossyCodec();
+        }
+    }
+    return comp->codec != FTI_CODEC_NONE && FTI_CodecAvailable(comp->codec);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Compresses chunks of the current batch.
+  @param      ctx             Compression job.
+  @param      first           First chunk, relative to the batch.
+  @param      last            Chunk after the last one.
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_CompressChunks(void* ctx, int64_t first, int64_t last) {
+    FTIT_compressJob* job = (FTIT_compressJob*) ctx;
+    uint64_t lossyBound = (job->lossy) ?
+     FTI_LossyBound(job->chunkSize, job->lossy) : 0;
+    unsigned char* scratch = NULL;
+    int64_t c;
+
+    if (job->lossy) {
+        scratch = malloc(2 * lossyBound);
+    } else if (job->shuffle) {
+        scratch = malloc(job->chunkSize);
+    }
+    if ((job->lossy || job->shuffle) && !scratch) {
+        __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    for (c = first; c < last; c++) {
+        int64_t chunk = job->first + c;
+        uint64_t pos = (uint64_t) chunk * job->chunkSize;
+        uint64_t len = (job->size - pos < job->chunkSize) ?
+         job->size - pos : job->chunkSize;
+        const unsigned char* in = job->src + pos;
+        unsigned char* out = job->dest + c * job->bound;
+        if (job->lossy) {
+            // the bytes of the codes are shuffled, as most are zero
+            unsigned char* packed = scratch + lossyBound;
+            uint64_t m = len / job->lossy * sizeof(int32_t);
+            uint64_t n = FTI_LossyEncode(in, len, job->lossy,
+             job->errorBound, scratch);
+            memcpy(packed, scratch, sizeof(uint32_t));
+            FTI_Shuffle(scratch + sizeof(uint32_t), packed + sizeof(uint32_t),
+             m, sizeof(int32_t));
+            memcpy(packed + sizeof(uint32_t) + m, scratch + sizeof(uint32_t)
+             + m, n - sizeof(uint32_t) - m);
+            in = packed;
+            len = n;
+        } else if (scratch) {
+            FTI_Shuffle(in, scratch, len, job->shuffle);
+            in = scratch;
+        }
+        uint64_t n = FTI_CodecCompress(job->codec, job->level, in, len, out,
+         job->bound);
+        if (n == 0) {
+            memcpy(out, in, len);
+            n = len | FTI_CHUNK_RAW;
+        }
+        job->sizes[chunk] = n;
+    }
+    free(scratch);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Returns the range of the finite values of a dataset.
+  @param      data            FTI_SFLT or FTI_DBLE dataset.
+  @return     double          Maximum minus minimum value.
+ **/
+/*-------------------------------------------------------------------------*/
+static double FTI_ValueRange(const FTIT_dataset* data) {
+    double min = INFINITY, max = -INFINITY;
+    int64_t i;
+    for (i = 0; i < data->size / data->eleSize; i++) {
+        double x = (data->eleSize == sizeof(float)) ?
+         ((const float*) data->ptr)[i] : ((const double*) data->ptr)[i];
+        if (isfinite(x)) {
+            min = (x < min) ? x : min;
+            max = (x > max) ? x : max;
+        }
+    }
+    return (max >= min) ? max - min : 0;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Writes a dataset compressed.
+  @param      data            Dataset in host memory.
+  @param      comp            Compression of the dataset.
+  @param      writeFunc       Writes bytes to the checkpoint file.
+  @param      opaque          File handle passed to 'writeFunc'.
+  @return     integer         FTI_SCES if successful.
+
+  Sets the bytes the dataset takes in the file and its codec. At most two
+  chunks per thread are held in memory.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_WriteCompressed(FTIT_dataset* data, const FTIT_compression* comp,
+ int (*writeFunc)(void* src, size_t size, void* opaque), void* opaque) {
+    FTIT_compressJob job;
+    memset(&job, 0, sizeof(job));
+    job.src = (const unsigned char*) data->ptr;
+    job.size = data->size;
+    job.codec = comp->codec;
+    job.level = comp->level;
+    job.chunkSize = compressConf.chunkSize;
+    if (comp->errorMode != FTI_ERROR_NONE) {
+        job.errorBound = comp->errorBound;
+        if (comp->errorMode == FTI_ERROR_REL) {
+            job.errorBound *= FTI_ValueRange(data);
+        }
+        // a zero bound is lossless, which the codec does better
+        if (job.errorBound > 0 && isfinite(job.errorBound)) {
+            job.lossy = data->eleSize;
+            job.chunkSize -= job.chunkSize % data->eleSize;
+        }
+    }
+    if (!job.lossy && comp->shuffle && data->eleSize > 1 &&
+     data->eleSize <= job.chunkSize) {
+        job.shuffle = data->eleSize;
+        job.chunkSize -= job.chunkSize % data->eleSize;
+    }
+    job.bound = FTI_CodecBound(job.codec, (job.lossy) ?
+     FTI_LossyBound(job.chunkSize, job.lossy) : job.chunkSize);
+
+    int64_t nbChunks = (job.size + job.chunkSize - 1) / job.chunkSize;
+    int64_t batch = 2 * FTI_HashEngineThreads(FTI_POOL_COMPRESS);
+    batch = (batch < nbChunks) ? batch : nbChunks;
+    job.sizes = talloc(uint64_t, nbChunks);
+    job.dest = malloc(batch * job.bound);
+    if (!job.sizes || !job.dest) {
+        FTI_Print("Cannot allocate the compression buffers.", FTI_EROR);
+        free(job.sizes);
+        free(job.dest);
+        return FTI_NSCS;
+    }
+
+    int res = FTI_SCES;
+    int64_t written = 0, c;
+    for (job.first = 0; job.first < nbChunks && res == FTI_SCES;
+     job.first += batch) {
+        int64_t n = (nbChunks - job.first < batch) ?
+         nbChunks - job.first : batch;
+        FTI_HashParallel(FTI_CompressChunks, &job, n, FTI_POOL_COMPRESS);
+        if (job.failed) {
+            FTI_Print("Cannot allocate the compression buffers.", FTI_EROR);
+            res = FTI_NSCS;
+        }
+        for (c = 0; c < n && res == FTI_SCES; c++) {
+            uint64_t len = job.sizes[job.first + c] & ~FTI_CHUNK_RAW;
+            res = writeFunc(job.dest + c * job.bound, len, opaque);
+            written += len;
+        }
+    }
+
+    FTIT_compressTrailer trailer;
+    memset(&trailer, 0, sizeof(trailer));
+    trailer.rawSize = job.size;
+    trailer.nbChunks = nbChunks;
+    trailer.chunkSize = job.chunkSize;
+    trailer.codec = job.codec;
+    trailer.shuffle = job.shuffle;
+    trailer.lossy = job.lossy;
+    trailer.errorBound = job.errorBound;
+    memcpy(trailer.magic, FTI_COMPRESS_MAGIC, sizeof(trailer.magic));
+    if (res == FTI_SCES) {
+        res = writeFunc(job.sizes, nbChunks * sizeof(uint64_t), opaque);
+    }
+    if (res == FTI_SCES) {
+        res = writeFunc(&trailer, sizeof(trailer), opaque);
+    }
+    data->fileSize = written + nbChunks * sizeof(uint64_t) + sizeof(trailer);
+    data->fileCodec = job.codec;
+
+    char str[FTI_BUFS];
+    if (job.lossy) {
+        snprintf(str, FTI_BUFS, "Dataset #%d compressed from %ld to %ld bytes"
+         " (%s, error bound %g).", data->id, (int64_t) data->size,
+         data->fileSize, FTI_CodecName(job.codec), job.errorBound);
+    } else {
+        snprintf(str, FTI_BUFS, "Dataset #%d compressed from %ld to %ld bytes"
+         " (%s).", data->id, (int64_t) data->size, data->fileSize,
+         FTI_CodecName(job.codec));
+    }
+    FTI_Print(str, FTI_DBUG);
+
+    free(job.sizes);
+    free(job.dest);
+    return res;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Decompresses chunks of a dataset.
+  @param      ctx             Decompression job.
+  @param      first           First chunk.
+  @param      last            Chunk after the last one.
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_DecompressChunks(void* ctx, int64_t first, int64_t last) {
+    FTIT_compressJob* job = (FTIT_compressJob*) ctx;
+    uint64_t lossyBound = (job->lossy) ?
+     FTI_LossyBound(job->chunkSize, job->lossy) : 0;
+    unsigned char* scratch = NULL;
+    int64_t c;
+
+    if (job->lossy) {
+        scratch = malloc(2 * lossyBound);
+    } else if (job->shuffle) {
+        scratch = malloc(job->chunkSize);
+    }
+    if ((job->lossy || job->shuffle) && !scratch) {
+        __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    for (c = first; c < last; c++) {
+        uint64_t pos = (uint64_t) c * job->chunkSize;
+        uint64_t len = (job->size - pos < job->chunkSize) ?
+         job->size - pos : job->chunkSize;
+        const unsigned char* in = job->src + job->offsets[c];
+        uint64_t n = job->sizes[c] & ~FTI_CHUNK_RAW;
+        unsigned char* out = (scratch) ? scratch : job->dest + pos;
+        // the lossy encoding of the chunk is at most lossyBound bytes
+        uint64_t cap = (job->lossy) ? FTI_LossyBound(len, job->lossy) : len;
+        uint64_t got = 0;
+        if (job->sizes[c] & FTI_CHUNK_RAW) {
+            if ((job->lossy) ? n <= cap : n == len) {
+                memcpy(out, in, n);
+                got = n;
+            }
+        } else {
+            got = FTI_CodecDecompress(job->codec, in, n, out, cap);
+        }
+        int res = FTI_NSCS;
+        if (job->lossy && got > sizeof(uint32_t)) {
+            unsigned char* packed = scratch + lossyBound;
+            uint64_t m = len / job->lossy * sizeof(int32_t);
+            if (got >= sizeof(uint32_t) + m) {
+                memcpy(packed, scratch, sizeof(uint32_t));
+                FTI_Unshuffle(scratch + sizeof(uint32_t),
+                 packed + sizeof(uint32_t), m, sizeof(int32_t));
+                memcpy(packed + sizeof(uint32_t) + m, scratch +
+                 sizeof(uint32_t) + m, got - sizeof(uint32_t) - m);
+                res = FTI_LossyDecode(packed, got, job->dest + pos, len,
+                 job->lossy, job->errorBound);
+            }
+        } else if (!job->lossy && got == len) {
+            if (scratch) {
+                FTI_Unshuffle(scratch, job->dest + pos, len, job->shuffle);
+            }
+            res = FTI_SCES;
+        }
+        if (res != FTI_SCES) {
+            __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+            break;
+        }
+    }
+    free(scratch);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Decompresses a dataset read from the checkpoint file.
+  @param      src             Bytes of the dataset in the file.
+  @param      srcSize         Number of bytes in 'src'.
+  @param      dest            Dataset in host memory.
+  @param      destSize        Size of the dataset.
+  @return     integer         FTI_SCES if successful.
+
+  The chunk index is checked against the sizes before any chunk is
+  decompressed, so a truncated or corrupted file fails cleanly.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_Decompress(const void* src, int64_t srcSize, void* dest,
+ int64_t destSize) {
+    char str[FTI_BUFS];
+    FTIT_compressTrailer trailer;
+    if (srcSize < (int64_t) sizeof(trailer)) {
+        FTI_Print("Compressed dataset is truncated.", FTI_WARN);
+        return FTI_NSCS;
+    }
+    memcpy(&trailer, (const unsigned char*) src + srcSize - sizeof(trailer),
+     sizeof(trailer));
+    int64_t dataSize = srcSize - sizeof(trailer);
+    if (memcmp(trailer.magic, FTI_COMPRESS_MAGIC, sizeof(trailer.magic)) ||
+     trailer.rawSize != (uint64_t) destSize || trailer.chunkSize == 0 ||
+     trailer.shuffle < 0 || (trailer.lossy && (!(trailer.lossy ==
+     sizeof(float) || trailer.lossy == sizeof(double)) ||
+     trailer.chunkSize % trailer.lossy || trailer.rawSize % trailer.lossy ||
+     !(trailer.errorBound > 0) || !isfinite(trailer.errorBound))) ||
+     trailer.nbChunks != (trailer.rawSize + trailer.chunkSize - 1) /
+     trailer.chunkSize || trailer.nbChunks > dataSize / sizeof(uint64_t)) {
+        FTI_Print("Compressed dataset is corrupted.", FTI_WARN);
+        return FTI_NSCS;
+    }
+    if (!FTI_CodecAvailable(trailer.codec)) {
+        snprintf(str, FTI_BUFS, "Dataset compressed with %s, which this FTI"
+         " build does not support.", FTI_CodecName(trailer.codec));
+        FTI_Print(str, FTI_EROR);
+        return FTI_NSCS;
+    }
+
+    FTIT_compressJob job;
+    memset(&job, 0, sizeof(job));
+    job.src = (const unsigned char*) src;
+    job.dest = (unsigned char*) dest;
+    job.size = trailer.rawSize;
+    job.chunkSize = trailer.chunkSize;
+    job.codec = trailer.codec;
+    job.shuffle = trailer.shuffle;
+    job.lossy = trailer.lossy;
+    job.errorBound = trailer.errorBound;
+    job.sizes = talloc(uint64_t, trailer.nbChunks);
+    job.offsets = talloc(uint64_t, trailer.nbChunks);
+    if (trailer.nbChunks > 0 && (!job.sizes || !job.offsets)) {
+        FTI_Print("Cannot allocate the chunk index.", FTI_EROR);
+        free(job.sizes);
+        free(job.offsets);
+        return FTI_NSCS;
+    }
+    dataSize -= trailer.nbChunks * sizeof(uint64_t);
+    memcpy(job.sizes, (const unsigned char*) src + dataSize,
+     trailer.nbChunks * sizeof(uint64_t));
+
+    uint64_t offset = 0, c;
+    for (c = 0; c < trailer.nbChunks; c++) {
+        job.offsets[c] = offset;
+        if ((job.sizes[c] & ~FTI_CHUNK_RAW) > (uint64_t) dataSize) {
+            break;
+        }
+        offset += job.sizes[c] & ~FTI_CHUNK_RAW;
+    }
+    int res = FTI_NSCS;
+    if (c == trailer.nbChunks && offset == (uint64_t) dataSize) {
+        FTI_HashParallel(FTI_DecompressChunks, &job, trailer.nbChunks,
+         FTI_POOL_RECO);
+        res = (job.failed) ? FTI_NSCS : FTI_SCES;
+    }
+    if (res != FTI_SCES) {
+        FTI_Print("Compressed dataset is corrupted.", FTI_WARN);
+    }
+    free(job.sizes);
+    free(job.offsets);
+    return res;
+}
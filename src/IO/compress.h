@@ -0,0 +1,23 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  @file   compress.h
+ */
+
+#ifndef FTI_SRC_IO_COMPRESS_H_
+#define FTI_SRC_IO_COMPRESS_H_
+
+#include <stdint.h>
+
+int FTI_InitCompression(FTIT_configuration* FTI_Conf);
+bool FTI_CodecAvailable(int codec);
+const char* FTI_CodecName(int codec);
+int FTI_LossyCodec();
+bool FTI_CompressionOf(const FTIT_dataset* data, FTIT_compression* comp);
+int FTI_WriteCompressed(FTIT_dataset* data, const FTIT_compression* comp,
+ int (*writeFunc)(void* src, size_t size, void* opaque), void* opaque);
+int FTI_Decompress(const void* src, int64_t srcSize, void* dest,
+ int64_t destSize);
+
+#endif  // FTI_SRC_IO_COMPRESS_H_
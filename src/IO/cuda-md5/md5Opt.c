@@ -63,6 +63,17 @@ unsigned char* (*cpuHash)(const unsigned char *data, uint64_t nBytes,
  unsigned char *hash);
 int32_t tempBufferSize;
 int32_t md5ChunkSize;
+static int32_t digestWidth;
+
+/** Context of a parallel dCP hashing job. */
+typedef struct FTIT_md5Job {
+    FTIT_dataset *data;         /**< Dataset to hash.               */
+    unsigned char *ptr;         /**< Start of the dataset.          */
+    unsigned char *hashes;      /**< Hash array of the dataset.     */
+    unsigned char *oldHashes;   /**< Hashes of the last checkpoint. */
+    uint64_t oldSize;           /**< Bytes covered by 'oldHashes'.  */
+    uint64_t size;              /**< Size of the dataset.           */
+} FTIT_md5Job;
 
 
 /*-------------------------------------------------------------------------*/
@@ -83,6 +94,7 @@ int FTI_initMD5(int32_t cSize, int32_t tempSize, FTIT_configuration *FTI_Conf) {
         usesAsync = 0;
 
     cpuHash = FTI_Conf->dcpInfoPosix.hashFunc;
+    digestWidth = FTI_Conf->dcpInfoPosix.digestWidth;
     tempBufferSize = tempSize;
     md5ChunkSize = cSize;
     return FTI_SCES;
@@ -90,33 +102,58 @@ int FTI_initMD5(int32_t cSize, int32_t tempSize, FTIT_configuration *FTI_Conf) {
 
 /*-------------------------------------------------------------------------*/
 /**
-  @brief     This function computes the checksums of an Protected Variable 
-  @param     data Variable We need to compute the checksums
-  @return     integer         FTI_SCES if successfu.
-
-  This function computes the checksums of a specific variable 
+  @brief     Computes the checksums of the blocks [first,last) of a variable
+  @param     ctx Pointer to the FTIT_md5Job describing the variable
+  @param     first First block
+  @param     last Block after the last one
+
+  Called by the hashing engine, possibly from several threads at once on
+  disjoint block ranges. The last block is padded with zeros. Blocks that
+  the dirty tracking reports as not written keep their last hash.
  **/
 /*-------------------------------------------------------------------------*/
-int MD5CPU(FTIT_dataset *data) {
-    uint32_t dataSize = data->size;
+static void MD5CPUBlocks(void *ctx, int64_t first, int64_t last) {
+    FTIT_md5Job *job = (FTIT_md5Job *) ctx;
     unsigned char block[md5ChunkSize];
-    size_t i;
-    unsigned char *ptr = (unsigned char *) data->ptr;
-    for (i = 0 ; i < data->size; i+=md5ChunkSize) {
-        unsigned int blockId = i/md5ChunkSize;
-        unsigned int hashIdx = blockId*16;
-        unsigned int chunkSize = ((dataSize-i) < md5ChunkSize) ?
-         dataSize-i: md5ChunkSize;
-        if (chunkSize < md5ChunkSize) {
+    int64_t blockId;
+    for (blockId = first; blockId < last; blockId++) {
+        uint64_t i = (uint64_t) blockId * md5ChunkSize;
+        unsigned char *hash = &job->hashes[blockId * digestWidth];
+        uint64_t blockSize = ((job->size - i) < md5ChunkSize) ?
+         job->size - i : md5ChunkSize;
+        if (i < job->oldSize &&
+         FTI_DirtyTrackClean(job->data, i, blockSize)) {
+            memcpy(hash, &job->oldHashes[blockId * digestWidth], digestWidth);
+        } else if ((job->size - i) < md5ChunkSize) {
             memset(block, 0x0, md5ChunkSize);
-            memcpy(block, &ptr[i], chunkSize);
-            cpuHash(block, md5ChunkSize,
-             &data->dcpInfoPosix.currentHashArray[hashIdx]);
+            memcpy(block, &job->ptr[i], job->size - i);
+            cpuHash(block, md5ChunkSize, hash);
         } else {
-            cpuHash(&ptr[i], md5ChunkSize,
-             &data->dcpInfoPosix.currentHashArray[hashIdx]);
+            cpuHash(&job->ptr[i], md5ChunkSize, hash);
         }
     }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief     This function computes the checksums of an Protected Variable 
+  @param     data Variable We need to compute the checksums
+  @return     integer         FTI_SCES if successfu.
+
+  This function computes the checksums of a specific variable. The blocks
+  are distributed over the threads of the dCP hashing engine.
+ **/
+/*-------------------------------------------------------------------------*/
+int MD5CPU(FTIT_dataset *data) {
+    FTIT_md5Job job;
+    job.data = data;
+    job.ptr = (unsigned char *) data->ptr;
+    job.hashes = data->dcpInfoPosix.currentHashArray;
+    job.oldHashes = data->dcpInfoPosix.oldHashArray;
+    job.oldSize = data->dcpInfoPosix.hashDataSize;
+    job.size = data->size;
+    FTI_HashParallel(MD5CPUBlocks, &job,
+     (data->size + md5ChunkSize - 1) / md5ChunkSize, FTI_POOL_DCP);
     return FTI_SCES;
 }
 
@@ -0,0 +1,519 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  FTI - A multi-level checkpointing library for C/C++/Fortran applications
+ *
+ *  Revision 1.0 : Fault Tolerance Interface (FTI)
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *  list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors
+ *  may be used to endorse or promote products derived from this software without
+ *  specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  @brief  Block index and layer merging of dCP POSIX files.
+ *
+ *  A dCP POSIX file holds a base layer with the padded data of every
+ *  variable, followed by up to 'StackSize - 1' layers of (meta, block)
+ *  records. The block index gives the offset of the newest copy of every
+ *  block, recovery reads each block once from there.
+ *
+ *  When enough layers are stacked, a helper thread uses the same index to
+ *  write a new base file from the current one while the application runs.
+ *  The next dCP checkpoint adopts this file and appends its layer to it.
+ */
+
+#include "../interface.h"
+#include "dcp-compact.h"
+
+#include <fcntl.h>
+
+/** Number of block records of a layer whose meta data is read at once. */
+#define FTI_DCP_INDEX_CHUNK 65536
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Compares two block indexes by variable ID.
+  @param      a               Pointer to the first index.
+  @param      b               Pointer to the second index.
+  @return     integer         <0, 0 or >0 as for qsort.
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_CompareBlockIndex(const void* a, const void* b) {
+    int ia = (*(FTIT_dcpBlockIndex* const*) a)->id;
+    int ib = (*(FTIT_dcpBlockIndex* const*) b)->id;
+    return (ia > ib) - (ia < ib);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Finds the block index of a variable.
+  @param      byId            Block indexes sorted by variable ID.
+  @param      nbVar           Number of block indexes.
+  @param      id              Variable ID.
+  @return     FTIT_dcpBlockIndex*  The index or NULL if not indexed.
+ **/
+/*-------------------------------------------------------------------------*/
+static FTIT_dcpBlockIndex* FTI_FindBlockIndex(FTIT_dcpBlockIndex** byId,
+ int nbVar, int id) {
+    FTIT_dcpBlockIndex key = { .id = id };
+    FTIT_dcpBlockIndex* keyPtr = &key;
+    FTIT_dcpBlockIndex** found = (FTIT_dcpBlockIndex**) bsearch(&keyPtr,
+     byId, nbVar, sizeof(FTIT_dcpBlockIndex*), FTI_CompareBlockIndex);
+    return (found) ? *found : NULL;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Builds the block index of a dCP POSIX file.
+  @param      fd              File descriptor of the dCP file.
+  @param      blockSize       dCP block size of the file.
+  @param      layerSize       Size of every layer, header included.
+  @param      nbLayer         Number of layers to index.
+  @param      vars            Variables to index, 'id' and 'size' set.
+  @param      nbVar           Number of variables.
+  @param      parallel        TRUE to read on the worker pool.
+  @return     integer         FTI_SCES if successful.
+
+  Sets 'nbBlocks' and allocates 'pos' for every variable. Only the 6 bytes
+  of meta data of the records are read. The layers are processed from the
+  oldest to the newest, so 'pos' ends up with the newest copy of a block.
+  Blocks that are not in the file keep the offset -1. The 'pos' arrays
+  must be freed with FTI_DcpPosixIndexFree, even on failure.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_DcpPosixIndex(int fd, uint32_t blockSize, const uint64_t* layerSize,
+ int nbLayer, FTIT_dcpBlockIndex* vars, int nbVar, bool parallel) {
+    int (*readExtents)(int, FTIT_extent*, int64_t) = (parallel) ?
+     FTI_ReadExtents : FTI_ReadExtentsSerial;
+    int64_t b;
+    int i, l;
+
+    FTIT_dcpBlockIndex** byId = talloc(FTIT_dcpBlockIndex*, nbVar + 1);
+    for (i = 0; i < nbVar; i++) {
+        vars[i].nbBlocks = (vars[i].size + blockSize - 1) / blockSize;
+        vars[i].pos = talloc(int64_t, vars[i].nbBlocks + 1);
+        for (b = 0; b < vars[i].nbBlocks; b++) {
+            vars[i].pos[b] = -1;
+        }
+        byId[i] = &vars[i];
+    }
+    qsort(byId, nbVar, sizeof(FTIT_dcpBlockIndex*), FTI_CompareBlockIndex);
+
+    // base layer: header of every variable followed by its padded data
+    int nbVarLayer;
+    int64_t pos = sizeof(uint32_t) + sizeof(unsigned int) + sizeof(int);
+    FTIT_extent nbVarExt = { pos, &nbVarLayer, sizeof(int) };
+    int res = readExtents(fd, &nbVarExt, 1);
+    pos += sizeof(int);
+    for (i = 0; i < nbVarLayer && res == FTI_SCES; i++) {
+        int varId;
+        uint64_t varSize;
+        FTIT_extent meta[2] = {
+            { pos, &varId, sizeof(int) },
+            { pos + sizeof(int), &varSize, sizeof(uint64_t) }
+        };
+        res = readExtents(fd, meta, 2);
+        if (res != FTI_SCES) {
+            break;
+        }
+        pos += sizeof(int) + sizeof(uint64_t);
+
+        int64_t nbBlocks = (varSize + blockSize - 1) / blockSize;
+        FTIT_dcpBlockIndex* var = FTI_FindBlockIndex(byId, nbVar, varId);
+        if (var) {
+            for (b = 0; b < nbBlocks && b < var->nbBlocks; b++) {
+                var->pos[b] = pos + b * blockSize;
+            }
+        }
+        pos += nbBlocks * blockSize;
+    }
+
+    // next layers: only the meta data of the records is read
+    int64_t recSize = FTI_DCP_RECORD_SIZE(blockSize);
+    unsigned char* meta = talloc(unsigned char, 6 * FTI_DCP_INDEX_CHUNK);
+    FTIT_extent* ext = talloc(FTIT_extent, FTI_DCP_INDEX_CHUNK);
+    pos = layerSize[0];
+    for (l = 1; l < nbLayer && res == FTI_SCES; l++) {
+        int64_t first = pos + 2 * sizeof(int);
+        int64_t nbRec = (int64_t) (layerSize[l] - 2 * sizeof(int)) / recSize;
+        int64_t r0;
+        for (r0 = 0; r0 < nbRec && res == FTI_SCES;
+         r0 += FTI_DCP_INDEX_CHUNK) {
+            int64_t n = nbRec - r0;
+            n = (n < FTI_DCP_INDEX_CHUNK) ? n : FTI_DCP_INDEX_CHUNK;
+            int64_t r;
+            for (r = 0; r < n; r++) {
+                ext[r].offset = first + (r0 + r) * recSize;
+                ext[r].dest = meta + r * 6;
+                ext[r].size = 6;
+            }
+            res = readExtents(fd, ext, n);
+            for (r = 0; r < n && res == FTI_SCES; r++) {
+                blockMetaInfo_t blockMeta;
+                memcpy(&blockMeta, meta + r * 6, 6);
+                FTIT_dcpBlockIndex* var = FTI_FindBlockIndex(byId, nbVar,
+                 blockMeta.varId);
+                if (var && blockMeta.blockId < var->nbBlocks) {
+                    var->pos[blockMeta.blockId] = first + (r0 + r) * recSize
+                     + 6;
+                }
+            }
+        }
+        pos += layerSize[l];
+    }
+
+    free(ext);
+    free(meta);
+    free(byId);
+    return res;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Frees the offsets of block indexes.
+  @param      vars            Block indexes.
+  @param      nbVar           Number of block indexes.
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_DcpPosixIndexFree(FTIT_dcpBlockIndex* vars, int nbVar) {
+    int i;
+    for (i = 0; i < nbVar; i++) {
+        free(vars[i].pos);
+        vars[i].pos = NULL;
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Builds the extents reading a range of blocks of a variable.
+  @param      var             Block index of the variable.
+  @param      blockSize       dCP block size.
+  @param      first           First block to read.
+  @param      last            Block after the last one to read.
+  @param      dest            Destination of block 'first'.
+  @param      ext             Extents, at least 'last - first'.
+  @return     int64_t         Number of extents.
+
+  Blocks missing in the file are skipped. Blocks that follow each other
+  in the file and in memory are merged into one extent.
+ **/
+/*-------------------------------------------------------------------------*/
+int64_t FTI_DcpPosixExtents(const FTIT_dcpBlockIndex* var, uint32_t blockSize,
+ int64_t first, int64_t last, unsigned char* dest, FTIT_extent* ext) {
+    int64_t b, n = 0;
+    for (b = first; b < last; b++) {
+        if (var->pos[b] < 0) {
+            continue;
+        }
+        int64_t size = var->size - (uint64_t) b * blockSize;
+        size = (size < blockSize) ? size : blockSize;
+        unsigned char* d = dest + (b - first) * blockSize;
+        if (n > 0 && ext[n-1].offset + ext[n-1].size == var->pos[b] &&
+         (unsigned char*) ext[n-1].dest + ext[n-1].size == d) {
+            ext[n-1].size += size;
+        } else {
+            ext[n].offset = var->pos[b];
+            ext[n].dest = d;
+            ext[n].size = size;
+            n++;
+        }
+    }
+    return n;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Writes the merged base file.
+  @param      c               Merge to run.
+  @return     integer         FTI_SCES if successful.
+
+  The new file has the layout of a base layer, its data is read from the
+  newest copy of every block of 'src'. Reads are serial so the merge
+  does not compete with the application for the worker pool.
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_DcpPosixMerge(FTIT_dcpCompaction* c) {
+    int sfd = open(c->src, O_RDONLY);
+    if (sfd == -1) {
+        return FTI_NSCS;
+    }
+    int res = FTI_DcpPosixIndex(sfd, c->blockSize, c->layerSize, c->nbLayer,
+     c->vars, c->nbVar, false);
+
+    FILE* dst = NULL;
+    if (res == FTI_SCES) {
+        dst = fopen(c->dst, "wb");
+        res = (dst) ? FTI_SCES : FTI_NSCS;
+    }
+    if (res == FTI_SCES) {
+        if (fwrite(&c->blockSize, sizeof(uint32_t), 1, dst) != 1 ||
+         fwrite(&c->stackSize, sizeof(unsigned int), 1, dst) != 1 ||
+         fwrite(&c->ckptId, sizeof(int), 1, dst) != 1 ||
+         fwrite(&c->nbVar, sizeof(int), 1, dst) != 1) {
+            res = FTI_NSCS;
+        }
+    }
+
+    int64_t nbBuf = FTI_READ_BATCH / c->blockSize;
+    nbBuf = (nbBuf > 0) ? nbBuf : 1;
+    unsigned char* buffer = talloc(unsigned char, nbBuf * c->blockSize);
+    FTIT_extent* ext = talloc(FTIT_extent, nbBuf);
+    int i;
+    for (i = 0; i < c->nbVar && res == FTI_SCES; i++) {
+        FTIT_dcpBlockIndex* var = &c->vars[i];
+        if (fwrite(&var->id, sizeof(int), 1, dst) != 1 ||
+         fwrite(&var->size, sizeof(uint64_t), 1, dst) != 1) {
+            res = FTI_NSCS;
+        }
+        int64_t b;
+        for (b = 0; b < var->nbBlocks && res == FTI_SCES; b += nbBuf) {
+            int64_t last = (b + nbBuf < var->nbBlocks) ? b + nbBuf :
+             var->nbBlocks;
+            int64_t j;
+            for (j = b; j < last; j++) {
+                // every block of the current data is in the file
+                if (var->pos[j] < 0) {
+                    res = FTI_NSCS;
+                }
+            }
+            memset(buffer, 0, (last - b) * c->blockSize);
+            int64_t n = FTI_DcpPosixExtents(var, c->blockSize, b, last,
+             buffer, ext);
+            if (res == FTI_SCES) {
+                res = FTI_ReadExtentsSerial(sfd, ext, n);
+            }
+            if (res == FTI_SCES && fwrite(buffer, c->blockSize, last - b,
+             dst) != last - b) {
+                res = FTI_NSCS;
+            }
+        }
+    }
+    free(ext);
+    free(buffer);
+
+    if (dst) {
+        if (fflush(dst) != 0 || fsync(fileno(dst)) != 0) {
+            res = FTI_NSCS;
+        }
+        if (fclose(dst) != 0) {
+            res = FTI_NSCS;
+        }
+    }
+    close(sfd);
+    return res;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Entry point of the merging thread.
+  @param      arg             Merge to run.
+  @return     void*           NULL.
+ **/
+/*-------------------------------------------------------------------------*/
+static void* FTI_DcpPosixCompactThread(void* arg) {
+    FTIT_dcpCompaction* c = (FTIT_dcpCompaction*) arg;
+    c->result = FTI_DcpPosixMerge(c);
+    return NULL;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Starts merging the layers of the current dCP file.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Data        Dataset metadata.
+  @param      dir             Directory of the dCP file.
+  @param      myRank          Rank of the process.
+  @return     integer         FTI_SCES if successful.
+
+  Called by FTI_CommitCkpt once all ranks wrote their layer. Layers are
+  merged if 'dcp_compact_layers' layers are stacked or if the layers after
+  the base hold more than 'dcp_compact_ratio' percent of its size. All
+  ranks must keep the same layer structure, hence the decision is
+  collective. The new base holds
+  the data of the last checkpoint, its hash is computed from the block
+  hashes kept for the next checkpoint.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_DcpPosixCompactStart(FTIT_configuration* FTI_Conf,
+ FTIT_execution* FTI_Exec, FTIT_keymap* FTI_Data, const char* dir,
+ int myRank) {
+    FTIT_dcpCompaction* c = &FTI_Exec->dcpCompact;
+    unsigned int compactLayers = FTI_Conf->dcpInfoPosix.CompactLayers;
+    unsigned int compactRatio = FTI_Conf->dcpInfoPosix.CompactRatio;
+    unsigned int stackSize = FTI_Conf->dcpInfoPosix.StackSize;
+    uint32_t blockSize = FTI_Conf->dcpInfoPosix.BlockSize;
+    int nbLayer = (FTI_Exec->dcpInfoPosix.Counter - 1) % stackSize + 1;
+
+    if (c->active || (compactLayers == 0 && compactRatio == 0)) {
+        return FTI_SCES;
+    }
+
+    // a rank that lost a layer to a failed checkpoint has fewer layers,
+    // it merges anyway when another rank asks for it
+    uint64_t dirty = 0;
+    int l;
+    for (l = 1; l < nbLayer; l++) {
+        dirty += FTI_Exec->dcpInfoPosix.LayerSize[l];
+    }
+    int merge = (nbLayer >= 2 && nbLayer < stackSize) &&
+     ((compactLayers > 0 && nbLayer >= compactLayers) ||
+      (compactRatio > 0 && dirty * 100 >=
+       (uint64_t) compactRatio * FTI_Exec->dcpInfoPosix.LayerSize[0]));
+    MPI_Allreduce(MPI_IN_PLACE, &merge, 1, MPI_INT, MPI_LOR, FTI_COMM_WORLD);
+    if (!merge) {
+        return FTI_SCES;
+    }
+
+    FTIT_dataset* data;
+    if ((FTI_Data->data(&data, FTI_Exec->nbVar) != FTI_SCES) || !data) {
+        // the failed merge is still adopted collectively, and rejected
+        c->active = true;
+        c->threaded = false;
+        c->result = FTI_NSCS;
+        c->dst[0] = '\0';
+        c->vars = NULL;
+        c->nbVar = 0;
+        return FTI_NSCS;
+    }
+
+    int fileId = (FTI_Exec->dcpInfoPosix.Counter - 1) / stackSize;
+    snprintf(c->src, FTI_BUFS, "%s/%s", dir, FTI_Exec->ckptMeta.ckptFile);
+    snprintf(c->dst, FTI_BUFS, "%s/dcp-id%d-rank%d.fti.tmp", dir,
+     fileId + 1, myRank);
+    c->oldFileId = fileId;
+    c->blockSize = blockSize;
+    c->stackSize = stackSize;
+    c->ckptId = FTI_Exec->ckptId;
+    c->nbLayer = nbLayer;
+    memcpy(c->layerSize, FTI_Exec->dcpInfoPosix.LayerSize,
+     sizeof(c->layerSize));
+
+    // the new base holds every block, hashed as the base layer is
+    MD5_CTX ctx;
+    MD5_Init(&ctx);
+    c->nbVar = FTI_Exec->nbVar;
+    c->vars = talloc(FTIT_dcpBlockIndex, c->nbVar);
+    c->baseSize = sizeof(uint32_t) + sizeof(unsigned int) + 2 * sizeof(int);
+    int i;
+    for (i = 0; i < c->nbVar; i++) {
+        int64_t nbBlocks = (data[i].size + blockSize - 1) / blockSize;
+        c->vars[i].id = data[i].id;
+        c->vars[i].size = data[i].size;
+        c->vars[i].nbBlocks = nbBlocks;
+        c->vars[i].pos = NULL;
+        MD5_Update(&ctx, data[i].dcpInfoPosix.oldHashArray,
+         nbBlocks * FTI_Conf->dcpInfoPosix.digestWidth);
+        c->baseSize += sizeof(int) + sizeof(uint64_t) + nbBlocks * blockSize;
+    }
+    unsigned char hash[MD5_DIGEST_LENGTH];
+    MD5_Final(hash, &ctx);
+    FTI_GetHashHexStr(hash, MD5_DIGEST_LENGTH, c->baseHash);
+
+    c->active = true;
+    c->result = FTI_NSCS;
+    c->threaded = (pthread_create(&c->thread, NULL,
+     FTI_DcpPosixCompactThread, c) == 0);
+    if (!c->threaded) {
+        FTI_Print("cannot start dCP merging thread, merging now.", FTI_WARN);
+        c->result = FTI_DcpPosixMerge(c);
+    }
+    return FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Adopts the merged base file, if any.
+  @param      FTI_Exec        Execution metadata.
+  @return     integer         FTI_SCES if successful.
+
+  Called before a dCP checkpoint. Waits for the merge, then all ranks
+  switch to the new file or none does. On success the next layer is
+  appended to the new file, which becomes the file of the next ID.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_DcpPosixCompactAdopt(FTIT_execution* FTI_Exec) {
+    FTIT_dcpCompaction* c = &FTI_Exec->dcpCompact;
+    char str[FTI_BUFS];
+    char fn[FTI_BUFS];
+
+    if (!c->active) {
+        return FTI_SCES;
+    }
+    if (c->threaded) {
+        pthread_join(c->thread, NULL);
+    }
+    c->active = false;
+
+    // the final name is the temporary one without '.tmp'
+    snprintf(fn, FTI_BUFS, "%.*s", (int) strlen(c->dst) - 4, c->dst);
+    int ok = (c->result == FTI_SCES) && (rename(c->dst, fn) == 0);
+    int all;
+    MPI_Allreduce(&ok, &all, 1, MPI_INT, MPI_LAND, FTI_COMM_WORLD);
+
+    if (all) {
+        FTI_Exec->dcpInfoPosix.Counter = (c->oldFileId + 1) * c->stackSize
+         + 1;
+        FTI_Exec->dcpInfoPosix.LayerSize[0] = c->baseSize;
+        memcpy(FTI_Exec->dcpInfoPosix.LayerHash, c->baseHash,
+         MD5_DIGEST_STRING_LENGTH);
+        FTI_Exec->dcpInfoPosix.FileSize = c->baseSize;
+        c->adopted = true;
+        snprintf(str, FTI_BUFS, "dCP layers 0 to %d merged into '%s'.",
+         c->nbLayer - 1, fn);
+        FTI_Print(str, FTI_DBUG);
+    } else {
+        remove((ok) ? fn : c->dst);
+        FTI_Print("dCP layer merging failed, keeping the layers.", FTI_WARN);
+    }
+
+    FTI_DcpPosixIndexFree(c->vars, c->nbVar);
+    free(c->vars);
+    c->vars = NULL;
+    return (all) ? FTI_SCES : FTI_NSCS;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Cancels a pending merge.
+  @param      FTI_Exec        Execution metadata.
+
+  Called by FTI_Finalize. A merge that was not adopted is not referenced
+  by the metadata, its file is removed.
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_DcpPosixCompactFinalize(FTIT_execution* FTI_Exec) {
+    FTIT_dcpCompaction* c = &FTI_Exec->dcpCompact;
+    if (!c->active) {
+        return;
+    }
+    if (c->threaded) {
+        pthread_join(c->thread, NULL);
+    }
+    c->active = false;
+    remove(c->dst);
+    FTI_DcpPosixIndexFree(c->vars, c->nbVar);
+    free(c->vars);
+    c->vars = NULL;
+}
@@ -0,0 +1,27 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  @file   dcp-compact.h
+ */
+
+#ifndef FTI_SRC_IO_DCP_COMPACT_H_
+#define FTI_SRC_IO_DCP_COMPACT_H_
+
+#include <stdint.h>
+
+/** Size of a block record of the dCP POSIX layers > 0 (meta data + block). */
+#define FTI_DCP_RECORD_SIZE(blockSize) ((int64_t) (blockSize) + 6)
+
+int FTI_DcpPosixIndex(int fd, uint32_t blockSize, const uint64_t* layerSize,
+ int nbLayer, FTIT_dcpBlockIndex* vars, int nbVar, bool parallel);
+void FTI_DcpPosixIndexFree(FTIT_dcpBlockIndex* vars, int nbVar);
+int64_t FTI_DcpPosixExtents(const FTIT_dcpBlockIndex* var, uint32_t blockSize,
+ int64_t first, int64_t last, unsigned char* dest, FTIT_extent* ext);
+int FTI_DcpPosixCompactStart(FTIT_configuration* FTI_Conf,
+ FTIT_execution* FTI_Exec, FTIT_keymap* FTI_Data, const char* dir,
+ int myRank);
+int FTI_DcpPosixCompactAdopt(FTIT_execution* FTI_Exec);
+void FTI_DcpPosixCompactFinalize(FTIT_execution* FTI_Exec);
+
+#endif  // FTI_SRC_IO_DCP_COMPACT_H_
@@ -0,0 +1,456 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  FTI - A multi-level checkpointing library for C/C++/Fortran applications
+ *
+ *  Revision 1.0 : Fault Tolerance Interface (FTI)
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *  list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors
+ *  may be used to endorse or promote products derived from this software without
+ *  specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  @file   dcp-hash.c
+ *  @date   October, 2026
+ *  @brief  Parallel block hashing engine for differential checkpointing.
+ *
+ *  The engine keeps a small pool of worker threads that split the block
+ *  range of a dataset among themselves (the calling thread takes part as
+ *  well). Besides MD5 and CRC32, it provides CRC32C, which uses the SSE4.2
+ *  (x86_64) or ARMv8 CRC instructions when the CPU supports them.
+ */
+
+#include "../interface.h"
+#include "dcp-hash.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#   include <nmmintrin.h>
+#   define FTI_CRC32C_SSE42
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#   include <arm_acle.h>
+#   define FTI_CRC32C_ARMV8
+#endif
+
+#define FTI_CRC32C_POLY 0x82F63B78  /**< Reflected Castagnoli polynomial. */
+
+/** State of the hashing thread pool. */
+static struct {
+    pthread_t* threads;         /**< Worker threads.                        */
+    int nbWorkers;              /**< Number of workers (without caller).    */
+    pthread_mutex_t lock;       /**< Protects the job description.          */
+    pthread_mutex_t run;        /**< Serializes FTI_HashParallel calls.     */
+    pthread_cond_t wake;        /**< Signals a new job to the workers.      */
+    pthread_cond_t done;        /**< Signals the end of a job to caller.    */
+    FTIT_hashJob job;           /**< Current work function.                 */
+    void* ctx;                  /**< Context of the current job.            */
+    int64_t nbItems;            /**< Number of items of the current job.    */
+    int64_t grain;              /**< Items taken per grab.                  */
+    int64_t next;               /**< Next unclaimed item.                   */
+    unsigned int generation;    /**< Job counter.                           */
+    int busy;                   /**< Workers still running the current job. */
+    int active;                 /**< Workers that may still join the job.   */
+    int limit[FTI_POOL_USERS];  /**< Threads allowed to each pool user.     */
+    bool quit;                  /**< TRUE to stop the workers.              */
+    bool initialized;           /**< TRUE if FTI_InitHashEngine ran.        */
+} hashPool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .run = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+    .done = PTHREAD_COND_INITIALIZER
+};
+
+static pthread_once_t crc32cOnce = PTHREAD_ONCE_INIT;
+static uint32_t crc32cTable[8][256];
+static uint32_t (*crc32cKernel)(uint32_t, const unsigned char*, uint64_t);
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Software CRC32C kernel (slicing-by-8).
+  @param      crc             Running (inverted) CRC value.
+  @param      d               Pointer to the data.
+  @param      nBytes          Number of bytes.
+  @return     uint32_t        Updated (inverted) CRC value.
+ **/
+/*-------------------------------------------------------------------------*/
+static uint32_t FTI_Crc32cSw(uint32_t crc, const unsigned char* d,
+ uint64_t nBytes) {
+    while (nBytes && ((uintptr_t)d & 7)) {
+        crc = crc32cTable[0][(crc ^ *d++) & 0xFF] ^ (crc >> 8);
+        nBytes--;
+    }
+    while (nBytes >= 8) {
+        uint64_t w;
+        memcpy(&w, d, 8);
+        w ^= crc;
+        crc = crc32cTable[7][w & 0xFF] ^
+              crc32cTable[6][(w >> 8) & 0xFF] ^
+              crc32cTable[5][(w >> 16) & 0xFF] ^
+              crc32cTable[4][(w >> 24) & 0xFF] ^
+              crc32cTable[3][(w >> 32) & 0xFF] ^
+              crc32cTable[2][(w >> 40) & 0xFF] ^
+              crc32cTable[1][(w >> 48) & 0xFF] ^
+              crc32cTable[0][w >> 56];
+        d += 8;
+        nBytes -= 8;
+    }
+    while (nBytes--) {
+        crc = crc32cTable[0][(crc ^ *d++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#ifdef FTI_CRC32C_SSE42
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      SSE4.2 CRC32C kernel.
+  @param      crc             Running (inverted) CRC value.
+  @param      d               Pointer to the data.
+  @param      nBytes          Number of bytes.
+  @return     uint32_t        Updated (inverted) CRC value.
+ **/
+/*-------------------------------------------------------------------------*/
+__attribute__((target("sse4.2")))
+static uint32_t FTI_Crc32cHw(uint32_t crc, const unsigned char* d,
+ uint64_t nBytes) {
+    uint64_t c = crc;
+    while (nBytes && ((uintptr_t)d & 7)) {
+        c = _mm_crc32_u8((uint32_t)c, *d++);
+        nBytes--;
+    }
+    while (nBytes >= 8) {
+        uint64_t w;
+        memcpy(&w, d, 8);
+        c = _mm_crc32_u64(c, w);
+        d += 8;
+        nBytes -= 8;
+    }
+    while (nBytes--) {
+        c = _mm_crc32_u8((uint32_t)c, *d++);
+    }
+    return (uint32_t)c;
+}
+#elif defined(FTI_CRC32C_ARMV8)
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      ARMv8 CRC32C kernel.
+  @param      crc             Running (inverted) CRC value.
+  @param      d               Pointer to the data.
+  @param      nBytes          Number of bytes.
+  @return     uint32_t        Updated (inverted) CRC value.
+ **/
+/*-------------------------------------------------------------------------*/
+static uint32_t FTI_Crc32cHw(uint32_t crc, const unsigned char* d,
+ uint64_t nBytes) {
+    while (nBytes && ((uintptr_t)d & 7)) {
+        crc = __crc32cb(crc, *d++);
+        nBytes--;
+    }
+    while (nBytes >= 8) {
+        uint64_t w;
+        memcpy(&w, d, 8);
+        crc = __crc32cd(crc, w);
+        d += 8;
+        nBytes -= 8;
+    }
+    while (nBytes--) {
+        crc = __crc32cb(crc, *d++);
+    }
+    return crc;
+}
+#endif
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Builds the CRC32C tables and selects the fastest kernel.
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_InitCrc32c() {
+    uint32_t i, j, crc;
+    for (i = 0; i < 256; i++) {
+        crc = i;
+        for (j = 0; j < 8; j++) {
+            crc = (crc & 1) ? (crc >> 1) ^ FTI_CRC32C_POLY : crc >> 1;
+        }
+        crc32cTable[0][i] = crc;
+    }
+    for (i = 0; i < 256; i++) {
+        crc = crc32cTable[0][i];
+        for (j = 1; j < 8; j++) {
+            crc = crc32cTable[0][crc & 0xFF] ^ (crc >> 8);
+            crc32cTable[j][i] = crc;
+        }
+    }
+    crc32cKernel = FTI_Crc32cSw;
+#if defined(FTI_CRC32C_SSE42)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) {
+        crc32cKernel = FTI_Crc32cHw;
+    }
+#elif defined(FTI_CRC32C_ARMV8)
+    crc32cKernel = FTI_Crc32cHw;
+#endif
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Computes the CRC32C (Castagnoli) checksum of a buffer.
+  @param      crc             CRC of the preceding data (0 to start).
+  @param      d               Pointer to the data.
+  @param      nBytes          Number of bytes.
+  @return     uint32_t        The CRC32C checksum.
+ **/
+/*-------------------------------------------------------------------------*/
+uint32_t FTI_Crc32c(uint32_t crc, const unsigned char* d, uint64_t nBytes) {
+    pthread_once(&crc32cOnce, FTI_InitCrc32c);
+    return ~crc32cKernel(~crc, d, nBytes);
+}
+
+// same signature as MD5 and CRC32
+unsigned char* CRC32C(const unsigned char *d, uint64_t nBytes,
+ unsigned char *hash) {
+    static unsigned char hash_[CRC32C_DIGEST_LENGTH];
+    if (hash == NULL) {
+        hash = hash_;
+    }
+
+    uint32_t digest = FTI_Crc32c(0, d, nBytes);
+    memcpy(hash, &digest, CRC32C_DIGEST_LENGTH);
+
+    return hash;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Claims and processes chunks of the current job until done.
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_HashWork() {
+    int64_t first;
+    while ((first = __atomic_fetch_add(&hashPool.next, hashPool.grain,
+     __ATOMIC_RELAXED)) < hashPool.nbItems) {
+        int64_t last = first + hashPool.grain;
+        if (last > hashPool.nbItems) {
+            last = hashPool.nbItems;
+        }
+        hashPool.job(hashPool.ctx, first, last);
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Main loop of the hashing worker threads.
+  @param      arg             Unused.
+  @return     void*           NULL.
+ **/
+/*-------------------------------------------------------------------------*/
+static void* FTI_HashWorker(void* arg) {
+    unsigned int seen = 0;
+    pthread_mutex_lock(&hashPool.lock);
+    while (true) {
+        while (hashPool.generation == seen && !hashPool.quit) {
+            pthread_cond_wait(&hashPool.wake, &hashPool.lock);
+        }
+        if (hashPool.quit) {
+            break;
+        }
+        seen = hashPool.generation;
+        if (hashPool.active > 0) {
+            hashPool.active--;
+            pthread_mutex_unlock(&hashPool.lock);
+            FTI_HashWork();
+            pthread_mutex_lock(&hashPool.lock);
+        }
+        if (--hashPool.busy == 0) {
+            pthread_cond_signal(&hashPool.done);
+        }
+    }
+    pthread_mutex_unlock(&hashPool.lock);
+    return NULL;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Starts the hashing thread pool.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+  @return     integer         FTI_SCES if successful.
+
+  Every user of the pool runs its jobs on at most the number of threads of
+  its own setting (e.g. 'dcp_threads' for the dCP hashing), the pool has
+  the workers of the largest setting among the users of the process. With
+  all of them at 1 no worker is started and the jobs are run by the
+  calling thread, as before.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_InitHashEngine(FTIT_configuration* FTI_Conf,
+ FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo) {
+    char str[FTI_BUFS];
+    int i;
+
+    pthread_once(&crc32cOnce, FTI_InitCrc32c);
+    if (hashPool.initialized) {
+        return FTI_SCES;
+    }
+    hashPool.initialized = true;
+    hashPool.quit = false;
+    hashPool.nbWorkers = 0;
+
+    // the users that do not run on this process keep a single thread
+    for (i = 0; i < FTI_POOL_USERS; i++) {
+        hashPool.limit[i] = 1;
+    }
+    hashPool.limit[FTI_POOL_L3] = FTI_Conf->l3Threads;
+    if (FTI_Topo->amIaHead) {
+        hashPool.limit[FTI_POOL_HEAD] = FTI_Conf->headThreads;
+    } else {
+        if (FTI_Conf->dcpFtiff || FTI_Conf->dcpPosix) {
+            hashPool.limit[FTI_POOL_DCP] = FTI_Conf->dcpThreads;
+        }
+        if (FTI_Exec->reco) {
+            hashPool.limit[FTI_POOL_RECO] = FTI_Conf->recoThreads;
+        }
+        hashPool.limit[FTI_POOL_COMPRESS] = FTI_Conf->compressThreads;
+        if (FTI_Conf->integrity == FTI_INTEGRITY_TREE) {
+            hashPool.limit[FTI_POOL_INTEGRITY] = FTI_Conf->integrityThreads;
+        }
+    }
+    int nbThreads = 1;
+    for (i = 0; i < FTI_POOL_USERS; i++) {
+        if (hashPool.limit[i] > nbThreads) {
+            nbThreads = hashPool.limit[i];
+        }
+    }
+    if (nbThreads <= 1) {
+        return FTI_SCES;
+    }
+
+    hashPool.threads = (pthread_t*) malloc(sizeof(pthread_t) *
+     (nbThreads - 1));
+    for (i = 0; i < nbThreads - 1; i++) {
+        if (pthread_create(&hashPool.threads[i], NULL, FTI_HashWorker,
+         NULL) != 0) {
+            snprintf(str, FTI_BUFS, "Could only start %d of %d dCP hashing "
+                "threads.", i + 1, nbThreads);
+            FTI_Print(str, FTI_WARN);
+            break;
+        }
+        hashPool.nbWorkers++;
+    }
+    snprintf(str, FTI_BUFS, "The worker pool has %d threads.",
+     hashPool.nbWorkers + 1);
+    FTI_Print(str, FTI_IDCP);
+
+    return FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Stops the hashing thread pool.
+  @return     integer         FTI_SCES if successful.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_FinalizeHashEngine() {
+    int i;
+    if (!hashPool.initialized) {
+        return FTI_SCES;
+    }
+    pthread_mutex_lock(&hashPool.lock);
+    hashPool.quit = true;
+    pthread_cond_broadcast(&hashPool.wake);
+    pthread_mutex_unlock(&hashPool.lock);
+    for (i = 0; i < hashPool.nbWorkers; i++) {
+        pthread_join(hashPool.threads[i], NULL);
+    }
+    free(hashPool.threads);
+    hashPool.threads = NULL;
+    hashPool.nbWorkers = 0;
+    hashPool.generation = 0;
+    hashPool.initialized = false;
+    return FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Returns the number of threads that run the jobs of a user.
+  @param      user            User of the pool.
+  @return     integer         Number of threads (incl. caller).
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_HashEngineThreads(FTIT_poolUser user) {
+    if (!hashPool.initialized || hashPool.limit[user] > hashPool.nbWorkers) {
+        return hashPool.nbWorkers + 1;
+    }
+    return hashPool.limit[user];
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Runs a job over nbItems items on the hashing thread pool.
+  @param      job             Work function, called on disjoint ranges.
+  @param      ctx             Context passed to job.
+  @param      nbItems         Number of items (e.g. dCP blocks).
+  @param      user            User of the pool running the job.
+
+  Returns when all items are processed. The calling thread takes part in
+  the work, with at most FTI_HashEngineThreads(user)-1 workers. If the
+  pool is not running or already in use, the job is run serially by the
+  caller.
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_HashParallel(FTIT_hashJob job, void* ctx, int64_t nbItems,
+ FTIT_poolUser user) {
+    if (nbItems <= 0) {
+        return;
+    }
+    int nbThreads = FTI_HashEngineThreads(user);
+    if (nbThreads == 1 || nbItems == 1 ||
+     pthread_mutex_trylock(&hashPool.run) != 0) {
+        job(ctx, 0, nbItems);
+        return;
+    }
+
+    int64_t grain = nbItems / (4 * nbThreads);
+
+    pthread_mutex_lock(&hashPool.lock);
+    hashPool.job = job;
+    hashPool.ctx = ctx;
+    hashPool.nbItems = nbItems;
+    hashPool.grain = (grain > 0) ? grain : 1;
+    hashPool.next = 0;
+    hashPool.busy = hashPool.nbWorkers;
+    hashPool.active = nbThreads - 1;
+    hashPool.generation++;
+    pthread_cond_broadcast(&hashPool.wake);
+    pthread_mutex_unlock(&hashPool.lock);
+
+    FTI_HashWork();
+
+    pthread_mutex_lock(&hashPool.lock);
+    while (hashPool.busy > 0) {
+        pthread_cond_wait(&hashPool.done, &hashPool.lock);
+    }
+    pthread_mutex_unlock(&hashPool.lock);
+    pthread_mutex_unlock(&hashPool.run);
+}
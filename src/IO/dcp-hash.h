@@ -0,0 +1,42 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  @file   dcp-hash.h
+ */
+
+#ifndef FTI_SRC_IO_DCP_HASH_H_
+#define FTI_SRC_IO_DCP_HASH_H_
+
+#include <stdint.h>
+
+#ifndef CRC32C_DIGEST_LENGTH
+#   define CRC32C_DIGEST_LENGTH 4  // 32 bits
+#endif
+
+/** Work function run by the hash engine on the item range [first,last). */
+typedef void (*FTIT_hashJob)(void* ctx, int64_t first, int64_t last);
+
+/** Users of the worker pool, each one limited by its own setting. */
+typedef enum {
+    FTI_POOL_DCP,               /**< dCP hashing ('dcp_threads').          */
+    FTI_POOL_L3,                /**< RS decoding ('l3_threads').           */
+    FTI_POOL_HEAD,              /**< Head post-processing ('head_threads'). */
+    FTI_POOL_RECO,              /**< Recovery reads ('reco_threads').      */
+    FTI_POOL_COMPRESS,          /**< Compression ('compression_threads').  */
+    FTI_POOL_INTEGRITY,         /**< Tree hash ('integrity_threads').      */
+    FTI_POOL_USERS
+} FTIT_poolUser;
+
+int FTI_InitHashEngine(FTIT_configuration* FTI_Conf,
+ FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo);
+int FTI_FinalizeHashEngine();
+int FTI_HashEngineThreads(FTIT_poolUser user);
+void FTI_HashParallel(FTIT_hashJob job, void* ctx, int64_t nbItems,
+ FTIT_poolUser user);
+uint32_t FTI_Crc32c(uint32_t crc, const unsigned char* d, uint64_t nBytes);
+// wrapper for CRC32C (Castagnoli) hash algorithm
+unsigned char* CRC32C(const unsigned char *d, uint64_t nBytes,
+ unsigned char *hash);
+
+#endif  // FTI_SRC_IO_DCP_HASH_H_
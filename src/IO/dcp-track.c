@@ -0,0 +1,558 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  FTI - A multi-level checkpointing library for C/C++/Fortran applications
+ *
+ *  Revision 1.0 : Fault Tolerance Interface (FTI)
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *  list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors
+ *  may be used to endorse or promote products derived from this software without
+ *  specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  @file   dcp-track.c
+ *  @date   October, 2026
+ *  @brief  Page-protection based dirty tracking for POSIX dCP.
+ *
+ *  Once the block hashes of a dataset are computed by a dCP checkpoint,
+ *  the pages lying entirely inside the dataset are made read-only. The
+ *  first write to such a page raises SIGSEGV, the handler records the
+ *  page in the bitmap of the dataset and makes the page writable again.
+ *  At the next dCP checkpoint, the blocks whose pages were not written
+ *  keep their hash, only the other blocks are hashed. The pages at the
+ *  edges of a dataset may be shared with other data and are always
+ *  considered dirty.
+ *
+ *  Memory written by the kernel or by a device does not raise SIGSEGV:
+ *  read(2) into a read-only page fails with EFAULT, single-copy MPI
+ *  transfers (CMA, XPMEM) fail or fall back, RDMA receives may fail or
+ *  corrupt the transfer. Such datasets must not be tracked, the tracking
+ *  is turned off for one of them with FTI_SetAttribute and
+ *  FTI_ATTRIBUTE_DCP_TRACK. FTI releases a dataset itself before writing
+ *  to it, e.g. on recovery.
+ */
+
+#include "../interface.h"
+#include "dcp-track.h"
+
+#include <signal.h>
+#include <sys/mman.h>
+
+/** Dataset tracked since its last dCP hashes. */
+typedef struct FTIT_dirtyRegion {
+    int id;                         /**< ID of the dataset.                  */
+    const void* ptr;                /**< Dataset address when armed.         */
+    uint64_t size;                  /**< Dataset size when armed.            */
+    uintptr_t start;                /**< First read-only page.               */
+    uintptr_t end;                  /**< End of the last read-only page.     */
+    unsigned char* dirty;           /**< One byte per page, 1 if written.    */
+    volatile sig_atomic_t lost;     /**< 1 if all pages are considered dirty */
+} FTIT_dirtyRegion;
+
+/** Tracked datasets sorted by address, never modified once published. */
+typedef struct FTIT_dirtyTable {
+    int nbRegions;                  /**< Number of tracked datasets.         */
+    FTIT_dirtyRegion* regions[];    /**< Tracked datasets.                   */
+} FTIT_dirtyTable;
+
+/** State of the dirty tracking. */
+static struct {
+    bool initialized;               /**< TRUE if the handler is installed.   */
+    uintptr_t pageSize;             /**< Size of a memory page.              */
+    struct sigaction oldAction;     /**< Handler replaced by the tracking.   */
+    FTIT_dirtyTable* volatile table;  /**< Searched by the handler.          */
+    void** garbage;                 /**< Replaced tables and regions.        */
+    int nbGarbage;                  /**< Number of items in 'garbage'.       */
+    volatile sig_atomic_t strays;   /**< 1 if protected pages were moved.    */
+} dirtyTrack;
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Finds the tracked dataset holding an address.
+  @param      table           Tracked datasets.
+  @param      addr            Address.
+  @return     integer         Index of the region, or -(insertion point)-1.
+
+  Called from the signal handler, must not allocate nor lock.
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_FindDirtyRegion(const FTIT_dirtyTable* table, uintptr_t addr) {
+    int lo = 0, hi = (table) ? table->nbRegions - 1 : -1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        const FTIT_dirtyRegion* r = table->regions[mid];
+        if (addr < r->start) {
+            hi = mid - 1;
+        } else if (addr >= r->end) {
+            lo = mid + 1;
+        } else {
+            return mid;
+        }
+    }
+    return -lo - 1;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Checks if the memory of a tracked dataset was unmapped.
+  @param      table           Tracked datasets.
+  @return     integer         1 if a dataset is not mapped anymore.
+
+  A buffer moved by realloc(3) keeps its read-only pages at an address
+  the tracking does not know. Called from the signal handler.
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_DirtyRegionsMoved(const FTIT_dirtyTable* table) {
+    int i;
+    for (i = 0; table && i < table->nbRegions; i++) {
+        unsigned char resident;
+        if (mincore((void*) table->regions[i]->start, dirtyTrack.pageSize,
+         &resident) == -1 && errno == ENOMEM) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Hands a fault not caused by the tracking to the old handler.
+  @param      sig             Signal number.
+  @param      info            Signal information.
+  @param      uctx            Interrupted context.
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_ForwardFault(int sig, siginfo_t* info, void* uctx) {
+    struct sigaction* old = &dirtyTrack.oldAction;
+    if (old->sa_flags & SA_SIGINFO) {
+        old->sa_sigaction(sig, info, uctx);
+    } else if (old->sa_handler != SIG_DFL && old->sa_handler != SIG_IGN) {
+        old->sa_handler(sig);
+    } else {
+        // the faulting instruction runs again with the default action
+        struct sigaction dfl;
+        memset(&dfl, 0, sizeof(dfl));
+        dfl.sa_handler = SIG_DFL;
+        sigaction(sig, &dfl, NULL);
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      SIGSEGV handler recording the first write to a page.
+  @param      sig             Signal number.
+  @param      info            Signal information.
+  @param      uctx            Interrupted context.
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_DirtyTrackFault(int sig, siginfo_t* info, void* uctx) {
+    int savedErrno = errno;
+    uintptr_t ps = dirtyTrack.pageSize;
+    uintptr_t page = (uintptr_t) info->si_addr & ~(ps - 1);
+
+    if (info->si_code == SEGV_ACCERR) {
+        FTIT_dirtyTable* table = dirtyTrack.table;
+        int idx = FTI_FindDirtyRegion(table, page);
+        if (idx >= 0) {
+            FTIT_dirtyRegion* r = table->regions[idx];
+            r->dirty[(page - r->start) / ps] = 1;
+            if (mprotect((void*) page, ps, PROT_READ | PROT_WRITE) == 0) {
+                errno = savedErrno;
+                return;
+            }
+            // too many mappings, the whole dataset becomes writable
+            r->lost = 1;
+            if (mprotect((void*) r->start, r->end - r->start,
+             PROT_READ | PROT_WRITE) == 0) {
+                errno = savedErrno;
+                return;
+            }
+        } else if (!dirtyTrack.strays && FTI_DirtyRegionsMoved(table)) {
+            dirtyTrack.strays = 1;
+        }
+        if (dirtyTrack.strays && mprotect((void*) page, ps,
+         PROT_READ | PROT_WRITE) == 0) {
+            errno = savedErrno;
+            return;
+        }
+    }
+    errno = savedErrno;
+    FTI_ForwardFault(sig, info, uctx);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Installs the dirty tracking.
+  @return     integer         FTI_SCES if successful.
+
+  The SIGSEGV handler replaces the one of the application, faults that
+  are not caused by the tracking are forwarded to it.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_InitDirtyTracking() {
+    if (dirtyTrack.initialized) {
+        return FTI_SCES;
+    }
+    dirtyTrack.pageSize = sysconf(_SC_PAGESIZE);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = FTI_DirtyTrackFault;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGSEGV, &action, &dirtyTrack.oldAction) != 0) {
+        FTI_Print("Cannot install the dCP dirty tracking handler, dirty"
+            " tracking disabled.", FTI_WARN);
+        return FTI_NSCS;
+    }
+    dirtyTrack.initialized = true;
+    return FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Removes the dirty tracking.
+
+  All pages become writable and the handler of the application is
+  restored, unless read-only pages moved by realloc(3) may still fault.
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_FinalizeDirtyTracking() {
+    if (!dirtyTrack.initialized) {
+        return;
+    }
+    FTI_DirtyTrackDisarm();
+    if (!dirtyTrack.strays) {
+        sigaction(SIGSEGV, &dirtyTrack.oldAction, NULL);
+        dirtyTrack.initialized = false;
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Keeps an item the handler may still use until collected.
+  @param      item            Replaced table or region.
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_DirtyTrackRetire(void* item) {
+    dirtyTrack.garbage = (void**) realloc(dirtyTrack.garbage,
+     (dirtyTrack.nbGarbage + 1) * sizeof(void*));
+    dirtyTrack.garbage[dirtyTrack.nbGarbage++] = item;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Frees the tables and regions replaced before this call.
+
+  Called at the end of a dCP checkpoint, a fault raised by another thread
+  cannot still search a table replaced during the previous checkpoint.
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_DirtyTrackCollect() {
+    int i;
+    for (i = 0; i < dirtyTrack.nbGarbage; i++) {
+        free(dirtyTrack.garbage[i]);
+    }
+    free(dirtyTrack.garbage);
+    dirtyTrack.garbage = NULL;
+    dirtyTrack.nbGarbage = 0;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Publishes a new table of tracked datasets.
+  @param      table           New table.
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_DirtyTrackPublish(FTIT_dirtyTable* table) {
+    FTIT_dirtyTable* old = dirtyTrack.table;
+    __sync_synchronize();
+    dirtyTrack.table = table;
+    __sync_synchronize();
+    if (old) {
+        FTI_DirtyTrackRetire(old);
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Makes all tracked pages writable and forgets them.
+
+  Called before FTI writes to the datasets, the next dCP checkpoint then
+  hashes all the blocks.
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_DirtyTrackDisarm() {
+    FTIT_dirtyTable* table = dirtyTrack.table;
+    int i;
+    if (!table) {
+        return;
+    }
+    for (i = 0; i < table->nbRegions; i++) {
+        FTIT_dirtyRegion* r = table->regions[i];
+        if (mprotect((void*) r->start, r->end - r->start,
+         PROT_READ | PROT_WRITE) != 0) {
+            // unmapped, the read-only pages may live elsewhere
+            dirtyTrack.strays = 1;
+        }
+    }
+    FTI_DirtyTrackPublish(NULL);
+    for (i = 0; i < table->nbRegions; i++) {
+        FTI_DirtyTrackRetire(table->regions[i]->dirty);
+        FTI_DirtyTrackRetire(table->regions[i]);
+    }
+    FTI_DirtyTrackCollect();
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Stops tracking the writes to a dataset.
+  @param      data            Dataset written by FTI or not to be tracked.
+
+  Makes the pages of the dataset writable, the next dCP checkpoint hashes
+  all its blocks. The other datasets stay tracked.
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_DirtyTrackRelease(const FTIT_dataset* data) {
+    FTIT_dirtyTable* table = dirtyTrack.table;
+    int n = (table) ? table->nbRegions : 0;
+    int i;
+    for (i = 0; i < n && table->regions[i]->id != data->id; i++) {
+    }
+    if (i == n) {
+        return;
+    }
+    FTIT_dirtyRegion* r = table->regions[i];
+    FTIT_dirtyTable* next = NULL;
+    if (n > 1) {
+        next = (FTIT_dirtyTable*) malloc(sizeof(FTIT_dirtyTable) +
+         (n - 1) * sizeof(FTIT_dirtyRegion*));
+        if (!next) {
+            FTI_DirtyTrackDisarm();
+            return;
+        }
+        next->nbRegions = 0;
+        int j;
+        for (j = 0; j < n; j++) {
+            if (j != i) {
+                next->regions[next->nbRegions++] = table->regions[j];
+            }
+        }
+    }
+
+    // writable before it is unpublished, a fault still finds the region
+    if (mprotect((void*) r->start, r->end - r->start,
+     PROT_READ | PROT_WRITE) != 0) {
+        dirtyTrack.strays = 1;
+    }
+    FTI_DirtyTrackPublish(next);
+    FTI_DirtyTrackRetire(r->dirty);
+    FTI_DirtyTrackRetire(r);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Starts tracking the writes to a dataset.
+  @param      data            Dataset whose dCP hashes were just computed.
+  @return     integer         FTI_SCES if successful.
+
+  Clears the bitmap of the dataset and makes its pages read-only. Called
+  after every dataset of a dCP checkpoint, including the ones added by
+  FTI_AddVarICP, so that writes done before the end of the checkpoint are
+  seen. A dataset sharing pages with another tracked dataset is not
+  tracked.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_DirtyTrackArm(const FTIT_dataset* data) {
+    if (!dirtyTrack.initialized || data->isDevicePtr || !data->ptr ||
+     data->attribute.untracked) {
+        return FTI_SCES;
+    }
+    uintptr_t ps = dirtyTrack.pageSize;
+    uintptr_t first = (uintptr_t) data->ptr;
+    uintptr_t start = (first + ps - 1) & ~(ps - 1);
+    uintptr_t end = (first + data->size) & ~(ps - 1);
+    FTIT_dirtyTable* table = dirtyTrack.table;
+    int n = (table) ? table->nbRegions : 0;
+    int i;
+
+    // same dataset at the same place: restart from a clean bitmap
+    int idx = (end > start) ? FTI_FindDirtyRegion(table, start) : -1;
+    if (idx >= 0) {
+        FTIT_dirtyRegion* r = table->regions[idx];
+        if (r->id == data->id && r->ptr == data->ptr &&
+         r->size == data->size) {
+            memset(r->dirty, 0, (r->end - r->start) / ps);
+            r->lost = 0;
+            __sync_synchronize();
+            if (mprotect((void*) r->start, r->end - r->start,
+             PROT_READ) != 0) {
+                r->lost = 1;
+            }
+            return FTI_SCES;
+        }
+    }
+
+    // otherwise the old region of the dataset is replaced
+    FTIT_dirtyTable* next = (FTIT_dirtyTable*) malloc(sizeof(FTIT_dirtyTable)
+     + (n + 1) * sizeof(FTIT_dirtyRegion*));
+    if (!next) {
+        return FTI_NSCS;
+    }
+    next->nbRegions = 0;
+    FTIT_dirtyRegion* old = NULL;
+    for (i = 0; i < n; i++) {
+        if (table->regions[i]->id == data->id) {
+            old = table->regions[i];
+        } else {
+            next->regions[next->nbRegions++] = table->regions[i];
+        }
+    }
+    if (old && mprotect((void*) old->start, old->end - old->start,
+     PROT_READ | PROT_WRITE) != 0) {
+        dirtyTrack.strays = 1;
+    }
+
+    FTIT_dirtyRegion* r = NULL;
+    idx = (end > start) ? FTI_FindDirtyRegion(next, start) : 0;
+    // not tracked if the pages overlap another dataset
+    if (idx < 0 && (-idx - 1 == next->nbRegions ||
+     next->regions[-idx - 1]->start >= end)) {
+        idx = -idx - 1;
+        r = talloc(FTIT_dirtyRegion, 1);
+        r->id = data->id;
+        r->ptr = data->ptr;
+        r->size = data->size;
+        r->start = start;
+        r->end = end;
+        r->lost = 0;
+        r->dirty = (unsigned char*) calloc((end - start) / ps, 1);
+        if (!r->dirty) {
+            free(r);
+            r = NULL;
+        }
+    }
+    if (r) {
+        memmove(&next->regions[idx + 1], &next->regions[idx],
+         (next->nbRegions - idx) * sizeof(FTIT_dirtyRegion*));
+        next->regions[idx] = r;
+        next->nbRegions++;
+    }
+    FTI_DirtyTrackPublish(next);
+    if (old) {
+        FTI_DirtyTrackRetire(old->dirty);
+        FTI_DirtyTrackRetire(old);
+    }
+    if (r && mprotect((void*) r->start, r->end - r->start, PROT_READ) != 0) {
+        r->lost = 1;
+    }
+    return FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Checks that the clean pages are still read-only.
+  @return     void.
+
+  Called before the hashes of a dCP checkpoint are computed. A dataset
+  freed and allocated again at the same address by mmap(2) has writable
+  pages the tracking never saw, such datasets are considered dirty. The
+  check reads /proc/self/maps and is skipped where it does not exist.
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_DirtyTrackValidate() {
+    FTIT_dirtyTable* table = dirtyTrack.table;
+    if (!table || table->nbRegions == 0) {
+        return;
+    }
+    FILE* maps = fopen("/proc/self/maps", "r");
+    if (!maps) {
+        return;
+    }
+    uintptr_t ps = dirtyTrack.pageSize;
+    unsigned long lo, hi;
+    char perms[8];
+    int j = 0;
+    while (fscanf(maps, "%lx-%lx %7s%*[^\n]", &lo, &hi, perms) == 3) {
+        if (perms[1] != 'w') {
+            continue;
+        }
+        while (j < table->nbRegions && table->regions[j]->end <= lo) {
+            j++;
+        }
+        int k;
+        for (k = j; k < table->nbRegions && table->regions[k]->start < hi;
+         k++) {
+            FTIT_dirtyRegion* r = table->regions[k];
+            uintptr_t a = (lo > r->start) ? lo : r->start;
+            uintptr_t b = (hi < r->end) ? hi : r->end;
+            uintptr_t p;
+            for (p = (a - r->start) / ps; p < (b - r->start) / ps &&
+             !r->lost; p++) {
+                if (!r->dirty[p]) {
+                    r->lost = 1;
+                }
+            }
+        }
+    }
+    fclose(maps);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Checks if a range of a dataset was written since armed.
+  @param      data            Dataset.
+  @param      offset          Offset of the range in the dataset.
+  @param      size            Size of the range.
+  @return     bool            TRUE if the range was not written.
+
+  May be called by several threads at once.
+ **/
+/*-------------------------------------------------------------------------*/
+bool FTI_DirtyTrackClean(const FTIT_dataset* data, uint64_t offset,
+ uint64_t size) {
+    FTIT_dirtyTable* table = dirtyTrack.table;
+    if (!table || data->isDevicePtr) {
+        return false;
+    }
+    uintptr_t first = (uintptr_t) data->ptr + offset;
+    int idx = FTI_FindDirtyRegion(table, first);
+    if (idx < 0) {
+        return false;
+    }
+    FTIT_dirtyRegion* r = table->regions[idx];
+    if (r->lost || r->id != data->id || r->ptr != data->ptr ||
+     r->size != data->size || first + size > r->end) {
+        return false;
+    }
+    uintptr_t ps = dirtyTrack.pageSize;
+    uintptr_t p;
+    for (p = (first - r->start) / ps;
+     p < (first + size - r->start + ps - 1) / ps; p++) {
+        if (r->dirty[p]) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,23 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  @file   dcp-track.h
+ */
+
+#ifndef FTI_SRC_IO_DCP_TRACK_H_
+#define FTI_SRC_IO_DCP_TRACK_H_
+
+#include <stdint.h>
+
+int FTI_InitDirtyTracking();
+void FTI_FinalizeDirtyTracking();
+int FTI_DirtyTrackArm(const FTIT_dataset* data);
+void FTI_DirtyTrackDisarm();
+void FTI_DirtyTrackRelease(const FTIT_dataset* data);
+void FTI_DirtyTrackCollect();
+void FTI_DirtyTrackValidate();
+bool FTI_DirtyTrackClean(const FTIT_dataset* data, uint64_t offset,
+ uint64_t size);
+
+#endif  // FTI_SRC_IO_DCP_TRACK_H_
@@ -0,0 +1,480 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  FTI - A multi-level checkpointing library for C/C++/Fortran applications
+ *
+ *  Revision 1.0 : Fault Tolerance Interface (FTI)
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *  list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors
+ *  may be used to endorse or promote products derived from this software without
+ *  specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  @file   file-copy.c
+ *  @date   October, 2026
+ *  @brief  File copy engine used to flush local checkpoint files to the PFS
+ *          and to stage files.
+ *
+ *  By default the copy is done inside the kernel with copy_file_range(2),
+ *  falling back to sendfile(2) and finally to a pread/pwrite loop when the
+ *  file systems involved do not support it. Optionally, the destination is
+ *  opened with O_DIRECT and written from aligned buffers with several
+ *  asynchronous writes in flight. In both cases the pages of the source
+ *  file are dropped from the page cache once copied, so that flushing does
+ *  not evict the working set of the application. The kernel copy can also
+ *  be driven chunk by chunk with a copy stream, which lets the heads stage
+ *  several files at once and pause between chunks.
+ */
+
+#define _GNU_SOURCE
+
+#include "../interface.h"
+#include "file-copy.h"
+
+#include <fcntl.h>
+#include <aio.h>
+#ifdef __linux__
+#   include <sys/sendfile.h>
+#endif
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Tells if a copy primitive failed because it is unsupported.
+  @param      err             The errno value set by the primitive.
+  @return     integer         1 if the next primitive should be tried.
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_CopyUnsupported(int err) {
+    return err == ENOSYS || err == EXDEV || err == EINVAL ||
+        err == EOPNOTSUPP;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Reads exactly nBytes from a file at a given offset.
+  @param      fd              File descriptor.
+  @param      buffer          Destination buffer.
+  @param      nBytes          Number of bytes to read.
+  @param      offset          Offset in the file.
+  @return     ssize_t         Bytes read, or -1 on error.
+
+  Less than nBytes are returned only if the end of the file is reached.
+
+ **/
+/*-------------------------------------------------------------------------*/
+static ssize_t FTI_PreadAll(int fd, char* buffer, size_t nBytes,
+ off_t offset) {
+    size_t done = 0;
+    while (done < nBytes) {
+        ssize_t n = pread(fd, buffer + done, nBytes - done, offset + done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            return -1;
+        }
+        if (n == 0) {
+            break;
+        }
+        done += n;
+    }
+    return done;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Writes exactly nBytes to a file at a given offset.
+  @param      fd              File descriptor.
+  @param      buffer          Source buffer.
+  @param      nBytes          Number of bytes to write.
+  @param      offset          Offset in the file.
+  @return     ssize_t         nBytes, or -1 on error.
+ **/
+/*-------------------------------------------------------------------------*/
+static ssize_t FTI_PwriteAll(int fd, const char* buffer, size_t nBytes,
+ off_t offset) {
+    size_t done = 0;
+    while (done < nBytes) {
+        ssize_t n = pwrite(fd, buffer + done, nBytes - done, offset + done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        done += n;
+    }
+    return done;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Prepares the copy of a file chunk by chunk.
+  @param      cs              Copy stream to initialize.
+  @param      sfd             Source file descriptor.
+  @param      dfd             Destination file descriptor.
+  @param      fs              Number of bytes to copy.
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_CopyStreamInit(FTIT_copyStream* cs, int sfd, int dfd, int64_t fs) {
+#ifdef FTI_HAVE_COPY_FILE_RANGE
+    cs->method = FTI_COPY_RANGE;
+#elif defined(__linux__)
+    cs->method = FTI_COPY_SENDFILE;
+#else
+    cs->method = FTI_COPY_RW;
+#endif
+    cs->sfd = sfd;
+    cs->dfd = dfd;
+    cs->buffer = NULL;
+    cs->pos = 0;
+    cs->size = fs;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Frees the buffer of a copy stream.
+  @param      cs              Copy stream.
+
+  The file descriptors are left open.
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_CopyStreamFree(FTIT_copyStream* cs) {
+    free(cs->buffer);
+    cs->buffer = NULL;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Copies the next chunk of a file through the page cache.
+  @param      FTI_Conf        Configuration metadata.
+  @param      cs              Copy stream.
+  @return     integer         FTI_SCES if successful.
+
+  Up to 'transferSize' bytes are moved with the first primitive supported
+  by both file systems, the pages of the source file are then dropped from
+  the page cache. The copy is complete when 'pos' reaches 'size'.
+
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_CopyStep(FTIT_configuration* FTI_Conf, FTIT_copyStream* cs) {
+    char str[FTI_BUFS];
+    int64_t pos = cs->pos;
+    if (pos >= cs->size) {
+        return FTI_SCES;
+    }
+    size_t len = (cs->size - pos < FTI_Conf->transferSize) ?
+        (size_t)(cs->size - pos) : (size_t)FTI_Conf->transferSize;
+    while (1) {
+        ssize_t n = -1;
+        errno = 0;
+        if (cs->method == FTI_COPY_RANGE) {
+#ifdef FTI_HAVE_COPY_FILE_RANGE
+            loff_t inOff = pos, outOff = pos;
+            n = copy_file_range(cs->sfd, &inOff, cs->dfd, &outOff, len, 0);
+#else
+            errno = ENOSYS;
+#endif
+            if (n < 0 && FTI_CopyUnsupported(errno)) {
+                cs->method = FTI_COPY_SENDFILE;
+                continue;
+            }
+        } else if (cs->method == FTI_COPY_SENDFILE) {
+#ifdef __linux__
+            off_t inOff = pos;
+            if (lseek(cs->dfd, pos, SEEK_SET) == pos) {
+                n = sendfile(cs->dfd, cs->sfd, &inOff, len);
+            }
+#else
+            errno = ENOSYS;
+#endif
+            if (n < 0 && FTI_CopyUnsupported(errno)) {
+                cs->method = FTI_COPY_RW;
+                continue;
+            }
+        } else {
+            if (cs->buffer == NULL) {
+                cs->buffer = talloc(char, FTI_Conf->transferSize);
+            }
+            n = FTI_PreadAll(cs->sfd, cs->buffer, len, pos);
+            if (n > 0) {
+                n = FTI_PwriteAll(cs->dfd, cs->buffer, n, pos);
+            }
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            snprintf(str, FTI_BUFS, "Copy of file failed at offset %ld of"
+             " %ld: %s", pos, cs->size,
+             (n == 0) ? "unexpected end of file" : strerror(errno));
+            FTI_Print(str, FTI_EROR);
+            return FTI_NSCS;
+        }
+        posix_fadvise(cs->sfd, pos, n, POSIX_FADV_DONTNEED);
+        cs->pos += n;
+        return FTI_SCES;
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Copies a file through the page cache, avoiding user space.
+  @param      FTI_Conf        Configuration metadata.
+  @param      sfd             Source file descriptor.
+  @param      dfd             Destination file descriptor.
+  @param      fs              Number of bytes to copy.
+  @return     integer         FTI_SCES if successful.
+
+  The file is copied in chunks of 'transferSize' bytes (see FTI_CopyStep).
+
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_CopyKernel(FTIT_configuration* FTI_Conf, int sfd, int dfd,
+ int64_t fs) {
+    FTIT_copyStream cs;
+    int res = FTI_SCES;
+    FTI_CopyStreamInit(&cs, sfd, dfd, fs);
+    while (cs.pos < cs.size && res == FTI_SCES) {
+        res = FTI_CopyStep(FTI_Conf, &cs);
+    }
+    FTI_CopyStreamFree(&cs);
+    return res;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Waits for an asynchronous write and checks its result.
+  @param      cb              Control block of the write.
+  @return     integer         FTI_SCES if all the bytes were written.
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_AioWait(struct aiocb* cb) {
+    const struct aiocb* list[1] = { cb };
+    int err;
+    while ((err = aio_error(cb)) == EINPROGRESS) {
+        aio_suspend(list, 1, NULL);
+    }
+    ssize_t n = aio_return(cb);
+    if (err != 0 || n != (ssize_t)cb->aio_nbytes) {
+        errno = (err != 0) ? err : EIO;
+        return FTI_NSCS;
+    }
+    return FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Copies a file into a destination opened with O_DIRECT.
+  @param      FTI_Conf        Configuration metadata.
+  @param      sfd             Source file descriptor.
+  @param      dfd             Destination file descriptor (O_DIRECT).
+  @param      fs              Number of bytes to copy.
+  @param      refused         Set to TRUE if the file system refused the
+                              O_DIRECT writes.
+  @return     integer         FTI_SCES if successful.
+
+  The 'transferSize' bytes of buffer are split into FTI_PIPELINE_DEPTH
+  aligned buffers, each one holding an asynchronous write while the next
+  chunks are read. The last chunk is padded up to the O_DIRECT alignment
+  and the file is truncated to its real size at the end. Some file systems
+  accept O_DIRECT at open but fail the writes with EINVAL, the copy is then
+  left to the caller.
+
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_CopyDirect(FTIT_configuration* FTI_Conf, int sfd, int dfd,
+ int64_t fs, bool* refused) {
+    char str[FTI_BUFS];
+    *refused = false;
+    size_t bs = FTI_Conf->transferSize / FTI_PIPELINE_DEPTH;
+    bs -= bs % FTI_DIRECT_IO_ALIGN;
+    if (bs == 0) {
+        bs = FTI_DIRECT_IO_ALIGN;
+    }
+
+    struct aiocb cb[FTI_PIPELINE_DEPTH];
+    void* buffer[FTI_PIPELINE_DEPTH];
+    bool busy[FTI_PIPELINE_DEPTH];
+    memset(cb, 0, sizeof(cb));
+    int i;
+    for (i = 0; i < FTI_PIPELINE_DEPTH; i++) {
+        busy[i] = false;
+        if (posix_memalign(&buffer[i], FTI_DIRECT_IO_ALIGN, bs) != 0) {
+            FTI_Print("Cannot allocate aligned buffers for O_DIRECT.",
+             FTI_EROR);
+            while (i-- > 0) {
+                free(buffer[i]);
+            }
+            return FTI_NSCS;
+        }
+    }
+
+    int res = FTI_SCES;
+    int64_t pos = 0;
+    int slot = 0;
+    while (pos < fs) {
+        if (busy[slot]) {
+            busy[slot] = false;
+            if (FTI_AioWait(&cb[slot]) != FTI_SCES) {
+                res = FTI_NSCS;
+                break;
+            }
+        }
+        size_t len = (fs - pos < bs) ? (size_t)(fs - pos) : bs;
+        errno = 0;
+        if (FTI_PreadAll(sfd, buffer[slot], len, pos) != (ssize_t)len) {
+            if (errno == 0) {
+                errno = EIO;
+            }
+            res = FTI_NSCS;
+            break;
+        }
+        posix_fadvise(sfd, pos, len, POSIX_FADV_DONTNEED);
+        size_t padded = (len + FTI_DIRECT_IO_ALIGN - 1) &
+            ~((size_t)FTI_DIRECT_IO_ALIGN - 1);
+        memset((char*)buffer[slot] + len, 0, padded - len);
+
+        cb[slot].aio_fildes = dfd;
+        cb[slot].aio_buf = buffer[slot];
+        cb[slot].aio_nbytes = padded;
+        cb[slot].aio_offset = pos;
+        if (aio_write(&cb[slot]) != 0) {
+            res = FTI_NSCS;
+            break;
+        }
+        busy[slot] = true;
+        pos += len;
+        slot = (slot + 1) % FTI_PIPELINE_DEPTH;
+    }
+    int err = errno;
+
+    for (i = 0; i < FTI_PIPELINE_DEPTH; i++) {
+        if (busy[i] && FTI_AioWait(&cb[i]) != FTI_SCES && res == FTI_SCES) {
+            err = errno;
+            res = FTI_NSCS;
+        }
+        free(buffer[i]);
+    }
+    if (res == FTI_SCES && (fs % FTI_DIRECT_IO_ALIGN) != 0 &&
+     ftruncate(dfd, fs) != 0) {
+        err = errno;
+        res = FTI_NSCS;
+    }
+    if (res != FTI_SCES && err == EINVAL) {
+        *refused = true;
+    } else if (res != FTI_SCES) {
+        snprintf(str, FTI_BUFS, "O_DIRECT copy of checkpoint file failed"
+         " near offset %ld of %ld: %s", pos, fs, strerror(err));
+        FTI_Print(str, FTI_EROR);
+    }
+    return res;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Copies a local checkpoint file to another location.
+  @param      FTI_Conf        Configuration metadata.
+  @param      srcName         Path of the source file.
+  @param      dstName         Path of the destination file.
+  @param      fs              Number of bytes to copy.
+  @return     integer         FTI_SCES if successful.
+
+  The destination is created or truncated. If 'flush_direct_io' is set it
+  is opened with O_DIRECT, which bypasses the page cache of the PFS client;
+  file systems that refuse O_DIRECT, at open or at the first writes,
+  silently fall back to the kernel copy.
+
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_CopyFile(FTIT_configuration* FTI_Conf, const char* srcName,
+ const char* dstName, int64_t fs) {
+    char str[FTI_BUFS];
+    int sfd = open(srcName, O_RDONLY);
+    if (sfd == -1) {
+        snprintf(str, FTI_BUFS, "Cannot open '%s' for copying: %s",
+         srcName, strerror(errno));
+        FTI_Print(str, FTI_EROR);
+        return FTI_NSCS;
+    }
+    posix_fadvise(sfd, 0, fs, POSIX_FADV_SEQUENTIAL);
+
+    int dfd = -1;
+    bool direct = false;
+#ifdef O_DIRECT
+    if (FTI_Conf->flushDirectIo) {
+        dfd = open(dstName, O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0666);
+        direct = (dfd != -1);
+        if (!direct) {
+            snprintf(str, FTI_BUFS, "O_DIRECT not supported for '%s' (%s),"
+             " using buffered copy.", dstName, strerror(errno));
+            FTI_Print(str, FTI_DBUG);
+        }
+    }
+#endif
+    if (dfd == -1) {
+        dfd = open(dstName, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    }
+    if (dfd == -1) {
+        snprintf(str, FTI_BUFS, "Cannot create '%s': %s", dstName,
+         strerror(errno));
+        FTI_Print(str, FTI_EROR);
+        close(sfd);
+        return FTI_NSCS;
+    }
+
+    int res = FTI_NSCS;
+    bool refused = false;
+    if (direct) {
+        res = FTI_CopyDirect(FTI_Conf, sfd, dfd, fs, &refused);
+    }
+#ifdef O_DIRECT
+    if (refused) {
+        snprintf(str, FTI_BUFS, "O_DIRECT writes refused for '%s',"
+         " using buffered copy.", dstName);
+        FTI_Print(str, FTI_DBUG);
+        int flags = fcntl(dfd, F_GETFL);
+        if (flags == -1 || fcntl(dfd, F_SETFL, flags & ~O_DIRECT) == -1 ||
+         ftruncate(dfd, 0) != 0) {
+            snprintf(str, FTI_BUFS, "Cannot reset '%s' for a buffered copy:"
+             " %s", dstName, strerror(errno));
+            FTI_Print(str, FTI_EROR);
+            direct = true;
+        } else {
+            direct = false;
+        }
+    }
+#endif
+    if (!direct) {
+        res = FTI_CopyKernel(FTI_Conf, sfd, dfd, fs);
+    }
+    if (close(dfd) != 0 && res == FTI_SCES) {
+        snprintf(str, FTI_BUFS, "Cannot close '%s': %s", dstName,
+         strerror(errno));
+        FTI_Print(str, FTI_EROR);
+        res = FTI_NSCS;
+    }
+    close(sfd);
+    return res;
+}
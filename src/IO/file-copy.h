@@ -0,0 +1,39 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  @file   file-copy.h
+ */
+
+#ifndef FTI_SRC_IO_FILE_COPY_H_
+#define FTI_SRC_IO_FILE_COPY_H_
+
+#include <stdint.h>
+
+/** Alignment of buffers, offsets and sizes used with O_DIRECT. */
+#define FTI_DIRECT_IO_ALIGN 4096
+
+/** Copy primitives, tried in this order. */
+typedef enum {
+    FTI_COPY_RANGE,                 /**< copy_file_range(2).            */
+    FTI_COPY_SENDFILE,              /**< sendfile(2).                   */
+    FTI_COPY_RW                     /**< pread/pwrite through a buffer. */
+} FTIT_copyMethod;
+
+/** File copied chunk by chunk through the kernel. */
+typedef struct FTIT_copyStream {
+    int sfd;                        /**< Source file descriptor.        */
+    int dfd;                        /**< Destination file descriptor.   */
+    FTIT_copyMethod method;         /**< Primitive used for the copy.   */
+    char* buffer;                   /**< Buffer of the pread/pwrite.    */
+    int64_t pos;                    /**< Bytes copied so far.           */
+    int64_t size;                   /**< Bytes to copy.                 */
+} FTIT_copyStream;
+
+int FTI_CopyFile(FTIT_configuration* FTI_Conf, const char* srcName,
+ const char* dstName, int64_t fs);
+void FTI_CopyStreamInit(FTIT_copyStream* cs, int sfd, int dfd, int64_t fs);
+int FTI_CopyStep(FTIT_configuration* FTI_Conf, FTIT_copyStream* cs);
+void FTI_CopyStreamFree(FTIT_copyStream* cs);
+
+#endif  // FTI_SRC_IO_FILE_COPY_H_
@@ -0,0 +1,297 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  FTI - A multi-level checkpointing library for C/C++/Fortran applications
+ *
+ *  Revision 1.0 : Fault Tolerance Interface (FTI)
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *  list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors
+ *  may be used to endorse or promote products derived from this software without
+ *  specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  @file   file-read.c
+ *  @date   October, 2026
+ *  @brief  Reader used to load checkpoint files on restart.
+ *
+ *  The caller describes what has to be read as a list of extents (file
+ *  offset, destination, size). The extents are sorted by offset, cut into
+ *  pieces of at most FTI_READ_BATCH bytes and the contiguous pieces are
+ *  grouped into batches, each read with a single preadv(2). The batches are
+ *  read concurrently on the worker pool (see FTI_HashParallel), after the
+ *  whole range has been announced to the kernel with posix_fadvise(2), so
+ *  that loading many small variables costs a few large reads.
+ */
+
+#define _GNU_SOURCE
+
+#include "../interface.h"
+#include "file-read.h"
+
+#include <fcntl.h>
+#include <sys/uio.h>
+
+/** A group of contiguous pieces read with one preadv(2). */
+typedef struct FTIT_readBatch {
+    int64_t offset;                 /**< Offset of the batch in the file. */
+    int64_t size;                   /**< Number of bytes of the batch.    */
+    int64_t firstIov;               /**< First buffer of the batch.       */
+    int nbIov;                      /**< Number of buffers of the batch.  */
+} FTIT_readBatch;
+
+/** Batches read by the worker pool. */
+typedef struct FTIT_readJob {
+    int fd;                         /**< File descriptor.                 */
+    struct iovec* iov;              /**< Buffers of all batches.          */
+    FTIT_readBatch* batch;          /**< Batches.                         */
+    int* err;                       /**< errno per batch, -1 if truncated.*/
+} FTIT_readJob;
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Orders two extents by file offset (qsort callback).
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_CompareExtents(const void* a, const void* b) {
+    int64_t x = ((const FTIT_extent*) a)->offset;
+    int64_t y = ((const FTIT_extent*) b)->offset;
+    return (x > y) - (x < y);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Fills the buffers of a batch from the file.
+  @param      fd              File descriptor.
+  @param      iov             Buffers, modified on partial reads.
+  @param      nbIov           Number of buffers.
+  @param      offset          Offset in the file.
+  @return     integer         0, errno on error or -1 at the end of file.
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_PreadvAll(int fd, struct iovec* iov, int nbIov,
+ off_t offset) {
+    while (nbIov > 0) {
+        ssize_t n = preadv(fd, iov, nbIov, offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            return errno;
+        }
+        if (n == 0) {
+            return -1;
+        }
+        offset += n;
+        while (nbIov > 0 && (size_t) n >= iov->iov_len) {
+            n -= iov->iov_len;
+            iov++;
+            nbIov--;
+        }
+        if (nbIov > 0) {
+            iov->iov_base = (char*) iov->iov_base + n;
+            iov->iov_len -= n;
+        }
+    }
+    return 0;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Reads the batches [first,last) (hash engine job).
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_ReadJob(void* ctx, int64_t first, int64_t last) {
+    FTIT_readJob* job = (FTIT_readJob*) ctx;
+    int64_t i;
+    for (i = first; i < last; i++) {
+        FTIT_readBatch* b = &job->batch[i];
+        job->err[i] = FTI_PreadvAll(job->fd, &job->iov[b->firstIov],
+         b->nbIov, b->offset);
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Reads a list of file ranges into memory.
+  @param      fd              File descriptor open for reading.
+  @param      ext             Extents to read, sorted by offset on return.
+  @param      nbExt           Number of extents.
+  @param      parallel        TRUE to read on the worker pool.
+  @return     integer         FTI_SCES if successful.
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_ReadExtentsOn(int fd, FTIT_extent* ext, int64_t nbExt,
+ bool parallel) {
+    char str[FTI_BUFS];
+    int64_t i, nbIov = 0;
+
+    qsort(ext, nbExt, sizeof(FTIT_extent), FTI_CompareExtents);
+    for (i = 0; i < nbExt; i++) {
+        // an extent starting inside a batch is cut once more
+        if (ext[i].size > 0) {
+            nbIov += (ext[i].size + FTI_READ_BATCH - 1) / FTI_READ_BATCH + 1;
+        }
+    }
+    if (nbIov == 0) {
+        return FTI_SCES;
+    }
+
+    FTIT_readJob job;
+    job.fd = fd;
+    job.iov = talloc(struct iovec, nbIov);
+    job.batch = talloc(FTIT_readBatch, nbIov);
+    job.err = talloc(int, nbIov);
+
+    // cut the extents into pieces and group the contiguous ones
+    int64_t nbBatch = 0, k = 0;
+    FTIT_readBatch* b = NULL;
+    for (i = 0; i < nbExt; i++) {
+        int64_t done = 0;
+        while (done < ext[i].size) {
+            int64_t offset = ext[i].offset + done;
+            int64_t n = ext[i].size - done;
+            if (b == NULL || b->offset + b->size != offset ||
+             b->nbIov == FTI_READ_IOV || b->size == FTI_READ_BATCH) {
+                b = &job.batch[nbBatch++];
+                b->offset = offset;
+                b->size = 0;
+                b->firstIov = k;
+                b->nbIov = 0;
+            }
+            if (n > FTI_READ_BATCH - b->size) {
+                n = FTI_READ_BATCH - b->size;
+            }
+            job.iov[k].iov_base = (char*) ext[i].dest + done;
+            job.iov[k].iov_len = n;
+            k++;
+            b->size += n;
+            b->nbIov++;
+            done += n;
+        }
+    }
+
+    int64_t start = job.batch[0].offset;
+    int64_t end = b->offset + b->size;
+    posix_fadvise(fd, start, end - start, POSIX_FADV_SEQUENTIAL);
+    posix_fadvise(fd, start, end - start, POSIX_FADV_WILLNEED);
+
+    if (parallel) {
+        FTI_HashParallel(FTI_ReadJob, &job, nbBatch, FTI_POOL_RECO);
+    } else {
+        FTI_ReadJob(&job, 0, nbBatch);
+    }
+
+    int res = FTI_SCES;
+    for (i = 0; i < nbBatch && res == FTI_SCES; i++) {
+        if (job.err[i] != 0) {
+            snprintf(str, FTI_BUFS, "Cannot read %ld bytes at offset %ld"
+             " of checkpoint file: %s", job.batch[i].size,
+             job.batch[i].offset, (job.err[i] > 0) ?
+             strerror(job.err[i]) : "unexpected end of file");
+            FTI_Print(str, FTI_EROR);
+            res = FTI_NSCS;
+        }
+    }
+    snprintf(str, FTI_BUFS, "Read %ld extents of checkpoint file in %ld"
+     " batches.", nbExt, nbBatch);
+    FTI_Print(str, FTI_DBUG);
+
+    free(job.iov);
+    free(job.batch);
+    free(job.err);
+    return res;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Reads a list of file ranges into memory.
+  @param      fd              File descriptor open for reading.
+  @param      ext             Extents to read, sorted by offset on return.
+  @param      nbExt           Number of extents.
+  @return     integer         FTI_SCES if successful.
+
+  The extents must not overlap in memory. The file is read in batches of
+  contiguous ranges of at most FTI_READ_BATCH bytes, on all the threads of
+  the worker pool. Reaching the end of the file before an extent is
+  complete is an error.
+
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_ReadExtents(int fd, FTIT_extent* ext, int64_t nbExt) {
+    return FTI_ReadExtentsOn(fd, ext, nbExt, true);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Reads a list of file ranges into memory from this thread.
+  @param      fd              File descriptor open for reading.
+  @param      ext             Extents to read, sorted by offset on return.
+  @param      nbExt           Number of extents.
+  @return     integer         FTI_SCES if successful.
+
+  Same as FTI_ReadExtents, without the worker pool. Used by background
+  threads, which must not compete with the application for the pool.
+
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_ReadExtentsSerial(int fd, FTIT_extent* ext, int64_t nbExt) {
+    return FTI_ReadExtentsOn(fd, ext, nbExt, false);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Verifies the checksum of a file from the extents read.
+  @param      fn              Name of the file.
+  @param      ext             Extents read, sorted by offset.
+  @param      nbExt           Number of extents.
+  @param      fs              Size of the file.
+  @param      checksum        Checksum of the file.
+  @return     integer         FTI_SCES if the checksum matches.
+
+  The file is hashed from the buffers it was read to, so that it is read
+  once on restart. If the extents do not cover the file, for instance
+  because some datasets are located in device memory, the file is read
+  again to compute its checksum.
+
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_VerifyExtents(char* fn, FTIT_extent* ext, int64_t nbExt, int64_t fs,
+ char* checksum) {
+    int64_t i, pos = 0;
+    for (i = 0; i < nbExt && ext[i].offset == pos; i++) {
+        pos += ext[i].size;
+    }
+    if (i < nbExt || pos != fs) {
+        FTI_Print("Checkpoint file not fully loaded, verifying its checksum"
+         " separately.", FTI_DBUG);
+        return FTI_VerifyChecksum(fn, checksum);
+    }
+
+    FTIT_integrity ctx;
+    FTI_IntegrityInitFor(&ctx, checksum);
+    for (i = 0; i < nbExt; i++) {
+        FTI_IntegrityUpdate(&ctx, ext[i].dest, ext[i].size);
+    }
+    return FTI_VerifyHash(fn, &ctx, checksum);
+}
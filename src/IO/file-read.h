@@ -0,0 +1,30 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  @file   file-read.h
+ */
+
+#ifndef FTI_SRC_IO_FILE_READ_H_
+#define FTI_SRC_IO_FILE_READ_H_
+
+#include <stdint.h>
+
+/** Maximum number of bytes read by a single preadv(2). */
+#define FTI_READ_BATCH (4*1024*1024)
+/** Maximum number of buffers filled by a single preadv(2). */
+#define FTI_READ_IOV 64
+
+/** A range of a file and the buffer it is read to. */
+typedef struct FTIT_extent {
+    int64_t offset;                 /**< Offset of the range in the file. */
+    void* dest;                     /**< Destination buffer.              */
+    int64_t size;                   /**< Number of bytes to read.         */
+} FTIT_extent;
+
+int FTI_ReadExtents(int fd, FTIT_extent* ext, int64_t nbExt);
+int FTI_ReadExtentsSerial(int fd, FTIT_extent* ext, int64_t nbExt);
+int FTI_VerifyExtents(char* fn, FTIT_extent* ext, int64_t nbExt, int64_t fs,
+ char* checksum);
+
+#endif  // FTI_SRC_IO_FILE_READ_H_
@@ -272,9 +272,10 @@ int FTI_InitDcp(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec) {
     char str[FTI_BUFS];
     if (getenv("FTI_DCP_HASH_MODE") != 0) {
         DCP_MODE = atoi(getenv("FTI_DCP_HASH_MODE")) + FTI_DCP_MODE_OFFSET;
-        if ((DCP_MODE < FTI_DCP_MODE_MD5) || (DCP_MODE > FTI_DCP_MODE_CRC32)) {
-            FTI_Print("dCP mode ('Basic:dcp_mode') must be either 1 (MD5)"
-                " or 2 (CRC32), dCP disabled.", FTI_WARN);
+        if ((DCP_MODE < FTI_DCP_MODE_MD5) ||
+         (DCP_MODE > FTI_DCP_MODE_CRC32C)) {
+            FTI_Print("dCP mode ('Basic:dcp_mode') must be either 1 (MD5),"
+                " 2 (CRC32) or 3 (CRC32C), dCP disabled.", FTI_WARN);
             FTI_Conf->dcpFtiff = false;
             return FTI_NSCS;
         }
@@ -305,6 +306,9 @@ int FTI_InitDcp(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec) {
         case FTI_DCP_MODE_CRC32:
             FTI_Print("Hash algorithm in use is CRC32.", FTI_IDCP);
             break;
+        case FTI_DCP_MODE_CRC32C:
+            FTI_Print("Hash algorithm in use is CRC32C.", FTI_IDCP);
+            break;
         default:
             FTI_Print("Hash mode not recognized, dCP disabled!", FTI_WARN);
             FTI_Conf->dcpFtiff = false;
@@ -489,7 +493,7 @@ When the checkpoint will terminate the current hash will be freed, whereas the n
 will be used as current. Keep in mind that the next has the correct size
  **/
 /*-------------------------------------------------------------------------*/
-int FTI_CollapseBlockHashArray(FTIT_DataDiffHash* hashes, int32_t chunkSize) {
+int FTI_CollapseBlockHashArray(FTIT_DataDiffHash* hashes, int64_t chunkSize) {
     if (!dcpEnabled)
         return FTI_SCES;
 
@@ -554,7 +558,7 @@ When the checkpoint will terminate the current hash will be freed, whereas the n
 will be used as current. Keep in mind that the next has the correct size
  **/
 /*-------------------------------------------------------------------------*/
-int FTI_ExpandBlockHashArray(FTIT_DataDiffHash* dataHash, int32_t chunkSize) {
+int FTI_ExpandBlockHashArray(FTIT_DataDiffHash* dataHash, int64_t chunkSize) {
     if (!dcpEnabled)
         return FTI_SCES;
 
@@ -615,7 +619,7 @@ int FTI_ExpandBlockHashArray(FTIT_DataDiffHash* dataHash, int32_t chunkSize) {
   block size corresponding to chunkSize.
  **/
 /*-------------------------------------------------------------------------*/
-int32_t FTI_CalcNumHashes(int32_t chunkSize) {
+int32_t FTI_CalcNumHashes(int64_t chunkSize) {
     if ((chunkSize%((uint32_t)DCP_BLOCK_SIZE)) == 0) {
         return chunkSize/DCP_BLOCK_SIZE;
     } else {
@@ -623,7 +627,7 @@ int32_t FTI_CalcNumHashes(int32_t chunkSize) {
     }
 }
 
-void PrintDataHashInfo(FTIT_DataDiffHash* dataHash, int32_t chunkSize, int id) {
+void PrintDataHashInfo(FTIT_DataDiffHash* dataHash, int64_t chunkSize, int id) {
     char str[FTI_BUFS];
     FTI_Print("+++++++++++++++ INFO IS  +++++++++++++++", FTI_INFO);
     snprintf(str, sizeof(str), "I want to access index of the following id %d",
@@ -658,13 +662,100 @@ void PrintDataHashInfo(FTIT_DataDiffHash* dataHash, int32_t chunkSize, int id) {
      dataHash->blockSize[dataHash->nbHashes-1]);
     FTI_Print(str, FTI_INFO);
     snprintf(str, sizeof(str),
-     "Total Block size is %d, Computed Block Size is %d", chunkSize,
+     "Total Block size is %ld, Computed Block Size is %d", chunkSize,
       (dataHash->nbHashes-1)*FTI_GetDiffBlockSize() +
       dataHash->blockSize[dataHash->nbHashes-1]);
     FTI_Print(str, FTI_INFO);
 }
 
 
+/** Context of a parallel FTI-FF dCP hashing job. */
+typedef struct FTIT_dcpHashJob {
+    FTIT_DataDiffHash* hashes;  /**< Hash meta data of the data chunk.  */
+    unsigned char* ptr;         /**< Address of block 'firstIdx'.       */
+    int32_t firstIdx;           /**< Index of the first block to hash.  */
+} FTIT_dcpHashJob;
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Computes the next hashes of a range of data blocks.
+  @param      ctx             Pointer to the FTIT_dcpHashJob.
+  @param      first           First block relative to 'firstIdx'.
+  @param      last            Block after the last one.
+
+  Called by the hashing engine, possibly from several threads at once on
+  disjoint block ranges.
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_HashBlocks(void* ctx, int64_t first, int64_t last) {
+    FTIT_dcpHashJob* job = (FTIT_dcpHashJob*) ctx;
+    FTIT_DataDiffHash* hashes = job->hashes;
+    int64_t k;
+    for (k = first; k < last; k++) {
+        int32_t hashIdx = job->firstIdx + k;
+        unsigned char* ptr = job->ptr + k * DCP_BLOCK_SIZE;
+        uint32_t bit32hashNow;
+        switch (DCP_MODE) {
+            case FTI_DCP_MODE_MD5:
+                MD5(ptr, hashes->blockSize[hashIdx],
+                 &(hashes->md5hash[NEXT(hashes)][MD5_DIGEST_LENGTH *
+                  hashIdx]));
+                break;
+            case FTI_DCP_MODE_CRC32:
+#ifdef FTI_NOZLIB
+                bit32hashNow = crc32(ptr, hashes->blockSize[hashIdx]);
+#else
+                bit32hashNow = crc32(0L, Z_NULL, 0);
+                bit32hashNow = crc32(bit32hashNow, ptr,
+                 hashes->blockSize[hashIdx]);
+#endif
+                hashes->bit32hash[NEXT(hashes)][hashIdx] = bit32hashNow;
+                break;
+            case FTI_DCP_MODE_CRC32C:
+                hashes->bit32hash[NEXT(hashes)][hashIdx] =
+                 FTI_Crc32c(0, ptr, hashes->blockSize[hashIdx]);
+                break;
+        }
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Computes the next hashes of all blocks of a fetched chunk.
+  @param      dbvar           Data chunk meta data.
+  @param      ptr             Address of the fetched data.
+  @param      offset          Offset of the fetched data inside dbvar.
+  @param      nbytes          Number of fetched bytes.
+  @return     integer         FTI_SCES if successful.
+
+  The blocks are distributed over the threads of the dCP hashing engine.
+  'offset' is a multiple of the dCP block size. FTI_HashCmp only compares
+  the hashes computed here with the ones of the last checkpoint.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_HashDataChunk(FTIFF_dbvar* dbvar, unsigned char* ptr, size_t offset,
+ size_t nbytes) {
+    if (!dcpEnabled)
+        return FTI_SCES;
+
+    if (!(*dcpEnabled))
+        return FTI_SCES;
+
+    FTIT_dcpHashJob job;
+    job.hashes = dbvar->dataDiffHash;
+    job.ptr = ptr;
+    job.firstIdx = offset / DCP_BLOCK_SIZE;
+
+    int64_t nbBlocks = nbytes / DCP_BLOCK_SIZE +
+     ((nbytes % DCP_BLOCK_SIZE) != 0);
+    if (job.firstIdx + nbBlocks > job.hashes->nbHashes) {
+        nbBlocks = job.hashes->nbHashes - job.firstIdx;
+    }
+    FTI_HashParallel(FTI_HashBlocks, &job, nbBlocks, FTI_POOL_DCP);
+
+    return FTI_SCES;
+}
+
 /*-------------------------------------------------------------------------*/
 /**
   @brief      Checks if data block is dirty, clean or invalid.
@@ -676,20 +767,18 @@ void PrintDataHashInfo(FTIT_DataDiffHash* dataHash, int32_t chunkSize, int id) {
   @return     integer         -1 if hashIdx not in range.
 
   This function checks if data block corresponding to the hash meta data 
-  element is clean, dirty or invalid.  
+  element is clean, dirty or invalid. The hash of the block for the upcoming
+  checkpoint must have been computed by FTI_HashDataChunk.
 
   It returns -1 if hashIdx is out of range.
  **/
 /*-------------------------------------------------------------------------*/
-int FTI_HashCmp(int32_t hashIdx, FTIFF_dbvar* dbvar, unsigned char *ptr) {
+int FTI_HashCmp(int32_t hashIdx, FTIFF_dbvar* dbvar) {
     bool clean = true;
-    uint32_t bit32hashNow = 0;
     unsigned char *prevHash = NULL;
     unsigned char *nextHash = NULL;
 
     FTIT_DataDiffHash* hashes = dbvar->dataDiffHash;
-    // unsigned char* ptr = (unsigned char*) dbvar->cptr +
-    // hashIdx * DCP_BLOCK_SIZE;
 
     assert(!(hashIdx > hashes->nbHashes));
 
@@ -698,20 +787,6 @@ int FTI_HashCmp(int32_t hashIdx, FTIFF_dbvar* dbvar, unsigned char *ptr) {
         return -1;
     }
 
-    // I Compute the hash code for the upcoming checkpoint On the Next status
-    if (FTI_GetDcpMode() == FTI_DCP_MODE_MD5) {
-        MD5(ptr, hashes->blockSize[hashIdx],
-         &(hashes->md5hash[NEXT(hashes)][MD5_DIGEST_LENGTH * hashIdx]));
-    } else {
-#ifdef FTI_NOZLIB
-        bit32hashNow = crc32(ptr, hashes->blockSize[hashIdx]);
-#else
-        bit32hashNow = crc32(0L, Z_NULL, 0);
-        bit32hashNow = crc32(bit32hashNow, ptr, hashes->blockSize[hashIdx]);
-#endif
-        hashes->bit32hash[NEXT(hashes)][hashIdx] = bit32hashNow;
-    }
-
     clean = 0;
     if (!(hashes->isValid[hashIdx])) {
         return 1;
@@ -725,8 +800,9 @@ int FTI_HashCmp(int32_t hashIdx, FTIFF_dbvar* dbvar, unsigned char *ptr) {
                 clean = memcmp(nextHash , prevHash , MD5_DIGEST_LENGTH) == 0;
                 break;
             case FTI_DCP_MODE_CRC32:
-                clean = (bit32hashNow == hashes->bit32hash[CURRENT(hashes)]
-                    [hashIdx]);
+            case FTI_DCP_MODE_CRC32C:
+                clean = (hashes->bit32hash[NEXT(hashes)][hashIdx] ==
+                 hashes->bit32hash[CURRENT(hashes)][hashIdx]);
                 break;
         }
         // isValid is false, in the case in which I dont manage to update
@@ -848,7 +924,7 @@ int FTI_ReceiveDataChunk(unsigned char** buffer_addr, size_t* buffer_size,
     unsigned char clean = 1;
     int cleanIdx = hashIdx;
     while (hashIdx < maxNumHashes && clean) {
-        clean = FTI_HashCmp(hashIdx, dbvar, ptr) == 0;
+        clean = FTI_HashCmp(hashIdx, dbvar) == 0;
         ptr += (clean) * (dbvar->dataDiffHash->blockSize[hashIdx]);
         (*totalBytes) -= (clean) * (dbvar->dataDiffHash->blockSize[hashIdx]);
         hashIdx += (clean) *1;
@@ -872,7 +948,7 @@ int FTI_ReceiveDataChunk(unsigned char** buffer_addr, size_t* buffer_size,
     int dirtyIdx = hashIdx;
 
     while (hashIdx < maxNumHashes && dirty) {
-        dirty = FTI_HashCmp(hashIdx, dbvar, ptr);
+        dirty = FTI_HashCmp(hashIdx, dbvar);
         ptr += (dirty) * (dbvar->dataDiffHash->blockSize[hashIdx]);
         *buffer_size += (dirty) * (dbvar->dataDiffHash->blockSize[hashIdx]);
         (*totalBytes) -= (dirty) * (dbvar->dataDiffHash->blockSize[hashIdx]);
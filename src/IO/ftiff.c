@@ -107,7 +107,7 @@ int FTIFF_ReadDbFTIFF(FTIT_configuration *FTI_Conf, FTIT_execution *FTI_Exec,
         return FTI_NSCS;
     }
 
-    uint32_t fs = st.st_size;
+    int64_t fs = st.st_size;
 
     // open checkpoint file for read only
     int fd = open(fn, O_RDONLY, 0);
@@ -190,7 +190,7 @@ int FTIFF_ReadDbFTIFF(FTIT_configuration *FTI_Conf, FTIT_execution *FTI_Exec,
         seek_ptr += (FTI_ADDRVAL) FTI_dbstructsize;
 
         snprintf(str, FTI_BUFS, "FTI-FF: Updatedb - dataBlock:%i, dbsize:"
-            " %d, numvars: %i.", dbcounter, currentdb->dbsize,
+            " %ld, numvars: %i.", dbcounter, currentdb->dbsize,
              currentdb->numvars);
         FTI_Print(str, FTI_DBUG);
 
@@ -270,7 +270,7 @@ int FTIFF_ReadDbFTIFF(FTIT_configuration *FTI_Conf, FTIT_execution *FTI_Exec,
             // debug information
             snprintf(str, FTI_BUFS, "FTI-FF: Updatedb -  dataBlock:%i/"
                 "dataBlockVar%i id: %i, destptr: %ld, fptr: %ld, "
-                "chunksize: %d.", dbcounter, dbvar_idx,
+                "chunksize: %ld.", dbcounter, dbvar_idx,
                     currentdbvar->id, currentdbvar->dptr,
                     currentdbvar->fptr, currentdbvar->chunksize);
             FTI_Print(str, FTI_DBUG);
@@ -312,6 +312,27 @@ int FTIFF_ReadDbFTIFF(FTIT_configuration *FTI_Conf, FTIT_execution *FTI_Exec,
     return FTI_SCES;
 }
 
+/** Chunks of a FTI-FF file hashed by the threads of the hashing engine. */
+typedef struct FTIFF_chunkHashJob {
+    unsigned char** ptr;        /**< Content of every chunk.              */
+    int64_t* size;              /**< Size of every chunk.                 */
+    unsigned char* hash;        /**< MD5 digest of every chunk.           */
+    int64_t nbChunks;           /**< Number of chunks.                    */
+} FTIFF_chunkHashJob;
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Computes the MD5 digest of the chunks of [first,last).
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTIFF_HashChunks(void* ctx, int64_t first, int64_t last) {
+    FTIFF_chunkHashJob* job = (FTIFF_chunkHashJob*) ctx;
+    int64_t k;
+    for (k = first; k < last; k++) {
+        MD5(job->ptr[k], job->size[k], job->hash + k * MD5_DIGEST_LENGTH);
+    }
+}
+
 /*-------------------------------------------------------------------------*/
 /**
   @brief      Determines checksum of checkpoint data.
@@ -331,6 +352,8 @@ int FTIFF_GetFileChecksum(FTIFF_metaInfo *FTIFFMeta, int fd, char *checksum) {
     unsigned char hash[MD5_DIGEST_LENGTH];
     MD5_CTX ctx;
     MD5_Init(&ctx);
+    FTIFF_chunkHashJob job = { NULL, NULL, NULL, 0 };
+    int64_t capacity = 0;
 
     // map file into memory
     unsigned char* fmmap = (unsigned char*) mmap(0, FTIFFMeta->ckptSize,
@@ -397,18 +420,35 @@ int FTIFF_GetFileChecksum(FTIFF_metaInfo *FTIFFMeta, int fd, char *checksum) {
             // advance meta data offset
             seek_ptr += (FTI_ADDRVAL) FTI_dbvarstructsize;
 
-            // compute hash of chunk and file hash
-            // (Note: we create the file hash from the chunk hashes due to ICP)
+            // collect the chunks, the file hash is computed from the chunk
+            // hashes (Note: we create the file hash from them due to ICP)
             if (dbvar->hascontent) {
-                unsigned char chash[MD5_DIGEST_LENGTH];
-                MD5(fmmap + dbvar->fptr, dbvar->chunksize, chash);
-                MD5_Update(&ctx, chash, MD5_DIGEST_LENGTH);
+                if (job.nbChunks == capacity) {
+                    capacity = (capacity > 0) ? 2 * capacity : 64;
+                    job.ptr = realloc(job.ptr,
+                     capacity * sizeof(unsigned char*));
+                    job.size = realloc(job.size, capacity * sizeof(int64_t));
+                }
+                job.ptr[job.nbChunks] = fmmap + dbvar->fptr;
+                job.size[job.nbChunks] = dbvar->chunksize;
+                job.nbChunks++;
             }
         }
 
         free(dbvars);
     } while (seek_ptr < seek_end);
 
+    // the chunks are hashed in parallel and their hashes in order
+    job.hash = talloc(unsigned char, job.nbChunks * MD5_DIGEST_LENGTH + 1);
+    FTI_HashParallel(FTIFF_HashChunks, &job, job.nbChunks, FTI_POOL_INTEGRITY);
+    int64_t k;
+    for (k = 0; k < job.nbChunks; k++) {
+        MD5_Update(&ctx, job.hash + k * MD5_DIGEST_LENGTH, MD5_DIGEST_LENGTH);
+    }
+    free(job.hash);
+    free(job.ptr);
+    free(job.size);
+
     MD5_Final(hash, &ctx);
 
     int i;
@@ -517,7 +557,7 @@ int FTIFF_UpdateDatastructVarFTIFF(FTIT_execution* FTI_Exec,
         int editflags = 0;
         bool idFound = false;
         int isnextdb;
-        int32_t offset = 0;
+        int64_t offset = 0;
 
         /*
          *  - check if protected variable is in file info
@@ -527,11 +567,11 @@ int FTIFF_UpdateDatastructVarFTIFF(FTIT_execution* FTI_Exec,
         FTI_Exec->lastdb = FTI_Exec->firstdb;
 
         int nbContainers = 0;
-        int32_t containerSizesAccu = 0;
+        int64_t containerSizesAccu = 0;
 
         // init overflow with the datasizes and validBlock with true.
         bool validBlock = true;
-        int32_t overflow = data->size;
+        int64_t overflow = data->size;
 
         // iterate though datablock list. Current datablock is 'lastdb'.
         // At the beginning of the loop 'lastdb = firstdb'
@@ -568,7 +608,7 @@ int FTIFF_UpdateDatastructVarFTIFF(FTIT_execution* FTI_Exec,
                     // set chunksize to containersize and ensure that
                     // 'hascontent = true'.
                     if (overflow > dbvar->containersize) {
-                        int32_t chunksizeOld = dbvar->chunksize;
+                        int64_t chunksizeOld = dbvar->chunksize;
                         dbvar->chunksize = dbvar->containersize;
                         dbvar->cptr = data->ptr + dbvar->dptr;
                         if (!dbvar->hascontent) {
@@ -598,7 +638,7 @@ int FTIFF_UpdateDatastructVarFTIFF(FTIT_execution* FTI_Exec,
                     // afterwards overflow to 0 and
                     // ensure that 'hascontent = true'.
                     if (overflow <= dbvar->containersize) {
-                        int32_t chunksizeOld = dbvar->chunksize;
+                        int64_t chunksizeOld = dbvar->chunksize;
                         dbvar->chunksize = overflow;
                         dbvar->cptr = data->ptr + dbvar->dptr;
                         if (!dbvar->hascontent) {
@@ -674,7 +714,7 @@ int FTIFF_UpdateDatastructVarFTIFF(FTIT_execution* FTI_Exec,
             }
 
             int evar_idx = dblock->numvars;
-            int32_t dbsize = dblock->dbsize;
+            int64_t dbsize = dblock->dbsize;
             switch (editflags) {
                 case 1:
                     // add new protected variable in next datablock
@@ -741,6 +781,109 @@ int FTIFF_UpdateDatastructVarFTIFF(FTIT_execution* FTI_Exec,
     return FTI_SCES;
 }
 
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Writes the pending runs of the data block to the file.
+  @param      fd              FTI-FF file descriptor.
+  @return     integer         FTI_SCES if successful.
+
+  The runs are contiguous in the file and are submitted with one
+  'pwritev' (more if the kernel writes less than requested).
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTIFF_FlushRuns(WriteFTIFFInfo_t *fd) {
+    if (fd->nbIov == 0) {
+        return FTI_SCES;
+    }
+
+    // nothing of the stdio buffer may overtake the runs
+    fflush(fd->f);
+
+    struct iovec *iov = fd->iov;
+    int nbIov = fd->nbIov;
+    off_t pos = fd->batchPos;
+    while (nbIov > 0) {
+        ssize_t written = pwritev(fileno(fd->f), iov, nbIov, pos);
+        fd->FTI_Exec->dcpIo.nbCalls++;
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            char str[FTI_BUFS];
+            snprintf(str, FTI_BUFS, "Unable to write : [POSIX ERROR - %s.]",
+             strerror(errno));
+            FTI_Print(str, FTI_EROR);
+            fd->nbIov = 0;
+            return FTI_NSCS;
+        }
+        pos += written;
+        fd->FTI_Exec->dcpIo.bytes += written;
+        while (nbIov > 0 && (size_t) written >= iov->iov_len) {
+            written -= iov->iov_len;
+            iov++;
+            nbIov--;
+        }
+        if (nbIov > 0) {
+            iov->iov_base = (char*) iov->iov_base + written;
+            iov->iov_len -= written;
+        }
+    }
+
+    fd->nbIov = 0;
+    fd->batchSize = 0;
+    return FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Adds a dirty run to the pending runs of the data block.
+  @param      fd              FTI-FF file descriptor.
+  @param      addr            Memory address of the run.
+  @param      size            Size of the run in bytes.
+  @param      fptr            File offset of the run.
+  @return     integer         FTI_SCES if successful.
+
+  Runs that continue the pending ones in the file are appended, even if
+  they come from another variable. A clean gap of at most
+  FTIFF_BRIDGE_SIZE bytes within the same buffer is written along with
+  the runs, as the file already holds the same data.
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTIFF_AddRun(WriteFTIFFInfo_t *fd, unsigned char *addr,
+        size_t size, size_t fptr) {
+    fd->FTI_Exec->dcpIo.nbRuns++;
+
+    if (fd->nbIov > 0) {
+        size_t end = fd->batchPos + fd->batchSize;
+        struct iovec *last = &fd->iov[fd->nbIov - 1];
+        uintptr_t lastEnd = (uintptr_t) last->iov_base + last->iov_len;
+        if (fptr >= end && (fptr - end) <= FTIFF_BRIDGE_SIZE &&
+         (uintptr_t) addr == lastEnd + (fptr - end)) {
+            last->iov_len += (fptr - end) + size;
+            fd->batchSize += (fptr - end) + size;
+            return FTI_SCES;
+        }
+        if (fptr == end && fd->nbIov < FTIFF_BATCH_IOV) {
+            fd->iov[fd->nbIov].iov_base = addr;
+            fd->iov[fd->nbIov].iov_len = size;
+            fd->nbIov++;
+            fd->batchSize += size;
+            return FTI_SCES;
+        }
+        if (FTIFF_FlushRuns(fd) != FTI_SCES) {
+            return FTI_NSCS;
+        }
+    }
+
+    if (fd->iov == NULL) {
+        fd->iov = talloc(struct iovec, FTIFF_BATCH_IOV);
+    }
+    fd->iov[0].iov_base = addr;
+    fd->iov[0].iov_len = size;
+    fd->nbIov = 1;
+    fd->batchPos = fptr;
+    fd->batchSize = size;
+    return FTI_SCES;
+}
+
 /*-------------------------------------------------------------------------*/
 /**
   @brief      Writes the data of memory chunk to the appropriate file location. 
@@ -756,48 +899,42 @@ int FTIFF_UpdateDatastructVarFTIFF(FTIT_execution* FTI_Exec,
 
   This function writes a subset of the data of a dbvar on the checkpointed file. If the 
   data are in the CPU memory the subset is equal to the size of the dbvar otherwise
-  we process smaller chunks of memory (usually equal to 32Mb).
+  we process smaller chunks of memory (usually equal to 32Mb). The dirty runs
+  are collected by \ref FTIFF_AddRun and written in batches, the caller must
+  call \ref FTIFF_FlushRuns before 'dptr' is reused.
  **/
 /*-------------------------------------------------------------------------*/
 int FTI_WriteMemFTIFFChunk(FTIT_execution *FTI_Exec, FTIFF_dbvar *currentdbvar,
         unsigned char *dptr, size_t currentOffset, size_t fetchedBytes,
-        int32_t *dcpSize, WriteFTIFFInfo_t *fd) {
+        int64_t *dcpSize, WriteFTIFFInfo_t *fd) {
     unsigned char *chunk_addr = NULL;
     size_t chunk_size, chunk_offset;
     size_t remainingBytes = fetchedBytes;
     chunk_size = 0;
     chunk_offset = 0;
-
-    int32_t membs = 1024*1024*16;  // 16 MB
-    int32_t cpybuf, cpynow, cpycnt;  //, fptr;
+    int res = FTI_SCES;
 
     uintptr_t fptr = currentdbvar-> fptr + currentOffset;
     uintptr_t fptrTemp = fptr;
     size_t prevRemBytes = remainingBytes;
 
+    FTI_HashDataChunk(currentdbvar, dptr, currentOffset, fetchedBytes);
+
     while (FTI_ReceiveDataChunk(&chunk_addr, &chunk_size, currentdbvar,
      dptr, &remainingBytes)) {
         chunk_offset = chunk_addr - dptr;
         fptr = fptrTemp + chunk_offset;
-        // #warning handle error of seek
-        FTI_PosixSeek(fptr, fd);
-
-        cpycnt = 0;
-        while (cpycnt < chunk_size) {
-            cpybuf = chunk_size - cpycnt;
-            cpynow = (cpybuf > membs) ? membs : cpybuf;
-            // #warning We need to also fault inject the writes etc.
-            FTI_PosixWrite(&chunk_addr[cpycnt], cpynow, fd);
-            cpycnt += cpynow;
+        // keep consuming the chunks to leave the dCP state consistent
+        if (res == FTI_SCES) {
+            res = FTIFF_AddRun(fd, chunk_addr, chunk_size, fptr);
         }
         (*dcpSize) += chunk_size;
-        assert(cpycnt == chunk_size);
         dptr += (prevRemBytes-remainingBytes);
         prevRemBytes = remainingBytes;
         fptrTemp += chunk_offset + chunk_size;
     }
     assert(remainingBytes == 0);
-    return FTI_SCES;
+    return res;
 }
 
 /*-------------------------------------------------------------------------*/
@@ -820,7 +957,7 @@ int FTI_WriteMemFTIFFChunk(FTIT_execution *FTI_Exec, FTIFF_dbvar *currentdbvar,
 /*-------------------------------------------------------------------------*/
 int FTI_ProcessDBVar(FTIT_execution *FTI_Exec, FTIT_configuration *FTI_Conf,
     FTIFF_dbvar *currentdbvar, FTIT_dataset *data, unsigned char *hashchk,
-     WriteFTIFFInfo_t *fd, int32_t *dcpSize, unsigned char **dptr) {
+     WriteFTIFFInfo_t *fd, int64_t *dcpSize, unsigned char **dptr) {
     bool hascontent = currentdbvar->hascontent;
     unsigned char *cbasePtr = NULL;
     errno = 0;
@@ -872,8 +1009,15 @@ int FTI_ProcessDBVar(FTIT_execution *FTI_Exec, FTIT_configuration *FTI_Conf,
 
         while (cbasePtr) {
             MD5_Update(&dbContext, cbasePtr, totalBytes);
-            FTI_WriteMemFTIFFChunk(FTI_Exec, currentdbvar, cbasePtr, offset,
-             totalBytes, dcpSize, fd);
+            int res = FTI_WriteMemFTIFFChunk(FTI_Exec, currentdbvar, cbasePtr,
+             offset, totalBytes, dcpSize, fd);
+            // the prefetch buffer is reused for the next block
+            if (prefetcher.isDevice && res == FTI_SCES) {
+                res = FTIFF_FlushRuns(fd);
+            }
+            if (res != FTI_SCES) {
+                return FTI_NSCS;
+            }
             offset+=totalBytes;
             if (FTI_Try(FTI_getPrefetchedData (&prefetcher, &totalBytes,
              &cbasePtr),
@@ -957,6 +1101,12 @@ void* FTI_InitFtiff(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     // important for reading and writing operations
     FTI_Exec->FTIFFMeta.dataSize = 0;
     FTI_Exec->FTIFFMeta.pureDataSize = 0;
+    memset(&FTI_Exec->dcpIo, 0x0, sizeof(FTIT_dcpIoStats));
+    write_info->iov = NULL;
+    write_info->nbIov = 0;
+    write_info->batchPos = 0;
+    write_info->batchSize = 0;
+    write_info->failed = 0;
 
     // update ckpt file name
     snprintf(FTI_Exec->ckptMeta.ckptFile, FTI_BUFS, "Ckpt%d-Rank%d.%s",
@@ -1024,9 +1174,9 @@ int FTI_WriteFtiffData(FTIT_dataset* data, void *fd) {
     unsigned char *dptr;
     int dbvar_idx, dbcounter = 0;
     int isnextdb;
-    int32_t dcpSize = 0;
-    int32_t dataSize = 0;
-    int32_t pureDataSize = 0;
+    int64_t dcpSize = 0;
+    int64_t dataSize = 0;
+    int64_t pureDataSize = 0;
 
     FTIFF_UpdateDatastructVarFTIFF(write_info->FTI_Exec, data,
      write_info->FTI_Conf);
@@ -1035,6 +1185,7 @@ int FTI_WriteFtiffData(FTIT_dataset* data, void *fd) {
     if (write_info->FTI_Exec->firstdb == NULL) {
         FTI_Print("No data structure found to write data to file. "
             "Discarding checkpoint.", FTI_WARN);
+        write_info->failed = 1;
         return FTI_NSCS;
     }
 
@@ -1056,8 +1207,13 @@ int FTI_WriteFtiffData(FTIT_dataset* data, void *fd) {
                 if (dbvar->hascontent)
                     pureDataSize += dbvar->chunksize;
 
-                FTI_ProcessDBVar(write_info->FTI_Exec, write_info->FTI_Conf,
-                 dbvar , data, hashchk, fd, &dcpSize, &dptr);
+                if (FTI_ProcessDBVar(write_info->FTI_Exec,
+                 write_info->FTI_Conf, dbvar, data, hashchk, fd, &dcpSize,
+                 &dptr) != FTI_SCES) {
+                    FTI_Print("Failed to write the FTI-FF data.", FTI_WARN);
+                    write_info->failed = 1;
+                    return FTI_NSCS;
+                }
                 // create hash for datachunk and assign to member 'hash'
                 if (dbvar->hascontent) {
                     memcpy(dbvar->hash, hashchk, MD5_DIGEST_LENGTH);
@@ -1073,6 +1229,13 @@ int FTI_WriteFtiffData(FTIT_dataset* data, void *fd) {
         dbcounter++;
     } while (isnextdb);
 
+    // with iCP the application may change the data after this call
+    if (write_info->FTI_Exec->iCPInfo.status == FTI_ICP_ACTV &&
+     FTIFF_FlushRuns(write_info) != FTI_SCES) {
+        write_info->failed = 1;
+        return FTI_NSCS;
+    }
+
     // only for printout of dCP share in FTI_Checkpoint
     write_info->FTI_Exec->FTIFFMeta.dcpSize += dcpSize;
     write_info->FTI_Exec->FTIFFMeta.pureDataSize += pureDataSize;
@@ -1093,9 +1256,17 @@ int FTI_WriteFtiffData(FTIT_dataset* data, void *fd) {
 int FTI_FinalizeFtiff(void *fd) {
     WriteFTIFFInfo_t *write_info = (WriteFTIFFInfo_t*) fd;
 
-    if (FTI_Try(FTIFF_CreateMetadata(write_info->FTI_Exec,
-     write_info->FTI_Topo, write_info->FTI_Conf),
-     "Create FTI-FF meta data") != FTI_SCES) {
+    // after a failed write the file is only closed
+    int res = (write_info->failed) ? FTI_NSCS : FTIFF_FlushRuns(write_info);
+    free(write_info->iov);
+    write_info->iov = NULL;
+    if (res == FTI_SCES) {
+        res = FTI_Try(FTIFF_CreateMetadata(write_info->FTI_Exec,
+         write_info->FTI_Topo, write_info->FTI_Conf),
+         "Create FTI-FF meta data");
+    }
+    if (res != FTI_SCES) {
+        FTI_PosixClose(write_info);
         return FTI_NSCS;
     }
 
@@ -1201,7 +1372,7 @@ int FTIFF_finalizeDatastructFTIFF(FTIT_execution* FTI_Exec) {
         return FTI_NSCS;
     }
 
-    uint32_t metaSize = FTI_filemetastructsize;
+    uint64_t metaSize = FTI_filemetastructsize;
 
     do {
         db->finalized = true;
@@ -1308,14 +1479,14 @@ int FTIFF_CreateMetadata(FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo,
 
     FTI_Exec->ckptSize = FTI_Exec->FTIFFMeta.metaSize +
      FTI_Exec->FTIFFMeta.dataSize;
-    int32_t fs = FTI_Exec->ckptSize;
+    int64_t fs = FTI_Exec->ckptSize;
     FTI_Exec->FTIFFMeta.ckptSize = fs;
     FTI_Exec->FTIFFMeta.fs = fs;
 
     // allgather not needed for L1 checkpoint
     if ((FTI_Exec->ckptMeta.level == 2) || (FTI_Exec->ckptMeta.level == 3)) {
-        int32_t fileSizes[FTI_BUFS], mfs = 0;
-        MPI_Allgather(&fs, 1, MPI_INT32_T, fileSizes, 1, MPI_INT32_T,
+        int64_t fileSizes[FTI_BUFS], mfs = 0;
+        MPI_Allgather(&fs, 1, MPI_INT64_T, fileSizes, 1, MPI_INT64_T,
          FTI_Exec->groupComm);
         int ptnerGroupRank, i;
         switch (FTI_Exec->ckptMeta.level) {
@@ -1415,8 +1586,8 @@ int FTIFF_Recover(FTIT_execution *FTI_Exec, FTIT_keymap *FTI_Data,
 
     int i = 0; for (; i < FTI_Exec->nbVar; i++) {
         if (data[i].size != data[i].sizeStored) {
-            snprintf(str, FTI_BUFS, "Cannot recover %d bytes to protected"
-                    " variable (ID %d) size: %d",
+            snprintf(str, FTI_BUFS, "Cannot recover %ld bytes to protected"
+                    " variable (ID %d) size: %ld",
                     data[i].sizeStored, data[i].id,
                     data[i].size);
             FTI_Print(str, FTI_WARN);
@@ -1453,7 +1624,7 @@ int FTIFF_Recover(FTIT_execution *FTI_Exec, FTIT_keymap *FTI_Data,
 
     // block size for memcpy of pointer.
     int32_t membs = 1024*1024*16;  // 16 MB
-    int32_t cpybuf, cpynow, cpycnt;
+    int64_t cpybuf, cpynow, cpycnt;
 
     // open checkpoint file for read only
     int fd = open(fn, O_RDONLY, 0);
@@ -1549,7 +1720,7 @@ int FTIFF_Recover(FTIT_execution *FTI_Exec, FTIT_keymap *FTI_Data,
             // debug information
             snprintf(str, FTI_BUFS, "FTI-FF: FTIFF_Recover -  "
                     "dataBlock:%i/dataBlockVar%i id: %i"
-                    ", destptr: %ld, fptr: %ld, chunksize: %d, "
+                    ", destptr: %ld, fptr: %ld, chunksize: %ld, "
                     "base_ptr: 0x%" PRIxPTR " ptr_pos: 0x%" PRIxPTR ".",
                     dbcounter, dbvar_idx,
                     currentdbvar->id, currentdbvar->dptr,
@@ -1668,7 +1839,7 @@ int FTIFF_RecoverVar(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
 
     // block size for memcpy of pointer.
     int32_t membs = 1024*1024*16;  // 16 MB
-    int32_t cpybuf, cpynow, cpycnt;
+    int64_t cpybuf, cpynow, cpycnt;
 
     // MD5 context for checksum of data chunks
     MD5_CTX mdContext;
@@ -1698,8 +1869,8 @@ int FTIFF_RecoverVar(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
                     return FTI_NSCS;
                 }
                 if (data->size != data->sizeStored) {
-                    snprintf(str, sizeof(str), "Cannot recover %d bytes to "
-                        "protected variable (ID %d) size: %d",
+                    snprintf(str, sizeof(str), "Cannot recover %ld bytes to "
+                        "protected variable (ID %d) size: %ld",
                         data->sizeStored, data->id, data->size);
                     FTI_Print(str, FTI_WARN);
                     return FTI_NREC;
@@ -1723,7 +1894,7 @@ int FTIFF_RecoverVar(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
                 // debug information
                 snprintf(str, FTI_BUFS, "FTIFF: FTIFF_RecoverVar -"
                         "  dataBlock:%i/dataBlockVar%i id: %i"
-                        ", destptr: %ld, fptr: %ld, chunksize: %d, "
+                        ", destptr: %ld, fptr: %ld, chunksize: %ld, "
                         "base_ptr: 0x%" PRIxPTR " ptr_pos: 0x%" PRIxPTR ".",
                         dbcounter, dbvar_idx,
                         currentdbvar->id, currentdbvar->dptr,
@@ -1965,7 +2136,7 @@ int FTIFF_LoadMetaPostprocessing(FTIT_execution* FTI_Exec,
 /*-------------------------------------------------------------------------*/
 int FTIFF_GetEncodedFileChecksum(FTIFF_metaInfo *FTIFFMeta, int fd,
  char *checksum) {
-    int32_t rcount = 0, toRead, diff;
+    int64_t rcount = 0, toRead, diff;
     int rbuffer;
     char buffer[CHUNK_SIZE], strerr[FTI_BUFS];
     MD5_CTX mdContext;
@@ -1983,7 +2154,7 @@ int FTIFF_GetEncodedFileChecksum(FTIFF_metaInfo *FTIFFMeta, int fd,
         rbuffer = read(fd, buffer, toRead);
         if (rbuffer == -1) {
             snprintf(strerr, FTI_BUFS, "FTI-FF: L3RecoveryInit - Failed to"
-            " read %d bytes from file", toRead);
+            " read %ld bytes from file", toRead);
             FTI_Print(strerr, FTI_EROR);
             errno = 0;
             return FTI_NSCS;
@@ -2236,7 +2407,7 @@ int FTIFF_CheckL2RecoverInit(FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo,
         }
     }
     snprintf(dbgstr, FTI_BUFS, "FTI-FF: L2-Recovery - rank: %i, left: %i,"
-        " right: %i, fs: %d, pfs: %d, ckptId: %i",
+        " right: %i, fs: %ld, pfs: %ld, ckptId: %i",
             FTI_Topo->myRank, leftIdx, rightIdx, FTI_Exec->ckptMeta.fs,
              FTI_Exec->ckptMeta.pfs, FTI_Exec->ckptId);
     FTI_Print(dbgstr, FTI_DBUG);
@@ -2290,7 +2461,7 @@ int FTIFF_CheckL3RecoverInit(FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo,
 
     // check if recovery possible
     int i, saneCkptID = 0, saneMaxFs = 0, erasures = 0;
-    int32_t maxFs = 0;
+    int64_t maxFs = 0;
     ckptId = 0;
     for (i = 0; i < FTI_Topo->groupSize; i++) {
         erased[i]=!groupInfo[i].FileExists;
@@ -2313,7 +2484,7 @@ int FTIFF_CheckL3RecoverInit(FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo,
     }
     // for the case that all (and only) the encoded files are deleted
     if (saneMaxFs == 0 && !(erasures > FTI_Topo->groupSize)) {
-        MPI_Allreduce(&(info.maxFs), &FTI_Exec->ckptMeta.maxFs, 1, MPI_INT32_T,
+        MPI_Allreduce(&(info.maxFs), &FTI_Exec->ckptMeta.maxFs, 1, MPI_INT64_T,
          MPI_SUM, FTI_Exec->groupComm);
         FTI_Exec->ckptMeta.maxFs /= FTI_Topo->groupSize;
     }
@@ -2390,7 +2561,7 @@ void FTIFF_SetHashChunk(FTIFF_dbvar *dbvar, FTIT_keymap* FTI_Data) {
         }
 
         void * ptr = data->ptr + dbvar->dptr;
-        uint32_t size = dbvar->chunksize;
+        uint64_t size = dbvar->chunksize;
         MD5(ptr, size, dbvar->hash);
     }
 }
@@ -2406,13 +2577,13 @@ void FTIFF_GetHashMetaInfo(unsigned char *hash, FTIFF_metaInfo *FTIFFMeta) {
     MD5_CTX md5Ctx;
     MD5_Init(&md5Ctx);
     MD5_Update(&md5Ctx, FTIFFMeta->checksum, MD5_DIGEST_STRING_LENGTH);
-    MD5_Update(&md5Ctx, &(FTIFFMeta->timestamp), sizeof(int32_t));
-    MD5_Update(&md5Ctx, &(FTIFFMeta->ckptSize), sizeof(int32_t));
-    MD5_Update(&md5Ctx, &(FTIFFMeta->metaSize), sizeof(int32_t));
-    MD5_Update(&md5Ctx, &(FTIFFMeta->dataSize), sizeof(int32_t));
-    MD5_Update(&md5Ctx, &(FTIFFMeta->fs), sizeof(int32_t));
-    MD5_Update(&md5Ctx, &(FTIFFMeta->ptFs), sizeof(int32_t));
-    MD5_Update(&md5Ctx, &(FTIFFMeta->maxFs), sizeof(int32_t));
+    MD5_Update(&md5Ctx, &(FTIFFMeta->timestamp), sizeof(int64_t));
+    MD5_Update(&md5Ctx, &(FTIFFMeta->ckptSize), sizeof(int64_t));
+    MD5_Update(&md5Ctx, &(FTIFFMeta->metaSize), sizeof(int64_t));
+    MD5_Update(&md5Ctx, &(FTIFFMeta->dataSize), sizeof(int64_t));
+    MD5_Update(&md5Ctx, &(FTIFFMeta->fs), sizeof(int64_t));
+    MD5_Update(&md5Ctx, &(FTIFFMeta->ptFs), sizeof(int64_t));
+    MD5_Update(&md5Ctx, &(FTIFFMeta->maxFs), sizeof(int64_t));
     MD5_Final(hash, &md5Ctx);
 }
 
@@ -2427,7 +2598,7 @@ void FTIFF_GetHashdb(unsigned char *hash, FTIFF_db *db) {
     MD5_CTX md5Ctx;
     MD5_Init(&md5Ctx);
     MD5_Update(&md5Ctx, &(db->numvars), sizeof(int));
-    MD5_Update(&md5Ctx, &(db->dbsize), sizeof(int32_t));
+    MD5_Update(&md5Ctx, &(db->dbsize), sizeof(int64_t));
     MD5_Final(hash, &md5Ctx);
 }
 
@@ -2447,8 +2618,8 @@ void FTIFF_GetHashdbvar(unsigned char *hash, FTIFF_dbvar *dbvar)  {
     MD5_Update(&md5Ctx, &(dbvar->hasCkpt), sizeof(bool));
     MD5_Update(&md5Ctx, &(dbvar->dptr), sizeof(uintptr_t));
     MD5_Update(&md5Ctx, &(dbvar->fptr), sizeof(uintptr_t));
-    MD5_Update(&md5Ctx, &(dbvar->chunksize), sizeof(int32_t));
-    MD5_Update(&md5Ctx, &(dbvar->containersize), sizeof(int32_t));
+    MD5_Update(&md5Ctx, &(dbvar->chunksize), sizeof(int64_t));
+    MD5_Update(&md5Ctx, &(dbvar->containersize), sizeof(int64_t));
     MD5_Update(&md5Ctx, dbvar->hash, MD5_DIGEST_LENGTH);
     MD5_Final(hash, &md5Ctx);
 }
@@ -2468,7 +2639,7 @@ void FTIFF_InitMpiTypes() {
     MBR_CNT(headInfo) =  7;
     MBR_BLK_LEN(headInfo) = { 1, 1, FTI_BUFS, 1, 1, 1, 1 };
     MBR_TYPES(headInfo) = { MPI_INT, MPI_INT, MPI_CHAR,
-     MPI_INT32_T, MPI_INT32_T, MPI_INT32_T, MPI_INT };
+     MPI_INT64_T, MPI_INT64_T, MPI_INT64_T, MPI_INT };
     MBR_DISP(headInfo) = {
         offsetof(FTIFF_headInfo, exists),
         offsetof(FTIFF_headInfo, nbVar),
@@ -2487,7 +2658,7 @@ void FTIFF_InitMpiTypes() {
     MBR_CNT(RecoInfo) = 6;
     MBR_BLK_LEN(RecoInfo) = { 1, 1, 1, 1, 1, 1 };
     MBR_TYPES(RecoInfo) = { MPI_INT, MPI_INT, MPI_INT,
-     MPI_INT, MPI_INT32_T, MPI_INT32_T };
+     MPI_INT, MPI_INT64_T, MPI_INT64_T };
     MBR_DISP(RecoInfo) = {
         offsetof(FTIFF_RecoveryInfo, FileExists),
         offsetof(FTIFF_RecoveryInfo, BackupExists),
@@ -2543,19 +2714,19 @@ int FTIFF_DeserializeFileMeta(FTIFF_metaInfo* meta, char* buffer_ser) {
     pos += MD5_DIGEST_LENGTH;
     memcpy(&(meta->ckptId)       , buffer_ser + pos, sizeof(int));
     pos += sizeof(int);
-    memcpy(&(meta->ckptSize)     , buffer_ser + pos, sizeof(int32_t));
-    pos += sizeof(int32_t);
-    memcpy(&(meta->metaSize)     , buffer_ser + pos, sizeof(int32_t));
-    pos += sizeof(int32_t);
-    memcpy(&(meta->dataSize)     , buffer_ser + pos, sizeof(int32_t));
-    pos += sizeof(int32_t);
-    memcpy(&(meta->fs)           , buffer_ser + pos, sizeof(int32_t));
-    pos += sizeof(int32_t);
-    memcpy(&(meta->maxFs)        , buffer_ser + pos, sizeof(int32_t));
-    pos += sizeof(int32_t);
-    memcpy(&(meta->ptFs)         , buffer_ser + pos, sizeof(int32_t));
-    pos += sizeof(int32_t);
-    memcpy(&(meta->timestamp)    , buffer_ser + pos, sizeof(int32_t));
+    memcpy(&(meta->ckptSize)     , buffer_ser + pos, sizeof(int64_t));
+    pos += sizeof(int64_t);
+    memcpy(&(meta->metaSize)     , buffer_ser + pos, sizeof(int64_t));
+    pos += sizeof(int64_t);
+    memcpy(&(meta->dataSize)     , buffer_ser + pos, sizeof(int64_t));
+    pos += sizeof(int64_t);
+    memcpy(&(meta->fs)           , buffer_ser + pos, sizeof(int64_t));
+    pos += sizeof(int64_t);
+    memcpy(&(meta->maxFs)        , buffer_ser + pos, sizeof(int64_t));
+    pos += sizeof(int64_t);
+    memcpy(&(meta->ptFs)         , buffer_ser + pos, sizeof(int64_t));
+    pos += sizeof(int64_t);
+    memcpy(&(meta->timestamp)    , buffer_ser + pos, sizeof(int64_t));
 
     return FTI_SCES;
 }
@@ -2576,7 +2747,7 @@ int FTIFF_DeserializeDbMeta(FTIFF_db* db, char* buffer_ser) {
     int pos = 0;
     memcpy(&(db->numvars)    , buffer_ser + pos, sizeof(int));
     pos += sizeof(int);
-    memcpy(&(db->dbsize)     , buffer_ser + pos, sizeof(int32_t));
+    memcpy(&(db->dbsize)     , buffer_ser + pos, sizeof(int64_t));
 
     return FTI_SCES;
 }
@@ -2607,10 +2778,10 @@ int FTIFF_DeserializeDbVarMeta(FTIFF_dbvar* dbvar, char* buffer_ser) {
     pos += sizeof(uintptr_t);
     memcpy(&(dbvar->fptr)            , buffer_ser + pos, sizeof(uintptr_t));
     pos += sizeof(uintptr_t);
-    memcpy(&(dbvar->chunksize)       , buffer_ser + pos, sizeof(int32_t));
-    pos += sizeof(int32_t);
-    memcpy(&(dbvar->containersize)   , buffer_ser + pos, sizeof(int32_t));
-    pos += sizeof(int32_t);
+    memcpy(&(dbvar->chunksize)       , buffer_ser + pos, sizeof(int64_t));
+    pos += sizeof(int64_t);
+    memcpy(&(dbvar->containersize)   , buffer_ser + pos, sizeof(int64_t));
+    pos += sizeof(int64_t);
     memcpy(dbvar->hash               , buffer_ser + pos, MD5_DIGEST_LENGTH);
 
     return FTI_SCES;
@@ -2636,19 +2807,19 @@ int FTIFF_SerializeFileMeta(FTIFF_metaInfo* meta, char* buffer_ser) {
     pos += MD5_DIGEST_LENGTH;
     memcpy(buffer_ser + pos, &(meta->ckptId)       , sizeof(int));
     pos += sizeof(int);
-    memcpy(buffer_ser + pos, &(meta->ckptSize)     , sizeof(int32_t));
-    pos += sizeof(int32_t);
-    memcpy(buffer_ser + pos, &(meta->metaSize)     , sizeof(int32_t));
-    pos += sizeof(int32_t);
-    memcpy(buffer_ser + pos, &(meta->dataSize)     , sizeof(int32_t));
-    pos += sizeof(int32_t);
-    memcpy(buffer_ser + pos, &(meta->fs)           , sizeof(int32_t));
-    pos += sizeof(int32_t);
-    memcpy(buffer_ser + pos, &(meta->maxFs)        , sizeof(int32_t));
-    pos += sizeof(int32_t);
-    memcpy(buffer_ser + pos, &(meta->ptFs)         , sizeof(int32_t));
-    pos += sizeof(int32_t);
-    memcpy(buffer_ser + pos, &(meta->timestamp)    , sizeof(int32_t));
+    memcpy(buffer_ser + pos, &(meta->ckptSize)     , sizeof(int64_t));
+    pos += sizeof(int64_t);
+    memcpy(buffer_ser + pos, &(meta->metaSize)     , sizeof(int64_t));
+    pos += sizeof(int64_t);
+    memcpy(buffer_ser + pos, &(meta->dataSize)     , sizeof(int64_t));
+    pos += sizeof(int64_t);
+    memcpy(buffer_ser + pos, &(meta->fs)           , sizeof(int64_t));
+    pos += sizeof(int64_t);
+    memcpy(buffer_ser + pos, &(meta->maxFs)        , sizeof(int64_t));
+    pos += sizeof(int64_t);
+    memcpy(buffer_ser + pos, &(meta->ptFs)         , sizeof(int64_t));
+    pos += sizeof(int64_t);
+    memcpy(buffer_ser + pos, &(meta->timestamp)    , sizeof(int64_t));
 
     return FTI_SCES;
 }
@@ -2669,7 +2840,7 @@ int FTIFF_SerializeDbMeta(FTIFF_db* db, char* buffer_ser) {
     int pos = 0;
     memcpy(buffer_ser + pos, &(db->numvars)    , sizeof(int));
     pos += sizeof(int);
-    memcpy(buffer_ser + pos, &(db->dbsize)     , sizeof(int32_t));
+    memcpy(buffer_ser + pos, &(db->dbsize)     , sizeof(int64_t));
 
     return FTI_SCES;
 }
@@ -2700,10 +2871,10 @@ int FTIFF_SerializeDbVarMeta(FTIFF_dbvar* dbvar, char* buffer_ser) {
     pos += sizeof(uintptr_t);
     memcpy(buffer_ser + pos, &(dbvar->fptr)            , sizeof(uintptr_t));
     pos += sizeof(uintptr_t);
-    memcpy(buffer_ser + pos, &(dbvar->chunksize)       , sizeof(int32_t));
-    pos += sizeof(int32_t);
-    memcpy(buffer_ser + pos, &(dbvar->containersize)   , sizeof(int32_t));
-    pos += sizeof(int32_t);
+    memcpy(buffer_ser + pos, &(dbvar->chunksize)       , sizeof(int64_t));
+    pos += sizeof(int64_t);
+    memcpy(buffer_ser + pos, &(dbvar->containersize)   , sizeof(int64_t));
+    pos += sizeof(int64_t);
     memcpy(buffer_ser + pos, dbvar->hash               , MD5_DIGEST_LENGTH);
 
     return FTI_SCES;
@@ -2740,7 +2911,7 @@ void FTIFF_PrintDataStructure(int rank, FTIT_execution* FTI_Exec) {
         " [%d]----------------\n\n", rank);
         do {
             printf("    DataBase-id: %d\n", dbcnt);
-            printf("                 dbsize: %d\n", dbgdb->dbsize);
+            printf("                 dbsize: %ld\n", dbgdb->dbsize);
             printf("                 metasize (offset: %d): %d\n\n",
              FTI_filemetastructsize,
              FTI_dbstructsize+dbgdb->numvars*FTI_dbvarstructsize);
@@ -2754,8 +2925,8 @@ void FTIFF_PrintDataStructure(int rank, FTIT_execution* FTI_Exec) {
                         "                 hasCkpt: %s\n"
                         "                 dptr: %lu\n"
                         "                 fptr: %lu\n"
-                        "                 chunksize: %u\n"
-                        "                 containersize: %u\n\n",
+                        "                 chunksize: %ld\n"
+                        "                 containersize: %ld\n\n",
                         /*
                          "                 nbHashes: %lu\n"
                          "                 diffBlockSize: %d\n"
@@ -400,6 +400,119 @@ size_t FTI_GetHDF5FilePos(void *fileDesc) {
     return 0;
 }
 
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Creates the MPI-IO hints of the VPR file.
+  @param      FTI_Conf        Configuration metadata.
+  @return     MPI_Info        The hints, to be freed by the caller.
+
+  Collective buffering is enabled by default. The hints of
+  'h5_single_file_hints' are a comma separated list of key=value pairs,
+  which are added to the defaults or replace them.
+ **/
+/*-------------------------------------------------------------------------*/
+static MPI_Info FTI_H5SingleFileInfo(FTIT_configuration* FTI_Conf) {
+    char hints[FTI_BUFS], str[FTI_BUFS];
+    char *hint, *save;
+    MPI_Info info;
+
+    MPI_Info_create(&info);
+    MPI_Info_set(info, "romio_cb_write", "enable");
+    snprintf(hints, FTI_BUFS, "%s", FTI_Conf->h5SingleFileHints);
+    for (hint = strtok_r(hints, ", ", &save); hint != NULL;
+     hint = strtok_r(NULL, ", ", &save)) {
+        char* value = strchr(hint, '=');
+        if (value == NULL || value == hint || value[1] == '\0') {
+            snprintf(str, FTI_BUFS, "Ignoring the malformed MPI-IO hint "
+             "'%s' of the VPR file.", hint);
+            FTI_Print(str, FTI_WARN);
+            continue;
+        }
+        *value++ = '\0';
+        MPI_Info_set(info, hint, value);
+    }
+    return info;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Creates the file access properties of the checkpoint files.
+  @param      FTI_Conf        Configuration metadata.
+  @return     hid_t           The property list, closed by the caller.
+
+  Sets the alignment of the objects and the size of the metadata blocks.
+  The chunk cache holds at least two chunks, so that partial reads do not
+  read and verify the same chunk several times.
+ **/
+/*-------------------------------------------------------------------------*/
+static hid_t FTI_H5FileAccess(FTIT_configuration* FTI_Conf) {
+    hid_t plid = H5Pcreate(H5P_FILE_ACCESS);
+    if (FTI_Conf->h5Alignment > 1) {
+        // small objects, mostly metadata, are packed
+        H5Pset_alignment(plid, FTI_Conf->h5Alignment / 2,
+         FTI_Conf->h5Alignment);
+    }
+    if (FTI_Conf->h5MetaBlock > 0) {
+        H5Pset_meta_block_size(plid, FTI_Conf->h5MetaBlock);
+    }
+    if (FTI_Conf->h5ChunkSize > 0) {
+        int mdcElmts;
+        size_t nslots, nbytes;
+        double w0;
+        H5Pget_cache(plid, &mdcElmts, &nslots, &nbytes, &w0);
+        if (nbytes < 2 * (size_t) FTI_Conf->h5ChunkSize) {
+            nbytes = 2 * (size_t) FTI_Conf->h5ChunkSize;
+        }
+        H5Pset_cache(plid, mdcElmts, nslots, nbytes, w0);
+    }
+    return plid;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Computes the chunk dimensions of a protected variable.
+  @param      FTI_Conf        Configuration metadata.
+  @param      eleSize         Size of an element in bytes.
+  @param      rank            Number of dimensions.
+  @param      dims            Dimensions of the variable.
+  @param      chunk           Chunk dimensions (out).
+  @return     bool            False for the contiguous layout.
+
+  A chunk holds whole rows of the innermost dimensions and as many of the
+  outer ones as fit in 'h5_chunk_size' bytes, rounded down to a multiple
+  of 'h5_alignment' when it is larger. Partial reads only read, and
+  verify, the chunks they touch.
+ **/
+/*-------------------------------------------------------------------------*/
+static bool FTI_H5ChunkDims(FTIT_configuration* FTI_Conf, size_t eleSize,
+ int rank, hsize_t* dims, hsize_t* chunk) {
+    int64_t target = FTI_Conf->h5ChunkSize;
+    int j;
+
+    if (target <= 0 || rank <= 0 || eleSize == 0) {
+        return false;
+    }
+    for (j = 0; j < rank; j++) {
+        if (dims[j] == 0) {
+            return false;
+        }
+    }
+    if (FTI_Conf->h5Alignment > 1 && target > FTI_Conf->h5Alignment) {
+        target -= target % FTI_Conf->h5Alignment;
+    }
+    hsize_t left = ((size_t) target > eleSize) ? target / eleSize : 1;
+    for (j = rank - 1; j >= 0; j--) {
+        if (dims[j] <= left) {
+            chunk[j] = dims[j];
+            left /= dims[j];
+        } else {
+            chunk[j] = left;
+            left = 1;
+        }
+    }
+    return true;
+}
+
 /*-------------------------------------------------------------------------*/
 /**
   @brief      Opens and HDF5 file (Only for write).
@@ -412,12 +525,18 @@ int FTI_HDF5Open(char *fn, void *fileDesc) {
     char str[FTI_BUFS];
     // Creating new hdf5 file
     if (fd->FTI_Exec->h5SingleFile && fd->FTI_Conf->h5SingleFileIsInline) {
-        hid_t plid = H5Pcreate(H5P_FILE_ACCESS);
-        H5Pset_fapl_mpio(plid, FTI_COMM_WORLD, MPI_INFO_NULL);
+        MPI_Info info = FTI_H5SingleFileInfo(fd->FTI_Conf);
+        hid_t plid = FTI_H5FileAccess(fd->FTI_Conf);
+        H5Pset_fapl_mpio(plid, FTI_COMM_WORLD, info);
+        // all ranks create the same objects, write the metadata collectively
+        H5Pset_coll_metadata_write(plid, true);
         fd->file_id = H5Fcreate(fn, H5F_ACC_TRUNC, H5P_DEFAULT, plid);
         H5Pclose(plid);
+        MPI_Info_free(&info);
     } else {
-        fd->file_id = H5Fcreate(fn, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+        hid_t plid = FTI_H5FileAccess(fd->FTI_Conf);
+        fd->file_id = H5Fcreate(fn, H5F_ACC_TRUNC, H5P_DEFAULT, plid);
+        H5Pclose(plid);
     }
     if (fd->file_id < 0) {
         snprintf(str, sizeof(str),
@@ -492,7 +611,7 @@ int FTI_CommitDataType(FTIT_execution *FTI_Exec, FTIT_dataset *data) {
 
  **/
 /*-------------------------------------------------------------------------*/
-int FTI_CheckHDF5File(char* fn, int32_t fs, char* checksum) {
+int FTI_CheckHDF5File(char* fn, int64_t fs, char* checksum) {
     char str[FTI_BUFS];
     if (access(fn, F_OK) == 0) {
         struct stat fileStatus;
@@ -735,11 +854,14 @@ int FTI_AdvanceOffset(hsize_t sep,  hsize_t *start, hsize_t *add,
   If the data are on the HOST CPU side, all the data are tranfered with a single call.
   If the data are on the GPU side, we use hyperslabs to slice the data and asynchronously
   move data from the GPU side to the host side and then to the filesytem.
+  The dataset is chunked following 'h5_chunk_size', the Fletcher32 checksum
+  of 'h5_checksum' is computed per chunk.
  **/
 /*-------------------------------------------------------------------------*/
-int FTI_WriteHDF5Var(FTIT_dataset *data, FTIT_execution* FTI_Exec) {
+int FTI_WriteHDF5Var(FTIT_dataset *data, FTIT_configuration* FTI_Conf,
+ FTIT_execution* FTI_Exec) {
     int j;
-    hsize_t dimLength[32];
+    hsize_t dimLength[32], chunk[32];
     char str[FTI_BUFS];
     int res;
     hid_t dcpl;
@@ -749,8 +871,13 @@ int FTI_WriteHDF5Var(FTIT_dataset *data, FTIT_execution* FTI_Exec) {
     }
 
     dcpl = H5Pcreate(H5P_DATASET_CREATE);
-    res = H5Pset_fletcher32(dcpl);
-    res = H5Pset_chunk(dcpl, data->rank, dimLength);
+    if (FTI_H5ChunkDims(FTI_Conf, data->eleSize, data->rank, dimLength,
+     chunk)) {
+        res = H5Pset_chunk(dcpl, data->rank, chunk);
+        if (FTI_Conf->h5Checksum) {
+            res = H5Pset_fletcher32(dcpl);
+        }
+    }
 
     hid_t dataspace = H5Screate_simple(data->rank, dimLength, NULL);
     hid_t dataset;
@@ -1077,24 +1204,24 @@ int FTI_WriteHDF5Data(FTIT_dataset *data, void *write_info) {
     WriteHDF5Info_t *fd = (WriteHDF5Info_t *) write_info;
     char str[FTI_BUFS];
     int res;
-    FTIT_H5Group* rootGroup = fd->FTI_Exec->H5groups[0];
 
     if (fd->FTI_Exec->h5SingleFile && fd->FTI_Conf->h5SingleFileIsInline) {
+        // The subsets are written collectively when the file is closed,
+        // iCP writes every variable as it is added.
+        if (fd->FTI_Exec->iCPInfo.status != FTI_ICP_ACTV) {
+            return FTI_SCES;
+        }
         res = FTI_WriteSharedFileData(*data);
     } else {
         FTI_CommitDataType(fd->FTI_Exec, data);
-        res = FTI_WriteHDF5Var(data, fd->FTI_Exec);
+        res = FTI_WriteHDF5Var(data, fd->FTI_Conf, fd->FTI_Exec);
     }
     if (res != FTI_SCES) {
-        int j;
         snprintf(str, sizeof(str), "Dataset #%d could not be written",
          data->id);
         FTI_Print(str, FTI_EROR);
-        for (j = 0; j < fd->FTI_Exec->H5groups[0]->childrenNo; j++) {
-            FTI_CloseGroup(fd->FTI_Exec->H5groups[rootGroup->childrenID[j]],
-             fd->FTI_Exec->H5groups);
-        }
-        H5Fclose(fd->file_id);
+        // the file is closed by FTI_HDF5Close
+        fd->failed = 1;
         return FTI_NSCS;
     }
     return FTI_SCES;
@@ -1114,11 +1241,22 @@ int  FTI_HDF5Close(void *fileDesc) {
     FTIT_H5Group* rootGroup = fd->FTI_Exec->H5groups[0];
     FTIT_keymap* FTI_Data = fd->FTI_Data;
 
+    // the rank takes part in the collective calls below in any case
+    int res = FTI_SCES, nbVar = fd->FTI_Exec->nbVar;
     FTIT_dataset* data;
-    if (FTI_Data->data(&data, fd->FTI_Exec->nbVar) != FTI_SCES)
-        return FTI_NSCS;
+    if (FTI_Data->data(&data, nbVar) != FTI_SCES) {
+        res = FTI_NSCS;
+        nbVar = 0;
+    }
+
+    if (fd->FTI_Exec->h5SingleFile && fd->FTI_Conf->h5SingleFileIsInline &&
+     fd->FTI_Exec->iCPInfo.status != FTI_ICP_ACTV &&
+     FTI_WriteGlobalDatasets(fd->FTI_Exec,
+     (res == FTI_SCES) ? FTI_Data : NULL) != FTI_SCES) {
+        res = FTI_NSCS;
+    }
 
-    for (i = 0; i < fd->FTI_Exec->nbVar; i++) {
+    for (i = 0; i < nbVar; i++) {
         FTI_CloseComplexType(data[i].type);
     }
 
@@ -1141,6 +1279,9 @@ int  FTI_HDF5Close(void *fileDesc) {
         FTI_Print("FTI checkpoint file could not be closed.", FTI_EROR);
         return FTI_NSCS;
     }
+    if (res != FTI_SCES || fd->failed) {
+        return FTI_NSCS;
+    }
     if (fd->FTI_Exec->h5SingleFile) {
         bool removeLastFile = !fd->FTI_Conf->h5SingleFileKeep &&
          (bool)strcmp(fd->FTI_Exec->h5SingleFileLast, "") &&
@@ -1226,6 +1367,7 @@ void *FTI_InitHDF5(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     fd->FTI_Data = FTI_Data;
     fd->FTI_Conf = FTI_Conf;
     fd->FTI_Topo = FTI_Topo;
+    fd->failed = 0;
 
     FTI_HDF5Open(fn, fd);
 
@@ -1236,7 +1378,7 @@ void *FTI_InitHDF5(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
             FTI_CommitDataType(FTI_Exec, &data[i]);
         }
         if (fd->FTI_Conf->h5SingleFileIsInline) {
-            FTI_CreateGlobalDatasets(FTI_Exec);
+            FTI_CreateGlobalDatasets(FTI_Conf, FTI_Exec, FTI_Data);
         } else {
             FTI_CreateGlobalDatasetsAsGroups(FTI_Exec);
         }
@@ -1303,14 +1445,12 @@ int FTI_RecoverHDF5(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     hid_t file_id;
 
     // Open hdf5 file
+    hid_t plid = FTI_H5FileAccess(FTI_Conf);
     if (FTI_Exec->h5SingleFile) {
-        hid_t plid = H5Pcreate(H5P_FILE_ACCESS);
         H5Pset_fapl_mpio(plid, FTI_COMM_WORLD, MPI_INFO_NULL);
-        file_id = H5Fopen(fn, H5F_ACC_RDONLY, plid);
-        H5Pclose(plid);
-    } else {
-        file_id = H5Fopen(fn, H5F_ACC_RDONLY, H5P_DEFAULT);
     }
+    file_id = H5Fopen(fn, H5F_ACC_RDONLY, plid);
+    H5Pclose(plid);
     if (file_id < 0) {
         snprintf(str, FTI_BUFS, "Could not open FTI checkpoint file '%s'.", fn);
         FTI_Print(str, FTI_EROR);
@@ -1401,14 +1541,12 @@ int FTI_RecoverVarInitHDF5(FTIT_configuration* FTI_Conf,
         snprintf(fn, FTI_BUFS, "%s/%s-ID%08d.h5", FTI_Conf->h5SingleFileDir,
          FTI_Conf->h5SingleFilePrefix, FTI_Exec->ckptId);
     }
+    hid_t plid = FTI_H5FileAccess(FTI_Conf);
     if (FTI_Exec->h5SingleFile) {
-        hid_t plid = H5Pcreate(H5P_FILE_ACCESS);
         H5Pset_fapl_mpio(plid, FTI_COMM_WORLD, MPI_INFO_NULL);
-        _file_id = H5Fopen(fn, H5F_ACC_RDONLY, plid);
-        H5Pclose(plid);
-    } else {
-        _file_id = H5Fopen(fn, H5F_ACC_RDONLY, H5P_DEFAULT);
     }
+    _file_id = H5Fopen(fn, H5F_ACC_RDONLY, plid);
+    H5Pclose(plid);
 
     if (_file_id < 0) {
         snprintf(str, FTI_BUFS, "Could not open FTI checkpoint file '%s'.", fn);
@@ -1505,8 +1643,8 @@ int FTI_RecoverVarHDF5(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
          FTI_Conf->h5SingleFilePrefix, FTI_Exec->ckptId);
     } else {
         if (data->size != data->sizeStored) {
-            snprintf(str, sizeof(str), "Cannot recover %d bytes to "
-                "protected variable (ID %d) size: %d",
+            snprintf(str, sizeof(str), "Cannot recover %ld bytes to "
+                "protected variable (ID %d) size: %ld",
                     data->sizeStored, data->id,
                     data->size);
             FTI_Print(str, FTI_WARN);
@@ -1774,6 +1912,111 @@ herr_t FTI_WriteSharedFileData(FTIT_dataset FTI_Data) {
     return FTI_SCES;
 }
 
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Writes one subset of a global dataset collectively.
+  @param      dataset         Global dataset.
+  @param      data            Variable of the subset, NULL for no subset.
+  @return     integer         FTI_SCES if successful.
+
+  All the ranks must call this function, those without a subset to write
+  take part in the collective write with an empty selection.
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_WriteSubset(FTIT_globalDataset* dataset, FTIT_dataset* data) {
+    char str[FTI_BUFS];
+    hid_t fsid = dataset->fileSpace;
+    hid_t msid = -1;
+    void* ptr = NULL;
+    int res = FTI_SCES;
+
+    if (data) {
+        msid = H5Screate_simple(dataset->rank, data->sharedData.count, NULL);
+        if (msid < 0 || H5Sselect_hyperslab(fsid, H5S_SELECT_SET,
+         data->sharedData.offset, NULL, data->sharedData.count, NULL) < 0) {
+            snprintf(str, FTI_BUFS, "Unable to select sub-space for var-id %d"
+             " in dataset #%d", data->id, dataset->id);
+            FTI_Print(str, FTI_EROR);
+            if (msid >= 0) {
+                H5Sclose(msid);
+            }
+            msid = -1;
+            res = FTI_NSCS;
+        } else {
+            ptr = data->ptr;
+        }
+    }
+    if (msid < 0) {
+        hsize_t one = 1;
+        msid = H5Screate_simple(1, &one, NULL);
+        H5Sselect_none(msid);
+        H5Sselect_none(fsid);
+    }
+
+    hid_t plid = H5Pcreate(H5P_DATASET_XFER);
+    H5Pset_dxpl_mpio(plid, H5FD_MPIO_COLLECTIVE);
+    if (H5Dwrite(dataset->hid, dataset->hdf5TypeId, msid, fsid, plid,
+     ptr) < 0) {
+        snprintf(str, FTI_BUFS, "Unable to write a subset of dataset #%d",
+         dataset->id);
+        FTI_Print(str, FTI_EROR);
+        res = FTI_NSCS;
+    }
+    H5Pclose(plid);
+    H5Sclose(msid);
+    return res;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Writes the subsets of all global datasets into the VPR file.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Data        Dataset metadata, NULL for a rank that failed.
+  @return     integer         FTI_SCES if successful.
+
+  The subsets go directly to the global datasets, in one pass. In round i,
+  every rank writes its i-th subset of the dataset, the ranks with fewer
+  subsets take part with an empty selection. A dataset is thus written in
+  as many collective calls as the largest number of subsets of a rank,
+  independently of the order in which the variables were protected. A rank
+  without dataset metadata writes nothing but still takes part in every
+  round, the checkpoint then fails on all ranks.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_WriteGlobalDatasets(FTIT_execution* FTI_Exec, FTIT_keymap* FTI_Data) {
+    char str[FTI_BUFS];
+    int res = (FTI_Data) ? FTI_SCES : FTI_NSCS, nbCalls = 0;
+
+    FTIT_globalDataset* dataset = FTI_Exec->globalDatasets;
+    while (dataset) {
+        int i, nbRounds = dataset->numSubSets;
+        MPI_Allreduce(MPI_IN_PLACE, &nbRounds, 1, MPI_INT, MPI_MAX,
+         FTI_COMM_WORLD);
+        for (i = 0; i < nbRounds; i++) {
+            FTIT_dataset* data = NULL;
+            if (i < dataset->numSubSets && FTI_Data && (FTI_Data->get(&data,
+             dataset->varId[i]) != FTI_SCES || data == NULL)) {
+                snprintf(str, FTI_BUFS, "Subset %d of dataset #%d is not a"
+                 " protected variable.", i, dataset->id);
+                FTI_Print(str, FTI_EROR);
+                data = NULL;
+                res = FTI_NSCS;
+            }
+            if (FTI_WriteSubset(dataset, data) != FTI_SCES) {
+                res = FTI_NSCS;
+            }
+        }
+        nbCalls += nbRounds;
+        dataset = dataset->next;
+    }
+
+    MPI_Allreduce(MPI_IN_PLACE, &res, 1, MPI_INT, MPI_MIN, FTI_COMM_WORLD);
+    snprintf(str, FTI_BUFS, "VPR datasets written in %d collective calls.",
+     nbCalls);
+    FTI_Print(str, FTI_DBUG);
+    return res;
+}
+
 /*-------------------------------------------------------------------------*/
 /**
   @brief      returns rank of global dataset.
@@ -2008,18 +2251,80 @@ void FTI_FreeVPRMem(FTIT_execution* FTI_Exec, FTIT_keymap* FTI_Data) {
     }
 }
 
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Computes the chunk of a global dataset from its subsets.
+  @param      dataset         Global dataset.
+  @param      FTI_Data        Dataset metadata.
+  @param      chunk           Chunk dimensions (out).
+  @return     bool            True if the dataset should be chunked.
+
+  Collective. The dataset is chunked if all subsets of all ranks have the
+  same dimensions, each chunk is then written by a single rank. A chunk
+  covering the whole dataset or larger than the 4 GB limit of HDF5 keeps
+  the contiguous layout.
+ **/
+/*-------------------------------------------------------------------------*/
+static bool FTI_SubsetChunk(FTIT_globalDataset* dataset,
+ FTIT_keymap* FTI_Data, hsize_t* chunk) {
+    int i, j, n = dataset->rank;
+    // minimum and, as UINT64_MAX - count, maximum count of each dimension
+    uint64_t* range = talloc(uint64_t, 2 * n);
+    for (j = 0; j < 2 * n; j++) {
+        range[j] = UINT64_MAX;
+    }
+    for (i = 0; i < dataset->numSubSets; i++) {
+        FTIT_dataset* data;
+        if (FTI_Data->get(&data, dataset->varId[i]) != FTI_SCES ||
+         data == NULL) {
+            range[0] = 0;
+            break;
+        }
+        for (j = 0; j < n; j++) {
+            uint64_t c = data->sharedData.count[j];
+            range[j] = (c < range[j]) ? c : range[j];
+            range[n + j] = (UINT64_MAX - c < range[n + j]) ?
+             UINT64_MAX - c : range[n + j];
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, range, 2 * n, MPI_UINT64_T, MPI_MIN,
+     FTI_COMM_WORLD);
+
+    bool uniform = true, whole = true;
+    for (j = 0; j < n && uniform; j++) {
+        uniform = range[j] > 0 && range[j] == UINT64_MAX - range[n + j] &&
+         range[j] <= dataset->dimension[j];
+        whole = whole && range[j] == dataset->dimension[j];
+        chunk[j] = range[j];
+    }
+    free(range);
+    if (!uniform || whole) {
+        return false;
+    }
+    uint64_t bytes = dataset->type->size;
+    for (j = 0; j < n; j++) {
+        bytes *= chunk[j];
+    }
+    return bytes < ((uint64_t) 1 << 32);
+}
+
 /*-------------------------------------------------------------------------*/
 /**
   @brief      It creates the global dataset in the VPR file.
+  @param      FTI_Conf        Configuration metadata.
   @param      FTI_Exec        Execution metadata.
+  @param      FTI_Data        Dataset metadata.
   @return     integer         FTI_SCES if successful.
 
   Creates global dataset (shared among all ranks) in VPR file. The dataset
   position will be the group assigned to it by calling the FTI API function 
-  'FTI_DefineGlobalDataset'.
+  'FTI_DefineGlobalDataset'. With 'h5_single_file_chunk', the datasets
+  made of subsets of the same dimensions are chunked along the subsets.
  **/
 /*-------------------------------------------------------------------------*/
-int FTI_CreateGlobalDatasets(FTIT_execution* FTI_Exec) {
+int FTI_CreateGlobalDatasets(FTIT_configuration* FTI_Conf,
+ FTIT_execution* FTI_Exec, FTIT_keymap* FTI_Data) {
+    char str[FTI_BUFS];
     FTIT_globalDataset* dataset = FTI_Exec->globalDatasets;
     while (dataset) {
         // create file space
@@ -2043,10 +2348,15 @@ int FTI_CreateGlobalDatasets(FTIT_execution* FTI_Exec) {
         // FLETCHER CHECKSUM NOT SUPPORTED FOR PARALLEL I/O IN HDF5
         hid_t plid = H5Pcreate(H5P_DATASET_CREATE);
         // H5Pset_fletcher32 (dcpl);
-        //
-        // hsize_t *chunk = malloc(sizeof(hsize_t) * dataset->rank);
-        // chunk[0] = chunk[1] = 4096;
-        // H5Pset_chunk (dcpl, 2, chunk);
+        hsize_t* chunk = talloc(hsize_t, dataset->rank);
+        if (FTI_Conf->h5SingleFileChunk &&
+         FTI_SubsetChunk(dataset, FTI_Data, chunk)) {
+            H5Pset_chunk(plid, dataset->rank, chunk);
+            snprintf(str, FTI_BUFS, "VPR dataset #%d is chunked by subsets.",
+             dataset->id);
+            FTI_Print(str, FTI_DBUG);
+        }
+        free(chunk);
 
         dataset->hid = H5Dcreate(loc, dataset->name, tid, fsid, H5P_DEFAULT,
          plid, H5P_DEFAULT);
@@ -2397,6 +2707,7 @@ int FTI_FlushH5SingleFile(FTIT_execution* FTI_Exec,
  FTIT_configuration* FTI_Conf, FTIT_topology* FTI_Topo) {
     char fn[FTI_BUFS], tmpfn[FTI_BUFS], lfn[FTI_BUFS];
     hid_t fid, lfid;
+    double t0 = MPI_Wtime();
     snprintf(tmpfn, FTI_BUFS, "%s/%s-ID%08d.h5", FTI_Conf->gTmpDir,
      FTI_Conf->h5SingleFilePrefix, FTI_Exec->ckptMeta.ckptId);
     snprintf(fn, FTI_BUFS, "%s/%s-ID%08d.h5", FTI_Conf->h5SingleFileDir,
@@ -2406,14 +2717,11 @@ int FTI_FlushH5SingleFile(FTIT_execution* FTI_Exec,
     }
     MPI_Barrier(FTI_COMM_WORLD);
 
-    // NO IMPROVEMENT IN PERFORMANCE OBSERVED USING HINTS HERE
-    MPI_Info info;
-    MPI_Info_create(&info);
-    MPI_Info_set(info, "romio_cb_write", "enable");
-    MPI_Info_set(info, "stripping_unit", "4194304");
+    MPI_Info info = FTI_H5SingleFileInfo(FTI_Conf);
     hid_t plid = H5Pcreate(H5P_FILE_ACCESS);
     H5Pset_fapl_mpio(plid, FTI_COMM_WORLD, info);
     fid = H5Fcreate(tmpfn, H5F_ACC_TRUNC, H5P_DEFAULT, plid);
+    MPI_Info_free(&info);
     if (fid < 0) {
         char errstr[FTI_BUFS];
         snprintf(errstr, FTI_BUFS, "Unable to create '%s'", tmpfn);
@@ -2442,6 +2750,11 @@ int FTI_FlushH5SingleFile(FTIT_execution* FTI_Exec,
 
     H5Fclose(fid);
 
+    char str[FTI_BUFS];
+    snprintf(str, FTI_BUFS, "Ckpt. ID %d merged into the VPR file in %.2f sec.",
+     FTI_Exec->ckptMeta.ckptId, MPI_Wtime() - t0);
+    FTI_Print(str, FTI_INFO);
+
     if (FTI_Topo->splitRank == 0) {
         int status = rename(tmpfn, fn);
         remove(FTI_Conf->gTmpDir);
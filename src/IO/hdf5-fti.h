@@ -28,8 +28,9 @@ int FTI_RecoverVarFinalizeHDF5(FTIT_configuration* FTI_Conf,
 int FTI_ReadHDF5Var(FTIT_dataset *data);
 int FTI_GetDatasetRankReco(hid_t did);
 int FTI_GetDatasetSpanReco(hid_t did, hsize_t * span);
-int FTI_WriteHDF5Var(FTIT_dataset *data, FTIT_execution* FTI_Exec);
-int FTI_CheckHDF5File(char* fn, int32_t fs, char* checksum);
+int FTI_WriteHDF5Var(FTIT_dataset *data, FTIT_configuration* FTI_Conf,
+ FTIT_execution* FTI_Exec);
+int FTI_CheckHDF5File(char* fn, int64_t fs, char* checksum);
 int FTI_OpenGlobalDatasets(FTIT_execution* FTI_Exec);
 herr_t FTI_ReadSharedFileData(FTIT_dataset FTI_Data);
 int FTI_H5CheckSingleFile(FTIT_configuration* FTI_Conf, int * ckptID);
@@ -37,6 +38,7 @@ int FTI_ScanGroup(hid_t gid, char* fn);
 int FTI_CheckDimensions(FTIT_keymap * FTI_Data, FTIT_execution * FTI_Exec);
 void FTI_FreeVPRMem(FTIT_execution* FTI_Exec, FTIT_keymap* FTI_Data);
 herr_t FTI_WriteSharedFileData(FTIT_dataset FTI_Data);
+int FTI_WriteGlobalDatasets(FTIT_execution* FTI_Exec, FTIT_keymap* FTI_Data);
 void FTI_CreateComplexType(FTIT_Datatype* ftiType);
 void FTI_CloseComplexType(FTIT_Datatype* ftiType);
 void FTI_CreateGroup(FTIT_H5Group* ftiGroup, hid_t parentGroup,
@@ -44,7 +46,8 @@ void FTI_CreateGroup(FTIT_H5Group* ftiGroup, hid_t parentGroup,
 void FTI_OpenGroup(FTIT_H5Group* ftiGroup, hid_t parentGroup,
  FTIT_H5Group** FTI_Group);
 void FTI_CloseGroup(FTIT_H5Group* ftiGroup, FTIT_H5Group** FTI_Group);
-int FTI_CreateGlobalDatasets(FTIT_execution* FTI_Exec);
+int FTI_CreateGlobalDatasets(FTIT_configuration* FTI_Conf,
+ FTIT_execution* FTI_Exec, FTIT_keymap* FTI_Data);
 int FTI_CreateGlobalDatasetsAsGroups(FTIT_execution* FTI_Exec);
 int FTI_CloseGlobalDatasets(FTIT_execution* FTI_Exec);
 int FTI_CloseGlobalDatasetsAsGroups(FTIT_execution* FTI_Exec);
@@ -73,7 +73,7 @@ int FTI_IMEOpen(char *fn, void *fileDesc) {
         FTI_Print(str, FTI_EROR);
         return FTI_NSCS;
     }
-    MD5_Init(&(fd->integrity));
+    FTI_IntegrityInit(&(fd->integrity));
     return FTI_SCES;
 }
 
@@ -115,7 +115,7 @@ int FTI_IMEWrite(void *src, size_t size, void *fileDesc) {
         fwrite_errno = errno;
     }
 
-    MD5_Update(&(fd->integrity), src, size);
+    FTI_IntegrityUpdate(&(fd->integrity), src, size);
 /* KC FIXME *
     if (ferror(fd->f)){
         char error_msg[FTI_BUFS];
@@ -243,7 +243,6 @@ int FTI_WriteIMEData(FTIT_dataset * FTI_DataVar, void *fd) {
             snprintf(str, FTI_BUFS, "Dataset #%d could not be written.",
              FTI_DataVar->id);
             FTI_Print(str, FTI_EROR);
-            FTI_IMEClose(write_info);
             return FTI_NSCS;
         }
     }
@@ -258,7 +257,6 @@ int FTI_WriteIMEData(FTIT_dataset * FTI_DataVar, void *fd) {
             snprintf(str, FTI_BUFS, "Dataset #%d could not be written.",
              FTI_DataVar->id);
             FTI_Print(str, FTI_EROR);
-            FTI_IMEClose(write_info);
             return FTI_NSCS;
         }
     }
@@ -275,7 +273,7 @@ int FTI_WriteIMEData(FTIT_dataset * FTI_DataVar, void *fd) {
 
  **/
 /*-------------------------------------------------------------------------*/
-void FTI_IMEMD5(unsigned char *dest, void *md5) {
+void FTI_IMEMD5(char *dest, void *md5) {
     WriteIMEInfo_t *write_info = (WriteIMEInfo_t *) md5;
-    MD5_Final(dest, &(write_info->integrity));
+    FTI_IntegrityFinal(&(write_info->integrity), dest);
 }
@@ -11,7 +11,7 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
-void FTI_IMEMD5(unsigned char *dest, void *md5);
+void FTI_IMEMD5(char *dest, void *md5);
 int FTI_WriteIMEData(FTIT_dataset * FTI_DataVar, void *fd);
 void* FTI_InitIME(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
  FTIT_topology* FTI_Topo, FTIT_checkpoint *FTI_Ckpt, FTIT_dataset *FTI_Data);
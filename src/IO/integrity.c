@@ -0,0 +1,319 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  FTI - A multi-level checkpointing library for C/C++/Fortran applications
+ *
+ *  Revision 1.0 : Fault Tolerance Interface (FTI)
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *  list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors
+ *  may be used to endorse or promote products derived from this software without
+ *  specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *  @file   integrity.c
+ *  @date   October, 2026
+ *  @brief  Integrity digests of the checkpoint files.
+ *
+ *  The checksum of a checkpoint file is either the MD5 of the whole file
+ *  or a tree hash. The tree hash cuts the file in chunks of
+ *  'integrity_chunk' bytes, at fixed file offsets. The CRC32C of the
+ *  complete chunks of a write are computed at once by the threads of the
+ *  hashing engine, and the root digest is the MD5 of the chunk CRCs and
+ *  of the file size. The checksum fits in the MD5 checksum fields of the
+ *  metadata, it is tagged with the version of the scheme and the chunk
+ *  size, which no MD5 hex-string starts with:
+ *
+ *      "t1" | log2(chunk size) in 2 hex digits | 112 bits of the root
+ *
+ *  A checksum is always verified with the scheme it was computed with.
+ */
+
+#include "../interface.h"
+#include "integrity.h"
+
+/** Tag of the tree hash checksums, version 1. */
+#define FTI_INTEGRITY_TAG "t1"
+
+/** Bytes of the root digest kept in the checksum. */
+#define FTI_INTEGRITY_ROOT 14
+
+/** Largest read hashed at once when a file is verified. */
+#define FTI_INTEGRITY_MAX_BATCH (64*1024*1024)
+
+/** Integrity settings of the configuration file. */
+static struct {
+    int scheme;                 /**< Scheme of the new checksums.         */
+    int chunkLog;               /**< Log2 of the tree hash chunk size.    */
+} integrityConf = { FTI_INTEGRITY_MD5, 20 };
+
+/** Chunks hashed by the threads of the hashing engine. */
+typedef struct FTIT_integrityJob {
+    const unsigned char* src;   /**< First complete chunk.                */
+    uint32_t* crc;              /**< CRC32C of every chunk.               */
+    uint64_t chunkSize;         /**< Size of a chunk.                     */
+} FTIT_integrityJob;
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Sets the integrity scheme of the new checksums.
+  @param      FTI_Conf        Configuration metadata.
+  @return     integer         FTI_SCES if successful.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_InitIntegrity(FTIT_configuration* FTI_Conf) {
+    integrityConf.scheme = FTI_Conf->integrity;
+    integrityConf.chunkLog = 0;
+    while ((1LL << integrityConf.chunkLog) < FTI_Conf->integrityChunk) {
+        integrityConf.chunkLog++;
+    }
+    return FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Starts a digest with the configured scheme.
+  @param      ctx             Digest to start.
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_IntegrityInit(FTIT_integrity* ctx) {
+    memset(ctx, 0, sizeof(FTIT_integrity));
+    ctx->scheme = integrityConf.scheme;
+    ctx->chunkLog = integrityConf.chunkLog;
+    if (ctx->scheme == FTI_INTEGRITY_MD5) {
+        MD5_Init(&ctx->md5);
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Starts a digest to verify a checksum.
+  @param      ctx             Digest to start.
+  @param      checksum        Checksum to verify.
+  @return     integer         Scheme of the checksum.
+
+  The digest uses the scheme and the chunk size of the checksum, which
+  may differ from the configured ones.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_IntegrityInitFor(FTIT_integrity* ctx, const char* checksum) {
+    unsigned int chunkLog;
+    memset(ctx, 0, sizeof(FTIT_integrity));
+    if (strncmp(checksum, FTI_INTEGRITY_TAG, 2) == 0 &&
+     sscanf(checksum + 2, "%2x", &chunkLog) == 1 &&
+     chunkLog >= 12 && chunkLog <= 26) {
+        ctx->scheme = FTI_INTEGRITY_TREE;
+        ctx->chunkLog = chunkLog;
+    } else {
+        ctx->scheme = FTI_INTEGRITY_MD5;
+        MD5_Init(&ctx->md5);
+    }
+    return ctx->scheme;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Computes the CRC32C of the chunks of [first,last).
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_IntegrityChunks(void* ctx, int64_t first, int64_t last) {
+    FTIT_integrityJob* job = (FTIT_integrityJob*) ctx;
+    int64_t k;
+    for (k = first; k < last; k++) {
+        job->crc[k] = FTI_Crc32c(0, job->src + k * job->chunkSize,
+         job->chunkSize);
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Adds the CRC32C of complete chunks to the chunk list.
+  @param      ctx             Digest.
+  @param      n               Number of chunks to add.
+  @return     uint32_t*       First new entry, NULL if the list cannot grow.
+ **/
+/*-------------------------------------------------------------------------*/
+static uint32_t* FTI_IntegrityGrow(FTIT_integrity* ctx, int64_t n) {
+    int64_t nbChunks = ctx->size >> ctx->chunkLog;
+    if (nbChunks + n > ctx->capacity) {
+        int64_t capacity = 2 * ctx->capacity;
+        if (capacity < nbChunks + n) {
+            capacity = nbChunks + n + 64;
+        }
+        uint32_t* chunks = realloc(ctx->chunks, capacity * sizeof(uint32_t));
+        if (chunks == NULL) {
+            FTI_Print("Cannot allocate the chunk digests of the checksum.",
+             FTI_EROR);
+            ctx->failed = 1;
+            return NULL;
+        }
+        ctx->chunks = chunks;
+        ctx->capacity = capacity;
+    }
+    return ctx->chunks + nbChunks;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Adds data to a digest.
+  @param      ctx             Digest.
+  @param      d               Data following the data already hashed.
+  @param      n               Number of bytes.
+
+  With the tree hash, the current chunk is completed first, the complete
+  chunks of the data are then hashed in parallel and the rest starts the
+  next chunk.
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_IntegrityUpdate(FTIT_integrity* ctx, const void* d, uint64_t n) {
+    if (ctx->scheme == FTI_INTEGRITY_MD5) {
+        MD5_Update(&ctx->md5, d, n);
+        return;
+    }
+    if (ctx->failed) {
+        return;
+    }
+
+    const unsigned char* src = (const unsigned char*) d;
+    uint64_t chunkSize = 1ULL << ctx->chunkLog;
+    uint64_t pos = ctx->size & (chunkSize - 1);
+    if (pos > 0) {
+        uint64_t m = (n < chunkSize - pos) ? n : chunkSize - pos;
+        ctx->crc = FTI_Crc32c(ctx->crc, src, m);
+        src += m;
+        n -= m;
+        if (pos + m == chunkSize) {
+            uint32_t* crc = FTI_IntegrityGrow(ctx, 1);
+            if (crc == NULL) {
+                return;
+            }
+            *crc = ctx->crc;
+            ctx->crc = 0;
+        }
+        ctx->size += m;
+    }
+
+    int64_t nbChunks = n >> ctx->chunkLog;
+    if (nbChunks > 0) {
+        FTIT_integrityJob job;
+        job.src = src;
+        job.crc = FTI_IntegrityGrow(ctx, nbChunks);
+        job.chunkSize = chunkSize;
+        if (job.crc == NULL) {
+            return;
+        }
+        FTI_HashParallel(FTI_IntegrityChunks, &job, nbChunks,
+         FTI_POOL_INTEGRITY);
+        src += nbChunks * chunkSize;
+        n -= nbChunks * chunkSize;
+        ctx->size += nbChunks * chunkSize;
+    }
+
+    if (n > 0) {
+        ctx->crc = FTI_Crc32c(0, src, n);
+        ctx->size += n;
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Completes a digest.
+  @param      ctx             Digest.
+  @param      checksum        Checksum hex-string, MD5_DIGEST_STRING_LENGTH
+                              bytes.
+
+  The checksum is empty if the digest failed.
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_IntegrityFinal(FTIT_integrity* ctx, char* checksum) {
+    unsigned char hash[MD5_DIGEST_LENGTH];
+    int i, nbBytes = MD5_DIGEST_LENGTH;
+    char* hex = checksum;
+
+    if (ctx->scheme == FTI_INTEGRITY_TREE) {
+        int64_t nbChunks = ctx->size >> ctx->chunkLog;
+        if ((ctx->size & ((1ULL << ctx->chunkLog) - 1)) && !ctx->failed) {
+            uint32_t* crc = FTI_IntegrityGrow(ctx, 1);
+            if (crc != NULL) {
+                *crc = ctx->crc;
+                nbChunks++;
+            }
+        }
+        if (ctx->failed) {
+            free(ctx->chunks);
+            ctx->chunks = NULL;
+            checksum[0] = '\0';
+            return;
+        }
+        // the chunk CRCs and the size are hashed little-endian
+        MD5_CTX root;
+        unsigned char le[8];
+        MD5_Init(&root);
+        for (i = 0; i < nbChunks; i++) {
+            uint32_t crc = ctx->chunks[i];
+            le[0] = crc; le[1] = crc >> 8; le[2] = crc >> 16; le[3] = crc >> 24;
+            MD5_Update(&root, le, 4);
+        }
+        for (i = 0; i < 8; i++) {
+            le[i] = ctx->size >> (8 * i);
+        }
+        MD5_Update(&root, le, 8);
+        MD5_Final(hash, &root);
+        free(ctx->chunks);
+        ctx->chunks = NULL;
+
+        snprintf(hex, MD5_DIGEST_STRING_LENGTH, "%s%02x", FTI_INTEGRITY_TAG,
+         ctx->chunkLog);
+        hex += 4;
+        nbBytes = FTI_INTEGRITY_ROOT;
+    } else {
+        MD5_Final(hash, &ctx->md5);
+    }
+
+    for (i = 0; i < nbBytes; i++) {
+        snprintf(hex + 2 * i, 3, "%02x", hash[i]);
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Returns the size of the reads worth hashing at once.
+  @param      ctx             Digest.
+  @return     uint64_t        Size of a read.
+
+  A read holds several chunks per hashing thread with the tree hash.
+ **/
+/*-------------------------------------------------------------------------*/
+uint64_t FTI_IntegrityBatch(const FTIT_integrity* ctx) {
+    uint64_t batch = CHUNK_SIZE;
+    if (ctx->scheme == FTI_INTEGRITY_TREE) {
+        batch = (4ULL * FTI_HashEngineThreads(FTI_POOL_INTEGRITY)) <<
+         ctx->chunkLog;
+        if (batch > FTI_INTEGRITY_MAX_BATCH) {
+            batch = FTI_INTEGRITY_MAX_BATCH;
+        }
+        if (batch < (1ULL << ctx->chunkLog)) {
+            batch = 1ULL << ctx->chunkLog;
+        }
+    }
+    return batch;
+}
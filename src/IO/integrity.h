@@ -0,0 +1,37 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  @file   integrity.h
+ */
+
+#ifndef FTI_SRC_IO_INTEGRITY_H_
+#define FTI_SRC_IO_INTEGRITY_H_
+
+#include <stdint.h>
+
+#include "../deps/md5/md5.h"
+
+#define FTI_INTEGRITY_MD5 0     /**< MD5 of the whole file.               */
+#define FTI_INTEGRITY_TREE 1    /**< Tree hash of CRC32C chunk digests.   */
+
+/** Running digest of a checkpoint file. */
+typedef struct FTIT_integrity {
+    int scheme;                 /**< FTI_INTEGRITY_MD5 or _TREE.          */
+    MD5_CTX md5;                /**< MD5 context of the MD5 scheme.       */
+    int chunkLog;               /**< Log2 of the tree hash chunk size.    */
+    uint64_t size;              /**< Bytes hashed so far.                 */
+    uint32_t crc;               /**< CRC32C of the current chunk.         */
+    uint32_t* chunks;           /**< CRC32C of the complete chunks.       */
+    int64_t capacity;           /**< Allocated entries of 'chunks'.       */
+    int failed;                 /**< Set if the chunk list cannot grow.   */
+} FTIT_integrity;
+
+int FTI_InitIntegrity(FTIT_configuration* FTI_Conf);
+void FTI_IntegrityInit(FTIT_integrity* ctx);
+int FTI_IntegrityInitFor(FTIT_integrity* ctx, const char* checksum);
+void FTI_IntegrityUpdate(FTIT_integrity* ctx, const void* d, uint64_t n);
+void FTI_IntegrityFinal(FTIT_integrity* ctx, char* checksum);
+uint64_t FTI_IntegrityBatch(const FTIT_integrity* ctx);
+
+#endif  // FTI_SRC_IO_INTEGRITY_H_
@@ -38,6 +38,9 @@
 
 #include "../interface.h"
 
+/** Largest collective write, MPI counts are 'int'                        */
+#define FTI_MPIO_ROUND (1 << 30)
+
 /*-------------------------------------------------------------------------*/
 /**
   @brief      Opens and file (Only for write).
@@ -124,19 +127,15 @@ int FTI_MPIOClose(void *fileDesc) {
 /*-------------------------------------------------------------------------*/
 int FTI_MPIOWrite(void *src, size_t size, void *fileDesc) {
     WriteMPIInfo_t *fd = (WriteMPIInfo_t *)fileDesc;
+    // MPI counts are 'int', write in chunks of at most 'transferSize'
     size_t pos = 0;
     size_t bSize = fd->FTI_Conf->transferSize;
     while (pos < size) {
         if ((size - pos) < fd->FTI_Conf->transferSize) {
             bSize = size - pos;
         }
-
-        MPI_Datatype dType;
-        MPI_Type_contiguous(bSize, MPI_BYTE, &dType);
-        MPI_Type_commit(&dType);
-
-        fd->err = MPI_File_write_at(fd->pfh, fd->offset, src, 1, dType,
-         MPI_STATUS_IGNORE);
+        fd->err = MPI_File_write_at(fd->pfh, fd->offset, (char*)src + pos,
+         (int)bSize, MPI_BYTE, MPI_STATUS_IGNORE);
         // check if successful
         if (fd->err != 0) {
             errno = 0;
@@ -148,15 +147,107 @@ int FTI_MPIOWrite(void *src, size_t size, void *fileDesc) {
             FTI_Print(str, FTI_EROR);
             return FTI_NSCS;
         }
-        MPI_Type_free(&dType);
-        src += bSize;
         fd->offset += bSize;
         pos = pos + bSize;
     }
     return FTI_SCES;
 }
 
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Writes the pending datasets with collective calls.
+  @param      fd              The file descriptor.
+  @return     integer         FTI_SCES if successful.
+
+  Every call writes the next FTI_MPIO_ROUND bytes of the rank, described
+  by one datatype indexing the memory of the datasets. The ranks make the
+  same number of calls, ranks with less data write nothing in the last
+  ones. The data is contiguous in the file, at the offset of the rank.
+
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_MPIOWriteAll(WriteMPIInfo_t *fd) {
+    char str[FTI_BUFS];
+    int64_t total = 0;
+    int i, r;
+    for (i = 0; i < fd->nbIov; i++) {
+        total += fd->iov[i].iov_len;
+    }
+    int rounds = (total + FTI_MPIO_ROUND - 1) / FTI_MPIO_ROUND;
+    MPI_Allreduce(MPI_IN_PLACE, &rounds, 1, MPI_INT, MPI_MAX, FTI_COMM_WORLD);
+
+    // a round takes at most one piece of every dataset
+    int *lens = talloc(int, fd->nbIov + 1);
+    MPI_Aint *addrs = talloc(MPI_Aint, fd->nbIov + 1);
+    MPI_Offset pos = fd->offset;
+    size_t skip = 0;
+    int err = MPI_SUCCESS;
+    i = 0;
+    for (r = 0; r < rounds; r++) {
+        size_t left = FTI_MPIO_ROUND;
+        int n = 0;
+        while (i < fd->nbIov && left > 0) {
+            size_t len = fd->iov[i].iov_len - skip;
+            len = (len < left) ? len : left;
+            if (len > 0) {
+                MPI_Get_address((char*)fd->iov[i].iov_base + skip, &addrs[n]);
+                lens[n++] = (int)len;
+            }
+            left -= len;
+            skip += len;
+            if (skip == fd->iov[i].iov_len) {
+                skip = 0;
+                i++;
+            }
+        }
+        MPI_Datatype type;
+        MPI_Type_create_hindexed(n, lens, addrs, MPI_BYTE, &type);
+        MPI_Type_commit(&type);
+        int res = MPI_File_write_at_all(fd->pfh, pos, MPI_BOTTOM,
+         (n > 0) ? 1 : 0, type, MPI_STATUS_IGNORE);
+        MPI_Type_free(&type);
+        // keep calling on error, the other ranks wait for us
+        if (res != MPI_SUCCESS && err == MPI_SUCCESS) {
+            err = res;
+        }
+        pos += FTI_MPIO_ROUND - left;
+    }
+    free(lens);
+    free(addrs);
+
+    if (err != MPI_SUCCESS) {
+        int reslen;
+        char mpi_err[FTI_BUFS];
+        MPI_Error_string(err, mpi_err, &reslen);
+        snprintf(str, FTI_BUFS, "unable to write the checkpoint file "
+         "[MPI ERROR - %i] %s", err, mpi_err);
+        FTI_Print(str, FTI_EROR);
+        return FTI_NSCS;
+    }
+    snprintf(str, FTI_BUFS, "MPI-IO checkpoint written in %d collective "
+     "calls.", rounds);
+    FTI_Print(str, FTI_DBUG);
+    return FTI_SCES;
+}
 
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Writes the pending datasets and closes the checkpoint file.
+  @param      fileDesc        The file descriptor.
+  @return     integer         FTI_SCES if successful.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_MPIOCkptClose(void *fileDesc) {
+    WriteMPIInfo_t *fd = (WriteMPIInfo_t*) fileDesc;
+    int res = FTI_SCES;
+    if (fd->collective) {
+        res = FTI_MPIOWriteAll(fd);
+    }
+    free(fd->iov);
+    fd->iov = NULL;
+    FTI_MPIOClose(fd);
+    return res;
+}
 
 /*-------------------------------------------------------------------------*/
 /**
@@ -183,8 +274,19 @@ size_t FTI_GetMPIOFilePos(void *fileDesc) {
 /*-------------------------------------------------------------------------*/
 int FTI_MPIORead(void *dest, size_t size, void *fileDesc) {
     WriteMPIInfo_t *fd = (WriteMPIInfo_t *)fileDesc;
-    return MPI_File_read_at(fd->pfh, fd->offset, dest, size, MPI_BYTE,
-     MPI_STATUS_IGNORE);
+    // MPI counts are 'int', read in chunks of at most 'transferSize'
+    size_t pos = 0;
+    size_t bSize = fd->FTI_Conf->transferSize;
+    int res = MPI_SUCCESS;
+    while (pos < size && res == MPI_SUCCESS) {
+        if ((size - pos) < fd->FTI_Conf->transferSize) {
+            bSize = size - pos;
+        }
+        res = MPI_File_read_at(fd->pfh, fd->offset + pos, (char*)dest + pos,
+         (int)bSize, MPI_BYTE, MPI_STATUS_IGNORE);
+        pos += bSize;
+    }
+    return res;
 }
 
 
@@ -213,6 +315,8 @@ void *FTI_InitMPIO(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     write_info->FTI_Topo = FTI_Topo;
     write_info->loffset = 0;
     write_info->flag = 'w';
+    write_info->iov = NULL;
+    write_info->nbIov = 0;
 
     FTI_Print("I/O mode: MPI-IO.", FTI_DBUG);
     snprintf(FTI_Exec->ckptMeta.ckptFile, FTI_BUFS, "Ckpt%d-Rank%d.fti",
@@ -221,19 +325,27 @@ void *FTI_InitMPIO(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     snprintf(gfn, FTI_BUFS, "%s/%s", FTI_Conf->gTmpDir, ckptFile);
     FTI_MPIOOpen(gfn, write_info);
 
-
-    // collect chunksizes of other ranks
-    MPI_Offset* chunkSizes = talloc(MPI_Offset,
-     FTI_Topo->nbApprocs * FTI_Topo->nbNodes);
-    MPI_Allgather(&chunkSize, 1, MPI_OFFSET, chunkSizes, 1,
-     MPI_OFFSET, FTI_COMM_WORLD);
-
-    // set file offset
-    for (i = 0; i < FTI_Topo->splitRank; i++) {
-        offset += chunkSizes[i];
+    // the ranks write their chunks one after the other
+    MPI_Exscan(&chunkSize, &offset, 1, MPI_OFFSET, MPI_SUM, FTI_COMM_WORLD);
+    if (FTI_Topo->splitRank == 0) {
+        offset = 0;
     }
-    free(chunkSizes);
     write_info->offset = offset;
+
+    // the datasets of an iCP can change after they are added, and GPU
+    // data is staged through the host, these are written independently
+    int collective = FTI_Conf->mpiioCollective &&
+     FTI_Exec->iCPInfo.status == FTI_ICP_NINI;
+    FTIT_dataset* data;
+    if (collective &&
+     FTI_Data->data(&data, FTI_Exec->nbVar) == FTI_SCES) {
+        for (i = 0; i < FTI_Exec->nbVar; i++) {
+            collective = collective && !data[i].isDevicePtr;
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &collective, 1, MPI_INT, MPI_LAND,
+     FTI_COMM_WORLD);
+    write_info->collective = collective;
     return (void *) write_info;
 }
 
@@ -256,7 +368,18 @@ int FTI_WriteMPIOData(FTIT_dataset * data, void *fd) {
 
     char str[FTI_BUFS];
     int res;
-    if (!(data->isDevicePtr)) {
+    if (write_info->collective && !(data->isDevicePtr)) {
+        snprintf(str, FTI_BUFS, "Dataset #%d Queued for collective write.",
+         data->id);
+        FTI_Print(str, FTI_DBUG);
+        write_info->iov = realloc(write_info->iov,
+         sizeof(struct iovec) * (write_info->nbIov + 1));
+        write_info->iov[write_info->nbIov].iov_base = data->ptr;
+        write_info->iov[write_info->nbIov].iov_len = data->size;
+        write_info->nbIov++;
+        write_info->loffset += data->size;
+        return FTI_SCES;
+    } else if (!(data->isDevicePtr)) {
         snprintf(str, FTI_BUFS, "Dataset #%d Writing CPU Data.", data->id);
         FTI_Print(str, FTI_DBUG);
         res = FTI_MPIOWrite(data->ptr, data->size, write_info);
@@ -264,7 +387,6 @@ int FTI_WriteMPIOData(FTIT_dataset * data, void *fd) {
             snprintf(str, FTI_BUFS, "Dataset #%d could not be written.",
              data->id);
             FTI_Print(str, FTI_EROR);
-            FTI_MPIOClose(write_info);
             return res;
         }
     }
@@ -281,7 +403,6 @@ int FTI_WriteMPIOData(FTIT_dataset * data, void *fd) {
             snprintf(str, FTI_BUFS, "Dataset #%d could not be written.",
              data->id);
             FTI_Print(str, FTI_EROR);
-            FTI_MPIOClose(write_info);
             return res;
         }
     }
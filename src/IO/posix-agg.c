@@ -0,0 +1,529 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  FTI - A multi-level checkpointing library for C/C++/Fortran applications
+ *
+ *  Revision 1.0 : Fault Tolerance Interface (FTI)
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *  list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors
+ *  may be used to endorse or promote products derived from this software without
+ *  specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  @file   posix-agg.c
+ *  @date   October, 2026
+ *  @brief  Aggregated inline L4 checkpoints with POSIX I/O.
+ *
+ *  The application processes are split in aggregation groups of
+ *  'l4_aggregation' consecutive ranks. The data of the group is shipped to
+ *  the first rank of the group, which writes a single file to the PFS:
+ *
+ *      index | rank data[0] | ... | rank data[n-1]
+ *
+ *  The index and the data of every rank start at a multiple of
+ *  'l4_aggregation_align' bytes, so that the extents of different ranks
+ *  do not share stripes. The index is written last, a file without a
+ *  valid index is never used for recovery.
+ *
+ *  No rank holds its whole checkpoint in memory. The data is staged in two
+ *  buffers of 'transfer_size' bytes: the aggregator writes its own data to
+ *  the file as the buffer fills, the other ranks send every full buffer to
+ *  the aggregator while they fill the other one. A message shorter than
+ *  'transfer_size' ends the data of a rank. The aggregator receives the
+ *  ranks one after the other, the extent of a rank starts after the one of
+ *  the previous rank, so that compressed sizes need not be known in
+ *  advance. Synchronous sends keep the ranks from running ahead of it.
+ *
+ *  On restart, every rank looks up its extent in the index and copies it
+ *  to its local checkpoint file, which is then recovered as usual.
+ */
+
+#include "../interface.h"
+#include "posix-agg.h"
+
+#define FTI_AGG_MAGIC "FTIAGG01"
+
+/** Index of an aggregated file, followed by one entry per rank. */
+typedef struct FTIT_aggHeader {
+    char magic[8];              /**< FTI_AGG_MAGIC                        */
+    int32_t nbRanks;            /**< Number of entries                    */
+    int32_t reserved;
+    int64_t align;              /**< Alignment of the extents             */
+} FTIT_aggHeader;
+
+/** Extent of the checkpoint data of a rank in an aggregated file. */
+typedef struct FTIT_aggEntry {
+    int64_t rank;               /**< Rank in FTI_COMM_WORLD               */
+    int64_t offset;             /**< Position of the data in the file     */
+    int64_t size;               /**< Checkpoint file size of the rank     */
+} FTIT_aggEntry;
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Rounds a position up to the next multiple of the alignment.
+  @param      pos             Position in the file.
+  @param      align           Alignment in bytes.
+  @return     int64_t         The aligned position.
+ **/
+/*-------------------------------------------------------------------------*/
+static int64_t FTI_AggAlign(int64_t pos, int64_t align) {
+    return ((pos + align - 1) / align) * align;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Writes a buffer at a position of a file.
+  @param      fd              File descriptor.
+  @param      src             Data to write.
+  @param      size            Number of bytes to write.
+  @param      pos             Position in the file.
+  @return     integer         FTI_SCES if successful.
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_AggPwrite(int fd, const char* src, size_t size, int64_t pos) {
+    while (size > 0) {
+        ssize_t n = pwrite(fd, src, size, pos);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            char str[FTI_BUFS];
+            snprintf(str, FTI_BUFS, "Unable to write the aggregated file "
+             "[POSIX ERROR - %s.]", strerror(errno));
+            FTI_Print(str, FTI_EROR);
+            return FTI_NSCS;
+        }
+        src += n;
+        size -= n;
+        pos += n;
+    }
+    return FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Builds the name of the aggregated file of the rank.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Topo        Topology metadata.
+  @param      dir             Directory of the file.
+  @param      ckptId          Checkpoint ID.
+  @param      fn              Where to store the file name.
+  @return     void.
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_AggFileName(FTIT_configuration* FTI_Conf, FTIT_topology* FTI_Topo,
+ const char* dir, int ckptId, char* fn) {
+    snprintf(fn, FTI_BUFS, "%s/Ckpt%d-Agg%d.%s", dir, ckptId,
+     FTI_Topo->splitRank / FTI_Conf->l4Aggregation, FTI_Conf->suffix);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Returns the size of the index of an aggregation group.
+  @param      nbRanks         Number of ranks in the group.
+  @return     size_t          Size of the index in bytes.
+ **/
+/*-------------------------------------------------------------------------*/
+static size_t FTI_AggIndexSize(int nbRanks) {
+    return sizeof(FTIT_aggHeader) + nbRanks * sizeof(FTIT_aggEntry);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Initializes an aggregated checkpoint.
+  @param      FTI_Conf          Configuration of FTI
+  @param      FTI_Exec          Execution environment options
+  @param      FTI_Topo          Topology of nodes
+  @param      FTI_Ckpt          Checkpoint configurations
+  @param      FTI_Data          Data to be stored
+  @return     void*             Return void pointer to file descriptor
+
+  The aggregator creates the aggregated file, its own data starts right
+  after the index. A failure is only recorded here, the rank must still
+  take part in the exchange of its group.
+ **/
+/*-------------------------------------------------------------------------*/
+void* FTI_InitPosixAgg(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
+ FTIT_topology* FTI_Topo, FTIT_checkpoint *FTI_Ckpt, FTIT_keymap *FTI_Data) {
+    FTI_Print("I/O mode: Posix, aggregated.", FTI_DBUG);
+
+    WriteAggInfo_t *write_info = talloc(WriteAggInfo_t, 1);
+    write_info->FTI_Conf = FTI_Conf;
+    write_info->FTI_Exec = FTI_Exec;
+    write_info->FTI_Topo = FTI_Topo;
+    write_info->buf[0] = malloc(FTI_Conf->transferSize);
+    write_info->buf[1] = malloc(FTI_Conf->transferSize);
+    write_info->cur = 0;
+    write_info->fill = 0;
+    write_info->req = MPI_REQUEST_NULL;
+    write_info->file = -1;
+    write_info->base = 0;
+    write_info->size = 0;
+    write_info->failed = 0;
+    if (write_info->buf[0] == NULL || write_info->buf[1] == NULL) {
+        FTI_Print("Cannot allocate the aggregation buffers.", FTI_EROR);
+        write_info->failed = 1;
+    }
+    FTI_IntegrityInit(&(write_info->integrity));
+
+    int rank, nbRanks;
+    MPI_Comm_rank(FTI_Exec->aggComm, &rank);
+    MPI_Comm_size(FTI_Exec->aggComm, &nbRanks);
+    write_info->isAgg = (rank == 0);
+    if (write_info->isAgg) {
+        char fn[FTI_BUFS];
+        FTI_AggFileName(FTI_Conf, FTI_Topo, FTI_Conf->gTmpDir,
+         FTI_Exec->ckptMeta.ckptId, fn);
+        write_info->file = open(fn, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (write_info->file < 0) {
+            char str[FTI_BUFS];
+            snprintf(str, FTI_BUFS, "unable to create file %s "
+             "[POSIX ERROR - %d] %s", fn, errno, strerror(errno));
+            FTI_Print(str, FTI_EROR);
+            write_info->failed = 1;
+        }
+        write_info->base = FTI_AggAlign(FTI_AggIndexSize(nbRanks),
+         FTI_Conf->l4AggAlign);
+    }
+
+    // The file name is the one of a rank file, recovery restores it
+    snprintf(FTI_Exec->ckptMeta.ckptFile, FTI_BUFS, "Ckpt%d-Rank%d.%s",
+     FTI_Exec->ckptMeta.ckptId, FTI_Topo->myRank, FTI_Conf->suffix);
+    return write_info;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Empties the current staging buffer.
+  @param      fd                The fileDescriptor
+  @return     integer           FTI_SCES if successful.
+
+  The aggregator writes the buffer to its extent. The other ranks send it
+  to the aggregator and switch to the other buffer once its previous send
+  completed. The buffer is sent even if empty or after a failure, the
+  aggregator needs a short message to end the data of the rank.
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_AggFlush(WriteAggInfo_t* fd) {
+    FTIT_configuration* FTI_Conf = fd->FTI_Conf;
+    int res = FTI_SCES;
+    if (fd->isAgg) {
+        if (!fd->failed && fd->fill > 0) {
+            res = FTI_AggPwrite(fd->file, fd->buf[fd->cur], fd->fill,
+             fd->base + fd->size - fd->fill);
+        }
+    } else {
+        MPI_Wait(&(fd->req), MPI_STATUS_IGNORE);
+        MPI_Issend(fd->buf[fd->cur], fd->fill, MPI_BYTE, 0,
+         FTI_Conf->generalTag, fd->FTI_Exec->aggComm, &(fd->req));
+        fd->cur = 1 - fd->cur;
+    }
+    fd->fill = 0;
+    return res;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Appends data to the checkpoint data of the rank.
+  @param      src               pointer pointing to the data to be stored
+  @param      size              size of the data to be written
+  @param      fileDesc          The fileDescriptor
+  @return     integer           FTI_SCES if successful.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_PosixAggWrite(void *src, size_t size, void *fileDesc) {
+    WriteAggInfo_t *fd = (WriteAggInfo_t *) fileDesc;
+    size_t transfer = fd->FTI_Conf->transferSize;
+    if (fd->failed) {
+        return FTI_NSCS;
+    }
+    FTI_IntegrityUpdate(&(fd->integrity), src, size);
+    char* pos = (char*) src;
+    while (size > 0) {
+        size_t len = transfer - fd->fill;
+        if (len > size) {
+            len = size;
+        }
+        memcpy(fd->buf[fd->cur] + fd->fill, pos, len);
+        fd->fill += len;
+        fd->size += len;
+        pos += len;
+        size -= len;
+        if (fd->fill == transfer && FTI_AggFlush(fd) != FTI_SCES) {
+            fd->failed = 1;
+            return FTI_NSCS;
+        }
+    }
+    return FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Writes a dataset to the checkpoint data of the rank.
+  @param      data            Dataset to write.
+  @param      fd              The fileDescriptor
+  @return     integer         FTI_SCES.
+
+  A failure is only recorded here: the rank must still take part in the
+  exchange of its group, FTI_PosixAggClose reports it.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_WritePosixAggData(FTIT_dataset * data, void *fd) {
+    WriteAggInfo_t *write_info = (WriteAggInfo_t*) fd;
+    FTIT_compression comp;
+    int res = FTI_SCES;
+
+    if (!(data->isDevicePtr) && FTI_CompressionOf(data, &comp)) {
+        res = FTI_WriteCompressed(data, &comp, FTI_PosixAggWrite, write_info);
+    } else if (!(data->isDevicePtr)) {
+        res = FTI_PosixAggWrite(data->ptr, data->size, write_info);
+    }
+#ifdef GPUSUPPORT
+    else {
+        res = FTI_TransferDeviceMemToFileAsync(data, FTI_PosixAggWrite,
+         write_info);
+    }
+#endif
+    if (res != FTI_SCES) {
+        char str[FTI_BUFS];
+        snprintf(str, FTI_BUFS, "Dataset #%d could not be written.", data->id);
+        FTI_Print(str, FTI_EROR);
+        write_info->failed = 1;
+    }
+    return FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Returns the position in the checkpoint data of the rank.
+  @param      fileDesc          The fileDescriptor
+  @return     size_t            Position of the file descriptor
+ **/
+/*-------------------------------------------------------------------------*/
+size_t FTI_GetPosixAggFilePos(void *fileDesc) {
+    return ((WriteAggInfo_t *) fileDesc)->size;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Finalizes the checksum of the checkpoint data of the rank.
+  @param      dest            Where to store the checksum.
+  @param      md5             The fileDescriptor
+  @return     void.
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_PosixAggMD5(char *dest, void *md5) {
+    WriteAggInfo_t *write_info = (WriteAggInfo_t *) md5;
+    FTI_IntegrityFinal(&(write_info->integrity), dest);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Receives the data of the group and writes the aggregated file.
+  @param      fd              The fileDescriptor of the aggregator.
+  @param      ent             Index entries, filled with the extents.
+  @param      nbRanks         Number of ranks in the group.
+  @return     integer         FTI_SCES if successful.
+
+  The ranks are received in order, in the staging buffers of the
+  aggregator. The next piece is received while the current one is written.
+  After a write error the pieces are still received, so that the other
+  ranks of the group complete.
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_AggGather(WriteAggInfo_t* fd, FTIT_aggEntry* ent,
+ int nbRanks) {
+    FTIT_configuration* FTI_Conf = fd->FTI_Conf;
+    MPI_Comm comm = fd->FTI_Exec->aggComm;
+    int64_t align = FTI_Conf->l4AggAlign;
+    int transfer = FTI_Conf->transferSize;
+    int res = (fd->file >= 0 && !fd->failed) ? FTI_SCES : FTI_NSCS;
+    char* bounce[2] = { fd->buf[0], fd->buf[1] };
+    char* drain = NULL;
+    if (bounce[0] == NULL || bounce[1] == NULL) {
+        // The data of the group is dropped, it still has to be received
+        drain = talloc(char, transfer);
+        bounce[0] = drain;
+        bounce[1] = drain;
+    }
+
+    ent[0].offset = fd->base;
+    ent[0].size = fd->size;
+    MPI_Request req = MPI_REQUEST_NULL;
+    int m = 1, cur = 0;
+    if (m < nbRanks) {
+        ent[m].offset = FTI_AggAlign(ent[0].offset + ent[0].size, align);
+        ent[m].size = 0;
+        MPI_Irecv(bounce[cur], transfer, MPI_BYTE, m, FTI_Conf->generalTag,
+         comm, &req);
+    }
+    while (m < nbRanks) {
+        MPI_Status status;
+        int len;
+        MPI_Wait(&req, &status);
+        MPI_Get_count(&status, MPI_BYTE, &len);
+
+        int nm = (len < transfer) ? m + 1 : m;
+        if (nm < nbRanks) {
+            MPI_Irecv(bounce[1 - cur], transfer, MPI_BYTE, nm,
+             FTI_Conf->generalTag, comm, &req);
+        }
+        if (res == FTI_SCES && drain == NULL && len > 0) {
+            res = FTI_AggPwrite(fd->file, bounce[cur], len,
+             ent[m].offset + ent[m].size);
+        }
+        ent[m].size += len;
+        if (nm != m && nm < nbRanks) {
+            ent[nm].offset = FTI_AggAlign(ent[m].offset + ent[m].size, align);
+            ent[nm].size = 0;
+        }
+        m = nm;
+        cur = 1 - cur;
+    }
+    free(drain);
+    return res;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Completes the aggregated file of the group.
+  @param      fileDesc          The fileDescriptor
+  @return     integer           FTI_SCES if the whole group succeeded.
+
+  This function is collective over the aggregation group. The ranks send
+  the rest of their data, the aggregator then gathers their status and
+  writes the index. The result of the aggregated write is shared with the
+  group, so that every rank reports the same outcome.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_PosixAggClose(void *fileDesc) {
+    WriteAggInfo_t *fd = (WriteAggInfo_t *) fileDesc;
+    FTIT_configuration* FTI_Conf = fd->FTI_Conf;
+    FTIT_execution* FTI_Exec = fd->FTI_Exec;
+    MPI_Comm comm = FTI_Exec->aggComm;
+    int rank, nbRanks, res = FTI_SCES;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &nbRanks);
+
+    if (FTI_AggFlush(fd) != FTI_SCES) {
+        fd->failed = 1;
+    }
+    MPI_Wait(&(fd->req), MPI_STATUS_IGNORE);
+
+    FTIT_aggHeader* hdr = NULL;
+    size_t hdrSize = FTI_AggIndexSize(nbRanks);
+    if (rank == 0) {
+        hdr = (FTIT_aggHeader*) calloc(1, hdrSize);
+        memcpy(hdr->magic, FTI_AGG_MAGIC, sizeof(hdr->magic));
+        hdr->nbRanks = nbRanks;
+        hdr->align = FTI_Conf->l4AggAlign;
+        res = FTI_AggGather(fd, (FTIT_aggEntry*) (hdr + 1), nbRanks);
+    }
+
+    int64_t mine[2] = { fd->FTI_Topo->splitRank,
+     (fd->failed) ? -1 : (int64_t) fd->size };
+    int64_t* all = (rank == 0) ? talloc(int64_t, 2 * nbRanks) : NULL;
+    MPI_Gather(mine, 2, MPI_INT64_T, all, 2, MPI_INT64_T, 0, comm);
+
+    if (rank == 0) {
+        FTIT_aggEntry* ent = (FTIT_aggEntry*) (hdr + 1);
+        int i;
+        for (i = 0; i < nbRanks; i++) {
+            ent[i].rank = all[2 * i];
+            if (all[2 * i + 1] != ent[i].size) {
+                res = FTI_NSCS;
+            }
+        }
+        free(all);
+        // The index makes the file valid, it is written last
+        if (res == FTI_SCES) {
+            res = FTI_AggPwrite(fd->file, (char*) hdr, hdrSize, 0);
+        }
+        if (res == FTI_SCES && fsync(fd->file) != 0) {
+            FTI_Print("Unable to sync the aggregated file.", FTI_EROR);
+            res = FTI_NSCS;
+        }
+        if (fd->file >= 0) {
+            close(fd->file);
+        }
+        char fn[FTI_BUFS];
+        FTI_AggFileName(FTI_Conf, fd->FTI_Topo, FTI_Conf->gTmpDir,
+         FTI_Exec->ckptMeta.ckptId, fn);
+        if (res == FTI_SCES) {
+            char str[FTI_BUFS];
+            int64_t last = nbRanks - 1;
+            snprintf(str, FTI_BUFS, "L4 aggregated file %s: %d ranks, %ld "
+             "bytes.", fn, nbRanks, ent[last].offset + ent[last].size);
+            FTI_Print(str, FTI_DBUG);
+        } else if (fd->file >= 0) {
+            unlink(fn);
+        }
+    }
+    MPI_Bcast(&res, 1, MPI_INT, 0, comm);
+
+    free(hdr);
+    free(fd->buf[0]);
+    free(fd->buf[1]);
+    fd->buf[0] = NULL;
+    fd->buf[1] = NULL;
+    return res;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Looks up the extent of a rank in an aggregated file.
+  @param      fd              Descriptor of the aggregated file.
+  @param      rank            Rank in FTI_COMM_WORLD.
+  @param      offset          Where to store the position of the data.
+  @param      size            Where to store the size of the data.
+  @return     integer         FTI_SCES if the rank has a valid extent.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_AggFindExtent(int fd, int rank, int64_t* offset, int64_t* size) {
+    FTIT_aggHeader hdr;
+    if (pread(fd, &hdr, sizeof(hdr), 0) != sizeof(hdr) ||
+     memcmp(hdr.magic, FTI_AGG_MAGIC, sizeof(hdr.magic)) != 0 ||
+     hdr.nbRanks <= 0) {
+        FTI_Print("The aggregated file has no valid index.", FTI_WARN);
+        return FTI_NSCS;
+    }
+    size_t entSize = hdr.nbRanks * sizeof(FTIT_aggEntry);
+    FTIT_aggEntry* ent = talloc(FTIT_aggEntry, hdr.nbRanks);
+    int res = FTI_NSCS;
+    if (pread(fd, ent, entSize, sizeof(hdr)) == (ssize_t) entSize) {
+        int i;
+        for (i = 0; i < hdr.nbRanks; i++) {
+            if (ent[i].rank == rank && ent[i].size >= 0) {
+                *offset = ent[i].offset;
+                *size = ent[i].size;
+                res = FTI_SCES;
+            }
+        }
+    }
+    free(ent);
+    if (res != FTI_SCES) {
+        FTI_Print("The rank is not in the aggregated file.", FTI_WARN);
+    }
+    return res;
+}
@@ -0,0 +1,24 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  @file   posix-agg.h
+ */
+
+#ifndef FTI_SRC_IO_POSIX_AGG_H_
+#define FTI_SRC_IO_POSIX_AGG_H_
+
+#include <stdint.h>
+
+void* FTI_InitPosixAgg(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
+ FTIT_topology* FTI_Topo, FTIT_checkpoint *FTI_Ckpt, FTIT_keymap *FTI_Data);
+int FTI_WritePosixAggData(FTIT_dataset * data, void *fd);
+int FTI_PosixAggWrite(void *src, size_t size, void *fileDesc);
+size_t FTI_GetPosixAggFilePos(void *fileDesc);
+void FTI_PosixAggMD5(char *dest, void *md5);
+int FTI_PosixAggClose(void *fileDesc);
+void FTI_AggFileName(FTIT_configuration* FTI_Conf, FTIT_topology* FTI_Topo,
+ const char* dir, int ckptId, char* fn);
+int FTI_AggFindExtent(int fd, int rank, int64_t* offset, int64_t* size);
+
+#endif  // FTI_SRC_IO_POSIX_AGG_H_
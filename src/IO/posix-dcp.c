@@ -41,6 +41,8 @@
 #include "../api-cuda.h"
 #include "cuda-md5/md5Opt.h"
 
+#include <fcntl.h>
+
 
 
 /*-------------------------------------------------------------------------*/
@@ -84,8 +86,13 @@ void *FTI_InitDCPPosix(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     write_DCPinfo->FTI_Conf = FTI_Conf;
     write_DCPinfo->FTI_Ckpt = FTI_Ckpt;
     write_DCPinfo->FTI_Topo = FTI_Topo;
+    write_DCPinfo->FTI_Data = FTI_Data;
     write_DCPinfo->layerSize = 0;
+    write_DCPinfo->failed = 0;
 
+    // continue in the merged file if the layers were merged
+    FTI_DcpPosixCompactAdopt(FTI_Exec);
+    FTI_DirtyTrackValidate();
 
     FTI_Exec->dcpInfoPosix.dcpSize = 0;
     FTI_Exec->dcpInfoPosix.dataSize = 0;
@@ -129,8 +136,11 @@ void *FTI_InitDCPPosix(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         write_info->flag = 'a';
 
     FTI_PosixOpen(fn, write_info);
+    // the layer hash stays the MD5 of the data and of the block hashes
+    FTI_IntegrityInitFor(&write_info->integrity, "");
 
     if (dcpLayer == 0) FTI_Exec->dcpInfoPosix.FileSize = 0;
+    write_DCPinfo->layerStart = FTI_Exec->dcpInfoPosix.FileSize;
 
     // write constant meta data in the beginning of file
     // - blocksize
@@ -162,6 +172,26 @@ void *FTI_InitDCPPosix(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
 
 
 
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Writes a buffer to the dCP ckpt file.
+  @param      src               Data to write.
+  @param      size              Number of bytes to write.
+  @param      f                 The file, left open on error.
+  @return     integer           FTI_SCES if successful.
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_DcpFwrite(const void* src, size_t size, FILE* f) {
+    if (fwrite(src, size, 1, f) != 1 || ferror(f)) {
+        char str[FTI_BUFS];
+        snprintf(str, FTI_BUFS, "Unable to write the dCP file "
+         "[POSIX ERROR - %s.]", strerror(errno));
+        FTI_Print(str, FTI_EROR);
+        return FTI_NSCS;
+    }
+    return FTI_SCES;
+}
+
 /*-------------------------------------------------------------------------*/
 /**
   @brief      Writes dataset into dCP ckpt file using POSIX.
@@ -170,7 +200,7 @@ void *FTI_InitDCPPosix(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
   @return     integer           FTI_SCES if successful.
  **/
 /*-------------------------------------------------------------------------*/
-int FTI_WritePosixDCPData(FTIT_dataset *data, void *fd) {
+static int FTI_WritePosixDCPVar(FTIT_dataset *data, void *fd) {
     // dcpLayer corresponds to the additional layers towards the base layer.
     WriteDCPPosixInfo_t *write_DCPinfo = (WriteDCPPosixInfo_t *) fd;
     WritePosixInfo_t *write_info = &(write_DCPinfo->write_info);
@@ -182,19 +212,19 @@ int FTI_WritePosixDCPData(FTIT_dataset *data, void *fd) {
     char errstr[FTI_BUFS];
     unsigned char * block = (unsigned char*)malloc
     (FTI_Conf->dcpInfoPosix.BlockSize);
-    size_t bytes;
     int32_t varId = data->id;
 
     FTI_Exec->dcpInfoPosix.dataSize += data->size;
-    uint32_t dataSize = data->size;
+    uint64_t dataSize = data->size;
     // uint32_t nbHashes = dataSize/FTI_Conf->dcpInfoPosix.BlockSize +
     // (bool)(dataSize%FTI_Conf->dcpInfoPosix.BlockSize);
 
-    if (dataSize > (MAX_BLOCK_IDX*FTI_Conf->dcpInfoPosix.BlockSize)) {
+    if (dataSize > (((uint64_t)MAX_BLOCK_IDX)*
+         FTI_Conf->dcpInfoPosix.BlockSize)) {
         snprintf(errstr, FTI_BUFS, "overflow in size of dataset with id:"
-            " %d (datasize: %u > MAX_DATA_SIZE: %u)", data->id, dataSize,
-             ((uint32_t)MAX_BLOCK_IDX)*
-             ((uint32_t)FTI_Conf->dcpInfoPosix.BlockSize));
+            " %d (datasize: %lu > MAX_DATA_SIZE: %lu)", data->id, dataSize,
+             ((uint64_t)MAX_BLOCK_IDX)*
+             ((uint64_t)FTI_Conf->dcpInfoPosix.BlockSize));
         FTI_Print(errstr, FTI_EROR);
         return FTI_NSCS;
     }
@@ -214,15 +244,17 @@ int FTI_WritePosixDCPData(FTIT_dataset *data, void *fd) {
     blockMeta.varId = data->id;
 
     if (dcpLayer == 0) {
-        FWRITE(FTI_NSCS, bytes, &data->id, sizeof(int), 1,
-         write_info->f, "p", block);
-        FWRITE(FTI_NSCS, bytes, &dataSize, sizeof(uint32_t), 1,
-         write_info->f, "p", block);
+        if (FTI_DcpFwrite(&data->id, sizeof(int), write_info->f)
+         != FTI_SCES || FTI_DcpFwrite(&dataSize, sizeof(uint64_t),
+         write_info->f) != FTI_SCES) {
+            free(block);
+            return FTI_NSCS;
+        }
         FTI_Exec->dcpInfoPosix.FileSize += (sizeof(int) +
-         sizeof(uint32_t));
-        write_DCPinfo->layerSize += sizeof(int) + sizeof(uint32_t);
+         sizeof(uint64_t));
+        write_DCPinfo->layerSize += sizeof(int) + sizeof(uint64_t);
     }
-    uint32_t pos = 0;
+    uint64_t pos = 0;
 
     FTIT_data_prefetch prefetcher;
     size_t totalBytes = 0;
@@ -256,8 +288,8 @@ int FTI_WritePosixDCPData(FTIT_dataset *data, void *fd) {
         pos = 0;
         while (pos < totalBytes) {
             // hash index
-            unsigned int blockId = offset/FTI_Conf->dcpInfoPosix.BlockSize;
-            unsigned int hashIdx = blockId*FTI_Conf->dcpInfoPosix.digestWidth;
+            uint64_t blockId = offset/FTI_Conf->dcpInfoPosix.BlockSize;
+            uint64_t hashIdx = blockId*FTI_Conf->dcpInfoPosix.digestWidth;
 
             blockMeta.blockId = blockId;
 
@@ -292,31 +324,32 @@ int FTI_WritePosixDCPData(FTIT_dataset *data, void *fd) {
                 commitBlock = true;
             }
 
-            bool success = true;
             int fileUpdate = 0;
             if (commitBlock) {
                 if (dcpLayer > 0) {
-                    FWRITE(FTI_NSCS, success, &blockMeta, 6, 1, write_info->f,
-                     "p", block);
-                    if (success) fileUpdate += 6;
-                }
-                if (success) {
-                    FWRITE(FTI_NSCS, success, ptr, chunkSize, 1, write_info->f,
-                     "p", block);
-                    if (success) fileUpdate += chunkSize;
+                    if (FTI_DcpFwrite(&blockMeta, 6, write_info->f)
+                     != FTI_SCES) {
+                        free(block);
+                        return FTI_NSCS;
+                    }
+                    fileUpdate += 6;
                 }
-                FTI_Exec->dcpInfoPosix.FileSize += success*fileUpdate;
-                write_DCPinfo->layerSize += success*fileUpdate;
-
-                FTI_Exec->dcpInfoPosix.dcpSize += success*dcpChunkSize;
-                if (success) {
-                    MD5_Update(&write_info->integrity,
-                     &data->dcpInfoPosix.currentHashArray[hashIdx],
-                      MD5_DIGEST_LENGTH);
+                if (FTI_DcpFwrite(ptr, chunkSize, write_info->f)
+                 != FTI_SCES) {
+                    free(block);
+                    return FTI_NSCS;
                 }
+                fileUpdate += chunkSize;
+                FTI_Exec->dcpInfoPosix.FileSize += fileUpdate;
+                write_DCPinfo->layerSize += fileUpdate;
+
+                FTI_Exec->dcpInfoPosix.dcpSize += dcpChunkSize;
+                MD5_Update(&write_info->integrity.md5,
+                 &data->dcpInfoPosix.currentHashArray[hashIdx],
+                  FTI_Conf->dcpInfoPosix.digestWidth);
             }
-            offset += dcpChunkSize*success;
-            pos += dcpChunkSize*success;
+            offset += dcpChunkSize;
+            pos += dcpChunkSize;
             ptr = ptr + dcpChunkSize;  // chunkSize*success;
         }
         if (FTI_Try(FTI_getPrefetchedData (&prefetcher, &totalBytes, &ptr),
@@ -331,12 +364,32 @@ int FTI_WritePosixDCPData(FTIT_dataset *data, void *fd) {
     data->dcpInfoPosix.currentHashArray = data->dcpInfoPosix.oldHashArray;
     data->dcpInfoPosix.oldHashArray = tmp;
     //    data->dcpInfoPosix.hashArray = data->dcpInfoPosix.hashArrayTmp;
+    // only the blocks written from now on need a new hash
+    FTI_DirtyTrackArm(data);
 
     free(block);
 
     return FTI_SCES;
 }
 
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Writes dataset into dCP ckpt file using POSIX.
+  @param      FTI_Data          Dataset metadata for a specific variable.
+  @param      file descrriptor  FIle descriptor.
+  @return     integer           FTI_SCES if successful.
+
+  A failed write is remembered so that the close does not commit the layer.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_WritePosixDCPData(FTIT_dataset *data, void *fd) {
+    int res = FTI_WritePosixDCPVar(data, fd);
+    if (res != FTI_SCES) {
+        ((WriteDCPPosixInfo_t*) fd)->failed = 1;
+    }
+    return res;
+}
+
 /*-------------------------------------------------------------------------*/
 /**
   @brief      Finalizes for dCP POSIX I/O.
@@ -352,18 +405,36 @@ int FTI_PosixDCPClose(void *fileDesc) {
     WriteDCPPosixInfo_t *write_dcpInfo = (WriteDCPPosixInfo_t *) fileDesc;
     FTIT_execution *FTI_Exec = write_dcpInfo->FTI_Exec;
     FTIT_configuration *FTI_Conf = write_dcpInfo->FTI_Conf;
-    FTIT_checkpoint *FTI_Ckpt = write_dcpInfo->FTI_Ckpt;
-    FTIT_topology *FTI_Topo = write_dcpInfo->FTI_Topo;
-
 
     char errstr[FTI_BUFS];
 
-    int dcpFileId = FTI_Exec->dcpInfoPosix.Counter /
-     FTI_Conf->dcpInfoPosix.StackSize;
     // dcpLayer corresponds to the additional layers towards the base layer.
     int dcpLayer = FTI_Exec->dcpInfoPosix.Counter %
      FTI_Conf->dcpInfoPosix.StackSize;
 
+    // a layer that was not fully written is not committed: it is cut
+    // from the file and the next layer writes all the blocks again
+    if (write_dcpInfo->failed) {
+        FILE* f = write_dcpInfo->write_info.f;
+        fflush(f);
+        if (ftruncate(fileno(f), write_dcpInfo->layerStart) != 0) {
+            snprintf(errstr, FTI_BUFS, "cannot cut the failed dCP layer "
+             "[POSIX ERROR - %s.]", strerror(errno));
+            FTI_Print(errstr, FTI_WARN);
+        }
+        FTI_Exec->dcpInfoPosix.FileSize = write_dcpInfo->layerStart;
+        FTIT_dataset* data;
+        if ((write_dcpInfo->FTI_Data->data(&data, FTI_Exec->nbVar)
+         == FTI_SCES) && data) {
+            int i;
+            for (i = 0; i < FTI_Exec->nbVar; i++) {
+                data[i].dcpInfoPosix.hashDataSize = 0;
+            }
+        }
+        FTI_PosixClose(&(write_dcpInfo->write_info));
+        return FTI_NSCS;
+    }
+
     if (FTI_Conf->dcpInfoPosix.cachedCkpt) {
         FTI_CLOSE_ASYNC((write_dcpInfo->write_info.f));
     } else {
@@ -373,21 +444,96 @@ int FTI_PosixDCPClose(void *fileDesc) {
 
     // create final dcp layer hash
     unsigned char LayerHash[MD5_DIGEST_LENGTH];
-    MD5_Final(LayerHash, &(write_dcpInfo->write_info.integrity));
+    MD5_Final(LayerHash, &(write_dcpInfo->write_info.integrity.md5));
     FTI_GetHashHexStr(LayerHash, MD5_DIGEST_LENGTH,
      &FTI_Exec->dcpInfoPosix.LayerHash[dcpLayer*MD5_DIGEST_STRING_LENGTH]);
     // layer size is needed in order to create layer hash during recovery
     FTI_Exec->dcpInfoPosix.LayerSize[dcpLayer] = write_dcpInfo->layerSize;
     FTI_Exec->dcpInfoPosix.Counter++;
-    if ((dcpLayer == 0)) {
-        char ofn[512];
-        snprintf(ofn, FTI_BUFS, "%s/dcp-id%d-rank%d.fti", FTI_Ckpt[4].dcpDir,
+
+    // the layer is kept or cut by FTI_PosixDCPCommit
+    FTI_Exec->dcpInfoPosix.layerStart = write_dcpInfo->layerStart;
+    FTI_Exec->dcpInfoPosix.pending = true;
+    FTI_DirtyTrackCollect();
+    return FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Keeps or cuts the last dCP POSIX layer of the process.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+  @param      FTI_Ckpt        Checkpoint metadata.
+  @param      FTI_Data        Dataset metadata.
+  @param      committed       TRUE if every rank wrote its layer.
+  @return     integer         FTI_SCES if successful.
+
+  Called by FTI_CommitCkpt on all ranks. The files of the previous
+  checkpoint are removed only once the new layer is committed. If another
+  rank failed, the layer is cut from the file as a failed write does, so
+  that all ranks keep the same layers.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_PosixDCPCommit(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
+ FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt, FTIT_keymap* FTI_Data,
+ bool committed) {
+    FTIT_dcpExecutionPosix* dcp = &FTI_Exec->dcpInfoPosix;
+    char errstr[FTI_BUFS];
+    char fn[FTI_BUFS];
+
+    // the layer of a failed write was already cut
+    if (!dcp->pending) {
+        return FTI_SCES;
+    }
+    dcp->pending = false;
+
+    if (!committed) {
+        snprintf(fn, FTI_BUFS, "%s/%s", (FTI_Ckpt[4].isInline) ?
+         FTI_Ckpt[4].dcpDir : FTI_Ckpt[1].dcpDir,
+         FTI_Exec->ckptMeta.ckptFile);
+        if (truncate(fn, dcp->layerStart) != 0) {
+            snprintf(errstr, FTI_BUFS, "cannot cut the dCP layer of '%s' "
+             "[POSIX ERROR - %s.]", fn, strerror(errno));
+            FTI_Print(errstr, FTI_WARN);
+        }
+        dcp->FileSize = dcp->layerStart;
+        dcp->Counter--;
+        FTIT_dataset* data;
+        if ((FTI_Data->data(&data, FTI_Exec->nbVar) == FTI_SCES) && data) {
+            int i;
+            for (i = 0; i < FTI_Exec->nbVar; i++) {
+                data[i].dcpInfoPosix.hashDataSize = 0;
+            }
+        }
+        return FTI_SCES;
+    }
+
+    int dcpFileId = (dcp->Counter - 1) / FTI_Conf->dcpInfoPosix.StackSize;
+    int dcpLayer = (dcp->Counter - 1) % FTI_Conf->dcpInfoPosix.StackSize;
+    if (dcpLayer == 0) {
+        snprintf(fn, FTI_BUFS, "%s/dcp-id%d-rank%d.fti", FTI_Ckpt[4].dcpDir,
          dcpFileId-1, FTI_Topo->myRank);
-        if ((remove(ofn) < 0) && (errno != ENOENT)) {
-            snprintf(errstr, FTI_BUFS, "cannot delete file '%s'", ofn);
+        if ((remove(fn) < 0) && (errno != ENOENT)) {
+            snprintf(errstr, FTI_BUFS, "cannot delete file '%s'", fn);
             FTI_Print(errstr, FTI_WARN);
         }
     }
+
+    // the merged file is replaced once a layer is appended to the new one
+    FTIT_dcpCompaction* compact = &FTI_Exec->dcpCompact;
+    if (compact->adopted) {
+        compact->adopted = false;
+        int level;
+        for (level = 4; level > 0; level -= 3) {
+            snprintf(fn, FTI_BUFS, "%s/dcp-id%d-rank%d.fti",
+             FTI_Ckpt[level].dcpDir, compact->oldFileId, FTI_Topo->myRank);
+            if ((remove(fn) < 0) && (errno != ENOENT)) {
+                snprintf(errstr, FTI_BUFS, "cannot delete file '%s'", fn);
+                FTI_Print(errstr, FTI_WARN);
+            }
+        }
+    }
     return FTI_SCES;
 }
 
@@ -395,42 +541,85 @@ int FTI_PosixDCPClose(void *fileDesc) {
 
 /*-------------------------------------------------------------------------*/
 /**
-  @brief      It loads the checkpoint data for dcpPosix.
+  @brief      Reports a failed read of a dCP POSIX checkpoint file.
+  @param      fn              Path of the checkpoint file.
+  @param      fd              File descriptor, closed.
+  @param      buffer          Buffer to free, may be NULL.
+  @return     integer         FTI_NSCS.
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_RecoverDcpPosixFailed(const char* fn, int fd, void* buffer) {
+    char errstr[FTI_BUFS];
+    snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
+    FTI_Print(errstr, FTI_EROR);
+    free(buffer);
+    close(fd);
+    return FTI_NSCS;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Recomputes the block hashes of a recovered dataset.
+  @param      data            Recovered dataset.
+
+  The hashes are compared with the ones of the next checkpoint.
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_RehashDcpPosix(FTIT_dataset* data) {
+    if (data->isDevicePtr) {
+        FTI_MD5GPU(data);
+    } else {
+        FTI_MD5CPU(data);
+    }
+    FTI_startMD5();
+    FTI_SyncMD5();
+    data->dcpInfoPosix.hashDataSize = data->size;
+    unsigned char *tmp = data->dcpInfoPosix.currentHashArray;
+    data->dcpInfoPosix.currentHashArray = data->dcpInfoPosix.oldHashArray;
+    data->dcpInfoPosix.oldHashArray = tmp;
+    FTI_DirtyTrackArm(data);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Reads the newest data of datasets from the dCP POSIX file.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Ckpt        Checkpoint metadata.
+  @param      data            Datasets to read.
+  @param      nbVar           Number of datasets.
   @return     integer         FTI_SCES if successful.
 
-  dCP POSIX implementation of FTI_Recover().
+  The block index of the file gives the newest layer holding every block,
+  so each block is read once, whatever the number of layers. All the
+  blocks are read at once with FTI_ReadExtents. Blocks of device datasets
+  are staged in host memory.
  **/
 /*-------------------------------------------------------------------------*/
-int FTI_RecoverDcpPosix(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
-    FTIT_checkpoint* FTI_Ckpt, FTIT_keymap* FTI_Data) {
+static int FTI_LoadDcpPosix(FTIT_configuration* FTI_Conf,
+    FTIT_execution* FTI_Exec, FTIT_checkpoint* FTI_Ckpt, FTIT_dataset* data,
+    int nbVar) {
     uint32_t blockSize;
     unsigned int stackSize;
-    int nbVarLayer;
-    int ckptId;
 
     char errstr[FTI_BUFS];
     char fn[FTI_BUFS];
 
-    void* ptr;
-
-    FTIT_dataset* data;
-
     snprintf(fn, FTI_BUFS, "%s/%s", FTI_Ckpt[FTI_Exec->ckptLvel].dcpDir,
      FTI_Exec->ckptMeta.ckptFile);
 
-    // read base part of file
-    FILE* fd = fopen(fn, "rb");
-    fread(&blockSize, sizeof(uint32_t), 1, fd);
-    if (ferror(fd)) {
-        snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
+    int fd = open(fn, O_RDONLY);
+    if (fd == -1) {
+        snprintf(errstr, FTI_BUFS, "unable to open file %s", fn);
         FTI_Print(errstr, FTI_EROR);
         return FTI_NSCS;
     }
-    fread(&stackSize, sizeof(unsigned int), 1, fd);
-    if (ferror(fd)) {
-        snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-        FTI_Print(errstr, FTI_EROR);
-        return FTI_NSCS;
+    FTIT_extent head[2] = {
+        { 0, &blockSize, sizeof(uint32_t) },
+        { sizeof(uint32_t), &stackSize, sizeof(unsigned int) }
+    };
+    if (FTI_ReadExtents(fd, head, 2) != FTI_SCES) {
+        return FTI_RecoverDcpPosixFailed(fn, fd, NULL);
     }
 
     // check if settings are correct. If not correct them
@@ -440,6 +629,7 @@ int FTI_RecoverDcpPosix(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         " settings ('%u') and checkpoint file ('%u')",
          FTI_Conf->dcpInfoPosix.BlockSize, blockSize);
         FTI_Print(str, FTI_WARN);
+        close(fd);
         return FTI_NREC;
     }
     if (stackSize != FTI_Conf->dcpInfoPosix.StackSize) {
@@ -448,236 +638,107 @@ int FTI_RecoverDcpPosix(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         " settings ('%u') and checkpoint file ('%u')",
          FTI_Conf->dcpInfoPosix.StackSize, stackSize);
         FTI_Print(str, FTI_WARN);
+        close(fd);
         return FTI_NREC;
     }
 
-
-    void *buffer = malloc(blockSize);
-    if (!buffer) {
-        FTI_Print("unable to allocate memory!", FTI_EROR);
-        return FTI_NSCS;
-    }
-
     int i;
-    // treat Layer 0 first
-    fread(&ckptId, 1, sizeof(int), fd);
-    if (ferror(fd)) {
-        snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-        FTI_Print(errstr, FTI_EROR);
-        return FTI_NSCS;
+    FTIT_dcpBlockIndex* index = talloc(FTIT_dcpBlockIndex, nbVar + 1);
+    for (i = 0; i < nbVar; i++) {
+        index[i].id = data[i].id;
+        index[i].size = data[i].size;
     }
-    fread(&nbVarLayer, 1, sizeof(int), fd);
-    if (ferror(fd)) {
-        snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-        FTI_Print(errstr, FTI_EROR);
-        return FTI_NSCS;
-    }
-    for (i = 0; i < nbVarLayer; i++) {
-        unsigned int varId;
-        uint32_t locDataSize;
-        fread(&varId, sizeof(int), 1, fd);
-        if (ferror(fd)) {
-            snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-            FTI_Print(errstr, FTI_EROR);
-            return FTI_NSCS;
-        }
-        fread(&locDataSize, sizeof(uint32_t), 1, fd);
-        if (ferror(fd)) {
-            snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-            FTI_Print(errstr, FTI_EROR);
-            return FTI_NSCS;
-        }
-
-        if (FTI_Data->get(&data, varId) != FTI_SCES) return FTI_NSCS;
+    int res = FTI_DcpPosixIndex(fd, blockSize,
+     FTI_Exec->dcpInfoPosix.LayerSize, FTI_Exec->dcpInfoPosix.nbLayerReco,
+     index, nbVar, true);
 
-        if (!data) {
-            snprintf(errstr, FTI_BUFS, "id '%d' does not exist!", varId);
-            FTI_Print(errstr, FTI_EROR);
-            return FTI_NSCS;
-        }
+    int64_t nbExt = 0;
+    for (i = 0; i < nbVar; i++) {
+        nbExt += index[i].nbBlocks;
+    }
+    FTIT_extent* ext = talloc(FTIT_extent, nbExt + 1);
+    unsigned char** host = talloc(unsigned char*, nbVar + 1);
+    nbExt = 0;
+    for (i = 0; i < nbVar; i++) {
+        host[i] = NULL;
+        unsigned char* dest = (unsigned char*) data[i].ptr;
 #ifdef GPUSUPPORT
-        if (data->isDevicePtr) {
-            FTI_TransferFileToDeviceAsync(fd, data->devicePtr, data->size);
-        } else {
-            fread(data->ptr, locDataSize, 1, fd);
-            if (ferror(fd)) {
-                snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-                FTI_Print(errstr, FTI_EROR);
-                return FTI_NSCS;
-            }
-        }
-
-#else
-        fread(data->ptr, locDataSize, 1, fd);
-        if (ferror(fd)) {
-            snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-            FTI_Print(errstr, FTI_EROR);
-            return FTI_NSCS;
+        if (data[i].isDevicePtr) {
+            host[i] = talloc(unsigned char, data[i].size + 1);
+            dest = host[i];
         }
 #endif
-        int overflow;
-        if ((overflow=locDataSize%blockSize) != 0) {
-            fread(buffer, blockSize - overflow, 1, fd);
-            if (ferror(fd)) {
-                snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-                FTI_Print(errstr, FTI_EROR);
-                return FTI_NSCS;
-            }
-        }
+        nbExt += FTI_DcpPosixExtents(&index[i], blockSize, 0,
+         index[i].nbBlocks, dest, ext + nbExt);
     }
-
-
-    uint32_t offset;
-    blockMetaInfo_t blockMeta;
-    unsigned char *block = (unsigned char*) malloc(blockSize);
-    if (!block) {
-        FTI_Print("unable to allocate memory!", FTI_EROR);
-        return FTI_NSCS;
+    if (res == FTI_SCES) {
+        res = FTI_ReadExtents(fd, ext, nbExt);
     }
 
-    int nbLayer = FTI_Exec->dcpInfoPosix.nbLayerReco;
-
-
-    for (i = 1; i < nbLayer; i++) {
-        uint32_t pos = 0;
-        pos += fread(&ckptId, 1, sizeof(int), fd);
-        if (ferror(fd)) {
-            snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-            FTI_Print(errstr, FTI_EROR);
-            return FTI_NSCS;
+#ifdef GPUSUPPORT
+    for (i = 0; i < nbVar && res == FTI_SCES; i++) {
+        if (!host[i]) {
+            continue;
         }
-        pos += fread(&nbVarLayer, 1, sizeof(int), fd);
-        if (ferror(fd)) {
-            snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-            FTI_Print(errstr, FTI_EROR);
-            return FTI_NSCS;
+        int64_t n = FTI_DcpPosixExtents(&index[i], blockSize, 0,
+         index[i].nbBlocks, host[i], ext);
+        int64_t e;
+        for (e = 0; e < n && res == FTI_SCES; e++) {
+            unsigned char* dest = (unsigned char*) ext[e].dest;
+            res = FTI_copy_to_device_async((unsigned char*)
+             data[i].devicePtr + (dest - host[i]), dest, ext[e].size);
         }
+    }
+    FTI_device_sync();
+#endif
 
-        while (pos < FTI_Exec->dcpInfoPosix.LayerSize[i]) {
-            fread(&blockMeta, 1, 6, fd);
-            if (ferror(fd)) {
-                snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-                FTI_Print(errstr, FTI_EROR);
-                return FTI_NSCS;
-            }
-
-            if (FTI_Data->get(&data, blockMeta.varId) != FTI_SCES)
-                return FTI_NSCS;
+    for (i = 0; i < nbVar; i++) {
+        free(host[i]);
+    }
+    free(host);
+    FTI_DcpPosixIndexFree(index, nbVar);
+    free(index);
+    if (res != FTI_SCES) {
+        return FTI_RecoverDcpPosixFailed(fn, fd, ext);
+    }
+    free(ext);
+    close(fd);
+    return FTI_SCES;
+}
 
-            if (!data) {
-                snprintf(errstr, FTI_BUFS, "id '%d' does not exist!",
-                 blockMeta.varId);
-                FTI_Print(errstr, FTI_EROR);
-                return FTI_NSCS;
-            }
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It loads the checkpoint data for dcpPosix.
+  @return     integer         FTI_SCES if successful.
 
-            offset = blockMeta.blockId * blockSize;
-            unsigned int chunkSize = ((data->size-offset) < blockSize) ?
-             data->size-offset : blockSize;
+  dCP POSIX implementation of FTI_Recover(). The block hashes needed by
+  the next checkpoint are recomputed on the worker pool.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_RecoverDcpPosix(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
+    FTIT_checkpoint* FTI_Ckpt, FTIT_keymap* FTI_Data) {
+    FTIT_dataset* data;
 
-#ifdef GPUSUPPORT
-            if (data->isDevicePtr) {
-                FTI_device_sync();
-                fread(block, 1, chunkSize, fd);
-                FTI_copy_to_device_async(data->devicePtr + offset, block,
-                 chunkSize);
-            } else {
-                ptr = data->ptr + offset;
-                fread(ptr, 1, chunkSize, fd);
-            }
-#else
-            ptr = data->ptr + offset;
-            fread(ptr, 1, chunkSize, fd);
-#endif
-            if (ferror(fd)) {
-                snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-                FTI_Print(errstr, FTI_EROR);
-                return FTI_NSCS;
-            }
-            fread(buffer, 1, blockSize - chunkSize, fd);
-            if (ferror(fd)) {
-                snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-                FTI_Print(errstr, FTI_EROR);
-                return FTI_NSCS;
-            }
+    if ((FTI_Data->data(&data, FTI_Exec->nbVar) != FTI_SCES) || !data)
+        return FTI_NSCS;
 
-            pos += (blockSize+6);
-        }
+    int res = FTI_LoadDcpPosix(FTI_Conf, FTI_Exec, FTI_Ckpt, data,
+     FTI_Exec->nbVar);
+    if (res != FTI_SCES) {
+        return res;
     }
 
     // create hasharray
     if ((FTI_Data->data(&data, FTI_Exec->nbVarStored) != FTI_SCES) || !data)
         return FTI_NSCS;
 
+    int i;
     for (i = 0; i < FTI_Exec->nbVarStored; i++) {
-        FTIT_data_prefetch prefetcher;
-        size_t totalBytes = 0;
-        unsigned char * ptr = NULL, *startPtr = NULL;
-
-#ifdef GPUSUPPORT
-        prefetcher.fetchSize = ((FTI_Conf->cHostBufSize) /
-         FTI_Conf->dcpInfoPosix.BlockSize) * FTI_Conf->dcpInfoPosix.BlockSize;
-#else
-        prefetcher.fetchSize =  data[i].size;
-#endif
-        prefetcher.totalBytesToFetch = data[i].size;
-        prefetcher.isDevice = data[i].isDevicePtr;
-
-        if (prefetcher.isDevice) {
-            prefetcher.dptr = data[i].devicePtr;
-        } else {
-            prefetcher.dptr = data[i].ptr;
-        }
-
-        FTI_InitPrefetcher(&prefetcher);
-        if (FTI_Try(FTI_getPrefetchedData (&prefetcher, &totalBytes,
-         &startPtr), " Fetching Next Memory block from memory") != FTI_SCES) {
-            return FTI_NSCS;
-        }
-
-        uint32_t nbBlocks = (data[i].size % blockSize) ?
-         data[i].size/blockSize + 1 : data[i].size/blockSize;
-        data[i].dcpInfoPosix.hashDataSize = data[i].size;
-        int j = 0;
-        while (startPtr) {
-            ptr = startPtr;
-            int currentBlocks = (totalBytes % blockSize) ?
-              totalBytes/blockSize + 1 : totalBytes/blockSize;
-            int k;
-            for (k = 0 ; k < currentBlocks && j < nbBlocks-1; k++) {
-                uint32_t hashIdx = j*MD5_DIGEST_LENGTH;
-                FTI_Conf->dcpInfoPosix.hashFunc(ptr, blockSize,
-                 &data[i].dcpInfoPosix.oldHashArray[hashIdx]);
-                ptr = ptr+blockSize;
-                j++;
-            }
-            if (FTI_Try(FTI_getPrefetchedData(&prefetcher,
-             &totalBytes, &startPtr),
-             " Fetching Next Memory block from memory") != FTI_SCES) {
-                return FTI_NSCS;
-            }
-        }
-
-        if (data[i].size%blockSize) {
-            unsigned char* buffer = calloc(1, blockSize);
-            if (!buffer) {
-                FTI_Print("unable to allocate memory!", FTI_EROR);
-                return FTI_NSCS;
-            }
-            uint32_t dataOffset = blockSize * (nbBlocks - 1);
-            uint32_t dataSize = data[i].size - dataOffset;
-            memcpy(buffer, ptr, dataSize);
-            FTI_Conf->dcpInfoPosix.hashFunc(buffer, blockSize,
-            &data[i].dcpInfoPosix.oldHashArray[(nbBlocks-1)*MD5_DIGEST_LENGTH]);
-        }
+        FTI_RehashDcpPosix(&data[i]);
     }
 
-
     FTI_Exec->reco = 0;
 
-    free(buffer);
-    fclose(fd);
-
     return FTI_SCES;
 }
 
@@ -696,294 +757,22 @@ int FTI_RecoverVarDcpPosixFinalize() { /*TODO*/ return FTI_SCES; }
 int FTI_RecoverVarDcpPosix(FTIT_configuration* FTI_Conf,
     FTIT_execution* FTI_Exec, FTIT_checkpoint* FTI_Ckpt, FTIT_keymap* FTI_Data,
     int id) {
-    uint32_t blockSize;
-    unsigned int stackSize;
-    int nbVarLayer;
-    int ckptId;
-
     char errstr[FTI_BUFS];
-    char fn[FTI_BUFS];
-
     FTIT_dataset* data;
 
-    snprintf(fn, FTI_BUFS, "%s/%s", FTI_Ckpt[FTI_Exec->ckptLvel].dcpDir,
-     FTI_Exec->ckptMeta.ckptFile);
-
-    // read base part of file
-    FILE* fd = fopen(fn, "rb");
-    fread(&blockSize, sizeof(uint32_t), 1, fd);
-    if (ferror(fd)) {
-        snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-        FTI_Print(errstr, FTI_EROR);
-        return FTI_NSCS;
-    }
-    fread(&stackSize, sizeof(unsigned int), 1, fd);
-    if (ferror(fd)) {
-        snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-        FTI_Print(errstr, FTI_EROR);
-        return FTI_NSCS;
-    }
-
-    // check if settings are correct. If not correct them
-    if (blockSize != FTI_Conf->dcpInfoPosix.BlockSize) {
-        char str[FTI_BUFS];
-        snprintf(str, FTI_BUFS, "dCP blocksize differ between configuration"
-        " settings ('%u') and checkpoint file ('%u')",
-         FTI_Conf->dcpInfoPosix.BlockSize, blockSize);
-        FTI_Print(str, FTI_WARN);
-        return FTI_NREC;
-    }
-    if (stackSize != FTI_Conf->dcpInfoPosix.StackSize) {
-        char str[FTI_BUFS];
-        snprintf(str, FTI_BUFS, "dCP stacksize differ between configuration"
-        " settings ('%u') and checkpoint file ('%u')",
-         FTI_Conf->dcpInfoPosix.StackSize, stackSize);
-        FTI_Print(str, FTI_WARN);
-        return FTI_NREC;
-    }
-
-
-    void *buffer = malloc(blockSize);
-    if (!buffer) {
-        FTI_Print("unable to allocate memory!", FTI_EROR);
-        return FTI_NSCS;
-    }
-
-    int i;
-
-    // treat Layer 0 first
-    fread(&ckptId, 1, sizeof(int), fd);
-    if (ferror(fd)) {
-        snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-        FTI_Print(errstr, FTI_EROR);
-        return FTI_NSCS;
-    }
-    fread(&nbVarLayer, 1, sizeof(int), fd);
-    if (ferror(fd)) {
-        snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-        FTI_Print(errstr, FTI_EROR);
-        return FTI_NSCS;
-    }
-    for (i = 0; i < nbVarLayer; i++) {
-        unsigned int varId;
-        uint32_t locDataSize;
-        fread(&varId, sizeof(int), 1, fd);
-        if (ferror(fd)) {
-            snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-            FTI_Print(errstr, FTI_EROR);
-            return FTI_NSCS;
-        }
-        fread(&locDataSize, sizeof(uint32_t), 1, fd);
-        if (ferror(fd)) {
-            snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-            FTI_Print(errstr, FTI_EROR);
-            return FTI_NSCS;
-        }
-        // if requested id load else skip dataSize
-        if (varId == id) {
-            if (FTI_Data->get(&data, varId) != FTI_SCES) return FTI_NSCS;
-
-            if (!data) {
-                snprintf(errstr, FTI_BUFS, "id '%d' does not exist!", varId);
-                FTI_Print(errstr, FTI_EROR);
-                return FTI_NSCS;
-            }
-
-            fread(data->ptr, locDataSize, 1, fd);
-            if (ferror(fd)) {
-                snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-                FTI_Print(errstr, FTI_EROR);
-                return FTI_NSCS;
-            }
-
-            int overflow;
-            if ((overflow=locDataSize%blockSize) != 0) {
-                fread(buffer, blockSize - overflow, 1, fd);
-                if (ferror(fd)) {
-                    snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-                    FTI_Print(errstr, FTI_EROR);
-                    return FTI_NSCS;
-                }
-            }
-        } else {
-            uint32_t skip = (locDataSize%blockSize == 0) ?
-             locDataSize : (locDataSize/blockSize + 1)*blockSize;
-            if (fseek(fd, skip, SEEK_CUR) == -1) {
-                snprintf(errstr, FTI_BUFS, "unable to seek in file %s", fn);
-                FTI_Print(errstr, FTI_EROR);
-                return FTI_NSCS;
-            }
-        }
-    }
-
-
-    uint32_t offset;
-
-    blockMetaInfo_t blockMeta;
-    unsigned char *block = (unsigned char*) malloc(blockSize);
-    if (!block) {
-        FTI_Print("unable to allocate memory!", FTI_EROR);
-        return FTI_NSCS;
-    }
-
-    int nbLayer = FTI_Exec->dcpInfoPosix.nbLayerReco;
-    for (i = 1; i < nbLayer; i++) {
-        uint32_t pos = 0;
-        pos += fread(&ckptId, 1, sizeof(int), fd);
-        if (ferror(fd)) {
-            snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-            FTI_Print(errstr, FTI_EROR);
-            return FTI_NSCS;
-        }
-        pos += fread(&nbVarLayer, 1, sizeof(int), fd);
-        if (ferror(fd)) {
-            snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-            FTI_Print(errstr, FTI_EROR);
-            return FTI_NSCS;
-        }
-
-        while (pos < FTI_Exec->dcpInfoPosix.LayerSize[i]) {
-            fread(&blockMeta, 1, 6, fd);
-            if (ferror(fd)) {
-                snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-                FTI_Print(errstr, FTI_EROR);
-                return FTI_NSCS;
-            }
-            if (blockMeta.varId == id) {
-                if (FTI_Data->get(&data, blockMeta.varId) != FTI_SCES)
-                    return FTI_NSCS;
-
-                if (!data) {
-                    snprintf(errstr, FTI_BUFS, "id '%d' does not exist!",
-                     blockMeta.varId);
-                    FTI_Print(errstr, FTI_EROR);
-                    return FTI_NSCS;
-                }
-
-                offset = blockMeta.blockId * blockSize;
-                void* ptr = data->ptr + offset;
-                unsigned int chunkSize = ((data->size-offset) < blockSize) ?
-                 data->size-offset : blockSize;
-
-                fread(ptr, 1, chunkSize, fd);
-                if (ferror(fd)) {
-                    snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-                    FTI_Print(errstr, FTI_EROR);
-                    return FTI_NSCS;
-                }
-                fread(buffer, 1, blockSize - chunkSize, fd);
-                if (ferror(fd)) {
-                    snprintf(errstr, FTI_BUFS, "unable to read in file %s", fn);
-                    FTI_Print(errstr, FTI_EROR);
-                    return FTI_NSCS;
-                }
-
-            } else {
-                if (fseek(fd, blockSize, SEEK_CUR) == -1) {
-                    snprintf(errstr, FTI_BUFS, "unable to seek in file %s", fn);
-                    FTI_Print(errstr, FTI_EROR);
-                    return FTI_NSCS;
-                }
-            }
-            pos += (blockSize+6);
-        }
-    }
-
     if (FTI_Data->get(&data, id) != FTI_SCES) return FTI_NSCS;
 
     if (!data) {
-        snprintf(errstr, FTI_BUFS, "id '%d' does not exist!", blockMeta.varId);
+        snprintf(errstr, FTI_BUFS, "id '%d' does not exist!", id);
         FTI_Print(errstr, FTI_EROR);
         return FTI_NSCS;
     }
-    FTIT_data_prefetch prefetcher;
-    size_t totalBytes = 0;
-    unsigned char * ptr = NULL, *startPtr = NULL;
-
-#ifdef GPUSUPPORT
-    prefetcher.fetchSize = ((FTI_Conf->cHostBufSize) /
-     FTI_Conf->dcpInfoPosix.BlockSize) * FTI_Conf->dcpInfoPosix.BlockSize;
-#else
-    prefetcher.fetchSize =  data->size;
-#endif
-    prefetcher.totalBytesToFetch = data->size;
-    prefetcher.isDevice = data->isDevicePtr;
 
-    if (prefetcher.isDevice) {
-        prefetcher.dptr = data->devicePtr;
-    } else {
-        prefetcher.dptr = data->ptr;
+    int res = FTI_LoadDcpPosix(FTI_Conf, FTI_Exec, FTI_Ckpt, data, 1);
+    if (res != FTI_SCES) {
+        return res;
     }
-
-    FTI_InitPrefetcher(&prefetcher);
-    if (FTI_Try(FTI_getPrefetchedData (&prefetcher, &totalBytes, &startPtr),
-     " Fetching Next Memory block from memory") != FTI_SCES) {
-        return FTI_NSCS;
-    }
-
-    uint32_t nbBlocks = (data->size % blockSize) ?
-     data->size/blockSize + 1 : data->size/blockSize;
-    data->dcpInfoPosix.hashDataSize = data->size;
-    int j = 0;
-    while (startPtr) {
-        ptr = startPtr;
-        int currentBlocks = (totalBytes % blockSize) ?
-          totalBytes/blockSize + 1 : totalBytes/blockSize;
-        int k;
-        for (k = 0 ; k < currentBlocks && j < nbBlocks-1; k++) {
-            uint32_t hashIdx = j*MD5_DIGEST_LENGTH;
-            FTI_Conf->dcpInfoPosix.hashFunc(ptr, blockSize,
-             &data->dcpInfoPosix.oldHashArray[hashIdx]);
-            ptr = ptr+blockSize;
-            j++;
-        }
-        if (FTI_Try(FTI_getPrefetchedData (&prefetcher, &totalBytes,
-         &startPtr), " Fetching Next Memory block from memory") != FTI_SCES) {
-            return FTI_NSCS;
-        }
-    }
-
-    if (data->size%blockSize) {
-        unsigned char* buffer = calloc(1, blockSize);
-        if (!buffer) {
-            FTI_Print("unable to allocate memory!", FTI_EROR);
-            return FTI_NSCS;
-        }
-        uint32_t dataOffset = blockSize * (nbBlocks - 1);
-        uint32_t dataSize = data->size - dataOffset;
-        memcpy(buffer, ptr, dataSize);
-        FTI_Conf->dcpInfoPosix.hashFunc(buffer, blockSize,
-         &data->dcpInfoPosix.oldHashArray[(nbBlocks-1)*MD5_DIGEST_LENGTH]);
-    }
-
-    /*
-    // create hasharray for id
-    i = FTI_DataGetIdx(id, FTI_Exec, FTI_Data);
-    uint32_t nbBlocks = (FTI_Data[i].size % blockSize) ? FTI_Data[i].size/blockSize + 1 : FTI_Data[i].size/blockSize;
-    FTI_Data[i].dcpInfoPosix.hashDataSize = FTI_Data[i].size;
-
-    int j;
-    for(j=0; j<nbBlocks-1; j++) {
-    uint32_t offset = j*blockSize;
-    uint32_t hashIdx = j*MD5_DIGEST_LENGTH;
-    MD5(FTI_Data[i].ptr+offset, blockSize, &FTI_Data[i].dcpInfoPosix.hashArray[hashIdx]);
-    }
-    if (FTI_Data[i].size%blockSize) {
-    unsigned char* buffer = calloc(1, blockSize);
-    if (!buffer) {
-    FTI_Print("unable to allocate memory!", FTI_EROR);
-    return FTI_NSCS;
-    }
-    uint32_t dataOffset = blockSize * (nbBlocks - 1);
-    uint32_t dataSize = FTI_Data[i].size - dataOffset;
-    memcpy(buffer, FTI_Data[i].ptr + dataOffset, dataSize); 
-    MD5(buffer, blockSize, &FTI_Data[i].dcpInfoPosix.hashArray[(nbBlocks-1)*MD5_DIGEST_LENGTH]);
-    free(buffer);
-    }
-    */
-    free(buffer);
-    fclose(fd);
-
+    FTI_RehashDcpPosix(data);
 
     return FTI_SCES;
 }
@@ -993,22 +782,20 @@ int FTI_RecoverVarDcpPosix(FTIT_configuration* FTI_Conf,
   @brief      It checks if a file exist and that its size is 'correct'.
   @param      fn              The ckpt. file name to check.
   @param      fs              The ckpt. file size to check.
-  @param      checksum        The file checksum to check.
+  @param      checksum        The file checksum to check (unused).
   @return     integer         0 if file exists, 1 if not or wrong size.
 
-  dCP POSIX implementation of FTI_CheckFile().
+  dCP POSIX implementation of FTI_CheckFile(). The layers are always
+  verified with their hashes, which also sets up the recovery of the
+  datasets; the checksum of a dCP file is not computed.
  **/
 /*-------------------------------------------------------------------------*/
-int FTI_CheckFileDcpPosix(char* fn, int32_t fs, char* checksum) {
+int FTI_CheckFileDcpPosix(char* fn, int64_t fs, char* checksum) {
     if (access(fn, F_OK) == 0) {
         struct stat fileStatus;
         if (stat(fn, &fileStatus) == 0) {
-            if (strlen(checksum)) {
-                int res = FTI_VerifyChecksumDcpPosix(fn);
-                if (res != FTI_SCES) {
-                    return 1;
-                }
-                return 0;
+            if (FTI_VerifyChecksumDcpPosix(fn) != FTI_SCES) {
+                return 1;
             }
             return 0;
         } else {
@@ -1135,15 +922,15 @@ int FTI_VerifyChecksumDcpPosix(char* fileName) {
         goto FINALIZE;
     }
     for (i = 0; i < nbVarLayer; i++) {
-        uint32_t dataSize;
-        uint32_t pos = 0;
+        uint64_t dataSize;
+        uint64_t pos = 0;
         fs += fread(dummyBuffer, 1, sizeof(int), fd);
         if (ferror(fd)|| feof(fd)) {
             snprintf(errstr, FTI_BUFS, "unable to read in file %s", fileName);
             FTI_Print(errstr, FTI_EROR);
             goto FINALIZE;
         }
-        fs += fread(&dataSize, 1, sizeof(uint32_t), fd);
+        fs += fread(&dataSize, 1, sizeof(uint64_t), fd);
         if (ferror(fd)|| feof(fd)) {
             snprintf(errstr, FTI_BUFS, "unable to read in file %s", fileName);
             FTI_Print(errstr, FTI_EROR);
@@ -1157,14 +944,14 @@ int FTI_VerifyChecksumDcpPosix(char* fileName) {
                 FTI_Print(errstr, FTI_EROR);
                 goto FINALIZE;
             }
-            MD5(buffer, blockSize, md5_tmp);
-            MD5_Update(&mdContext, md5_tmp, MD5_DIGEST_LENGTH);
+            conf->dcpInfoPosix.hashFunc(buffer, blockSize, md5_tmp);
+            MD5_Update(&mdContext, md5_tmp, conf->dcpInfoPosix.digestWidth);
         }
         fs += pos;
     }
     MD5_Final(md5_final, &mdContext);
     // compare hashes
-    if (strcmp(FTI_GetHashHexStr(md5_final, conf->dcpInfoPosix.digestWidth,
+    if (strcmp(FTI_GetHashHexStr(md5_final, MD5_DIGEST_LENGTH,
      NULL), &exec->dcpInfoPosix.LayerHash[layer*MD5_DIGEST_STRING_LENGTH])) {
         FTI_Print("hashes differ in base", FTI_WARN);
         goto FINALIZE;
@@ -1250,13 +1037,13 @@ int FTI_VerifyChecksumDcpPosix(char* fileName) {
             }
             layerSize += bytes;
 
-            MD5(buffer, blockSize, md5_tmp);
-            MD5_Update(&mdContext, md5_tmp, MD5_DIGEST_LENGTH);
+            conf->dcpInfoPosix.hashFunc(buffer, blockSize, md5_tmp);
+            MD5_Update(&mdContext, md5_tmp, conf->dcpInfoPosix.digestWidth);
         }
         MD5_Final(md5_final, &mdContext);
         // compare hashes
         if (readLayer && strcmp(FTI_GetHashHexStr(md5_final,
-         conf->dcpInfoPosix.digestWidth, NULL),
+         MD5_DIGEST_LENGTH, NULL),
          &exec->dcpInfoPosix.LayerHash[layer*MD5_DIGEST_STRING_LENGTH])) {
             readLayer = false;
         }
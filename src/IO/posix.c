@@ -88,7 +88,7 @@ int FTI_PosixOpen(char *fn, void *fileDesc) {
         FTI_Print(str, FTI_EROR);
         return FTI_NSCS;
     }
-    MD5_Init(&(fd->integrity));
+    FTI_IntegrityInit(&(fd->integrity));
     return FTI_SCES;
 }
 
@@ -131,7 +131,7 @@ int FTI_PosixWrite(void *src, size_t size, void *fileDesc) {
         fwrite_errno = errno;
     }
 
-    MD5_Update(&(fd->integrity), src, size);
+    FTI_IntegrityUpdate(&(fd->integrity), src, size);
     if (ferror(fd->f)) {
         char error_msg[FTI_BUFS];
         error_msg[0] = 0;
@@ -139,7 +139,6 @@ int FTI_PosixWrite(void *src, size_t size, void *fileDesc) {
         snprintf(str, FTI_BUFS, "Unable to write : [POSIX ERROR - %s.]",
          error_msg);
         FTI_Print(str, FTI_EROR);
-        fclose(fd->f);
         return FTI_NSCS;
     } else {
         return FTI_SCES;
@@ -262,15 +261,24 @@ void* FTI_InitPosix(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
 int FTI_WritePosixData(FTIT_dataset * data, void *fd) {
     WritePosixInfo_t *write_info = (WritePosixInfo_t*) fd;
     char str[FTI_BUFS];
+    FTIT_compression comp;
     int res;
 
-    if (!(data->isDevicePtr)) {
+    if (!(data->isDevicePtr) && FTI_CompressionOf(data, &comp)) {
+        if (( res = FTI_Try(FTI_WriteCompressed(data, &comp, FTI_PosixWrite,
+         write_info), "Storing compressed Data to Checkpoint file"))
+         != FTI_SCES) {
+            snprintf(str, FTI_BUFS, "Dataset #%d could not be written.",
+             data->id);
+            FTI_Print(str, FTI_EROR);
+            return FTI_NSCS;
+        }
+    } else if (!(data->isDevicePtr)) {
         if (( res = FTI_Try(FTI_PosixWrite(data->ptr, data->size, write_info),
          "Storing Data to Checkpoint file")) != FTI_SCES) {
             snprintf(str, FTI_BUFS, "Dataset #%d could not be written.",
              data->id);
             FTI_Print(str, FTI_EROR);
-            FTI_PosixClose(write_info);
             return FTI_NSCS;
         }
     }
@@ -285,7 +293,6 @@ int FTI_WritePosixData(FTIT_dataset * data, void *fd) {
             snprintf(str, FTI_BUFS, "Dataset #%d could not be written.",
              data->id);
             FTI_Print(str, FTI_EROR);
-            FTI_PosixClose(write_info);
             return FTI_NSCS;
         }
     }
@@ -302,9 +309,9 @@ int FTI_WritePosixData(FTIT_dataset * data, void *fd) {
 
  **/
 /*-------------------------------------------------------------------------*/
-void FTI_PosixMD5(unsigned char *dest, void *md5) {
+void FTI_PosixMD5(char *dest, void *md5) {
     WritePosixInfo_t *write_info =(WritePosixInfo_t *) md5;
-    MD5_Final(dest, &(write_info->integrity));
+    FTI_IntegrityFinal(&(write_info->integrity), dest);
 }
 
 /**
@@ -353,21 +360,31 @@ int FTI_RecoverVarPOSIX(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     }
 
     if (data->size != data->sizeStored) {
-        snprintf(str, sizeof(str), "Cannot recover %d bytes to protected "
-        "variable (ID %d) size: %d", data->sizeStored, data->id, data->size);
+        snprintf(str, sizeof(str), "Cannot recover %ld bytes to protected "
+        "variable (ID %d) size: %ld", data->sizeStored, data->id, data->size);
         FTI_Print(str, FTI_WARN);
         return FTI_NREC;
     }
 
-    int32_t filePos = data->filePos;
-    if (fseek(fileposix, filePos, SEEK_SET) == 0) {
-        fread(data->ptr, 1, data->size, fileposix);
-        if (ferror(fileposix)) {
-            FTI_Print("Could not read FTI checkpoint file.", FTI_EROR);
-        } else {
-            res = FTI_SCES;
+    FTIT_extent ext = { data->filePos, data->ptr, data->size };
+    if (data->fileCodec != FTI_CODEC_NONE) {
+        ext.dest = malloc(data->fileSize);
+        ext.size = data->fileSize;
+        if (ext.dest == NULL) {
+            FTI_Print("Cannot allocate the compressed data.", FTI_EROR);
+            return FTI_NREC;
         }
     }
+    if (FTI_ReadExtents(fileno(fileposix), &ext, 1) != FTI_SCES) {
+        FTI_Print("Could not read FTI checkpoint file.", FTI_EROR);
+    } else if (data->fileCodec != FTI_CODEC_NONE) {
+        res = FTI_Decompress(ext.dest, data->fileSize, data->ptr, data->size);
+    } else {
+        res = FTI_SCES;
+    }
+    if (ext.dest != data->ptr) {
+        free(ext.dest);
+    }
     return res;
 }
 
@@ -16,7 +16,7 @@ extern FILE* fileposix;
 int FTI_ActivateHeadsPosix(FTIT_configuration* FTI_Conf,
  FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo,
  FTIT_checkpoint* FTI_Ckpt, int status);
-void FTI_PosixMD5(unsigned char *dest, void *md5);
+void FTI_PosixMD5(char *dest, void *md5);
 int FTI_WritePosixData(FTIT_dataset * data, void *fd);
 void* FTI_InitPosix(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
  FTIT_topology* FTI_Topo, FTIT_checkpoint *FTI_Ckpt, FTIT_keymap *FTI_Data);
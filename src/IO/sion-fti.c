@@ -143,11 +143,6 @@ int FTI_WriteSionData(FTIT_dataset *data, void *fd) {
             FTI_Print(str, FTI_EROR);
             errno = 0;
             FTI_Print("SIONlib: Data could not be written", FTI_EROR);
-            res =  sion_parclose_mapped_mpi(write_info->sid);
-            free(write_info->file_map);
-            free(write_info->rank_map);
-            free(write_info->ranks);
-            free(write_info->chunkSizes);
             return FTI_NSCS;
         }
     }
@@ -164,11 +159,6 @@ int FTI_WriteSionData(FTIT_dataset *data, void *fd) {
             FTI_Print(str, FTI_EROR);
             errno = 0;
             FTI_Print("SIONlib: Data could not be written", FTI_EROR);
-            res =  sion_parclose_mapped_mpi(write_info->sid);
-            free(write_info->file_map);
-            free(write_info->rank_map);
-            free(write_info->ranks);
-            free(write_info->chunkSizes);
             return FTI_NSCS;
         }
     }
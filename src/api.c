@@ -39,6 +39,8 @@
 #include "./interface.h"
 #include "IO/cuda-md5/md5Opt.h"
 
+#include <fcntl.h>
+
 #ifdef GPUSUPPORT
 #include <cuda_runtime_api.h>
 #endif
@@ -156,6 +158,7 @@ int FTI_Init(const char* configFile, MPI_Comm globalComm) {
     }
 
     FTI_KeyMap(&FTI_Data, sizeof(FTIT_dataset), FTI_Conf.maxVarId, true);
+    FTI_InitIntegrity(&FTI_Conf);
 
     FTI_Exec.initSCES = 1;
 
@@ -163,6 +166,8 @@ int FTI_Init(const char* configFile, MPI_Comm globalComm) {
     FTI_MetadataQueue(&FTI_Exec.mqueue);
 
     if (FTI_Topo.amIaHead) {  // If I am a FTI dedicated process
+        // the worker pool runs the post-processing of several ranks at once
+        FTI_InitHashEngine(&FTI_Conf, &FTI_Exec, &FTI_Topo);
         if (FTI_Exec.reco) {
             res = FTI_Try(FTI_RecoverFiles(&FTI_Conf, &FTI_Exec, &FTI_Topo,
              FTI_Ckpt), "recover the checkpoint files.");
@@ -194,6 +199,14 @@ int FTI_Init(const char* configFile, MPI_Comm globalComm) {
             FTI_initMD5(FTI_Conf.dcpInfoPosix.BlockSize, 32*1024*1024,
               &FTI_Conf);
         }
+        if (FTI_Conf.dcpTrack) {
+            FTI_InitDirtyTracking();
+        }
+        // the worker pool is shared by dCP hashing, L3 decoding, the
+        // recovery reader, the compression and the tree hash, each one
+        // runs on the threads of its own setting
+        FTI_InitCompression(&FTI_Conf);
+        FTI_InitHashEngine(&FTI_Conf, &FTI_Exec, &FTI_Topo);
         if (FTI_Exec.reco) {
             res = FTI_Try(FTI_RecoverFiles(&FTI_Conf, &FTI_Exec,
               &FTI_Topo, FTI_Ckpt), "recover the checkpoint files.");
@@ -801,7 +814,7 @@ int FTI_RenameGroup(FTIT_H5Group* h5group, char* name) {
 
  **/
 /*-------------------------------------------------------------------------*/
-int FTI_Protect(int id, void* ptr, int32_t count, fti_id_t tid) {
+int FTI_Protect(int id, void* ptr, int64_t count, fti_id_t tid) {
     if (FTI_Exec.initSCES == 0) {
         FTI_Print("FTI is not initialized.", FTI_WARN);
         return FTI_NSCS;
@@ -832,8 +845,10 @@ int FTI_Protect(int id, void* ptr, int32_t count, fti_id_t tid) {
         return FTI_NSCS;
     }
 
+    // A pending async. ckpt. keeps the layout of its snapshot, it is
+    // committed by the next collective call (see FTI_AsyncJoin)
     if (data != NULL) {  // Search for dataset with given id
-        int32_t prevSize = data->size;
+        int64_t prevSize = data->size;
 #ifdef GPUSUPPORT
         if (ptrInfo.type == FTIT_PTRTYPE_CPU) {
             // strcpy(memLocation, "CPU");
@@ -892,7 +907,7 @@ int FTI_Protect(int id, void* ptr, int32_t count, fti_id_t tid) {
         FTI_Print(str, FTI_DBUG);
         if (prevSize != data->size &&  FTI_Conf.dcpPosix) {
             if (!(data->isDevicePtr)) {
-                uint32_t nbHashes = data->size /
+                uint64_t nbHashes = data->size /
                 FTI_Conf.dcpInfoPosix.BlockSize +
                  (bool)(data->size %FTI_Conf.dcpInfoPosix.BlockSize);
                 data->dcpInfoPosix.currentHashArray = (unsigned char*)
@@ -907,10 +922,10 @@ int FTI_Protect(int id, void* ptr, int32_t count, fti_id_t tid) {
 #ifdef GPUSUPPORT
             else {
                 unsigned char *x;
-                uint32_t nbNewHashes = data->size /
+                uint64_t nbNewHashes = data->size /
                 FTI_Conf.dcpInfoPosix.BlockSize +
                  (bool)(data->size %FTI_Conf.dcpInfoPosix.BlockSize);
-                uint32_t nbOldHashes = prevSize /
+                uint64_t nbOldHashes = prevSize /
                 FTI_Conf.dcpInfoPosix.BlockSize +
                  (bool)(data->size %FTI_Conf.dcpInfoPosix.BlockSize);
                 CUDA_ERROR_CHECK(cudaMallocManaged((void**) &x,
@@ -1009,13 +1024,14 @@ int FTI_Protect(int id, void* ptr, int32_t count, fti_id_t tid) {
     data->rank = 1;
     data->dimLength[0] = data->count;
     data->h5group = FTI_Exec.H5groups[0];
+    data->attribute.compression.codec = FTI_CODEC_DEFAULT;
     // sprintf(data->name, "Dataset_%d", id);
     snprintf(data->name, sizeof(data->name), "Dataset_%d", id);
     FTI_Exec.ckptSize = FTI_Exec.ckptSize + (data->type->size * count);
 
     if (FTI_Conf.dcpPosix) {
         if (!(data->isDevicePtr)) {
-            uint32_t nbHashes = data->size /
+            uint64_t nbHashes = data->size /
             FTI_Conf.dcpInfoPosix.BlockSize
              + (bool)(data->size %FTI_Conf.dcpInfoPosix.BlockSize);
             data->dcpInfoPosix.hashDataSize = 0;
@@ -1029,7 +1045,7 @@ int FTI_Protect(int id, void* ptr, int32_t count, fti_id_t tid) {
 #ifdef GPUSUPPORT
         else {
             unsigned char *x;
-            uint32_t nbNewHashes = data->size /
+            uint64_t nbNewHashes = data->size /
             FTI_Conf.dcpInfoPosix.BlockSize +
              (bool)(data->size %FTI_Conf.dcpInfoPosix.BlockSize);
             CUDA_ERROR_CHECK(cudaMallocManaged((void**)&x,
@@ -1088,11 +1104,22 @@ int FTI_Protect(int id, void* ptr, int32_t count, fti_id_t tid) {
   flag can consist of any combination of the following flags:
     FTI_ATTRIBUTE_NAME
     FTI_ATTRIBUTE_DIM
+    FTI_ATTRIBUTE_COMPRESSION
+    FTI_ATTRIBUTE_DCP_TRACK
   flags can be combined by using the bitwise or operator. The attributes will
   appear inside the meta data files when a checkpoint is taken. When setting 
   the dimension of a dataset, the first dimension is the leading dimension, 
   i.e. the dimension that is stored contiguous inside a flat matrix 
-  representation. 
+  representation. The compression overrides the settings of the
+  configuration file for this dataset, FTI_CODEC_NONE stores it
+  uncompressed and FTI_CODEC_DEFAULT restores the configured compression.
+  An error mode other than FTI_ERROR_NONE compresses FTI_SFLT and FTI_DBLE
+  datasets lossy: every recovered element differs from the checkpointed
+  one by at most the error bound, taken relative to the value range of the
+  dataset with FTI_ERROR_REL. With 'untracked' set, the writes to the
+  dataset are not tracked by 'dcp_track', which is needed for memory
+  written by the kernel or by a device (read(2), RDMA or single-copy MPI
+  receives): its pages are writable again when the call returns.
  **/
 /*-------------------------------------------------------------------------*/
 int FTI_SetAttribute(int id, FTIT_attribute attribute,
@@ -1125,6 +1152,44 @@ int FTI_SetAttribute(int id, FTIT_attribute attribute,
         data->attribute.dim = attribute.dim;
     }
 
+    if ( (flag & FTI_ATTRIBUTE_COMPRESSION) == FTI_ATTRIBUTE_COMPRESSION ) {
+        if (!FTI_CodecAvailable(attribute.compression.codec)) {
+            char str[FTI_BUFS];
+            snprintf(str, FTI_BUFS, "failed to set attribute: codec %d is"
+             " not supported by this FTI build", attribute.compression.codec);
+            FTI_Print(str, FTI_WARN);
+            return FTI_NSCS;
+        }
+        FTIT_compression* comp = &attribute.compression;
+        if (comp->errorMode != FTI_ERROR_NONE) {
+            if ((comp->errorMode != FTI_ERROR_ABS &&
+             comp->errorMode != FTI_ERROR_REL) || !(comp->errorBound > 0)) {
+                FTI_Print("failed to set attribute: the lossy compression"
+                 " needs an absolute or relative error bound > 0", FTI_WARN);
+                return FTI_NSCS;
+            }
+            if (data->type->id != FTI_SFLT && data->type->id != FTI_DBLE) {
+                FTI_Print("failed to set attribute: the lossy compression"
+                 " needs a FTI_SFLT or FTI_DBLE dataset", FTI_WARN);
+                return FTI_NSCS;
+            }
+            if (FTI_LossyCodec() == FTI_CODEC_NONE) {
+                FTI_Print("failed to set attribute: the lossy compression"
+                 " needs a codec, none is supported by this FTI build",
+                 FTI_WARN);
+                return FTI_NSCS;
+            }
+        }
+        data->attribute.compression = attribute.compression;
+    }
+
+    if ( (flag & FTI_ATTRIBUTE_DCP_TRACK) == FTI_ATTRIBUTE_DCP_TRACK ) {
+        data->attribute.untracked = attribute.untracked;
+        if (data->attribute.untracked) {
+            FTI_DirtyTrackRelease(data);
+        }
+    }
+
     return FTI_SCES;
 }
 
@@ -1624,7 +1689,7 @@ int FTI_DefineDataset(int id, int rank, int* dimLength, char* name,
             // sprintf(str, "Trying to define datasize: number of elements %d,
             // but the dataset count is %ld.", expectedSize, data->count);
             snprintf(str, sizeof(str), "Trying to define datasize: number of"
-            " elements %d, but the dataset count is %d.",
+            " elements %d, but the dataset count is %ld.",
              expectedSize, data->count);
             FTI_Print(str, FTI_WARN);
             return FTI_NSCS;
@@ -1650,7 +1715,7 @@ int FTI_DefineDataset(int id, int rank, int* dimLength, char* name,
 /**
   @brief      Returns size saved in metadata of variable
   @param      id              Variable ID.
-  @return     int32_t            Returns size of variable or 0 if size not saved.
+  @return     int64_t            Returns size of variable or 0 if size not saved.
 
   This function returns size of variable of given ID that is saved in metadata.
   This may be different from size of variable that is in the program. If this
@@ -1659,7 +1724,7 @@ int FTI_DefineDataset(int id, int rank, int* dimLength, char* name,
   is no size saved in metadata it returns 0.
  **/
 /*-------------------------------------------------------------------------*/
-int32_t FTI_GetStoredSize(int id) {
+int64_t FTI_GetStoredSize(int id) {
     if (FTI_Exec.initSCES == 0) {
         FTI_Print("FTI is not initialized.", FTI_WARN);
         return 0;
@@ -1731,7 +1796,7 @@ void* FTI_Realloc(int id, void* ptr) {
         ptr = tmp;
 
         // sprintf(str, "Reallocated size: %ld", data->sizeStored);
-        snprintf(str, sizeof(str), "Reallocated size: %d", data->sizeStored);
+        snprintf(str, sizeof(str), "Reallocated size: %ld", data->sizeStored);
         FTI_Print(str, FTI_INFO);
 
         FTI_Exec.ckptSize += data->sizeStored - data->size;
@@ -1839,6 +1904,11 @@ int FTI_BitFlip(int id) {
   data, creates the metadata and the post-processing work. This function
   is complementary with the FTI_Listen function in terms of communications.
 
+  If asynchronous checkpoints are enabled ('async_ckpt'), the function
+  returns once the protected data is copied into the staging arena. The
+  data is written in background and the checkpoint is completed by
+  FTI_WaitCkpt.
+
  **/
 /*-------------------------------------------------------------------------*/
 int FTI_Checkpoint(int id, int level) {
@@ -1861,6 +1931,11 @@ int FTI_Checkpoint(int id, int level) {
         level -= 4;
     }
 
+    // Commit the previous checkpoint if it is still written in background
+    if (FTI_Exec.asyncInfo.status == FTI_ASYNC_ACTV) {
+        FTI_Try(FTI_WaitCkpt(), "complete the asynchronous checkpoint.");
+    }
+
     double t1, t2;
 
     FTI_Exec.ckptMeta.ckptId = id;
@@ -1919,6 +1994,18 @@ int FTI_Checkpoint(int id, int level) {
     int res = FTI_Try(FTI_WriteCkpt(&FTI_Conf, &FTI_Exec, &FTI_Topo, FTI_Ckpt,
      FTI_Data), "write the checkpoint.");
     t2 = MPI_Wtime();  // Time after writing checkpoint
+    // data is written in background, FTI_WaitCkpt completes the checkpoint
+    if (FTI_Exec.asyncInfo.status == FTI_ASYNC_ACTV) {
+        FTI_Exec.asyncInfo.t0 = t0;
+        FTI_Exec.asyncInfo.t1 = t1;
+        FTI_Exec.asyncInfo.t2 = t2;
+        snprintf(str, FTI_BUFS, "Ckpt. ID %d (L%d) snapshot taken in %.2f sec."
+        " (Wt:%.2fs, Cp:%.2fs), writing in background.",
+         FTI_Exec.ckptMeta.ckptId, FTI_Exec.ckptMeta.level, t2 - t0, t1 - t0,
+         t2 - t1);
+        FTI_Print(str, FTI_INFO);
+        return FTI_DONE;
+    }
     // no postprocessing or meta data for h5 single file
     if (res == FTI_SCES && FTI_Exec.h5SingleFile) {
 #ifdef ENABLE_HDF5
@@ -1927,85 +2014,74 @@ int FTI_Checkpoint(int id, int level) {
 #endif
     }
 
-    if (!FTI_Ckpt[FTI_Exec.ckptMeta.level].isInline) {
-        // If postCkpt. work is Async. then send message
-        FTI_Exec.activateHeads(&FTI_Conf, &FTI_Exec, &FTI_Topo, FTI_Ckpt, res);
-    } else {  // If post-processing is inline
-        FTI_Exec.wasLastOffline = 0;
-        if (res != FTI_SCES) {  // If Writing checkpoint failed
-            // The same as head call FTI_PostCkpt with reject
-            // ckptLvel if not success
-            FTI_Exec.ckptMeta.level = FTI_REJW - FTI_BASE;
-        }
-        res = FTI_Try(FTI_PostCkpt(&FTI_Conf, &FTI_Exec, &FTI_Topo, FTI_Ckpt),
-         "postprocess the checkpoint.");
-        if (res == FTI_SCES) {
-            FTI_Exec.ckptLvel = FTI_Exec.ckptMeta.level;  // Update level
-        }
-    }
-    double t3;
-
-    if (!FTI_Exec.hasCkpt && (FTI_Topo.splitRank == 0) && (res == FTI_SCES)) {
-        // Setting recover flag to 1 (to recover from current ckpt level)
-        res = FTI_Try(FTI_UpdateConf(&FTI_Conf, &FTI_Exec, 1),
-         "update configuration file.");
-        // in case FTI couldn't recover all ckpt files in FTI_Init
-        FTI_Exec.initSCES = 1;
-        if (res == FTI_SCES) {
-            FTI_Exec.hasCkpt = true;
-        }
+    res = FTI_FinishCkpt(&FTI_Conf, &FTI_Exec, &FTI_Topo, FTI_Ckpt,
+     FTI_Data, res, t0, t1, t2);
+    if (res == FTI_DONE) {
+        FTI_SchedRecordCost(&FTI_Conf, &FTI_Exec, FTI_Ckpt, MPI_Wtime() - t0);
     }
+    return res;
+}
 
-    MPI_Bcast(&FTI_Exec.hasCkpt, 1, MPI_INT, 0, FTI_COMM_WORLD);
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It completes a pending asynchronous checkpoint.
+  @return     integer         FTI_DONE if a checkpoint was completed.
 
-    t3 = MPI_Wtime();  // Time after post-processing
+  This function blocks until the background writer has written the
+  snapshot taken by FTI_Checkpoint, then creates the metadata and
+  triggers the post-ckpt. work as FTI_Checkpoint does for synchronous
+  checkpoints. It returns FTI_SCES if no checkpoint is pending and
+  FTI_NSCS if the checkpoint failed. This function is collective.
 
-    if (res != FTI_SCES) {
-        // sprintf(str, "Checkpoint with ID %d at Level %d failed.",
-        // FTI_Exec.ckptMeta.ckptId, FTI_Exec.ckptMeta.level);
-        snprintf(str, sizeof(str), "Checkpoint with ID %d at Level %d failed.",
-         FTI_Exec.ckptMeta.ckptId, FTI_Exec.ckptMeta.level);
-        FTI_Print(str, FTI_WARN);
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_WaitCkpt() {
+    if (FTI_Exec.initSCES == 0) {
+        FTI_Print("FTI is not initialized.", FTI_WARN);
         return FTI_NSCS;
     }
 
-    /*sprintf(str, "Ckpt. ID %d (L%d) (%.2f MB/proc) taken in %.2f sec. 
-    (Wt:%.2fs, Wr:%.2fs, Ps:%.2fs)",
-            FTI_Exec.ckptMeta.ckptId, FTI_Exec.ckptMeta.level, 
-            FTI_Exec.ckptSize / (1024.0 * 1024.0), t3 - t0,
-             t1 - t0, t2 - t1, t3 - t2);*/
-    snprintf(str, sizeof(str), "Ckpt. ID %d (L%d) (%.2f MB/proc) taken in %.2f"
-    " sec. (Wt:%.2fs, Wr:%.2fs, Ps:%.2fs)",
-            FTI_Exec.ckptMeta.ckptId, FTI_Exec.ckptMeta.level,
-             FTI_Exec.ckptSize / (1024.0 * 1024.0), t3 - t0, t1 - t0, t2 - t1,
-             t3 - t2);
-    FTI_Print(str, FTI_INFO);
+    if (FTI_Exec.asyncInfo.status != FTI_ASYNC_ACTV) {
+        return FTI_SCES;
+    }
+
+    double tj = MPI_Wtime();  // Time the application stopped computing
+    int res = FTI_AsyncJoin(&FTI_Exec, FTI_Data);
+    res = FTI_Try(FTI_CommitCkpt(&FTI_Conf, &FTI_Exec, &FTI_Topo, FTI_Ckpt,
+     FTI_Data, res), "write the checkpoint.");
+    FTI_Exec.asyncInfo.status = FTI_ASYNC_IDLE;
+    double t2 = MPI_Wtime();  // Time after writing checkpoint
 
-    if ( (FTI_Conf.dcpFtiff || FTI_Conf.dcpPosix) && FTI_Ckpt[4].isDcp ) {
-        FTI_PrintDcpStats(FTI_Conf, FTI_Exec, FTI_Topo);
+    res = FTI_FinishCkpt(&FTI_Conf, &FTI_Exec, &FTI_Topo, FTI_Ckpt,
+     FTI_Data, res, FTI_Exec.asyncInfo.t0, FTI_Exec.asyncInfo.t1, t2);
+    FTI_AsyncRestore(&FTI_Exec, FTI_Data);
+    if (res == FTI_DONE) {
+        // the application computed while the snapshot was written
+        FTI_SchedRecordCost(&FTI_Conf, &FTI_Exec, FTI_Ckpt, MPI_Wtime() - tj +
+         FTI_Exec.asyncInfo.t2 - FTI_Exec.asyncInfo.t0);
     }
+    return res;
+}
 
-    // update stored values to allow recovery online.
-    // FIXME in such a way, we don't cover the case !inline since at
-    // this point we cannot know if the
-    // postprocessing has been successfully.
-    // One way could be to convert tmp checkpoint into
-    // L1 checkpoint and update lateron.
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It tests if the asynchronous checkpoint data is written.
+  @return     integer         FTI_DONE if finished, FTI_SCES otherwise.
 
-    FTI_Exec.nbVarStored = FTI_Exec.nbVar;
-    FTI_Exec.ckptId = FTI_Exec.ckptMeta.ckptId;
+  This function does not block and is not collective. FTI_DONE is also
+  returned if no asynchronous checkpoint is pending. The checkpoint still
+  has to be completed with FTI_WaitCkpt (or implicitly by the next call
+  to FTI_Checkpoint or FTI_Finalize).
 
-    FTIT_dataset* data;
-    if (FTI_Data->data(&data, FTI_Exec.nbVar) != FTI_SCES) {
-        FTI_Print("failed to finalize FTI", FTI_WARN);
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_TestCkpt() {
+    if (FTI_Exec.initSCES == 0) {
+        FTI_Print("FTI is not initialized.", FTI_WARN);
         return FTI_NSCS;
     }
 
-    int k = 0; for (; k < FTI_Exec.nbVar; k++) {
-        data[k].sizeStored = data[k].size;
-    }
-
-    return FTI_DONE;
+    return FTI_AsyncTest(&FTI_Exec);
 }
 
 /*-------------------------------------------------------------------------*/
@@ -2038,6 +2114,8 @@ int FTI_InitICP(int id, int level, bool activate) {
         return FTI_SCES;
     }
 
+    FTI_Try(FTI_WaitCkpt(), "complete the asynchronous checkpoint.");
+
     FTI_Exec.h5SingleFile = false;
     if (level == FTI_L4_H5_SINGLE) {
         if (FTI_Conf.h5SingleFileEnable) {
@@ -2292,13 +2370,13 @@ int FTI_FinalizeICP() {
 
     if ((FTI_Conf.dcpFtiff || FTI_Conf.dcpPosix) && FTI_Ckpt[4].isDcp) {
         // After dCP update store total data and dCP sizes in application rank0
-        uint32_t *dataSize = (FTI_Conf.dcpFtiff)?(uint32_t*)&
+        uint64_t *dataSize = (FTI_Conf.dcpFtiff)?(uint64_t*)&
         FTI_Exec.FTIFFMeta.pureDataSize:&FTI_Exec.dcpInfoPosix.dataSize;
-        uint32_t *dcpSize = (FTI_Conf.dcpFtiff)?(uint32_t*)&
+        uint64_t *dcpSize = (FTI_Conf.dcpFtiff)?(uint64_t*)&
         FTI_Exec.FTIFFMeta.dcpSize:&FTI_Exec.dcpInfoPosix.dcpSize;
-        uint32_t dcpStats[2];  // 0:totalDcpSize, 1:totalDataSize
-        uint32_t sendBuf[] = { *dcpSize, *dataSize };
-        MPI_Reduce(sendBuf, dcpStats, 2, MPI_UINT32_T, MPI_SUM, 0,
+        uint64_t dcpStats[2];  // 0:totalDcpSize, 1:totalDataSize
+        uint64_t sendBuf[] = { *dcpSize, *dataSize };
+        MPI_Reduce(sendBuf, dcpStats, 2, MPI_UINT64_T, MPI_SUM, 0,
          FTI_COMM_WORLD);
         if (FTI_Topo.splitRank ==  0) {
             *dcpSize = dcpStats[0];
@@ -2410,15 +2488,56 @@ int FTI_FinalizeICP() {
 
 /*-------------------------------------------------------------------------*/
 /**
-  @brief      It loads the checkpoint data.
+  @brief      It settles a recovery with verification on load.
+  @param      corrupt         1 if the ckpt. file of this rank is corrupted.
+  @return     integer         FTI_SCES if successful.
+
+  With 'verify_on_load', the checksums of the L1, L2 and L3 ckpt. files
+  are verified when they are loaded. The ranks agree on the result, the
+  older checkpoints are discarded if all files are valid. Otherwise, the
+  ckpt. files are recovered again and the metadata of the datasets is
+  reloaded, 'corrupt' is then set on all ranks so that the data is loaded
+  again.
+
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_SettleRecovery(int* corrupt) {
+    if (!FTI_Exec.recoDeferred) {
+        return FTI_SCES;
+    }
+    FTI_Exec.recoDeferred = false;
+    FTI_Exec.recoChecksum[0] = '\0';
+    MPI_Allreduce(MPI_IN_PLACE, corrupt, 1, MPI_INT, MPI_MAX, FTI_COMM_WORLD);
+    if (!*corrupt) {
+        FTI_Exec.mqueue.clear(&FTI_Exec.mqueue);
+        return FTI_SCES;
+    }
+
+    FTI_Print("Corrupted checkpoint file, recovering the checkpoint"
+     " files again.", FTI_INFO);
+    if (FTI_RecoverFallback(&FTI_Conf, &FTI_Exec, &FTI_Topo, FTI_Ckpt)
+     != FTI_SCES || FTI_LoadMetaDataset(&FTI_Conf, &FTI_Exec, &FTI_Topo,
+     FTI_Ckpt, FTI_Data) != FTI_SCES) {
+        FTI_Exec.reco = 0;
+        FTI_Exec.initSCES = 2;
+        return FTI_NREC;
+    }
+    return FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It reads the checkpoint data from the checkpoint file.
+  @param      corrupt         Set to 1 if the checksum does not match.
   @return     integer         FTI_SCES if successful.
 
   This function loads the checkpoint data from the checkpoint file and
-  it updates some basic checkpoint information.
+  it updates some basic checkpoint information. With 'verify_on_load',
+  the checksum of the file is computed from the loaded data.
 
  **/
 /*-------------------------------------------------------------------------*/
-int FTI_Recover() {
+static int FTI_RecoverLoad(int* corrupt) {
     if ( FTI_Conf.ioMode == FTI_IO_FTIFF ) {
         int ret = FTI_Try(FTIFF_Recover(&FTI_Exec, FTI_Data, FTI_Ckpt),
          "Recovering from Checkpoint");
@@ -2434,6 +2553,10 @@ int FTI_Recover() {
         return FTI_NREC;
     }
 
+    FTI_Try(FTI_WaitCkpt(), "complete the asynchronous checkpoint.");
+    // the recovered datasets are written, writes are not tracked anymore
+    FTI_DirtyTrackDisarm();
+
     int i;
     char fn[FTI_BUFS];  // Path to the checkpoint file
     char str[2*FTI_BUFS];  // For console output
@@ -2474,8 +2597,8 @@ int FTI_Recover() {
                 protected variable (ID %d) size: %ld",
                         data[i].sizeStored, data[i].id,
                         data[i].size);*/
-                snprintf(str, sizeof(str), "Cannot recover %d bytes to "
-                  "protected variable (ID %d) size: %d",
+                snprintf(str, sizeof(str), "Cannot recover %ld bytes to "
+                  "protected variable (ID %d) size: %ld",
                         data[i].sizeStored, data[i].id,
                         data[i].size);
                 FTI_Print(str, FTI_WARN);
@@ -2510,8 +2633,8 @@ int FTI_Recover() {
                         FTI_Exec.dcpInfoPosix.datasetInfo[lidx][i].varSize, 
                         FTI_Exec.dcpInfoPosix.datasetInfo[lidx][i].varID,
                         data->sizeStored);*/
-                snprintf(str, sizeof(str), "Cannot recover %d bytes to "
-                  "protected variable (ID %d) size: %d",
+                snprintf(str, sizeof(str), "Cannot recover %lu bytes to "
+                  "protected variable (ID %d) size: %ld",
                         FTI_Exec.dcpInfoPosix.datasetInfo[lidx][i].varSize,
                          FTI_Exec.dcpInfoPosix.datasetInfo[lidx][i].varID,
                         data->sizeStored);
@@ -2553,8 +2676,8 @@ int FTI_Recover() {
       fn);
     FTI_Print(str, FTI_DBUG);
 
-    FILE* fd = fopen(fn, "rb");
-    if (fd == NULL) {
+    int fd = open(fn, O_RDONLY);
+    if (fd == -1) {
         // sprintf(str, "Could not open FTI checkpoint file. (%s)...", fn);
         snprintf(str, sizeof(str), "Could not open FTI checkpoint file."
           " (%s)...", fn);
@@ -2564,42 +2687,85 @@ int FTI_Recover() {
 
     if (FTI_Data->data(&data, FTI_Exec.nbVarStored) != FTI_SCES) {
         FTI_Print("failed to recover", FTI_WARN);
+        close(fd);
         return FTI_NREC;
     }
 
-#ifdef GPUSUPPORT
-
+    // all variables in host memory are read at once, sorted by file offset,
+    // compressed variables are read to a buffer and decompressed after
+    FTIT_extent* ext = talloc(FTIT_extent, FTI_Exec.nbVarStored);
+    void** packed = calloc(FTI_Exec.nbVarStored, sizeof(void*));
+    int nbExt = 0, res = FTI_SCES;
+    for (i = 0; i < FTI_Exec.nbVarStored && res == FTI_SCES; i++) {
+        if (data[i].isDevicePtr) {
+            if (data[i].fileCodec != FTI_CODEC_NONE) {
+                snprintf(str, sizeof(str), "Dataset #%d is compressed and"
+                 " cannot be recovered to device memory.", data[i].id);
+                FTI_Print(str, FTI_EROR);
+                res = FTI_NSCS;
+            }
+            continue;
+        }
+        ext[nbExt].offset = data[i].filePos;
+        ext[nbExt].dest = data[i].ptr;
+        ext[nbExt].size = data[i].sizeStored;
+        if (data[i].fileCodec != FTI_CODEC_NONE) {
+            packed[i] = malloc(data[i].fileSize);
+            if (packed[i] == NULL) {
+                FTI_Print("Cannot allocate the compressed data.", FTI_EROR);
+                res = FTI_NSCS;
+            }
+            ext[nbExt].dest = packed[i];
+            ext[nbExt].size = data[i].fileSize;
+        }
+        nbExt++;
+    }
+    if (res == FTI_SCES) {
+        res = FTI_ReadExtents(fd, ext, nbExt);
+    }
+    if (res == FTI_SCES && FTI_Exec.recoChecksum[0] != '\0') {
+        if (FTI_VerifyExtents(fn, ext, nbExt, FTI_Exec.ckptMeta.fs,
+         FTI_Exec.recoChecksum) != FTI_SCES) {
+            *corrupt = 1;
+            res = FTI_NSCS;
+        }
+        FTI_Exec.recoChecksum[0] = '\0';
+    }
     for (i = 0; i < FTI_Exec.nbVarStored; i++) {
-        size_t filePos = data[i].filePosStored;
-        // strncpy(data[i].idChar, data[i].idChar, FTI_BUFS);
-        fseek(fd, filePos, SEEK_SET);
-        if (data[i].isDevicePtr)
-            FTI_TransferFileToDeviceAsync(fd, data[i].devicePtr,
+        if (packed[i] != NULL && res == FTI_SCES) {
+            res = FTI_Decompress(packed[i], data[i].fileSize, data[i].ptr,
              data[i].sizeStored);
-        else
-            fread(data[i].ptr, 1, data[i].sizeStored, fd);
-
-        if (ferror(fd)) {
-            FTI_Print("Could not read FTI checkpoint file.", FTI_EROR);
-            fclose(fd);
-            return FTI_NREC;
         }
+        free(packed[i]);
     }
+    free(packed);
+    free(ext);
 
-#else
-    for (i = 0; i < FTI_Exec.nbVarStored; i++) {
-        size_t filePos = data[i].filePos;
-        // strncpy(data[i].idChar, data[i].idChar, FTI_BUFS);
-        fseek(fd, filePos, SEEK_SET);
-        fread(data[i].ptr, 1, data[i].sizeStored, fd);
-        if (ferror(fd)) {
-            FTI_Print("Could not read FTI checkpoint file.", FTI_EROR);
-            fclose(fd);
-            return FTI_NREC;
+#ifdef GPUSUPPORT
+    // device datasets are staged through the host buffers
+    if (res == FTI_SCES && nbExt < FTI_Exec.nbVarStored) {
+        FILE* f = fopen(fn, "rb");
+        res = (f == NULL) ? FTI_NSCS : FTI_SCES;
+        for (i = 0; i < FTI_Exec.nbVarStored && res == FTI_SCES; i++) {
+            if (data[i].isDevicePtr) {
+                fseek(f, data[i].filePos, SEEK_SET);
+                res = FTI_TransferFileToDeviceAsync(f, data[i].devicePtr,
+                 data[i].sizeStored);
+            }
+        }
+        if (f != NULL) {
+            fclose(f);
         }
     }
 #endif
-    if (fclose(fd) != 0) {
+    if (res != FTI_SCES) {
+        if (!*corrupt) {
+            FTI_Print("Could not read FTI checkpoint file.", FTI_EROR);
+        }
+        close(fd);
+        return FTI_NREC;
+    }
+    if (close(fd) != 0) {
         FTI_Print("Could not close FTI checkpoint file.", FTI_EROR);
         return FTI_NREC;
     }
@@ -2609,6 +2775,27 @@ int FTI_Recover() {
     return FTI_SCES;
 }
 
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It loads the checkpoint data.
+  @return     integer         FTI_SCES if successful.
+
+  This function loads the checkpoint data from the checkpoint file and
+  it updates some basic checkpoint information. With 'verify_on_load',
+  the function is collective and the data is loaded again from the
+  recovered files if a ckpt. file is corrupted.
+
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_Recover() {
+    int corrupt = 0;
+    int res = FTI_RecoverLoad(&corrupt);
+    if (FTI_SettleRecovery(&corrupt) != FTI_SCES) {
+        return FTI_NREC;
+    }
+    return (corrupt) ? FTI_RecoverLoad(&corrupt) : res;
+}
+
 /*-------------------------------------------------------------------------*/
 /**
   @brief      Takes an FTI snapshot or recovers the data if it is a restart.
@@ -2641,26 +2828,31 @@ int FTI_Snapshot() {
         if (FTI_Exec.ckptNext == FTI_Exec.ckptIcnt) {
             // If it is time to check for possible ckpt. (every minute)
             FTI_Print("Checking if it is time to checkpoint.", FTI_DBUG);
-            if (FTI_Exec.globMeanIter > 60) {
-                FTI_Exec.minuteCnt = FTI_Exec.totalIterTime/60;
+            if (FTI_Conf.ckptSched == FTI_SCHED_ADAPTIVE) {
+                // intervals planned from the measured cost and the MTBF
+                level = FTI_SchedLevel(&FTI_Conf, &FTI_Exec, FTI_Ckpt);
             } else {
-                FTI_Exec.minuteCnt++;  // Increment minute counter
-            }
-            for (i = 1; i < 5; i++) {  // Check ckpt. level
-                if ( (FTI_Ckpt[i].ckptDcpIntv > 0)
-                        && (FTI_Exec.minuteCnt/
-                          (FTI_Ckpt[i].ckptDcpCnt*FTI_Ckpt[i].ckptDcpIntv)) ) {
-                    // dCP level is level + 4
-                    level = i + 4;
-                    // counts the passed intervall times (if taken or not...)
-                    FTI_Ckpt[i].ckptDcpCnt++;
+                if (FTI_Exec.globMeanIter > 60) {
+                    FTI_Exec.minuteCnt = FTI_Exec.totalIterTime/60;
+                } else {
+                    FTI_Exec.minuteCnt++;  // Increment minute counter
                 }
-                if ((FTI_Ckpt[i].ckptIntv) > 0
-                        && (FTI_Exec.minuteCnt/
-                          (FTI_Ckpt[i].ckptCnt*FTI_Ckpt[i].ckptIntv))) {
-                    level = i;
-                    // counts the passed intervall times (if taken or not...)
-                    FTI_Ckpt[i].ckptCnt++;
+                for (i = 1; i < 5; i++) {  // Check ckpt. level
+                    if ( (FTI_Ckpt[i].ckptDcpIntv > 0)
+                            && (FTI_Exec.minuteCnt/(FTI_Ckpt[i].ckptDcpCnt*
+                              FTI_Ckpt[i].ckptDcpIntv)) ) {
+                        // dCP level is level + 4
+                        level = i + 4;
+                        // counts the passed intervall times (taken or not)
+                        FTI_Ckpt[i].ckptDcpCnt++;
+                    }
+                    if ((FTI_Ckpt[i].ckptIntv) > 0
+                            && (FTI_Exec.minuteCnt/
+                              (FTI_Ckpt[i].ckptCnt*FTI_Ckpt[i].ckptIntv))) {
+                        level = i;
+                        // counts the passed intervall times (taken or not)
+                        FTI_Ckpt[i].ckptCnt++;
+                    }
                 }
             }
             if (level != -1) {
@@ -2694,6 +2886,13 @@ int FTI_Finalize() {
         FTI_Print("FTI is not initialized.", FTI_WARN);
         return FTI_NSCS;
     }
+
+    FTI_Try(FTI_WaitCkpt(), "complete the asynchronous checkpoint.");
+    FTI_AsyncFree(&FTI_Exec);
+    FTI_DcpPosixCompactFinalize(&FTI_Exec);
+    FTI_FinalizeDirtyTracking();
+    FTI_FreeMetadata(&FTI_Exec, &FTI_Topo);
+
     MPI_Barrier(FTI_COMM_WORLD);
     if (FTI_Topo.amIaHead) {
         if ( FTI_Conf.stagingEnabled ) {
@@ -2830,6 +3029,7 @@ int FTI_Finalize() {
     if (FTI_Conf.dcpFtiff) {
         FTI_FinalizeDcp(&FTI_Conf, &FTI_Exec);
     }
+    FTI_FinalizeHashEngine();
 
     FTI_FreeTypesAndGroups(&FTI_Exec);
     if (FTI_Conf.ioMode == FTI_IO_FTIFF) {
@@ -2890,6 +3090,17 @@ int FTI_RecoverVarInit() {
         snprintf(fn, FTI_BUFS, "%s/%s", FTI_Ckpt[FTI_Exec.ckptLvel].dir,
          FTI_Exec.ckptMeta.ckptFile);
     }
+    // with 'verify_on_load', the file is verified before it is read
+    if (FTI_Exec.recoDeferred) {
+        int corrupt = (FTI_Exec.recoChecksum[0] != '\0' &&
+         FTI_VerifyChecksum(fn, FTI_Exec.recoChecksum) != FTI_SCES);
+        if (FTI_SettleRecovery(&corrupt) != FTI_SCES) {
+            return FTI_NSCS;
+        }
+        if (corrupt) {
+            return FTI_RecoverVarInit();
+        }
+    }
     // Check if sizes of protected variables matches
     // switch case
     switch (FTI_Conf.ioMode) {
@@ -2941,6 +3152,11 @@ int FTI_RecoverVarInit() {
 /*-------------------------------------------------------------------------*/
 int FTI_RecoverVar(int id) {
     int res = FTI_NSCS;
+    // only the recovered dataset is written, the others stay tracked
+    FTIT_dataset* data;
+    if ((FTI_Data->get(&data, id) == FTI_SCES) && data) {
+        FTI_DirtyTrackRelease(data);
+    }
     // Recovering from local for L4 case in FTI_Recover
     if (FTI_Exec.ckptLvel == 4) {
         if (FTI_Ckpt[4].recoIsDcp && FTI_Conf.dcpPosix) {
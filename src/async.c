@@ -0,0 +1,364 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  FTI - A multi-level checkpointing library for C/C++/Fortran applications
+ *
+ *  Revision 1.0 : Fault Tolerance Interface (FTI)
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *  list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors
+ *  may be used to endorse or promote products derived from this software without
+ *  specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  @file   async.c
+ *  @date   October, 2026
+ *  @brief  Background writer for asynchronous checkpoints.
+ */
+
+#include "async.h"
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It decides if the current checkpoint is written in background.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Ckpt        Checkpoint metadata.
+  @param      FTI_Data        Dataset metadata.
+  @return     integer         TRUE if the checkpoint is asynchronous.
+
+  Asynchronous checkpoints are used for POSIX checkpoints if enabled with
+  'async_ckpt'. dCP and VPR checkpoints as well as datasets located in
+  device memory are always written synchronously. The decision is taken
+  collectively, since the checkpoint is committed collectively later on.
+
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_AsyncEnabled(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
+        FTIT_checkpoint* FTI_Ckpt, FTIT_keymap* FTI_Data) {
+    if (!FTI_Conf->asyncCkpt) {
+        return false;
+    }
+
+    int i, local = !FTI_Exec->h5SingleFile && !FTI_Ckpt[4].isDcp;
+    // The aggregated L4 write is collective over the aggregation group
+    if ((FTI_Exec->aggComm != MPI_COMM_NULL) &&
+     (FTI_Exec->ckptMeta.level == 4) && FTI_Ckpt[4].isInline) {
+        local = false;
+    }
+
+    FTIT_dataset* data;
+    if (FTI_Data->data(&data, FTI_Exec->nbVar) != FTI_SCES) {
+        local = false;
+    } else {
+        for (i = 0; i < FTI_Exec->nbVar; i++) {
+            if (data[i].isDevicePtr) {
+                local = false;
+            }
+        }
+    }
+
+    int all;
+    MPI_Allreduce(&local, &all, 1, MPI_INT, MPI_MIN, FTI_COMM_WORLD);
+    return all;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It snapshots the protected data and starts the writer thread.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+  @param      FTI_Ckpt        Checkpoint metadata.
+  @param      FTI_Data        Dataset metadata.
+  @param      io              IO function pointers
+  @return     integer         FTI_SCES if successful.
+
+  The protected datasets are copied into the staging arena, which is kept
+  between checkpoints and only grows if the checkpoint grows. The copies
+  are written by FTI_AsyncWriter in background, so the application may
+  modify its buffers as soon as this function returns.
+
+  If the arena cannot be allocated or the thread cannot be created, the
+  data is written synchronously. In any case the checkpoint becomes
+  active and has to be committed by FTI_WaitCkpt, so that all ranks take
+  the same path through the collective part of the checkpoint.
+
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_AsyncWrite(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
+        FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt,
+        FTIT_keymap* FTI_Data, FTIT_IO *io) {
+    FTIT_asyncInfo* async = &FTI_Exec->asyncInfo;
+    char str[FTI_BUFS];
+    int i;
+
+    async->status = FTI_ASYNC_ACTV;
+    async->result = FTI_NSCS;
+    async->done = false;
+    async->isThreaded = false;
+    async->nbVar = 0;
+
+    FTIT_dataset* data;
+    if (FTI_Data->data(&data, FTI_Exec->nbVar) != FTI_SCES) {
+        async->done = true;
+        return FTI_SCES;
+    }
+
+    size_t size = 0;
+    for (i = 0; i < FTI_Exec->nbVar; i++) {
+        size += data[i].size;
+    }
+
+    if (size > async->arenaSize) {
+        void* arena = realloc(async->arena, size);
+        if (arena != NULL) {
+            async->arena = arena;
+            async->arenaSize = size;
+        }
+    }
+    FTIT_dataset* snapshot = (FTIT_dataset*) realloc(async->snapshot,
+     sizeof(FTIT_dataset) * (FTI_Exec->nbVar + 1));
+    if (snapshot != NULL) {
+        async->snapshot = snapshot;
+    }
+
+    if ((size > async->arenaSize) || (snapshot == NULL)) {
+        snprintf(str, FTI_BUFS, "Unable to allocate %lu bytes for the"
+        " async. ckpt. snapshot, writing synchronously.", size);
+        FTI_Print(str, FTI_WARN);
+        async->result = FTI_WriteDatasets(FTI_Conf, FTI_Exec, FTI_Topo,
+         FTI_Ckpt, FTI_Data, data, FTI_Exec->nbVar, io, async->integrity);
+        async->done = true;
+        return FTI_SCES;
+    }
+
+    char* ptr = (char*) async->arena;
+    for (i = 0; i < FTI_Exec->nbVar; i++) {
+        async->snapshot[i] = data[i];
+        async->snapshot[i].ptr = ptr;
+        memcpy(ptr, data[i].ptr, data[i].size);
+        ptr += data[i].size;
+    }
+    async->nbVar = FTI_Exec->nbVar;
+    async->ckptSize = FTI_Exec->ckptSize;
+
+    async->conf = FTI_Conf;
+    async->exec = FTI_Exec;
+    async->topo = FTI_Topo;
+    async->ckpt = FTI_Ckpt;
+    async->data = FTI_Data;
+    async->io = io;
+
+    pthread_mutex_init(&async->lock, NULL);
+    if (pthread_create(&async->thread, NULL, FTI_AsyncWriter, async) != 0) {
+        FTI_Print("Unable to start the async. ckpt. writer, writing"
+        " synchronously.", FTI_WARN);
+        pthread_mutex_destroy(&async->lock);
+        FTI_AsyncWriter(async);
+        return FTI_SCES;
+    }
+    async->isThreaded = true;
+
+    snprintf(str, FTI_BUFS, "Async. ckpt. writer started for %lu bytes.",
+     size);
+    FTI_Print(str, FTI_DBUG);
+    return FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Entry point of the background writer.
+  @param      arg             Async. ckpt. info (FTIT_asyncInfo).
+  @return     void*           NULL.
+
+  Writes the snapshot through the regular I/O functions. The writer does
+  not call MPI, the collective part is done when the thread is joined. The
+  checksum of the file is kept in the async. info until then.
+
+ **/
+/*-------------------------------------------------------------------------*/
+void* FTI_AsyncWriter(void* arg) {
+    FTIT_asyncInfo* async = (FTIT_asyncInfo*) arg;
+
+    int res = FTI_WriteDatasets(async->conf, async->exec, async->topo,
+     async->ckpt, async->data, async->snapshot, async->nbVar, async->io,
+     async->integrity);
+
+    if (async->isThreaded) {
+        pthread_mutex_lock(&async->lock);
+    }
+    async->result = res;
+    async->done = true;
+    if (async->isThreaded) {
+        pthread_mutex_unlock(&async->lock);
+    }
+    return NULL;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It tests if the background writer has finished.
+  @param      FTI_Exec        Execution metadata.
+  @return     integer         FTI_DONE if finished, FTI_SCES otherwise.
+
+  This function does not block and is local to the calling rank.
+
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_AsyncTest(FTIT_execution* FTI_Exec) {
+    FTIT_asyncInfo* async = &FTI_Exec->asyncInfo;
+
+    if (async->status != FTI_ASYNC_ACTV || !async->isThreaded) {
+        return FTI_DONE;
+    }
+
+    pthread_mutex_lock(&async->lock);
+    int done = async->done;
+    pthread_mutex_unlock(&async->lock);
+
+    return (done) ? FTI_DONE : FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It joins the background writer.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Data        Dataset metadata.
+  @return     integer         Result of the background write.
+
+  Blocks until the writer has finished, publishes the checksum of the file
+  it wrote and installs the datasets of the snapshot, with their file
+  positions, in place of the protected ones, as the checkpoint metadata
+  describes the snapshot. The application may have
+  protected new datasets or changed the count or type of some since the
+  snapshot was taken. The protected datasets are kept aside and are put
+  back by FTI_AsyncRestore once the checkpoint is committed. The datasets
+  are matched by id, the snapshot datasets come first in the key map since
+  FTI_Protect only appends new ones.
+
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_AsyncJoin(FTIT_execution* FTI_Exec, FTIT_keymap* FTI_Data) {
+    FTIT_asyncInfo* async = &FTI_Exec->asyncInfo;
+    int i;
+
+    if (async->isThreaded) {
+        pthread_join(async->thread, NULL);
+        pthread_mutex_destroy(&async->lock);
+        async->isThreaded = false;
+    }
+    memcpy(FTI_Exec->integrity, async->integrity, MD5_DIGEST_STRING_LENGTH);
+
+    async->nbLive = 0;
+    if (async->nbVar == 0) {
+        return async->result;
+    }
+
+    FTIT_dataset* data;
+    if (FTI_Data->data(&data, FTI_Exec->nbVar) != FTI_SCES) {
+        return FTI_NSCS;
+    }
+    FTIT_dataset* live = (FTIT_dataset*) realloc(async->live,
+     sizeof(FTIT_dataset) * FTI_Exec->nbVar);
+    if (live == NULL) {
+        FTI_Print("Unable to save the protected datasets for the async."
+        " ckpt. commit.", FTI_WARN);
+        return FTI_NSCS;
+    }
+    async->live = live;
+    memcpy(async->live, data, sizeof(FTIT_dataset) * FTI_Exec->nbVar);
+    async->nbLive = FTI_Exec->nbVar;
+    async->liveSize = FTI_Exec->ckptSize;
+
+    for (i = 0; i < async->nbVar; i++) {
+        if (FTI_Data->get(&data, async->snapshot[i].id) != FTI_SCES ||
+         data == NULL) {
+            FTI_Print("A dataset of the async. ckpt. snapshot is not"
+            " protected anymore.", FTI_WARN);
+            FTI_AsyncRestore(FTI_Exec, FTI_Data);
+            return FTI_NSCS;
+        }
+        *data = async->snapshot[i];
+    }
+    FTI_Exec->nbVar = async->nbVar;
+    FTI_Exec->ckptSize = async->ckptSize;
+
+    return async->result;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It puts back the protected datasets after the commit.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Data        Dataset metadata.
+
+  Undoes FTI_AsyncJoin. The file positions and stored sizes of the
+  committed checkpoint are kept, they describe the data in the file and
+  are needed to recover it.
+
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_AsyncRestore(FTIT_execution* FTI_Exec, FTIT_keymap* FTI_Data) {
+    FTIT_asyncInfo* async = &FTI_Exec->asyncInfo;
+    int i;
+
+    for (i = 0; i < async->nbLive; i++) {
+        FTIT_dataset* data;
+        if (FTI_Data->get(&data, async->live[i].id) != FTI_SCES ||
+         data == NULL) {
+            continue;
+        }
+        FTIT_dataset committed = *data;
+        *data = async->live[i];
+        data->filePos = committed.filePos;
+        data->fileSize = committed.fileSize;
+        data->fileCodec = committed.fileCodec;
+        data->sizeStored = committed.sizeStored;
+    }
+    if (async->nbLive > 0) {
+        FTI_Exec->nbVar = async->nbLive;
+        FTI_Exec->ckptSize = async->liveSize;
+    }
+    async->nbLive = 0;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It frees the staging arena of the asynchronous checkpoints.
+  @param      FTI_Exec        Execution metadata.
+
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_AsyncFree(FTIT_execution* FTI_Exec) {
+    FTIT_asyncInfo* async = &FTI_Exec->asyncInfo;
+
+    free(async->arena);
+    free(async->snapshot);
+    free(async->live);
+    async->arena = NULL;
+    async->snapshot = NULL;
+    async->live = NULL;
+    async->arenaSize = 0;
+    async->nbVar = 0;
+}
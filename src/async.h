@@ -0,0 +1,29 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  @file   async.h
+ */
+
+#ifndef FTI_SRC_ASYNC_H_
+#define FTI_SRC_ASYNC_H_
+
+#include <pthread.h>
+
+#include "interface.h"
+
+#define FTI_ASYNC_IDLE 0
+#define FTI_ASYNC_ACTV 1
+
+int FTI_AsyncEnabled(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
+        FTIT_checkpoint* FTI_Ckpt, FTIT_keymap* FTI_Data);
+int FTI_AsyncWrite(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
+        FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt,
+        FTIT_keymap* FTI_Data, FTIT_IO *io);
+void* FTI_AsyncWriter(void* arg);
+int FTI_AsyncTest(FTIT_execution* FTI_Exec);
+int FTI_AsyncJoin(FTIT_execution* FTI_Exec, FTIT_keymap* FTI_Data);
+void FTI_AsyncRestore(FTIT_execution* FTI_Exec, FTIT_keymap* FTI_Data);
+void FTI_AsyncFree(FTIT_execution* FTI_Exec);
+
+#endif  // FTI_SRC_ASYNC_H_
@@ -41,6 +41,7 @@
 #endif
 
 #include <math.h>
+#include <time.h>
 
 #include "checkpoint.h"
 
@@ -75,10 +76,11 @@ int FTI_UpdateIterTime(FTIT_execution* FTI_Exec) {
              MPI_DOUBLE, MPI_SUM, FTI_COMM_WORLD);
             MPI_Comm_size(FTI_COMM_WORLD, &nbProcs);
             FTI_Exec->globMeanIter = FTI_Exec->globMeanIter / nbProcs;
-            if (FTI_Exec->globMeanIter > 60) {
+            if (FTI_Exec->globMeanIter > FTI_Exec->sched.tick) {
                 FTI_Exec->ckptIntv = 1;
             } else {
-                FTI_Exec->ckptIntv = rint(60.0 / FTI_Exec->globMeanIter);
+                FTI_Exec->ckptIntv = rint(FTI_Exec->sched.tick /
+                 FTI_Exec->globMeanIter);
                 FTI_Exec->ckptIntv = ceil((double)FTI_Exec->ckptIntv/FTI_Exec->fastForward);
             }
             res = FTI_Exec->ckptLast + FTI_Exec->ckptIntv;
@@ -148,6 +150,7 @@ int FTI_WriteCkpt(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     }
     // If checkpoint is inlin and level 4 save directly to PFS
     int res;  // response from writing funcitons
+    int funcID;
     int offset = 2*(FTI_Conf->dcpPosix || FTI_Conf->dcpFtiff);
     if (((FTI_Ckpt[4].isInline && (FTI_Exec->ckptMeta.level == 4)) &&
      !FTI_Exec->h5SingleFile) || (FTI_Exec->h5SingleFile &&
@@ -158,8 +161,7 @@ int FTI_WriteCkpt(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         } else if (!FTI_Ckpt[4].hasDcp) {
             MKDIR(FTI_Ckpt[4].dcpDir, 0777);
         }
-        res = FTI_Exec->ckptFunc[GLOBAL](FTI_Conf, FTI_Exec, FTI_Topo,
-         FTI_Ckpt, FTI_Data, &ftiIO[offset + GLOBAL]);
+        funcID = GLOBAL;
     } else {
         if (!((FTI_Conf->dcpFtiff || FTI_Conf->dcpPosix) &&
          FTI_Ckpt[4].isDcp)) {
@@ -167,15 +169,61 @@ int FTI_WriteCkpt(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         } else if ( !FTI_Ckpt[4].hasDcp ) {
             MKDIR(FTI_Ckpt[1].dcpDir, 0777);
         }
-        res = FTI_Exec->ckptFunc[LOCAL](FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt,
-         FTI_Data, &ftiIO[offset + LOCAL]);
+        funcID = LOCAL;
     }
 
+    // The variable records are gathered while the data is written
+    int metaRes = FTI_Try(FTI_PostMetadata(FTI_Conf, FTI_Exec, FTI_Topo,
+     FTI_Data), "post the variable metadata.");
+
+    // Hand the data over to the background writer if possible. The
+    // checkpoint is committed by FTI_CommitCkpt once the writer is joined.
+    if ((metaRes == FTI_SCES) &&
+     FTI_AsyncEnabled(FTI_Conf, FTI_Exec, FTI_Ckpt, FTI_Data)) {
+        return FTI_AsyncWrite(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt,
+         FTI_Data, &ftiIO[offset + funcID]);
+    }
+
+    res = FTI_Exec->ckptFunc[funcID](FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt,
+     FTI_Data, &ftiIO[offset + funcID]);
+
+    return FTI_CommitCkpt(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt, FTI_Data,
+     (metaRes == FTI_SCES) ? res : FTI_NSCS);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It completes a checkpoint after the data has been written.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+  @param      FTI_Ckpt        Checkpoint metadata.
+  @param      FTI_Data        Dataset metadata.
+  @param      res             Local result of the data write.
+  @return     integer         FTI_SCES if successful.
+
+  This function checks that all processes have written their checkpoint
+  data, gathers the dCP statistics, starts merging the dCP POSIX layers if
+  needed and creates the checkpoint metadata.
+  It is called collectively, either right after the write or when the
+  background writer of an asynchronous checkpoint is joined.
+
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_CommitCkpt(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
+        FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt,
+        FTIT_keymap* FTI_Data, int res) {
     // Check if all processes have written correctly
     // (every process must succeed)
     int allRes;
     MPI_Allreduce(&res, &allRes, 1, MPI_INT, MPI_SUM, FTI_COMM_WORLD);
+    // every rank keeps its dCP layer or none does
+    if (FTI_Conf->dcpPosix && FTI_Ckpt[4].isDcp) {
+        FTI_PosixDCPCommit(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt, FTI_Data,
+         allRes == FTI_SCES);
+    }
     if (allRes != FTI_SCES) {
+        FTI_DiscardMetadata(FTI_Exec, FTI_Topo);
         return FTI_NSCS;
     } else if (FTI_Exec->h5SingleFile) {
         return FTI_SCES;
@@ -183,21 +231,33 @@ int FTI_WriteCkpt(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     if ((FTI_Conf->dcpFtiff || FTI_Conf->dcpPosix) && FTI_Ckpt[4].isDcp) {
         // After dCP update store total data and dCP
         // sizes in application rank 0
-        uint32_t *dataSize = (FTI_Conf->dcpFtiff)?
-        (uint32_t*)&FTI_Exec->FTIFFMeta.pureDataSize:
+        uint64_t *dataSize = (FTI_Conf->dcpFtiff)?
+        (uint64_t*)&FTI_Exec->FTIFFMeta.pureDataSize:
         &FTI_Exec->dcpInfoPosix.dataSize;
-        uint32_t *dcpSize = (FTI_Conf->dcpFtiff)?
-        (uint32_t*)&FTI_Exec->FTIFFMeta.dcpSize:
+        uint64_t *dcpSize = (FTI_Conf->dcpFtiff)?
+        (uint64_t*)&FTI_Exec->FTIFFMeta.dcpSize:
         &FTI_Exec->dcpInfoPosix.dcpSize;
-        uint32_t dcpStats[2];  // 0:totalDcpSize, 1:totalDataSize
-        uint32_t sendBuf[] = { *dcpSize, *dataSize };
-        MPI_Reduce(sendBuf, dcpStats, 2, MPI_UINT32_T, MPI_SUM, 0,
+        // 0:totalDcpSize, 1:totalDataSize, 2-4:FTI-FF write counters
+        uint64_t dcpStats[5];
+        FTIT_dcpIoStats* dcpIo = &FTI_Exec->dcpIo;
+        uint64_t sendBuf[] = { *dcpSize, *dataSize, dcpIo->nbRuns,
+         dcpIo->nbCalls, dcpIo->bytes };
+        MPI_Reduce(sendBuf, dcpStats, 5, MPI_UINT64_T, MPI_SUM, 0,
          FTI_COMM_WORLD);
         if (FTI_Topo->splitRank ==  0) {
             *dcpSize = dcpStats[0];
             *dataSize = dcpStats[1];
+            dcpIo->nbRuns = dcpStats[2];
+            dcpIo->nbCalls = dcpStats[3];
+            dcpIo->bytes = dcpStats[4];
         }
     }
+    if (FTI_Conf->dcpPosix && FTI_Ckpt[4].isDcp) {
+        // the layers are merged only once every rank wrote its layer
+        FTI_DcpPosixCompactStart(FTI_Conf, FTI_Exec, FTI_Data,
+         (FTI_Ckpt[4].isInline) ? FTI_Ckpt[4].dcpDir : FTI_Ckpt[1].dcpDir,
+         FTI_Topo->myRank);
+    }
 
     res = FTI_Try(FTI_CreateMetadata(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt,
      FTI_Data), "create metadata.");
@@ -330,6 +390,112 @@ int FTI_PostCkpt(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     return FTI_SCES;
 }
 
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It triggers the post-ckpt. work and reports the checkpoint.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+  @param      FTI_Ckpt        Checkpoint metadata.
+  @param      FTI_Data        Dataset metadata.
+  @param      res             Result of FTI_WriteCkpt or FTI_CommitCkpt.
+  @param      t0              Time the checkpoint request started.
+  @param      t1              Time after waiting for the previous ckpt.
+  @param      t2              Time after writing the checkpoint.
+  @return     integer         FTI_DONE if successful.
+
+  This function either notifies the heads or performs the post-processing
+  inline, then updates the recovery information of the execution.
+
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_FinishCkpt(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
+        FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt,
+        FTIT_keymap* FTI_Data, int res, double t0, double t1, double t2) {
+    char str[FTI_BUFS];  // For console output
+
+    if (!FTI_Ckpt[FTI_Exec->ckptMeta.level].isInline) {
+        // If postCkpt. work is Async. then send message
+        FTI_Exec->activateHeads(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt, res);
+    } else {  // If post-processing is inline
+        FTI_Exec->wasLastOffline = 0;
+        if (res != FTI_SCES) {  // If Writing checkpoint failed
+            // The same as head call FTI_PostCkpt with reject
+            // ckptLvel if not success
+            FTI_Exec->ckptMeta.level = FTI_REJW - FTI_BASE;
+        }
+        res = FTI_Try(FTI_PostCkpt(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt),
+         "postprocess the checkpoint.");
+        if (res == FTI_SCES) {
+            FTI_Exec->ckptLvel = FTI_Exec->ckptMeta.level;  // Update level
+        }
+    }
+    double t3;
+
+    if (!FTI_Exec->hasCkpt && (FTI_Topo->splitRank == 0) &&
+     (res == FTI_SCES)) {
+        // Setting recover flag to 1 (to recover from current ckpt level)
+        res = FTI_Try(FTI_UpdateConf(FTI_Conf, FTI_Exec, 1),
+         "update configuration file.");
+        // in case FTI couldn't recover all ckpt files in FTI_Init
+        FTI_Exec->initSCES = 1;
+        if (res == FTI_SCES) {
+            FTI_Exec->hasCkpt = true;
+        }
+    }
+
+    MPI_Bcast(&FTI_Exec->hasCkpt, 1, MPI_INT, 0, FTI_COMM_WORLD);
+
+    t3 = MPI_Wtime();  // Time after post-processing
+
+    if (res != FTI_SCES) {
+        // sprintf(str, "Checkpoint with ID %d at Level %d failed.",
+        // FTI_Exec->ckptMeta.ckptId, FTI_Exec->ckptMeta.level);
+        snprintf(str, sizeof(str), "Checkpoint with ID %d at Level %d failed.",
+         FTI_Exec->ckptMeta.ckptId, FTI_Exec->ckptMeta.level);
+        FTI_Print(str, FTI_WARN);
+        return FTI_NSCS;
+    }
+
+    /*sprintf(str, "Ckpt. ID %d (L%d) (%.2f MB/proc) taken in %.2f sec. 
+    (Wt:%.2fs, Wr:%.2fs, Ps:%.2fs)",
+            FTI_Exec->ckptMeta.ckptId, FTI_Exec->ckptMeta.level, 
+            FTI_Exec->ckptSize / (1024.0 * 1024.0), t3 - t0,
+             t1 - t0, t2 - t1, t3 - t2);*/
+    snprintf(str, sizeof(str), "Ckpt. ID %d (L%d) (%.2f MB/proc) taken in %.2f"
+    " sec. (Wt:%.2fs, Wr:%.2fs, Ps:%.2fs)",
+            FTI_Exec->ckptMeta.ckptId, FTI_Exec->ckptMeta.level,
+             FTI_Exec->ckptSize / (1024.0 * 1024.0), t3 - t0, t1 - t0, t2 - t1,
+             t3 - t2);
+    FTI_Print(str, FTI_INFO);
+
+    if ( (FTI_Conf->dcpFtiff || FTI_Conf->dcpPosix) && FTI_Ckpt[4].isDcp ) {
+        FTI_PrintDcpStats(*FTI_Conf, *FTI_Exec, *FTI_Topo);
+    }
+
+    // update stored values to allow recovery online.
+    // FIXME in such a way, we don't cover the case !inline since at
+    // this point we cannot know if the
+    // postprocessing has been successfully.
+    // One way could be to convert tmp checkpoint into
+    // L1 checkpoint and update lateron.
+
+    FTI_Exec->nbVarStored = FTI_Exec->nbVar;
+    FTI_Exec->ckptId = FTI_Exec->ckptMeta.ckptId;
+
+    FTIT_dataset* data;
+    if (FTI_Data->data(&data, FTI_Exec->nbVar) != FTI_SCES) {
+        FTI_Print("failed to finalize FTI", FTI_WARN);
+        return FTI_NSCS;
+    }
+
+    int k = 0; for (; k < FTI_Exec->nbVar; k++) {
+        data[k].sizeStored = data[k].size;
+    }
+
+    return FTI_DONE;
+}
+
 /*-------------------------------------------------------------------------*/
 /**
   @brief      It listens for checkpoint notifications.
@@ -341,7 +507,10 @@ int FTI_PostCkpt(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
   This function listens for notifications from the application processes
   and takes the required actions after notification. This function is only
   executed by the head of the nodes and its complementary with the
-  FTI_Checkpoint function in terms of communications.
+  FTI_Checkpoint function in terms of communications. Between two polls
+  without message, the head sleeps one microsecond, then twice as long
+  after every following poll up to 'head_sleep' microseconds, so that an
+  idle head leaves its core to the application.
  **/
 /*-------------------------------------------------------------------------*/
 int FTI_Listen(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
@@ -353,9 +522,15 @@ int FTI_Listen(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     int stage_flag = 0;
     int finalize_flag = 0;
 
+    // polls without message since the last one, and sleep statistics
+    int64_t idle = 0;
+    int64_t nbPolls = 0, slept = 0, longest = 0;
+
     FTI_Print("Head starts listening...", FTI_DBUG);
     while (1) {  // heads can stop only by receiving FTI_ENDW
-        FTI_Print("Head waits for message...", FTI_DBUG);
+        if (idle == 0) {
+            FTI_Print("Head waits for message...", FTI_DBUG);
+        }
         MPI_Iprobe(MPI_ANY_SOURCE, FTI_Conf->finalTag, FTI_Exec->globalComm,
          &finalize_flag, &finalize_status);
         if (FTI_Conf->stagingEnabled) {
@@ -364,6 +539,10 @@ int FTI_Listen(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         }
         MPI_Iprobe(MPI_ANY_SOURCE, FTI_Conf->ckptTag, FTI_Exec->globalComm,
          &ckpt_flag, &ckpt_status);
+        nbPolls++;
+        if (ckpt_flag || stage_flag || finalize_flag) {
+            idle = 0;
+        }
         if (ckpt_flag) {
             // head will process the whole checkpoint
             // (treated second due to priority)
@@ -373,15 +552,22 @@ int FTI_Listen(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         }
 
         if (stage_flag) {
-            // head will process each unstage request on its own
-            // [A MAYBE: we could interrupt the unstageing process if
-            // we receive a checkpoint request.]
+            // the request is queued, its file is copied below
             FTI_HandleStageRequest(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt,
              stage_status.MPI_SOURCE);
             stage_flag = 0;
             continue;
         }
 
+        // the queued files are staged one chunk at a time, the messages
+        // are probed again in between so that the checkpoint requests
+        // interrupt the staging.
+        if (FTI_Conf->stagingEnabled &&
+         FTI_ProgressStage(FTI_Conf, FTI_Exec, FTI_Topo) > 0) {
+            idle = 0;
+            continue;
+        }
+
         // the 'continue' statement ensures that we first process all
         // checkpoint and staging request before we call finalize.
         if (finalize_flag) {
@@ -405,12 +591,33 @@ int FTI_Listen(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
                 FTI_Print("Inconsistency in Finalize request.", FTI_WARN);
             }
 
+            snprintf(str, FTI_BUFS, "Head polled %ld times and slept %.3f"
+             " sec. (longest sleep %ld us).", nbPolls, slept / 1e9,
+             longest / 1000);
+            FTI_Print(str, FTI_DBUG);
             FTI_Print("Head stopped listening.", FTI_DBUG);
             FTI_Finalize();
 
             if (FTI_Conf->keepHeadsAlive) {
                 break;
             }
+        } else {
+            // nothing to do, the head sleeps before the next poll
+            idle++;
+            if (FTI_Conf->headSleep > 0) {
+                int64_t ns = FTI_Conf->headSleep * 1000L;
+                if (idle < 32 && (1000L << (idle - 1)) < ns) {
+                    ns = 1000L << (idle - 1);
+                }
+                struct timespec ts;
+                ts.tv_sec = ns / 1000000000L;
+                ts.tv_nsec = ns % 1000000000L;
+                nanosleep(&ts, NULL);
+                slept += ns;
+                if (ns > longest) {
+                    longest = ns;
+                }
+            }
         }
     }
     // will be reached only if keepHeadsAlive is TRUE
@@ -522,7 +729,41 @@ int FTI_HandleCkptRequest(FTIT_configuration* FTI_Conf,
 int FTI_Write(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt,
         FTIT_keymap* FTI_Data, FTIT_IO *io) {
-    int i;
+    FTIT_dataset* data;
+    if (FTI_Data->data(&data, FTI_Exec->nbVar) != FTI_SCES) return FTI_NSCS;
+
+    return FTI_WriteDatasets(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt, FTI_Data,
+     data, FTI_Exec->nbVar, io, FTI_Exec->integrity);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Writes a list of datasets into a new ckpt. file.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+  @param      FTI_Ckpt        Checkpoint metadata.
+  @param      FTI_Data        Dataset metadata.
+  @param      data            Datasets to write.
+  @param      nbVar           Number of datasets in 'data'.
+  @param      io              IO function pointers
+  @param      integrity       Where to store the checksum of the file.
+  @return     integer         FTI_SCES if successful.
+
+  The datasets do not need to be the ones stored in FTI_Data. The
+  asynchronous writer passes the snapshot copies of the protected datasets
+  and keeps the checksum until the checkpoint is committed.
+
+  The file is closed even if a dataset could not be written: the close of
+  some I/O libraries is collective, and it releases the file in any case.
+  The checkpoint fails with the error of the write.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_WriteDatasets(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
+        FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt,
+        FTIT_keymap* FTI_Data, FTIT_dataset* data, int nbVar, FTIT_IO *io,
+        char* integrity) {
+    int i, res = FTI_SCES;
     void *write_info = io->initCKPT(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt,
      FTI_Data);
     if (!write_info) {
@@ -530,18 +771,17 @@ int FTI_Write(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         return FTI_NSCS;
     }
 
-    FTIT_dataset* data;
-    if (FTI_Data->data(&data, FTI_Exec->nbVar) != FTI_SCES) return FTI_NSCS;
-
-    for (i = 0; i < FTI_Exec->nbVar; i++) {
+    for (i = 0; i < nbVar && res == FTI_SCES; i++) {
         data[i].filePos = io->getPos(write_info);
-        int ret = io->WriteData(&data[i], write_info);
-        if (ret != FTI_SCES)
-            return ret;
+        data[i].fileSize = data[i].size;
+        data[i].fileCodec = FTI_CODEC_NONE;
+        res = io->WriteData(&data[i], write_info);
     }
 
-    io->finIntegrity(FTI_Exec->integrity, write_info);
-    io->finCKPT(write_info);
+    if (res == FTI_SCES) {
+        io->finIntegrity(integrity, write_info);
+    }
+    int closed = io->finCKPT(write_info);
     free(write_info);
-    return FTI_SCES;
+    return (res == FTI_SCES) ? closed : res;
 }
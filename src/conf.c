@@ -142,6 +142,13 @@ int FTI_ReadConf(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     // 0 -> disabled
     FTI_Ckpt[4].ckptDcpIntv = (int)iniparser_getint(ini, "Basic:dcp_l4", 0);
     FTI_Ckpt[4].ckptIntv = (int)iniparser_getint(ini, "Basic:ckpt_l4", -1);
+    FTI_Conf->ckptSched = (int)iniparser_getint(ini, "Basic:ckpt_sched",
+     FTI_SCHED_FIXED);
+    // 0 -> level keeps the fixed interval
+    FTI_Ckpt[1].mtbf = (int)iniparser_getint(ini, "Basic:mtbf_l1", 0);
+    FTI_Ckpt[2].mtbf = (int)iniparser_getint(ini, "Basic:mtbf_l2", 0);
+    FTI_Ckpt[3].mtbf = (int)iniparser_getint(ini, "Basic:mtbf_l3", 0);
+    FTI_Ckpt[4].mtbf = (int)iniparser_getint(ini, "Basic:mtbf_l4", 0);
     // Fast Forward flag
     // FTI_Conf->fastForward = (int)iniparser_getint(ini, "Basic:fast_forward", 1);
     FTI_Exec->fastForward = (int)iniparser_getint(ini, "Advanced:fast_forward", 1);
@@ -163,13 +170,51 @@ int FTI_ReadConf(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     // Reading/setting configuration metadata
     FTI_Conf->keepHeadsAlive = (bool)iniparser_getboolean(ini,
      "Basic:keep_heads_alive", 0);
+    FTI_Conf->asyncCkpt = (bool)iniparser_getboolean(ini,
+     "Basic:async_ckpt", 0);
     bool dcpEnabled = (bool)iniparser_getboolean(ini, "Basic:enable_dcp", 0);
     FTI_Conf->dcpMode = (int)iniparser_getint(ini,
      "Basic:dcp_mode", -1) + FTI_DCP_MODE_OFFSET;
     FTI_Conf->dcpBlockSize = (int)iniparser_getint(ini,
      "Basic:dcp_block_size", -1);
+    FTI_Conf->dcpThreads = (int)iniparser_getint(ini,
+     "Basic:dcp_threads", 1);
+    FTI_Conf->dcpTrack = (bool)iniparser_getboolean(ini,
+     "Basic:dcp_track", 0);
+    FTI_Conf->l3Threads = (int)iniparser_getint(ini,
+     "Basic:l3_threads", 1);
+    FTI_Conf->headThreads = (int)iniparser_getint(ini,
+     "Basic:head_threads", 1);
+    FTI_Conf->headSleep = (int)iniparser_getint(ini,
+     "Basic:head_sleep", 1000);
+    FTI_Conf->recoThreads = (int)iniparser_getint(ini,
+     "Basic:reco_threads", 1);
+    FTI_Conf->compression.codec = (int)iniparser_getint(ini,
+     "Basic:compression", 0);
+    FTI_Conf->compression.level = (int)iniparser_getint(ini,
+     "Basic:compression_level", 0);
+    FTI_Conf->compression.shuffle = (bool)iniparser_getboolean(ini,
+     "Basic:compression_shuffle", 0);
+    FTI_Conf->compressChunk = (int)iniparser_getint(ini,
+     "Basic:compression_chunk", 1048576);
+    FTI_Conf->compressThreads = (int)iniparser_getint(ini,
+     "Basic:compression_threads", 1);
+    FTI_Conf->integrity = (int)iniparser_getint(ini,
+     "Basic:integrity", 0);
+    FTI_Conf->integrityChunk = (int)iniparser_getint(ini,
+     "Basic:integrity_chunk", 1048576);
+    FTI_Conf->integrityThreads = (int)iniparser_getint(ini,
+     "Basic:integrity_threads", 1);
+    FTI_Conf->l4Aggregation = (int)iniparser_getint(ini,
+     "Basic:l4_aggregation", 0);
+    FTI_Conf->l4AggAlign = (int)iniparser_getint(ini,
+     "Basic:l4_aggregation_align", 1048576);
     FTI_Conf->dcpInfoPosix.StackSize = (int)iniparser_getint(ini,
      "Basic:dcp_stack_size", 5);
+    FTI_Conf->dcpInfoPosix.CompactLayers = (int)iniparser_getint(ini,
+     "Basic:dcp_compact_layers", 0);
+    FTI_Conf->dcpInfoPosix.CompactRatio = (int)iniparser_getint(ini,
+     "Basic:dcp_compact_ratio", 0);
 
     int64_t maxVarId = (int64_t)iniparser_getlint(ini, "Basic:max_var_id",
      (int64_t)FTI_DEFAULT_MAX_VAR_ID);
@@ -194,10 +239,16 @@ int FTI_ReadConf(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
      "Basic:keep_last_ckpt", 0);
     FTI_Conf->keepL4Ckpt = (bool)iniparser_getboolean(ini,
      "Basic:keep_l4_ckpt", 0);
+    FTI_Conf->verifyOnLoad = (bool)iniparser_getboolean(ini,
+     "Basic:verify_on_load", 0);
     FTI_Conf->blockSize = (int)iniparser_getint(ini,
      "Advanced:block_size", -1) * 1024;
     FTI_Conf->transferSize = (int)iniparser_getint(ini,
      "Advanced:transfer_size", -1) * 1024 * 1024;
+    FTI_Conf->flushDirectIo = (bool)iniparser_getboolean(ini,
+     "Advanced:flush_direct_io", 0);
+    FTI_Conf->mpiioCollective = (bool)iniparser_getboolean(ini,
+     "Advanced:mpiio_collective", 1);
     FTI_Conf->ckptTag = (int)iniparser_getint(ini,
      "Advanced:ckpt_tag", 711);
     FTI_Conf->stageTag = (int)iniparser_getint(ini,
@@ -209,6 +260,8 @@ int FTI_ReadConf(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     FTI_Conf->test = (int)iniparser_getint(ini, "Advanced:local_test", -1);
     FTI_Conf->l3WordSize = FTI_WORD;
     FTI_Conf->ioMode = (int)iniparser_getint(ini, "Basic:ckpt_io", 0) + 1000;
+    FTI_Conf->metaFormat = (int)iniparser_getint(ini, "Basic:meta_format",
+     FTI_META_INI);
     // Enable either dcp for posix of ftiff depending on the selected io
     if (FTI_Conf->ioMode == FTI_IO_POSIX) {
         FTI_Conf->dcpPosix = dcpEnabled;
@@ -226,6 +279,10 @@ int FTI_ReadConf(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
                 FTI_Conf->dcpInfoPosix.hashFunc = CRC32;
                 FTI_Conf->dcpInfoPosix.digestWidth = CRC32_DIGEST_LENGTH;
                 break;
+            case FTI_DCP_MODE_CRC32C:
+                FTI_Conf->dcpInfoPosix.hashFunc = CRC32C;
+                FTI_Conf->dcpInfoPosix.digestWidth = CRC32C_DIGEST_LENGTH;
+                break;
         }
     } else if (FTI_Conf->ioMode == FTI_IO_FTIFF) {
         FTI_Conf->dcpFtiff = dcpEnabled;
@@ -308,6 +365,20 @@ int FTI_ReadConf(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
      "Basic:h5_single_file_keep", 0);
     FTI_Conf->h5SingleFileEnable = (bool)iniparser_getboolean(ini,
      "Basic:h5_single_file_enable", 0);
+    FTI_Conf->h5SingleFileChunk = (bool)iniparser_getboolean(ini,
+     "Basic:h5_single_file_chunk", 1);
+    char *h5SingleFileHints = iniparser_getstring(ini,
+     "Basic:h5_single_file_hints", NULL);
+    snprintf(FTI_Conf->h5SingleFileHints, FTI_BUFS, "%s",
+     (h5SingleFileHints) ? h5SingleFileHints : "");
+    FTI_Conf->h5ChunkSize = (int64_t)iniparser_getlint(ini,
+     "Basic:h5_chunk_size", 4194304);
+    FTI_Conf->h5Checksum = (bool)iniparser_getboolean(ini,
+     "Basic:h5_checksum", 1);
+    FTI_Conf->h5Alignment = (int64_t)iniparser_getlint(ini,
+     "Basic:h5_alignment", 0);
+    FTI_Conf->h5MetaBlock = (int64_t)iniparser_getlint(ini,
+     "Basic:h5_meta_block_size", 0);
 
     // Reading/setting topology metadata
     FTI_Topo->nbHeads = (int)iniparser_getint(ini, "Basic:head", 0);
@@ -390,6 +461,12 @@ int FTI_TestConfig(FTIT_configuration* FTI_Conf, FTIT_topology* FTI_Topo,
         return FTI_NSCS;
     }
 
+    if (FTI_Conf->asyncCkpt && (FTI_Conf->ioMode != FTI_IO_POSIX)) {
+        FTI_Print("Asynchronous checkpoints ('Basic:async_ckpt') are only"
+        " supported for POSIX I/O, async. ckpt. disabled.", FTI_WARN);
+        FTI_Conf->asyncCkpt = false;
+    }
+
     //fast forward
     if (FTI_Exec->fastForward < 1 || FTI_Exec->fastForward > 10) {
       FTI_Print("Fast Forward should be between 1 and 10, inclusive", FTI_WARN);
@@ -401,19 +478,183 @@ int FTI_TestConfig(FTIT_configuration* FTI_Conf, FTIT_topology* FTI_Topo,
         return FTI_NSCS;
     }
 
+    if (FTI_Conf->l3Threads < 1) {
+        FTI_Print("L3 decoding threads ('Basic:l3_threads') must be > 0."
+            " set to default (l3_threads = 1).", FTI_WARN);
+        FTI_Conf->l3Threads = 1;
+    }
+
+    if (FTI_Conf->headThreads < 1) {
+        FTI_Print("Head post-processing threads ('Basic:head_threads') must"
+            " be > 0. set to default (head_threads = 1).", FTI_WARN);
+        FTI_Conf->headThreads = 1;
+    }
+
+    if (FTI_Conf->headSleep < 0) {
+        FTI_Print("Head idle sleep ('Basic:head_sleep') must be >= 0."
+            " set to default (head_sleep = 1000).", FTI_WARN);
+        FTI_Conf->headSleep = 1000;
+    }
+
+    if (FTI_Conf->recoThreads < 1) {
+        FTI_Print("Recovery reading threads ('Basic:reco_threads') must be"
+            " > 0. set to default (reco_threads = 1).", FTI_WARN);
+        FTI_Conf->recoThreads = 1;
+    }
+
+    if ((FTI_Conf->compression.codec < FTI_CODEC_NONE) ||
+     (FTI_Conf->compression.codec > FTI_CODEC_ZLIB)) {
+        FTI_Print("Compression ('Basic:compression') must be either 0 (none),"
+            " 1 (LZ4), 2 (Zstandard) or 3 (zlib), compression disabled.",
+            FTI_WARN);
+        FTI_Conf->compression.codec = FTI_CODEC_NONE;
+    }
+    if (!FTI_CodecAvailable(FTI_Conf->compression.codec)) {
+        char str[FTI_BUFS];
+        snprintf(str, FTI_BUFS, "Compression ('Basic:compression') with %s"
+            " is not supported by this FTI build, compression disabled.",
+            FTI_CodecName(FTI_Conf->compression.codec));
+        FTI_Print(str, FTI_WARN);
+        FTI_Conf->compression.codec = FTI_CODEC_NONE;
+    }
+    if ((FTI_Conf->compression.codec != FTI_CODEC_NONE) &&
+     (FTI_Conf->ioMode != FTI_IO_POSIX)) {
+        FTI_Print("Compression ('Basic:compression') needs POSIX I/O"
+            " (ckpt_io = 1), compression disabled.", FTI_WARN);
+        FTI_Conf->compression.codec = FTI_CODEC_NONE;
+    }
+    if ((FTI_Conf->compression.codec == FTI_CODEC_ZLIB) &&
+     ((FTI_Conf->compression.level < 0) ||
+      (FTI_Conf->compression.level > 9))) {
+        FTI_Print("zlib compression level ('Basic:compression_level') must be"
+            " between 0 and 9. set to default (compression_level = 0).",
+            FTI_WARN);
+        FTI_Conf->compression.level = 0;
+    }
+    if ((FTI_Conf->compressChunk < 4096) ||
+     (FTI_Conf->compressChunk > 1073741824)) {
+        FTI_Print("Compression chunk size ('Basic:compression_chunk') must be"
+            " between 4 KB and 1 GB. set to default"
+            " (compression_chunk = 1048576).", FTI_WARN);
+        FTI_Conf->compressChunk = 1048576;
+    }
+    if (FTI_Conf->compressThreads < 1) {
+        FTI_Print("Compression threads ('Basic:compression_threads') must be"
+            " > 0. set to default (compression_threads = 1).", FTI_WARN);
+        FTI_Conf->compressThreads = 1;
+    }
+    if ((FTI_Conf->integrity != FTI_INTEGRITY_MD5) &&
+     (FTI_Conf->integrity != FTI_INTEGRITY_TREE)) {
+        FTI_Print("Integrity scheme ('Basic:integrity') must be either 0 (MD5)"
+            " or 1 (tree hash). set to default (integrity = 0).", FTI_WARN);
+        FTI_Conf->integrity = FTI_INTEGRITY_MD5;
+    }
+    if ((FTI_Conf->integrity == FTI_INTEGRITY_TREE) &&
+     (FTI_Conf->ioMode == FTI_IO_FTIFF)) {
+        FTI_Print("Tree hash ('Basic:integrity') is not supported by FTI-FF,"
+            " which hashes its data blocks. set to MD5 (integrity = 0).",
+            FTI_WARN);
+        FTI_Conf->integrity = FTI_INTEGRITY_MD5;
+    }
+    if ((FTI_Conf->integrityChunk < 4096) ||
+     (FTI_Conf->integrityChunk > 67108864) ||
+     (FTI_Conf->integrityChunk & (FTI_Conf->integrityChunk - 1))) {
+        FTI_Print("Tree hash chunk size ('Basic:integrity_chunk') must be a"
+            " power of two between 4 KB and 64 MB. set to default"
+            " (integrity_chunk = 1048576).", FTI_WARN);
+        FTI_Conf->integrityChunk = 1048576;
+    }
+    if (FTI_Conf->integrityThreads < 1) {
+        FTI_Print("Integrity threads ('Basic:integrity_threads') must be"
+            " > 0. set to default (integrity_threads = 1).", FTI_WARN);
+        FTI_Conf->integrityThreads = 1;
+    }
+    if (FTI_Conf->l4Aggregation < 0) {
+        FTI_Print("L4 aggregation ('Basic:l4_aggregation') must be >= 0."
+            " aggregation disabled.", FTI_WARN);
+        FTI_Conf->l4Aggregation = 0;
+    }
+    if ((FTI_Conf->l4Aggregation > 1) && (FTI_Conf->ioMode != FTI_IO_POSIX)) {
+        FTI_Print("L4 aggregation ('Basic:l4_aggregation') needs POSIX I/O"
+            " (ckpt_io = 1), aggregation disabled.", FTI_WARN);
+        FTI_Conf->l4Aggregation = 0;
+    }
+    if ((FTI_Conf->l4AggAlign < 512) ||
+     (FTI_Conf->l4AggAlign > 1073741824)) {
+        FTI_Print("L4 aggregation alignment ('Basic:l4_aggregation_align')"
+            " must be between 512 B and 1 GB. set to default"
+            " (l4_aggregation_align = 1048576).", FTI_WARN);
+        FTI_Conf->l4AggAlign = 1048576;
+    }
+    if ((FTI_Conf->h5ChunkSize < 0) ||
+     (FTI_Conf->h5ChunkSize >= ((int64_t)1 << 32))) {
+        FTI_Print("HDF5 chunk size ('Basic:h5_chunk_size') must be between"
+            " 0 and 4 GB. set to default (h5_chunk_size = 4194304).",
+             FTI_WARN);
+        FTI_Conf->h5ChunkSize = 4194304;
+    }
+    if ((FTI_Conf->h5ChunkSize == 0) && FTI_Conf->h5Checksum) {
+        FTI_Print("HDF5 checksums ('Basic:h5_checksum') need chunked"
+            " datasets (h5_chunk_size > 0), checksums disabled.", FTI_WARN);
+        FTI_Conf->h5Checksum = false;
+    }
+    if (FTI_Conf->h5Alignment < 0) {
+        FTI_Print("HDF5 alignment ('Basic:h5_alignment') must be >= 0."
+            " alignment disabled.", FTI_WARN);
+        FTI_Conf->h5Alignment = 0;
+    }
+    if (FTI_Conf->h5MetaBlock < 0) {
+        FTI_Print("HDF5 metadata block size ('Basic:h5_meta_block_size')"
+            " must be >= 0. set to default (h5_meta_block_size = 0).",
+             FTI_WARN);
+        FTI_Conf->h5MetaBlock = 0;
+    }
+
     // check dCP settings only if dCP is enabled
+    if ((FTI_Conf->dcpPosix || FTI_Conf->dcpFtiff) &&
+     (FTI_Conf->dcpThreads < 1)) {
+        FTI_Print("dCP hashing threads ('Basic:dcp_threads') must be > 0."
+            " set to default (dcp_threads = 1).", FTI_WARN);
+        FTI_Conf->dcpThreads = 1;
+    }
     if (FTI_Conf->dcpPosix) {
+        if ((FTI_Conf->dcpMode < FTI_DCP_MODE_MD5) ||
+         (FTI_Conf->dcpMode > FTI_DCP_MODE_CRC32C)) {
+            FTI_Print("dCP mode ('Basic:dcp_mode') must be either 1 (MD5),"
+            " 2 (CRC32) or 3 (CRC32C), dCP disabled.", FTI_WARN);
+            FTI_Conf->dcpPosix = false;
+        }
         if (FTI_Conf->dcpInfoPosix.StackSize > MAX_STACK_SIZE) {
             FTI_Print("dCP stack size ('Basic:dcp_stack_size') must be < 10."
                 " set to default (stack_size = 5).", FTI_WARN);
             FTI_Conf->dcpInfoPosix.StackSize = 5;
         }
+        if ((FTI_Conf->dcpInfoPosix.CompactLayers == 1) ||
+         (FTI_Conf->dcpInfoPosix.CompactLayers >=
+          FTI_Conf->dcpInfoPosix.StackSize)) {
+            FTI_Print("dCP merged layers ('Basic:dcp_compact_layers') must be"
+                " 0 or between 2 and dcp_stack_size - 1, merging by number"
+                " of layers disabled.", FTI_WARN);
+            FTI_Conf->dcpInfoPosix.CompactLayers = 0;
+        }
+    }
+    if (FTI_Conf->dcpTrack && !FTI_Conf->dcpPosix) {
+        FTI_Print("dCP dirty tracking ('Basic:dcp_track') needs POSIX dCP,"
+            " dirty tracking disabled.", FTI_WARN);
+        FTI_Conf->dcpTrack = false;
+    }
+#ifdef GPUSUPPORT
+    if (FTI_Conf->dcpTrack) {
+        FTI_Print("dCP dirty tracking ('Basic:dcp_track') is not supported"
+            " with GPU support, dirty tracking disabled.", FTI_WARN);
+        FTI_Conf->dcpTrack = false;
     }
+#endif
     if (FTI_Conf->dcpFtiff) {
         if ((FTI_Conf->dcpMode < FTI_DCP_MODE_MD5) ||
-         (FTI_Conf->dcpMode > FTI_DCP_MODE_CRC32)) {
-            FTI_Print("dCP mode ('Basic:dcp_mode') must be either 1 (MD5) or"
-            " 2 (CRC32), dCP disabled.", FTI_WARN);
+         (FTI_Conf->dcpMode > FTI_DCP_MODE_CRC32C)) {
+            FTI_Print("dCP mode ('Basic:dcp_mode') must be either 1 (MD5),"
+            " 2 (CRC32) or 3 (CRC32C), dCP disabled.", FTI_WARN);
             FTI_Conf->dcpFtiff = false;
             goto CHECK_DCP_SETTING_END;
         }
@@ -531,6 +772,34 @@ CHECK_DCP_SETTING_END:
             break;
     }
 
+    if (FTI_Conf->metaFormat != FTI_META_INI &&
+     FTI_Conf->metaFormat != FTI_META_BIN) {
+        FTI_Print("Metadata format ('Basic:meta_format') must be 0 (ini) or"
+        " 1 (binary). set to default (meta_format = 0).", FTI_WARN);
+        FTI_Conf->metaFormat = FTI_META_INI;
+    }
+
+    if (FTI_Conf->ckptSched != FTI_SCHED_FIXED &&
+     FTI_Conf->ckptSched != FTI_SCHED_ADAPTIVE) {
+        FTI_Print("Checkpoint scheduler ('Basic:ckpt_sched') must be 0 (fixed)"
+        " or 1 (adaptive). set to default (ckpt_sched = 0).", FTI_WARN);
+        FTI_Conf->ckptSched = FTI_SCHED_FIXED;
+    }
+    if (FTI_Conf->ckptSched == FTI_SCHED_ADAPTIVE) {
+        int adaptive = 0;
+        for (i = 1; i < 5; i++) {
+            if (FTI_Ckpt[i].mtbf < 0) {
+                FTI_Ckpt[i].mtbf = 0;
+            }
+            adaptive |= (FTI_Ckpt[i].mtbf > 0);
+        }
+        if (!adaptive) {
+            FTI_Print("Adaptive checkpoint scheduler needs at least one"
+            " 'Basic:mtbf_lN'. set to fixed intervals.", FTI_WARN);
+            FTI_Conf->ckptSched = FTI_SCHED_FIXED;
+        }
+    }
+
     // check variate processor restart settings
     if (FTI_Exec->reco == 3) {
         if (FTI_Conf->ioMode != FTI_IO_HDF5) {
@@ -714,6 +983,7 @@ int FTI_LoadConf(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     if (res == FTI_NSCS) {
         return FTI_NSCS;
     }
+    FTI_SchedInit(FTI_Conf, FTI_Exec);
     res = FTI_Try(FTI_TestDirectories(FTI_Conf, FTI_Topo),
      "pass the directories test.");
     if (res == FTI_NSCS) {
@@ -103,4 +103,18 @@ void FTI_PrintDcpStats(FTIT_configuration FTI_Conf, FTIT_execution FTI_Exec,
     if (FTI_Topo.splitRank)
         FTI_Print(str, FTI_DBUG);
     FTI_Print(str, FTI_IDCP);
+
+    if (FTI_Conf.dcpFtiff) {
+        size_t norder_io = get_metric(FTI_Exec.dcpIo.bytes, dcp_metric);
+        snprintf(str, FTI_BUFS, "%s dCP writes: %lu calls for %lu dirty"
+                " runs, %.2lf %s written",
+                cp_print_mode,
+                FTI_Exec.dcpIo.nbCalls,
+                FTI_Exec.dcpIo.nbRuns,
+                (double)FTI_Exec.dcpIo.bytes/norder_io,
+                dcp_metric);
+        if (FTI_Topo.splitRank)
+            FTI_Print(str, FTI_DBUG);
+        FTI_Print(str, FTI_IDCP);
+    }
 }
@@ -427,7 +427,7 @@ int iniparser_getint(dictionary * d, const char * key, int notfound)
   slightly modified to return long instead of int.
  */
 /*--------------------------------------------------------------------------*/
-int32_t iniparser_getlint(dictionary * d, const char * key, int notfound)
+long iniparser_getlint(dictionary * d, const char * key, long notfound)
 {
     char    *   str ;
 
@@ -56,7 +56,7 @@ FTIT_IO ftiIO[4];
   code and provides a more stream line code format.
  **/
 /*-------------------------------------------------------------------------*/
-void FTI_dummy(unsigned char *data, void* a) {
+void FTI_dummy(char *data, void* a) {
     return;
 }
 
@@ -86,6 +86,15 @@ int FTI_InitFunctionPointers(int ckptIO, FTIT_execution * FTI_Exec) {
             ftiIO[GLOBAL].getPos = FTI_GetPosixFilePos;
             ftiIO[GLOBAL].finIntegrity = FTI_PosixMD5;
 
+            // Inline L4 ships the data to the aggregator of the group
+            if (FTI_Exec->aggComm != MPI_COMM_NULL) {
+                ftiIO[GLOBAL].initCKPT = FTI_InitPosixAgg;
+                ftiIO[GLOBAL].WriteData = FTI_WritePosixAggData;
+                ftiIO[GLOBAL].finCKPT = FTI_PosixAggClose;
+                ftiIO[GLOBAL].getPos = FTI_GetPosixAggFilePos;
+                ftiIO[GLOBAL].finIntegrity = FTI_PosixAggMD5;
+            }
+
 
             ftiIO[2 + LOCAL].initCKPT = FTI_InitDCPPosix;
             ftiIO[2 + LOCAL].WriteData = FTI_WritePosixDCPData;
@@ -170,7 +179,7 @@ int FTI_InitFunctionPointers(int ckptIO, FTIT_execution * FTI_Exec) {
 
             ftiIO[GLOBAL].initCKPT = FTI_InitMPIO;
             ftiIO[GLOBAL].WriteData = FTI_WriteMPIOData;
-            ftiIO[GLOBAL].finCKPT = FTI_MPIOClose;
+            ftiIO[GLOBAL].finCKPT = FTI_MPIOCkptClose;
             ftiIO[GLOBAL].getPos = FTI_GetMPIOFilePos;
             ftiIO[GLOBAL].finIntegrity = FTI_dummy;
 
@@ -96,6 +96,8 @@ int FTI_WriteVar(int varID, FTIT_configuration* FTI_Conf,
     }
 
     data->filePos = io->getPos(write_info);
+    data->fileSize = data->size;
+    data->fileCodec = FTI_CODEC_NONE;
     res = io->WriteData(data, write_info);
     FTI_Exec->iCPInfo.result = res;
     return res;
@@ -123,11 +125,11 @@ int FTI_FinishICP(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         return FTI_NSCS;
     }
     void *write_info = FTI_Exec->iCPInfo.fd;
-    io->finCKPT(write_info);
+    int res = io->finCKPT(write_info);
     io->finIntegrity(FTI_Exec->integrity, write_info);
     free(write_info);
     FTI_Exec->iCPInfo.fd = NULL;
-    return FTI_SCES;
+    return res;
 }
 
 
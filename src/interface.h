@@ -49,15 +49,25 @@ extern "C" {
 #include "util/dataset.h"
 #include "util/keymap.h"
 #include "util/metaqueue.h"
+#include "util/metabin.h"
 #include "util/macros.h"
 #include "util/utility.h"
 #include "util/failure-injection.h"
+#include "util/gf16.h"
 
 #include "IO/posix.h"
 #include "IO/posix-dcp.h"
+#include "IO/posix-agg.h"
 #include "IO/hdf5-fti.h"
 #include "IO/ftiff.h"
 #include "IO/ftiff-dcp.h"
+#include "IO/dcp-hash.h"
+#include "IO/file-copy.h"
+#include "IO/file-read.h"
+#include "IO/dcp-compact.h"
+#include "IO/dcp-track.h"
+#include "IO/compress.h"
+#include "IO/integrity.h"
 #include "IO/ime.h"
 
 #include "./meta.h"
@@ -73,6 +83,8 @@ extern "C" {
 #include "./postckpt.h"
 #include "./recover.h"
 #include "./icp.h"
+#include "./async.h"
+#include "./scheduler.h"
 
 #include "deps/md5/md5.h"
 #include "deps/iniparser/iniparser.h"
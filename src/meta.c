@@ -41,6 +41,40 @@
 
 #include "meta.h"
 
+/** Where a variable is stored in the checkpoint file of this checkpoint. */
+typedef struct FTIT_metaVarFile {
+    int64_t     pos;        /**< Position in the checkpoint file        */
+    int64_t     fileSize;   /**< Bytes in the file if compressed        */
+    int32_t     codec;      /**< Compression codec, 0 if not compressed */
+    int32_t     reserved;   /**< Padding                                */
+} FTIT_metaVarFile;
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Loads a binary metadata file of the group.
+  @param      meta            Binary metadata (out).
+  @param      mfn             Path to the metadata file.
+  @param      part            Sections to load.
+  @param      groupSize       Expected number of processes in the group.
+  @return     integer         FTI_SCES if successful.
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_LoadMetaBin(FTIT_metaBin* meta, const char* mfn,
+        FTIT_metaBinPart part, int groupSize) {
+    if (FTI_MetaBinLoad(meta, mfn, part) != FTI_SCES) {
+        return FTI_NSCS;
+    }
+    if (meta->head->groupSize != groupSize) {
+        char str[FTI_BUFS];
+        snprintf(str, FTI_BUFS, "Metadata file (%s) is for %d processes, "
+         "the group has %d.", mfn, meta->head->groupSize, groupSize);
+        FTI_Print(str, FTI_WARN);
+        FTI_MetaBinFree(meta);
+        return FTI_NSCS;
+    }
+    return FTI_SCES;
+}
+
 /*-------------------------------------------------------------------------*/
 /**
   @brief      It gets the checksums from metadata.
@@ -76,6 +110,25 @@ int FTI_GetChecksums(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     snprintf(str, FTI_BUFS, "Getting FTI metadata file (%s)...", mfn);
     FTI_Print(str, FTI_DBUG);
 
+    if (FTI_MetaBinIsBinary(mfn)) {
+        FTIT_metaBin meta;
+        if (FTI_LoadMetaBin(&meta, mfn, FTI_METABIN_PROCS,
+         FTI_Topo->groupSize) != FTI_SCES) {
+            FTI_Print("Failed to load the binary metadata file.", FTI_WARN);
+            return FTI_NSCS;
+        }
+        int ptner = (FTI_Topo->groupRank + FTI_Topo->groupSize - 1) %
+         FTI_Topo->groupSize;
+        strncpy(checksum, meta.procs[FTI_Topo->groupRank].checksum,
+         MD5_DIGEST_STRING_LENGTH);
+        strncpy(ptnerChecksum, meta.procs[ptner].checksum,
+         MD5_DIGEST_STRING_LENGTH);
+        strncpy(rsChecksum, meta.procs[FTI_Topo->groupRank].rsChecksum,
+         MD5_DIGEST_STRING_LENGTH);
+        FTI_MetaBinFree(&meta);
+        return FTI_SCES;
+    }
+
     FTIT_iniparser ini;
     if (FTI_Iniparser(&ini, mfn, FTI_INI_OPEN) != FTI_SCES) {
         FTI_Print("Iniparser failed to parse the metadata file.", FTI_WARN);
@@ -144,6 +197,29 @@ int FTI_WriteRSedChecksum(FTIT_configuration* FTI_Conf,
     snprintf(fileName, FTI_BUFS, "%s/sector%d-group%d.fti", FTI_Conf->mTmpDir,
      FTI_Topo->sectorID, groupID);
 
+    if (FTI_MetaBinIsBinary(fileName)) {
+        FTIT_metaBin meta;
+        int res = FTI_LoadMetaBin(&meta, fileName, FTI_METABIN_PROCS,
+         FTI_Topo->groupSize);
+        if (res == FTI_SCES) {
+            int i;
+            for (i = 0; i < FTI_Topo->groupSize; i++) {
+                strncpy(meta.procs[i].rsChecksum,
+                 checksums + (i * MD5_DIGEST_STRING_LENGTH),
+                 MD5_DIGEST_STRING_LENGTH);
+            }
+            snprintf(str, FTI_BUFS, "Updating metadata file (%s)...",
+             fileName);
+            FTI_Print(str, FTI_DBUG);
+            res = FTI_MetaBinStoreProcs(&meta, fileName);
+            FTI_MetaBinFree(&meta);
+        } else {
+            FTI_Print("Temporary metadata file could NOT be loaded", FTI_WARN);
+        }
+        free(checksums);
+        return res;
+    }
+
     FTIT_iniparser ini;
     if (FTI_Iniparser(&ini, fileName, FTI_INI_OPEN) != FTI_SCES) {
         FTI_Print("Temporary metadata file could NOT be parsed", FTI_WARN);
@@ -204,6 +280,24 @@ int FTI_LoadMetaPostprocessing(FTIT_configuration* FTI_Conf,
     snprintf(str, FTI_BUFS, "Getting FTI metadata file (%s)...", metaFileName);
     FTI_Print(str, FTI_DBUG);
 
+    if (FTI_MetaBinIsBinary(metaFileName)) {
+        FTIT_metaBin meta;
+        if (FTI_LoadMetaBin(&meta, metaFileName, FTI_METABIN_PROCS,
+         FTI_Topo->groupSize) != FTI_SCES)
+          return FTI_NSCS;
+        int ptner = (FTI_Topo->groupRank + FTI_Topo->groupSize - 1) %
+         FTI_Topo->groupSize;
+        snprintf(FTI_Exec->ckptMeta.ckptFile, FTI_BUFS, "%s",
+         meta.procs[FTI_Topo->groupRank].fileName);
+        sscanf(FTI_Exec->ckptMeta.ckptFile, "Ckpt%d",
+         &FTI_Exec->ckptMeta.ckptId);
+        FTI_Exec->ckptMeta.fs = meta.procs[FTI_Topo->groupRank].fs;
+        FTI_Exec->ckptMeta.pfs = meta.procs[ptner].fs;
+        FTI_Exec->ckptMeta.maxFs = meta.head->maxFs;
+        FTI_MetaBinFree(&meta);
+        return FTI_SCES;
+    }
+
     FTIT_iniparser ini;
     if (FTI_Iniparser(&ini, metaFileName, FTI_INI_OPEN) != FTI_SCES)
       return FTI_NSCS;
@@ -286,6 +380,32 @@ int FTI_LoadMetaRecovery(FTIT_configuration* FTI_Conf,
          metaFileName);
         FTI_Print(str, FTI_DBUG);
 
+        if (FTI_MetaBinIsBinary(metaFileName)) {
+            FTIT_metaBin bin;
+            if (FTI_LoadMetaBin(&bin, metaFileName, FTI_METABIN_PROCS,
+             FTI_Topo->groupSize) != FTI_SCES)
+              continue;
+
+            snprintf(str, FTI_BUFS, "Meta for level %d exists.", i);
+            FTI_Print(str, FTI_DBUG);
+
+            int ptner = (FTI_Topo->groupRank + FTI_Topo->groupSize - 1) %
+             FTI_Topo->groupSize;
+            FTI_Ckpt[i].recoIsDcp = bin.head->isDcp;
+            FTI_Exec->ckptId = bin.head->ckptId;
+            snprintf(meta.ckptFile, FTI_BUFS, "%s",
+             bin.procs[FTI_Topo->groupRank].fileName);
+            meta.fs = bin.procs[FTI_Topo->groupRank].fs;
+            FTI_Exec->dcpInfoPosix.FileSize = meta.fs;
+            meta.pfs = bin.procs[ptner].fs;
+            meta.maxFs = bin.head->maxFs;
+
+            FTI_Exec->mqueue.push(&FTI_Exec->mqueue, meta);
+
+            FTI_MetaBinFree(&bin);
+            continue;
+        }
+
         if (FTI_Iniparser(&ini, metaFileName, FTI_INI_OPEN) != FTI_SCES)
           continue;
 
@@ -356,13 +476,42 @@ int FTI_LoadMetaDcp(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     snprintf(str, FTI_BUFS, "Getting FTI metadata file (%s)...", metaFileName);
     FTI_Print(str, FTI_DBUG);
 
+    if (FTI_MetaBinIsBinary(metaFileName)) {
+        FTIT_metaBin meta;
+        if (FTI_LoadMetaBin(&meta, metaFileName, FTI_METABIN_FULL,
+         FTI_Topo->groupSize) != FTI_SCES)
+          return FTI_NSCS;
+        int k; for (k = 0; k < meta.head->nbLayer && k < MAX_STACK_SIZE;
+         k++) {
+            FTIT_metaBinLayer* layer =
+             FTI_MetaBinLayerOf(&meta, FTI_Topo->groupRank, k);
+            FTI_Exec->dcpInfoPosix.LayerSize[k] = layer->size;
+            snprintf(
+             &FTI_Exec->dcpInfoPosix.LayerHash[k*MD5_DIGEST_STRING_LENGTH],
+             MD5_DIGEST_STRING_LENGTH, "%s", layer->hash);
+            // every layer holds all protected variables
+            int j; for (j = 0; j < meta.head->nbVar && j < FTI_BUFS; j++) {
+                FTIT_metaBinVar* var =
+                 FTI_MetaBinVarOf(&meta, FTI_Topo->groupRank, j);
+                if (var->id == -1) {
+                    break;
+                }
+                FTI_Exec->dcpInfoPosix.datasetInfo[k][j].varID = var->id;
+                FTI_Exec->dcpInfoPosix.datasetInfo[k][j].varSize =
+                 (uint64_t) var->size;
+            }
+        }
+        FTI_MetaBinFree(&meta);
+        return FTI_SCES;
+    }
+
     FTIT_iniparser ini;
     if (FTI_Iniparser(&ini, metaFileName, FTI_INI_OPEN) != FTI_SCES)
       return FTI_NSCS;
 
     int k; for (k = 0; k < MAX_STACK_SIZE; k++) {
         snprintf(str, FTI_BUFS, "%d:dcp_layer%d_size", FTI_Topo->groupRank, k);
-        uint32_t LayerSize = ini.getLong(&ini, str);
+        int64_t LayerSize = ini.getLong(&ini, str);
         if (LayerSize == -1) {
             // No more variables
             break;
@@ -383,12 +532,12 @@ int FTI_LoadMetaDcp(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
             FTI_Exec->dcpInfoPosix.datasetInfo[k][j].varID = varID;
             snprintf(str, FTI_BUFS, "%d:dcp_layer%d_var%d_size",
              FTI_Topo->groupRank, k, j);
-            int32_t varSize = ini.getLong(&ini, str);
+            int64_t varSize = ini.getLong(&ini, str);
             if (varID < 0) {
                 break;
             }
             FTI_Exec->dcpInfoPosix.datasetInfo[k][j].varSize =
-             (uint32_t) varSize;
+             (uint64_t) varSize;
         }
     }
 
@@ -397,6 +546,30 @@ int FTI_LoadMetaDcp(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     return FTI_SCES;
 }
 
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Stores the metadata of a dataset loaded from a metadata file.
+  @param      FTI_Data        Dataset metadata.
+  @param      data            Dataset loaded from the metadata file.
+  @return     integer         FTI_SCES if successful.
+
+  The metadata is loaded again if the ckpt. files are recovered again by
+  FTI_Recover, the datasets are then already protected and only the
+  fields describing the stored data are updated.
+
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_StoreMetaDataset(FTIT_keymap* FTI_Data, FTIT_dataset* data) {
+    FTIT_dataset* prot;
+    if (FTI_Data->get(&prot, data->id) != FTI_SCES) { return FTI_NSCS; }
+    if (prot == NULL) { return FTI_Data->push_back(data, data->id); }
+    prot->sizeStored = data->sizeStored;
+    prot->filePos = data->filePos;
+    prot->fileCodec = data->fileCodec;
+    prot->fileSize = data->fileSize;
+    return FTI_SCES;
+}
+
 /*-------------------------------------------------------------------------*/
 /**
   @brief      Loads the metadata for the protected datasets.
@@ -433,6 +606,47 @@ int FTI_LoadMetaDataset(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     snprintf(str, FTI_BUFS, "Getting FTI metadata file (%s)...", metaFileName);
     FTI_Print(str, FTI_DBUG);
 
+    if (FTI_MetaBinIsBinary(metaFileName)) {
+        FTIT_metaBin meta;
+        if (FTI_LoadMetaBin(&meta, metaFileName, FTI_METABIN_FULL,
+         FTI_Topo->groupSize) != FTI_SCES)
+          return FTI_NSCS;
+        int k; for (k = 0; k < meta.head->nbVar && k < FTI_Conf->maxVarId;
+         k++) {
+            FTIT_metaBinVar* var =
+             FTI_MetaBinVarOf(&meta, FTI_Topo->groupRank, k);
+            if (var->id == -1) {
+                // No more variables
+                break;
+            }
+
+            FTIT_dataset data; FTI_InitDataset(FTI_Exec, &data, var->id);
+
+            data.sizeStored = var->size;
+            data.filePos = var->pos;
+            data.fileCodec = var->codec;
+            data.fileSize = (var->codec != FTI_CODEC_NONE) ?
+             var->fileSize : var->size;
+            snprintf(data.idChar, FTI_BUFS, "%s",
+             FTI_MetaBinString(&meta, var->idChar));
+
+            FTI_Exec->ckptSize = FTI_Exec->ckptSize + data.size;
+
+            data.recovered = true;
+
+            if (FTI_StoreMetaDataset(FTI_Data, &data) != FTI_SCES) {
+                FTI_MetaBinFree(&meta);
+                return FTI_NSCS;
+            }
+        }
+
+        // Save number of variables in metadata
+        FTI_Exec->nbVarStored = k;
+
+        FTI_MetaBinFree(&meta);
+        return FTI_SCES;
+    }
+
     FTIT_iniparser ini;
     if (FTI_Iniparser(&ini, metaFileName, FTI_INI_OPEN) != FTI_SCES)
       return FTI_NSCS;
@@ -453,6 +667,14 @@ int FTI_LoadMetaDataset(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         snprintf(str, FTI_BUFS, "%d:Var%d_pos", FTI_Topo->groupRank, k);
         data.filePos = ini.getLong(&ini, str);
 
+        // the keys of the compression only exist for compressed variables
+        snprintf(str, FTI_BUFS, "%d:Var%d_codec", FTI_Topo->groupRank, k);
+        int codec = ini.getInt(&ini, str);
+        data.fileCodec = (codec > 0) ? codec : FTI_CODEC_NONE;
+        snprintf(str, FTI_BUFS, "%d:Var%d_fileSize", FTI_Topo->groupRank, k);
+        data.fileSize = (data.fileCodec != FTI_CODEC_NONE) ?
+         ini.getLong(&ini, str) : data.sizeStored;
+
         snprintf(str, FTI_BUFS, "%d:Var%d_idChar", FTI_Topo->groupRank, k);
         strncpy(data.idChar, ini.getString(&ini, str), FTI_BUFS);
 
@@ -460,7 +682,10 @@ int FTI_LoadMetaDataset(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
 
         data.recovered = true;
 
-        FTI_Data->push_back(&data, data.id);
+        if (FTI_StoreMetaDataset(FTI_Data, &data) != FTI_SCES) {
+            ini.clear(&ini);
+            return FTI_NSCS;
+        }
     }
 
     // Save number of variables in metadata
@@ -654,35 +879,255 @@ int FTI_WriteCkptMetaData(FTIT_configuration* FTI_Conf,
 }
 
 
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It packs the variable records of this process.
+  @param      FTI_Exec        Execution metadata.
+  @param      data            Protected datasets.
+  @param      nbVar           Number of protected datasets.
+  @return     FTIT_metaBinSection*   Packed records.
+
+  The names are stored once per process: empty names and dataset names
+  equal to the attribute name share the same string.
+
+ **/
+/*-------------------------------------------------------------------------*/
+static FTIT_metaBinSection* FTI_PackMetaSection(FTIT_execution* FTI_Exec,
+        FTIT_dataset* data, int nbVar) {
+    uint64_t nbDims = 0, stringSize = 1;
+    int i;
+    for (i = 0; i < nbVar; i++) {
+        uint64_t len = strnlen(data[i].idChar, FTI_BUFS - 1);
+        nbDims += data[i].attribute.dim.ndims;
+        stringSize += (len > 0) ? len + 1 : 0;
+        len = strnlen(data[i].attribute.name, FTI_BUFS - 1);
+        if (len > 0 && strncmp(data[i].attribute.name, data[i].idChar,
+         FTI_BUFS - 1) != 0) {
+            stringSize += len + 1;
+        }
+    }
+
+    uint64_t size = FTI_MetaBinSectionSize(nbVar, nbDims, stringSize);
+    FTIT_metaBinSection* section = calloc(1, size);
+    section->nbVar = nbVar;
+    section->nbDims = nbDims;
+    section->stringSize = stringSize;
+    section->size = size;
+
+    FTIT_metaBinVar* vars = FTI_MetaBinSectionVars(section);
+    uint64_t* dims = FTI_MetaBinSectionDims(section);
+    char* strings = FTI_MetaBinSectionStrings(section);
+    uint64_t dimUsed = 0, stringUsed = 1;
+    for (i = 0; i < nbVar; i++) {
+        int typeID = data[i].type->id - FTI_Exec->datatypes.primitive_offset;
+        vars[i].id = data[i].id;
+        vars[i].typeId = (typeID < FTI_Exec->datatypes.nprimitives) ?
+          typeID : -1;
+        vars[i].typeSize = data[i].type->size;
+        vars[i].size = data[i].size;
+        vars[i].ndims = data[i].attribute.dim.ndims;
+        vars[i].dims = dimUsed;
+        memcpy(&dims[dimUsed], data[i].attribute.dim.count,
+         vars[i].ndims * sizeof(uint64_t));
+        dimUsed += vars[i].ndims;
+
+        uint64_t len = strnlen(data[i].idChar, FTI_BUFS - 1);
+        if (len > 0) {
+            memcpy(&strings[stringUsed], data[i].idChar, len);
+            vars[i].idChar = stringUsed;
+            stringUsed += len + 1;
+        }
+        len = strnlen(data[i].attribute.name, FTI_BUFS - 1);
+        if (len > 0 && strncmp(data[i].attribute.name, data[i].idChar,
+         FTI_BUFS - 1) == 0) {
+            vars[i].name = vars[i].idChar;
+        } else if (len > 0) {
+            memcpy(&strings[stringUsed], data[i].attribute.name, len);
+            vars[i].name = stringUsed;
+            stringUsed += len + 1;
+        }
+    }
+
+    return section;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It starts sending the variable records to the group rank 0.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+  @param      FTI_Data        Dataset metadata.
+  @return     integer         FTI_SCES if successful.
+
+  This function is called collectively before the checkpoint data is
+  written, the records are gathered in the background and used by
+  \ref FTI_CreateMetadata. Records that did not change since the previous
+  checkpoint are not sent again.
+
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_PostMetadata(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
+        FTIT_topology* FTI_Topo, FTIT_keymap* FTI_Data) {
+    FTIT_metaExchange* xchg = &FTI_Exec->metaXchg;
+
+    // metadata is created before for FTI-FF
+    if (FTI_Conf->ioMode == FTI_IO_FTIFF || FTI_Exec->h5SingleFile ||
+     xchg->status != FTI_META_XCHG_IDLE) {
+        return FTI_SCES;
+    }
+
+    // The members take part in the gather even if their datasets fail
+    int res = FTI_SCES, nbVar = FTI_Exec->nbVar;
+    FTIT_dataset* data;
+    if (FTI_Data->data(&data, nbVar) != FTI_SCES) {
+        res = FTI_NSCS;
+        nbVar = 0;
+    }
+
+    FTIT_metaBinSection* section = FTI_PackMetaSection(FTI_Exec, data, nbVar);
+
+    uint32_t crc = FTI_Crc32c(0, (unsigned char*) section, section->size);
+    bool changed = !xchg->hasCrc || (crc != xchg->crc);
+    int count = (changed) ? section->size : 0;
+
+    if (FTI_Topo->groupRank == 0 && xchg->counts == NULL) {
+        xchg->counts = talloc(int, FTI_Topo->groupSize);
+        xchg->displs = talloc(int, FTI_Topo->groupSize);
+        xchg->cache = (void**) calloc(FTI_Topo->groupSize, sizeof(void*));
+    }
+    MPI_Gather(&count, 1, MPI_INT, xchg->counts, 1, MPI_INT, 0,
+     FTI_Exec->groupComm);
+
+    if (FTI_Topo->groupRank == 0) {
+        int i, total = 0;
+        for (i = 0; i < FTI_Topo->groupSize; i++) {
+            xchg->displs[i] = total;
+            total += xchg->counts[i];
+        }
+        xchg->recv = talloc(char, total + 1);
+    }
+    MPI_Igatherv(section, count, MPI_BYTE, xchg->recv, xchg->counts,
+     xchg->displs, MPI_BYTE, 0, FTI_Exec->groupComm, &xchg->req);
+
+    xchg->section = section;
+    xchg->nbVar = nbVar;
+    xchg->hasCrc = true;
+    xchg->crc = crc;
+    xchg->status = FTI_META_XCHG_POST;
+
+    return res;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It completes the gather of the variable records.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+  @return     integer         FTI_SCES if successful.
+
+  The group rank 0 replaces the records of the members that sent them and
+  keeps the previous records of the others. If it cannot store them, the
+  whole group fails and every member sends all its records again at the
+  next checkpoint.
+
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_WaitMetadata(FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo) {
+    FTIT_metaExchange* xchg = &FTI_Exec->metaXchg;
+    if (xchg->status != FTI_META_XCHG_POST) return FTI_SCES;
+
+    MPI_Wait(&xchg->req, MPI_STATUS_IGNORE);
+    free(xchg->section);
+    xchg->section = NULL;
+    xchg->status = FTI_META_XCHG_DONE;
+
+    int i, res = FTI_SCES;
+    if (FTI_Topo->groupRank == 0) {
+        for (i = 0; i < FTI_Topo->groupSize; i++) {
+            if (xchg->counts[i] == 0) continue;
+            void* cache = realloc(xchg->cache[i], xchg->counts[i]);
+            if (cache == NULL) {
+                FTI_Print("Failed to store the variable records.", FTI_EROR);
+                res = FTI_NSCS;
+                continue;
+            }
+            memcpy(cache, (char*) xchg->recv + xchg->displs[i],
+             xchg->counts[i]);
+            xchg->cache[i] = cache;
+        }
+        free(xchg->recv);
+        xchg->recv = NULL;
+    }
+
+    // The members can not tell which of their records were not stored
+    MPI_Bcast(&res, 1, MPI_INT, 0, FTI_Exec->groupComm);
+    if (res != FTI_SCES) {
+        xchg->hasCrc = false;
+    }
+
+    return res;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It drops the gathered records of a failed checkpoint.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_DiscardMetadata(FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo) {
+    FTI_WaitMetadata(FTI_Exec, FTI_Topo);
+    FTI_Exec->metaXchg.status = FTI_META_XCHG_IDLE;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It frees the records kept for the metadata exchange.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_FreeMetadata(FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo) {
+    FTIT_metaExchange* xchg = &FTI_Exec->metaXchg;
+    FTI_DiscardMetadata(FTI_Exec, FTI_Topo);
+
+    if (xchg->cache != NULL) {
+        int i;
+        for (i = 0; i < FTI_Topo->groupSize; i++) {
+            free(xchg->cache[i]);
+        }
+    }
+    free(xchg->cache);
+    free(xchg->counts);
+    free(xchg->displs);
+    xchg->cache = NULL;
+    xchg->counts = NULL;
+    xchg->displs = NULL;
+    xchg->hasCrc = false;
+}
+
 /*-------------------------------------------------------------------------*/
 /**
   @brief      It writes the metadata to recover the data after a failure.
   @param      FTI_Conf        Configuration metadata.
   @param      FTI_Exec        Execution metadata.
   @param      FTI_Topo        Topology metadata.
-  @param      fs              Pointer to the list of checkpoint sizes.
-  @param      mfs             The maximum checkpoint file size.
-  @param      fnl             Pointer to the list of checkpoint names.
-  @param      checksums       Checksums array.
-  @param      allVarIDs       IDs of vars from all processes in group.
-  @param      allVarSizes     Sizes of vars from all processes in group.
-  @param      allLayerSizes   Sizes of all layers used in dcp.
-  @param      allLayerHashes  Hashes of all layers used in dcp.
-  @param      allVarPositions Positions of variables stored in dCP.
+  @param      FTI_Ckpt        Checkpoint metadata.
+  @param      meta            Gathered metadata of the group.
   @return     integer         FTI_SCES if successful.
 
   This function should be executed only by one process per group. It
-  writes the metadata file used to recover in case of failure.
+  writes the metadata file used to recover in case of failure, in the
+  format selected with 'meta_format'.
 
  **/
 /*-------------------------------------------------------------------------*/
 int FTI_WriteMetadata(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
-        FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt, int32_t* fs,
-        int32_t mfs, char* fnl, char* checksums, int* allVarIDs,
-        int* allRanks, uint64_t* allCounts,
-        int* allVarTypeIDs, int* allVarTypeSizes,
-        int32_t* allVarSizes, uint32_t* allLayerSizes, char* allLayerHashes,
-        int32_t *allVarPositions, char *allNames, char *allCharIds) {
+        FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt,
+        FTIT_metaBin* meta) {
     // no metadata files for FTI-FF
     if (FTI_Conf->ioMode == FTI_IO_FTIFF) { return FTI_SCES; }
 
@@ -691,6 +1136,11 @@ int FTI_WriteMetadata(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     snprintf(fn, FTI_BUFS, "%s/sector%d-group%d.fti",
      FTI_Conf->mTmpDir, FTI_Topo->sectorID, FTI_Topo->groupID);
 
+    if (FTI_Conf->metaFormat == FTI_META_BIN) {
+        MKDIR(FTI_Conf->mTmpDir, 0777);
+        return FTI_MetaBinStore(meta, fn);
+    }
+
     // To bypass iniparser bug while empty dict.
     FTIT_iniparser ini;
     if (FTI_Iniparser(&ini, fn, FTI_INI_CREATE) != FTI_SCES) {
@@ -700,7 +1150,7 @@ int FTI_WriteMetadata(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
 
     // Add dcp POSIX meta data
     ini.set(&ini, "ckpt_info", NULL);
-    switch (FTI_Ckpt[FTI_Exec->ckptMeta.level].isDcp) {
+    switch (meta->head->isDcp) {
         case 0:
             ini.set(&ini, "ckpt_info:ckpt_type", "full");
             break;
@@ -710,108 +1160,106 @@ int FTI_WriteMetadata(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     }
 
     // add checkpoint id
-    snprintf(val, FTI_BUFS, "%d", FTI_Exec->ckptMeta.ckptId);
+    snprintf(val, FTI_BUFS, "%d", meta->head->ckptId);
     ini.set(&ini, "ckpt_info:ckpt_id", val);
 
     // Add metadata to dictionary
     int i;
-    for (i = 0; i < FTI_Topo->groupSize; i++) {
-        strncpy(val, fnl + (i * FTI_BUFS), FTI_BUFS - 1);
+    for (i = 0; i < meta->head->groupSize; i++) {
+        strncpy(val, meta->procs[i].fileName, FTI_BUFS - 1);
         snprintf(key, FTI_BUFS, "%d", i);
         ini.set(&ini, key, NULL);
         snprintf(key, FTI_BUFS, "%d:Ckpt_file_name", i);
         ini.set(&ini, key, val);
         snprintf(key, FTI_BUFS, "%d:Ckpt_file_size", i);
-        snprintf(val, FTI_BUFS, "%u", fs[i]);
+        snprintf(val, FTI_BUFS, "%ld", meta->procs[i].fs);
         ini.set(&ini, key, val);
         snprintf(key, FTI_BUFS, "%d:Ckpt_file_maxs", i);
-        snprintf(val, FTI_BUFS, "%u", mfs);
+        snprintf(val, FTI_BUFS, "%ld", meta->head->maxFs);
         ini.set(&ini, key, val);
-        strncpy(val, checksums + (i * MD5_DIGEST_STRING_LENGTH),
-         MD5_DIGEST_STRING_LENGTH);
         snprintf(key, FTI_BUFS, "%d:Ckpt_checksum", i);
-        ini.set(&ini, key, val);
-        int j;
-        for (j = 0; j < FTI_Exec->nbVar; j++) {
+        ini.set(&ini, key, meta->procs[i].checksum);
+        int j, nbVar = 0;
+        for (j = 0; j < meta->head->nbVar; j++) {
+            FTIT_metaBinVar* var = FTI_MetaBinVarOf(meta, i, j);
+            if (var->id == -1) {
+                break;
+            }
+            nbVar++;
+
             // Save id of variable
             snprintf(key, FTI_BUFS, "%d:Var%d_id", i, j);
-            snprintf(val, FTI_BUFS, "%d", allVarIDs[i * FTI_Exec->nbVar + j]);
+            snprintf(val, FTI_BUFS, "%d", var->id);
             ini.set(&ini, key, val);
 
             // Save id of type
             snprintf(key, FTI_BUFS, "%d:Var%d_typeId", i, j);
-            snprintf(val, FTI_BUFS, "%d",
-                    allVarTypeIDs[i * FTI_Exec->nbVar + j]);
+            snprintf(val, FTI_BUFS, "%d", var->typeId);
             ini.set(&ini, key, val);
 
             // Save size of type
             snprintf(key, FTI_BUFS, "%d:Var%d_typeSize", i, j);
-            snprintf(val, FTI_BUFS, "%d",
-                    allVarTypeSizes[i * FTI_Exec->nbVar + j]);
+            snprintf(val, FTI_BUFS, "%d", var->typeSize);
             ini.set(&ini, key, val);
 
             // Save size of variable
             snprintf(key, FTI_BUFS, "%d:Var%d_size", i, j);
-            snprintf(val, FTI_BUFS, "%d",
-             allVarSizes[i * FTI_Exec->nbVar + j]);
+            snprintf(val, FTI_BUFS, "%ld", var->size);
             ini.set(&ini, key, val);
 
             snprintf(key, FTI_BUFS, "%d:Var%d_pos", i, j);
-            snprintf(val, FTI_BUFS, "%d",
-             allVarPositions[i * FTI_Exec->nbVar + j]);
+            snprintf(val, FTI_BUFS, "%ld", var->pos);
             ini.set(&ini, key, val);
 
+            if (var->codec != FTI_CODEC_NONE) {
+                snprintf(key, FTI_BUFS, "%d:Var%d_codec", i, j);
+                snprintf(val, FTI_BUFS, "%d", var->codec);
+                ini.set(&ini, key, val);
+
+                snprintf(key, FTI_BUFS, "%d:Var%d_fileSize", i, j);
+                snprintf(val, FTI_BUFS, "%ld", var->fileSize);
+                ini.set(&ini, key, val);
+            }
+
             snprintf(key, FTI_BUFS, "%d:Var%d_name", i, j);
-            snprintf(val, FTI_BUFS, "%s",
-             &allNames[(i*FTI_Exec->nbVar*FTI_BUFS) +j*FTI_BUFS]);
-            ini.set(&ini, key, val);
+            ini.set(&ini, key, FTI_MetaBinString(meta, var->name));
 
             snprintf(key, FTI_BUFS, "%d:Var%d_idchar", i, j);
-            snprintf(val, FTI_BUFS, "%s",
-             &allCharIds[(i*FTI_Exec->nbVar*FTI_BUFS) +j*FTI_BUFS]);
-            ini.set(&ini, key, val);
+            ini.set(&ini, key, FTI_MetaBinString(meta, var->idChar));
 
             // Save rank of variable
             snprintf(key, FTI_BUFS, "%d:Var%d_ndims", i, j);
-            snprintf(val, FTI_BUFS, "%d",
-                    allRanks[i * FTI_Exec->nbVar + j]);
+            snprintf(val, FTI_BUFS, "%d", var->ndims);
             ini.set(&ini, key, val);
 
-            int r = 0; for (; r < allRanks[i * FTI_Exec->nbVar + j]; r++) {
+            int r = 0; for (; r < var->ndims; r++) {
                 // Save rank of variable
                 snprintf(key, FTI_BUFS, "%d:Var%d_dim%d", i, j, r);
-                snprintf(val, FTI_BUFS, "%lu",
-                        allCounts[i * 32 * FTI_Exec->nbVar + j * 32 + r]);
+                snprintf(val, FTI_BUFS, "%lu", meta->dims[var->dims + r]);
                 ini.set(&ini, key, val);
             }
         }
-        if (FTI_Ckpt[FTI_Exec->ckptMeta.level].isDcp) {
-            int nbLayer = ((FTI_Exec->dcpInfoPosix.Counter-1) %
-             FTI_Conf->dcpInfoPosix.StackSize) + 1;
-            for (j=0; j < nbLayer; j++) {
-                snprintf(key, FTI_BUFS, "%d:dcp_layer%d_size", i, j);
-                snprintf(val, FTI_BUFS, "%u", allLayerSizes[i * nbLayer + j]);
-                ini.set(&ini, key, val);
+        for (j = 0; j < meta->head->nbLayer; j++) {
+            FTIT_metaBinLayer* layer = FTI_MetaBinLayerOf(meta, i, j);
+            snprintf(key, FTI_BUFS, "%d:dcp_layer%d_size", i, j);
+            snprintf(val, FTI_BUFS, "%lu", layer->size);
+            ini.set(&ini, key, val);
 
-                snprintf(key, FTI_BUFS, "%d:dcp_layer%d_hash", i, j);
-                ini.set(&ini, key,
-                 &allLayerHashes[i*nbLayer*MD5_DIGEST_STRING_LENGTH +
-                  j*MD5_DIGEST_STRING_LENGTH]);
-                int k;
-                for (k = 0; k < FTI_Exec->nbVar; k++) {
-                    // Save id of variable
-                    snprintf(key, FTI_BUFS, "%d:dcp_layer%d_var%d_id",
-                     i, j, k);
-                    snprintf(val, FTI_BUFS, "%d",
-                     allVarIDs[i * FTI_Exec->nbVar + k]);
-                    ini.set(&ini, key, val);
-                    // Save size of variable
-                    snprintf(key, FTI_BUFS, "%d:dcp_layer%d_var%d_size",
-                     i, j, k);
-                    snprintf(val, FTI_BUFS, "%d",
-                     allVarSizes[i * FTI_Exec->nbVar + k]);
-                    ini.set(&ini, key, val);
-                }
+            snprintf(key, FTI_BUFS, "%d:dcp_layer%d_hash", i, j);
+            ini.set(&ini, key, layer->hash);
+            int k;
+            for (k = 0; k < nbVar; k++) {
+                FTIT_metaBinVar* var = FTI_MetaBinVarOf(meta, i, k);
+                // Save id of variable
+                snprintf(key, FTI_BUFS, "%d:dcp_layer%d_var%d_id",
+                 i, j, k);
+                snprintf(val, FTI_BUFS, "%d", var->id);
+                ini.set(&ini, key, val);
+                // Save size of variable
+                snprintf(key, FTI_BUFS, "%d:dcp_layer%d_var%d_size",
+                 i, j, k);
+                snprintf(val, FTI_BUFS, "%ld", var->size);
+                ini.set(&ini, key, val);
             }
         }
     }
@@ -824,6 +1272,73 @@ int FTI_WriteMetadata(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     return FTI_SCES;
 }
 
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It assembles the metadata of the group.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+  @param      FTI_Ckpt        Checkpoint metadata.
+  @param      meta            Metadata of the group (out).
+  @param      files           File records, layers and file positions.
+  @param      nbLayer         dCP layers per process.
+  @return     integer         FTI_SCES if successful.
+
+  Executed by the group rank 0, combines the cached variable records of
+  the members with the file information gathered for this checkpoint.
+
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_AssembleMetadata(FTIT_execution* FTI_Exec,
+        FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt,
+        FTIT_metaBin* meta, char* files, int nbLayer) {
+    FTIT_metaExchange* xchg = &FTI_Exec->metaXchg;
+    FTIT_metaBinSection** sections = (FTIT_metaBinSection**) xchg->cache;
+    uint64_t nbDims = 0, stringSize = 0;
+    int nbVar = 0, p, i;
+
+    for (p = 0; p < FTI_Topo->groupSize; p++) {
+        if (sections[p] == NULL) {
+            FTI_Print("Missing variable records of a group member.",
+             FTI_WARN);
+            return FTI_NSCS;
+        }
+        nbVar = (sections[p]->nbVar > nbVar) ? sections[p]->nbVar : nbVar;
+        nbDims += sections[p]->nbDims;
+        stringSize += sections[p]->stringSize;
+    }
+
+    if (FTI_MetaBinInit(meta, FTI_Topo->groupSize, nbVar, nbLayer, nbDims,
+     stringSize) != FTI_SCES) {
+        return FTI_NSCS;
+    }
+    meta->head->ckptId = FTI_Exec->ckptMeta.ckptId;
+    meta->head->isDcp = FTI_Ckpt[FTI_Exec->ckptMeta.level].isDcp;
+    meta->head->maxFs = FTI_Exec->ckptMeta.maxFs;
+
+    for (p = 0; p < FTI_Topo->groupSize; p++) {
+        char* ptr = files + xchg->displs[p];
+        if (FTI_MetaBinAddSection(meta, p, sections[p]) != FTI_SCES) {
+            FTI_MetaBinFree(meta);
+            return FTI_NSCS;
+        }
+        memcpy(&meta->procs[p], ptr, sizeof(FTIT_metaBinProc));
+        ptr += sizeof(FTIT_metaBinProc);
+        memcpy(FTI_MetaBinLayerOf(meta, p, 0), ptr,
+         nbLayer * sizeof(FTIT_metaBinLayer));
+        ptr += nbLayer * sizeof(FTIT_metaBinLayer);
+        FTIT_metaVarFile* vars = (FTIT_metaVarFile*) ptr;
+        for (i = 0; i < sections[p]->nbVar; i++) {
+            FTIT_metaBinVar* var = FTI_MetaBinVarOf(meta, p, i);
+            var->pos = vars[i].pos;
+            var->fileSize = vars[i].fileSize;
+            var->codec = vars[i].codec;
+        }
+    }
+    FTI_MetaBinIndex(meta);
+
+    return FTI_SCES;
+}
+
 /*-------------------------------------------------------------------------*/
 /**
   @brief      It writes the metadata to recover the data after a failure.
@@ -836,7 +1351,9 @@ int FTI_WriteMetadata(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
 
   This function gathers information about the checkpoint files in the
   group (name and sizes), and creates the metadata file used to recover in
-  case of failure.
+  case of failure. The variable records were posted with
+  \ref FTI_PostMetadata before the data was written, only the file
+  information and positions are gathered here.
 
  **/
 /*-------------------------------------------------------------------------*/
@@ -849,6 +1366,18 @@ int FTI_CreateMetadata(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     FTI_Exec->ckptMeta.fs = (FTI_Ckpt[FTI_Exec->ckptMeta.level].isDcp) ?
      FTI_Exec->dcpInfoPosix.FileSize : FTI_Exec->ckptSize;
 
+    // compressed variables take fewer bytes in the file
+    FTIT_dataset* data;
+    int i;
+    if (!FTI_Ckpt[FTI_Exec->ckptMeta.level].isDcp &&
+     FTI_Data->data(&data, FTI_Exec->nbVar) == FTI_SCES) {
+        for (i = 0; i < FTI_Exec->nbVar; i++) {
+            if (data[i].fileCodec != FTI_CODEC_NONE) {
+                FTI_Exec->ckptMeta.fs += data[i].fileSize - data[i].size;
+            }
+        }
+    }
+
 #ifdef ENABLE_HDF5
     if (FTI_Conf->ioMode == FTI_IO_HDF5) {
         char fn[FTI_BUFS];
@@ -881,9 +1410,16 @@ int FTI_CreateMetadata(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     }
 #endif
 
-    int32_t fileSizes[FTI_BUFS];
-    MPI_Allgather(&FTI_Exec->ckptMeta.fs, 1, MPI_INT32_T,
-            fileSizes, 1, MPI_INT32_T, FTI_Exec->groupComm);
+    // Records of iCP and synchronous fallbacks are sent now
+    FTIT_metaExchange* xchg = &FTI_Exec->metaXchg;
+    int res = FTI_SCES;
+    if (xchg->status == FTI_META_XCHG_IDLE) {
+        res = FTI_PostMetadata(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Data);
+    }
+
+    int64_t fileSizes[FTI_BUFS];
+    MPI_Allgather(&FTI_Exec->ckptMeta.fs, 1, MPI_INT64_T,
+            fileSizes, 1, MPI_INT64_T, FTI_Exec->groupComm);
 
     // update partner file size:
     if (FTI_Exec->ckptMeta.level == 2) {
@@ -892,8 +1428,7 @@ int FTI_CreateMetadata(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         FTI_Exec->ckptMeta.pfs = fileSizes[ptnerGroupRank];
     }
 
-    int32_t mfs = 0;  // Max file size in group
-    int i;
+    int64_t mfs = 0;  // Max file size in group
     for (i = 0; i < FTI_Topo->groupSize; i++) {
         if (fileSizes[i] > mfs) {
             mfs = fileSizes[i];  // Search max. size
@@ -901,188 +1436,94 @@ int FTI_CreateMetadata(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     }
     FTI_Exec->ckptMeta.maxFs = mfs;
     char str[FTI_BUFS];  // For console output
-    snprintf(str, FTI_BUFS, "Max. file size in group %u.", mfs);
+    snprintf(str, FTI_BUFS, "Max. file size in group %ld.", mfs);
     FTI_Print(str, FTI_DBUG);
 
-    char* ckptFileNames = NULL;
-    if (FTI_Topo->groupRank == 0) {
-        ckptFileNames = talloc(char, FTI_Topo->groupSize * FTI_BUFS);
+    if (FTI_WaitMetadata(FTI_Exec, FTI_Topo) != FTI_SCES) {
+        res = FTI_NSCS;
     }
-    strncpy(str, FTI_Exec->ckptMeta.ckptFile, FTI_BUFS);
-    // Gather all the file names
-    MPI_Gather(str, FTI_BUFS, MPI_CHAR, ckptFileNames, FTI_BUFS, MPI_CHAR, 0,
-     FTI_Exec->groupComm);
-
-    char checksum[MD5_DIGEST_STRING_LENGTH];
-    FTI_Checksum(FTI_Exec, FTI_Data, FTI_Conf, checksum);
+    xchg->status = FTI_META_XCHG_IDLE;
+
+    // File record, dCP layers and file positions of this process
+    int nbLayer = (FTI_Ckpt[FTI_Exec->ckptMeta.level].isDcp) ?
+     ((FTI_Exec->dcpInfoPosix.Counter-1) %
+      FTI_Conf->dcpInfoPosix.StackSize) + 1 : 0;
+    int nbVar = xchg->nbVar;
+    int size = sizeof(FTIT_metaBinProc) +
+     nbLayer * sizeof(FTIT_metaBinLayer) + nbVar * sizeof(FTIT_metaVarFile);
+    char* file = calloc(1, size);
+
+    FTIT_metaBinProc* proc = (FTIT_metaBinProc*) file;
+    proc->fs = FTI_Exec->ckptMeta.fs;
+    strncpy(proc->fileName, FTI_Exec->ckptMeta.ckptFile, FTI_BUFS - 1);
+    FTI_Checksum(FTI_Exec, FTI_Data, FTI_Conf, proc->checksum);
 
     // TODO(leobago) checksums of HDF5 files
 #ifdef ENABLE_HDF5
     if (FTI_Conf->ioMode == FTI_IO_HDF5) {
-        checksum[0] = '\0';
+        proc->checksum[0] = '\0';
     }
 #endif
 
-    char* checksums = NULL;
-    if (FTI_Topo->groupRank == 0) {
-        checksums = talloc(char, FTI_Topo->groupSize*MD5_DIGEST_STRING_LENGTH);
+    FTIT_metaBinLayer* layers = (FTIT_metaBinLayer*) (proc + 1);
+    for (i = 0; i < nbLayer; i++) {
+        layers[i].size = FTI_Exec->dcpInfoPosix.LayerSize[i];
+        strncpy(layers[i].hash,
+         &FTI_Exec->dcpInfoPosix.LayerHash[i * MD5_DIGEST_STRING_LENGTH],
+         MD5_DIGEST_STRING_LENGTH);
     }
-    MPI_Gather(checksum, MD5_DIGEST_STRING_LENGTH, MPI_CHAR, checksums,
-     MD5_DIGEST_STRING_LENGTH, MPI_CHAR, 0, FTI_Exec->groupComm);
-
-
-    // Every process has the same number of protected variables
-
-    int* allVarIDs = NULL;
-    int* allVarTypeIDs = NULL;
-    int* allVarTypeSizes = NULL;
-    int32_t* allVarSizes = NULL;
-    int32_t *allVarPositions = NULL;
-
-    // for posix dcp
-    uint32_t* allLayerSizes = NULL;
-    char* allLayerHashes = NULL;
-    char* allCharIds = NULL;
-    char* allNames = NULL;
-    uint64_t* allCounts = NULL;
-    int* allRanks = NULL;
 
-    int nbLayer = ((FTI_Exec->dcpInfoPosix.Counter-1) %
-     FTI_Conf->dcpInfoPosix.StackSize) + 1;
-
-    if (FTI_Topo->groupRank == 0) {
-        allRanks = talloc(int, FTI_Topo->groupSize * FTI_Exec->nbVar);
-        allCounts = talloc(uint64_t, 32 * FTI_Topo->groupSize *
-                FTI_Exec->nbVar);
-        allVarIDs = talloc(int, FTI_Topo->groupSize * FTI_Exec->nbVar);
-        allVarTypeIDs = talloc(int, FTI_Topo->groupSize * FTI_Exec->nbVar);
-        allVarTypeSizes = talloc(int, FTI_Topo->groupSize * FTI_Exec->nbVar);
-        allVarSizes = talloc(int32_t, FTI_Topo->groupSize * FTI_Exec->nbVar);
-        allVarPositions = talloc(int32_t,
-         FTI_Topo->groupSize * FTI_Exec->nbVar);
-        allCharIds = (char *)malloc(sizeof(char)*FTI_BUFS*
-          FTI_Exec->nbVar*FTI_Topo->groupSize);
-        allNames = (char *)malloc(sizeof(char)*FTI_BUFS*
-          FTI_Exec->nbVar*FTI_Topo->groupSize);
-        if (FTI_Ckpt[FTI_Exec->ckptMeta.level].isDcp) {
-            allLayerSizes = talloc(uint32_t,
-             FTI_Topo->groupSize * nbLayer);
-            allLayerHashes = talloc(char,
-             FTI_Topo->groupSize * nbLayer * MD5_DIGEST_STRING_LENGTH);
-        }
+    if (FTI_Data->data(&data, nbVar) != FTI_SCES) {
+        res = FTI_NSCS;
+        nbVar = 0;
     }
-
-    int* myVarIDs = talloc(int, FTI_Exec->nbVar);
-    int* myRanks = talloc(int, FTI_Exec->nbVar);
-    uint64_t* myCounts = talloc(uint64_t, 32 * FTI_Exec->nbVar);
-    int* myVarTypeIDs = talloc(int, FTI_Exec->nbVar);
-    int* myVarTypeSizes = talloc(int, FTI_Exec->nbVar);
-    int32_t* myVarSizes = talloc(int32_t, FTI_Exec->nbVar);
-    int32_t* myVarPositions = talloc(int32_t, FTI_Exec->nbVar);
-    char *ArrayOfIdChars = (char *)malloc(FTI_Exec->nbVar *
-     sizeof(char*) *FTI_BUFS);
-    char *ArrayOfNames = (char *)malloc(FTI_Exec->nbVar *
-     sizeof(char*) *FTI_BUFS);
-
-    FTIT_dataset* data;
-    if (FTI_Data->data(&data, FTI_Exec->nbVar) != FTI_SCES) return FTI_NSCS;
-
-    for (i = 0; i < FTI_Exec->nbVar; i++) {
-        int typeID = data[i].type->id - FTI_Exec->datatypes.primitive_offset;
-        myVarIDs[i] = data[i].id;
-        myVarTypeIDs[i] = (typeID < FTI_Exec->datatypes.nprimitives) ?
-          typeID : -1;
-        myVarTypeSizes[i] = data[i].type->size;
-        myVarSizes[i] =  data[i].size;
-        myVarIDs[i] =  data[i].id;
-        myRanks[i] =  data[i].attribute.dim.ndims;
-        memcpy(&myCounts[i*32], &data[i].attribute.dim.count,
-                32 * sizeof(uint64_t));
-        myVarPositions[i] = data[i].filePos;
-        strncpy(&ArrayOfIdChars[i*FTI_BUFS], data[i].idChar, FTI_BUFS);
-        strncpy(&ArrayOfNames[i*FTI_BUFS], data[i].attribute.name, FTI_BUFS);
+    FTIT_metaVarFile* vars = (FTIT_metaVarFile*) (layers + nbLayer);
+    for (i = 0; i < nbVar; i++) {
+        vars[i].pos = data[i].filePos;
+        vars[i].codec = data[i].fileCodec;
+        vars[i].fileSize = data[i].fileSize;
     }
 
-    // Gather variables IDs
-    MPI_Gather(myVarIDs, FTI_Exec->nbVar, MPI_INT, allVarIDs, FTI_Exec->nbVar,
-     MPI_INT, 0, FTI_Exec->groupComm);
-    // Gather variables Type IDs
-    MPI_Gather(myVarTypeIDs, FTI_Exec->nbVar, MPI_INT, allVarTypeIDs,
-            FTI_Exec->nbVar,    MPI_INT, 0, FTI_Exec->groupComm);
-    // Gather variables Type Sizes
-    MPI_Gather(myVarTypeSizes, FTI_Exec->nbVar, MPI_INT, allVarTypeSizes,
-            FTI_Exec->nbVar,     MPI_INT, 0, FTI_Exec->groupComm);
-    // Gather variables Ranks
-    MPI_Gather(myRanks, FTI_Exec->nbVar, MPI_INT, allRanks, FTI_Exec->nbVar,
-     MPI_INT, 0, FTI_Exec->groupComm);
-    // Gather variables Counts
-    MPI_Gather(myCounts, 32*FTI_Exec->nbVar, MPI_INT64_T,
-            allCounts, 32*FTI_Exec->nbVar, MPI_INT64_T, 0, FTI_Exec->groupComm);
-    // Gather variables sizes
-    MPI_Gather(myVarSizes, FTI_Exec->nbVar, MPI_INT32_T, allVarSizes,
-     FTI_Exec->nbVar, MPI_INT32_T, 0, FTI_Exec->groupComm);
-    // Gather variables file positions
-    MPI_Gather(myVarPositions, FTI_Exec->nbVar, MPI_INT32_T, allVarPositions,
-     FTI_Exec->nbVar, MPI_INT32_T, 0, FTI_Exec->groupComm);
-    // Gather all variable idchars
-    MPI_Gather(ArrayOfIdChars, FTI_Exec->nbVar*FTI_BUFS, MPI_CHAR,
-      allCharIds, FTI_Exec->nbVar*FTI_BUFS, MPI_CHAR, 0, FTI_Exec->groupComm);
-    // gather all variable names
-    MPI_Gather(ArrayOfNames, FTI_Exec->nbVar*FTI_BUFS, MPI_CHAR,
-      allNames, FTI_Exec->nbVar*FTI_BUFS, MPI_CHAR, 0, FTI_Exec->groupComm);
-
-
-    if (FTI_Ckpt[FTI_Exec->ckptMeta.level].isDcp) {
-        // Gather dcp layer sizes
-        MPI_Gather(FTI_Exec->dcpInfoPosix.LayerSize, nbLayer, MPI_UINT32_T,
-         allLayerSizes, nbLayer, MPI_UINT32_T, 0, FTI_Exec->groupComm);
-        // Gather dcp layer hashes
-        MPI_Gather(FTI_Exec->dcpInfoPosix.LayerHash,
-         nbLayer * MD5_DIGEST_STRING_LENGTH, MPI_CHAR, allLayerHashes,
-         nbLayer * MD5_DIGEST_STRING_LENGTH, MPI_CHAR, 0, FTI_Exec->groupComm);
+    // The group rank 0 knows the number of variables of every member
+    char* files = NULL;
+    if (FTI_Topo->groupRank == 0) {
+        int total = 0;
+        for (i = 0; i < FTI_Topo->groupSize; i++) {
+            FTIT_metaBinSection* section = xchg->cache[i];
+            xchg->counts[i] = sizeof(FTIT_metaBinProc) +
+             nbLayer * sizeof(FTIT_metaBinLayer) +
+             ((section != NULL) ? section->nbVar : 0) *
+             sizeof(FTIT_metaVarFile);
+            xchg->displs[i] = total;
+            total += xchg->counts[i];
+        }
+        files = talloc(char, total);
     }
-
-    free(myVarIDs);
-    free(myRanks);
-    free(myCounts);
-    free(myVarTypeIDs);
-    free(myVarTypeSizes);
-    free(myVarSizes);
-    free(myVarPositions);
-    free(ArrayOfIdChars);
-    free(ArrayOfNames);
+    MPI_Gatherv(file, size, MPI_BYTE, files,
+     xchg->counts, xchg->displs, MPI_BYTE, 0, FTI_Exec->groupComm);
+    free(file);
 
     // Only one process in the group create the metadata
     if (FTI_Topo->groupRank == 0) {
-        int res = FTI_Try(FTI_WriteMetadata(FTI_Conf, FTI_Exec, FTI_Topo,
-         FTI_Ckpt, fileSizes, mfs, ckptFileNames, checksums, allVarIDs,
-         allRanks, allCounts,
-         allVarTypeIDs, allVarTypeSizes,
-         allVarSizes, allLayerSizes, allLayerHashes, allVarPositions,
-          allNames, allCharIds), "write the metadata.");
-        free(allVarIDs);
-        free(allVarTypeIDs);
-        free(allVarTypeSizes);
-        free(allVarSizes);
-        free(allCharIds);
-        free(allNames);
-        free(allCounts);
-        free(allRanks);
-        if (FTI_Ckpt[FTI_Exec->ckptMeta.level].isDcp) {
-            free(allLayerSizes);
-            free(allLayerHashes);
+        FTIT_metaBin meta;
+        if (res == FTI_SCES) {
+            res = FTI_AssembleMetadata(FTI_Exec, FTI_Topo, FTI_Ckpt, &meta,
+             files, nbLayer);
         }
-        free(ckptFileNames);
-        free(checksums);
-        free(allVarPositions);
-        if (res == FTI_NSCS) {
+        if (res == FTI_SCES) {
+            res = FTI_Try(FTI_WriteMetadata(FTI_Conf, FTI_Exec, FTI_Topo,
+             FTI_Ckpt, &meta), "write the metadata.");
+            FTI_MetaBinFree(&meta);
+        }
+        free(files);
+        if (res != FTI_SCES) {
             return FTI_NSCS;
         }
     }
 
-    for (i = 0; i < FTI_Exec->nbVar; i++) {
+    for (i = 0; i < nbVar; i++) {
         data[i].sizeStored =  data[i].size;
     }
 
-    return FTI_SCES;
+    return (res == FTI_SCES) ? FTI_SCES : FTI_NSCS;
 }
@@ -10,6 +10,10 @@
 
 #include "interface.h"
 
+#define FTI_META_XCHG_IDLE 0
+#define FTI_META_XCHG_POST 1
+#define FTI_META_XCHG_DONE 2
+
 int FTI_GetChecksums(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt,
         char* checksum, char* ptnerChecksum, char* rsChecksum);
@@ -28,12 +32,13 @@ int FTI_LoadMetaDataset(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt,
         FTIT_keymap* FTI_Data);
 int FTI_WriteMetadata(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
-        FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt, int32_t* fs,
-        int32_t mfs, char* fnl, char* checksums, int* allVarIDs,
-        int* allRanks, uint64_t* allCounts,
-        int* allVarTypeIDs, int* allVarTypeSizes,
-        int32_t* allVarSizes, uint32_t* allLayerSizes, char* allLayerHashes,
-        int32_t *allVarPositions, char *allNames, char *allCharIds);
+        FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt,
+        FTIT_metaBin* meta);
+int FTI_PostMetadata(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
+        FTIT_topology* FTI_Topo, FTIT_keymap* FTI_Data);
+int FTI_WaitMetadata(FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo);
+void FTI_DiscardMetadata(FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo);
+void FTI_FreeMetadata(FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo);
 int FTI_CreateMetadata(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt,
         FTIT_keymap* FTI_Data);
@@ -62,112 +62,279 @@ int FTI_Local(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
 
 /*-------------------------------------------------------------------------*/
 /**
-  @brief      It sends Ckpt file.
+  @brief      Loads the post-processing metadata of all files to process.
   @param      FTI_Conf        Configuration metadata.
   @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
   @param      FTI_Ckpt        Checkpoint metadata.
-  @param      destination     destination group rank
-  @param      postFlag        0 if postckpt done by approc, > 0 if by head
-  @return     integer         FTI_SCES if successful.
+  @param      startProc       First process of the node to post-process.
+  @param      nbProc          Number of processes to post-process.
+  @return     FTIT_metadata*  Metadata per process, NULL on failure.
 
-  This function sends ckpt file to partner process. Partner should call
-  FTI_RecvPtner to receive this file.
+  A head loads the metadata of every application process of the node at
+  once, so the files can be processed concurrently afterwards. An
+  application process only post-processes its own file. As before, the
+  execution metadata is left with the values of the last process.
 
  **/
 /*-------------------------------------------------------------------------*/
-int FTI_SendCkpt(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
-        FTIT_checkpoint* FTI_Ckpt, int destination, int postFlag) {
-    char lfn[FTI_BUFS], str[FTI_BUFS];
-    snprintf(lfn, FTI_BUFS, "%s/%s", FTI_Conf->lTmpDir,
-     FTI_Exec->ckptMeta.ckptFile);
+static FTIT_metadata* FTI_LoadPostMeta(FTIT_configuration* FTI_Conf,
+        FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo,
+        FTIT_checkpoint* FTI_Ckpt, int* startProc, int* nbProc) {
+    *startProc = (FTI_Topo->amIaHead) ? 1 : 0;
+    *nbProc = (FTI_Topo->amIaHead) ? FTI_Topo->nodeSize - 1 : 1;
+
+    FTIT_metadata* meta = talloc(FTIT_metadata, *nbProc);
+    if (meta == NULL) {
+        FTI_Print("Cannot allocate the post-processing metadata.", FTI_EROR);
+        return NULL;
+    }
+    int i;
+    for (i = 0; i < *nbProc; i++) {
+        if (FTI_Topo->amIaHead) {
+            int res = FTI_Try(FTI_LoadMetaPostprocessing(FTI_Conf, FTI_Exec,
+             FTI_Topo, FTI_Ckpt, *startProc + i), "load temporary metadata.");
+            if (res != FTI_SCES) {
+                free(meta);
+                return NULL;
+            }
+        }
+        meta[i] = FTI_Exec->ckptMeta;
+    }
+    return meta;
+}
 
-    // PostFlag is set to 0 if Post-processing is inline and set to
-    // processes nodeID if Post-processing done by head
-    if (postFlag) {
-        snprintf(str, FTI_BUFS,
-         "L2 trying to access process's %d ckpt. file (%s).", postFlag, lfn);
-    } else {
-        snprintf(str, FTI_BUFS,
-         "L2 trying to access local ckpt. file (%s).", lfn);
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Number of files post-processed at the same time.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Topo        Topology metadata.
+  @param      nbProc          Number of files to post-process.
+  @return     integer         Batch width ('head_threads' for heads).
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_PostWidth(FTIT_configuration* FTI_Conf,
+        FTIT_topology* FTI_Topo, int nbProc) {
+    if (!FTI_Topo->amIaHead || FTI_Conf->headThreads > nbProc) {
+        return nbProc;
     }
-    FTI_Print(str, FTI_DBUG);
+    return FTI_Conf->headThreads;
+}
 
-    FILE* lfd = fopen(lfn, "rb");
-    if (lfd == NULL) {
-        FTI_Print("FTI failed to open L2 Ckpt. file.", FTI_DBUG);
+/** @typedef    FTIT_pipeRing
+ *  @brief      Ring of block buffers for one direction of a transfer.
+ *
+ *  Blocks are issued at 'head + count' and retired in order at 'head',
+ *  which preserves the order of the data in the files.
+ */
+typedef struct FTIT_pipeRing {
+    char* buf[FTI_PIPELINE_DEPTH];        /**< block buffers               */
+    int size[FTI_PIPELINE_DEPTH];         /**< bytes in flight per block   */
+    MPI_Request req[FTI_PIPELINE_DEPTH];  /**< request per block           */
+    int head;                             /**< oldest block in flight      */
+    int count;                            /**< number of blocks in flight  */
+} FTIT_pipeRing;
+
+/** @typedef    FTIT_pipeStream
+ *  @brief      A file sent and a file received over the same MPI tag.
+ */
+typedef struct FTIT_pipeStream {
+    FILE* lfd;                            /**< file to send                */
+    int64_t toSend;                       /**< bytes left to send          */
+    FILE* pfd;                            /**< file to write to            */
+    int64_t toRecv;                       /**< bytes left to receive       */
+    int tag;                              /**< MPI tag of the stream       */
+    FTIT_pipeRing snd;                    /**< blocks being sent           */
+    FTIT_pipeRing rcv;                    /**< blocks being received       */
+} FTIT_pipeStream;
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It sends files and receives other ones at the same time.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      st              Streams to transfer (files, sizes and tags).
+  @param      nbStreams       Number of streams.
+  @param      destination     Destination group rank.
+  @param      source          Source group rank.
+  @return     integer         FTI_SCES if successful.
+
+  Every direction of every stream is split into blocks of 'blockSize'
+  bytes and is kept in flight with MPI_Isend/MPI_Irecv over
+  FTI_PIPELINE_DEPTH reusable buffers. The next blocks are read while the
+  previous ones are on the network, and received blocks are written while
+  the following receives are pending. Since all receives are posted before
+  waiting and every stream has its own tag, the partners do not need to
+  agree on an order, and the streams progress independently.
+
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_PipeFiles(FTIT_configuration* FTI_Conf,
+        FTIT_execution* FTI_Exec, FTIT_pipeStream* st, int nbStreams,
+        int destination, int source) {
+    char* buffer = talloc(char, (size_t) 2 * FTI_PIPELINE_DEPTH * nbStreams *
+     FTI_Conf->blockSize);
+    MPI_Request* oldest = talloc(MPI_Request, 2 * nbStreams);
+    if (buffer == NULL || oldest == NULL) {
+        FTI_Print("L2 cannot allocate the transfer buffers.", FTI_EROR);
+        free(buffer);
+        free(oldest);
         return FTI_NSCS;
     }
+    int i, k;
+    for (k = 0; k < nbStreams; k++) {
+        char* base = buffer + (size_t) 2 * FTI_PIPELINE_DEPTH * k *
+         FTI_Conf->blockSize;
+        memset(&st[k].snd, 0, sizeof(FTIT_pipeRing));
+        memset(&st[k].rcv, 0, sizeof(FTIT_pipeRing));
+        for (i = 0; i < FTI_PIPELINE_DEPTH; i++) {
+            st[k].snd.buf[i] = base + (size_t) i * FTI_Conf->blockSize;
+            st[k].rcv.buf[i] = base +
+             (size_t) (FTI_PIPELINE_DEPTH + i) * FTI_Conf->blockSize;
+        }
+    }
+
+    int res = FTI_SCES;
+    while (res == FTI_SCES) {
+        bool pending = false;
+        for (k = 0; k < nbStreams && res == FTI_SCES; k++) {
+            FTIT_pipeRing* snd = &st[k].snd;
+            FTIT_pipeRing* rcv = &st[k].rcv;
+
+            // post the receives for all free buffers
+            while (rcv->count < FTI_PIPELINE_DEPTH && st[k].toRecv > 0) {
+                int slot = (rcv->head + rcv->count) % FTI_PIPELINE_DEPTH;
+                rcv->size[slot] = (st[k].toRecv > FTI_Conf->blockSize) ?
+                 FTI_Conf->blockSize : st[k].toRecv;
+                MPI_Irecv(rcv->buf[slot], rcv->size[slot], MPI_CHAR, source,
+                 st[k].tag, FTI_Exec->groupComm, &rcv->req[slot]);
+                st[k].toRecv -= rcv->size[slot];
+                rcv->count++;
+            }
+
+            // read the next blocks into the free buffers and send them
+            while (snd->count < FTI_PIPELINE_DEPTH && st[k].toSend > 0) {
+                int slot = (snd->head + snd->count) % FTI_PIPELINE_DEPTH;
+                int readSize = (st[k].toSend > FTI_Conf->blockSize) ?
+                 FTI_Conf->blockSize : st[k].toSend;
+                snd->size[slot] = fread(snd->buf[slot], sizeof(char),
+                 readSize, st[k].lfd);
+                if (snd->size[slot] != readSize) {
+                    FTI_Print("L2 cannot read the checkpoint file.",
+                     FTI_EROR);
+                    res = FTI_NSCS;
+                    break;
+                }
+                MPI_Isend(snd->buf[slot], snd->size[slot], MPI_CHAR,
+                 destination, st[k].tag, FTI_Exec->groupComm,
+                 &snd->req[slot]);
+                st[k].toSend -= snd->size[slot];
+                snd->count++;
+            }
 
-    char* buffer = talloc(char, FTI_Conf->blockSize);
-    int32_t toSend = FTI_Exec->ckptMeta.fs;  // remaining data to send
-    while (toSend > 0) {
-        int sendSize = (toSend > FTI_Conf->blockSize) ?
-         FTI_Conf->blockSize : toSend;
-        int bytes;
-        FREAD(FTI_NSCS, bytes, buffer, sizeof(char), sendSize, lfd, "p",
-         buffer);
-        MPI_Send(buffer, bytes, MPI_CHAR, destination, FTI_Conf->generalTag,
-         FTI_Exec->groupComm);
-        toSend -= bytes;
+            oldest[2 * k] = (snd->count > 0) ? snd->req[snd->head] :
+             MPI_REQUEST_NULL;
+            oldest[2 * k + 1] = (rcv->count > 0) ? rcv->req[rcv->head] :
+             MPI_REQUEST_NULL;
+            pending = pending || snd->count > 0 || rcv->count > 0;
+        }
+        if (res != FTI_SCES || !pending) {
+            break;
+        }
+
+        // retire the oldest send or receive of any stream
+        int idx;
+        MPI_Waitany(2 * nbStreams, oldest, &idx, MPI_STATUS_IGNORE);
+        k = idx / 2;
+        if (idx % 2 == 0) {
+            st[k].snd.head = (st[k].snd.head + 1) % FTI_PIPELINE_DEPTH;
+            st[k].snd.count--;
+        } else {
+            FTIT_pipeRing* rcv = &st[k].rcv;
+            int slot = rcv->head;
+            rcv->head = (rcv->head + 1) % FTI_PIPELINE_DEPTH;
+            rcv->count--;
+            if (fwrite(rcv->buf[slot], sizeof(char), rcv->size[slot],
+             st[k].pfd) != rcv->size[slot]) {
+                FTI_Print("L2 cannot write the partner file.", FTI_EROR);
+                res = FTI_NSCS;
+            }
+        }
     }
 
-    free(buffer);
-    fclose(lfd);
+    // on failure, drop pending receives and let the sends complete
+    for (k = 0; k < nbStreams; k++) {
+        FTIT_pipeRing* snd = &st[k].snd;
+        FTIT_pipeRing* rcv = &st[k].rcv;
+        for (i = 0; i < rcv->count; i++) {
+            int slot = (rcv->head + i) % FTI_PIPELINE_DEPTH;
+            MPI_Cancel(&rcv->req[slot]);
+            MPI_Wait(&rcv->req[slot], MPI_STATUS_IGNORE);
+        }
+        for (i = 0; i < snd->count; i++) {
+            MPI_Wait(&snd->req[(snd->head + i) % FTI_PIPELINE_DEPTH],
+             MPI_STATUS_IGNORE);
+        }
+    }
 
-    return FTI_SCES;
+    free(oldest);
+    free(buffer);
+    return res;
 }
 
 /*-------------------------------------------------------------------------*/
 /**
-  @brief      It receives Ptner file.
+  @brief      It opens the files exchanged with the partners for one ckpt.
   @param      FTI_Conf        Configuration metadata.
-  @param      FTI_Exec        Execution metadata.
-  @param      FTI_Ckpt        Checkpoint metadata.
-  @param      source          souce group rank
+  @param      meta            Metadata of the ckpt. file.
   @param      postFlag        0 if postckpt done by approc, > 0 if by head
+  @param      st              Stream to set up.
   @return     integer         FTI_SCES if successful.
 
-  This function receives ckpt file from partner process aand saves it as
-  Ptner file. Partner should call FTI_SendCkpt to send file.
+  The ckpt. file is sent to the destination and the ckpt. file of the
+  source is stored as Ptner file.
 
  **/
 /*-------------------------------------------------------------------------*/
-int FTI_RecvPtner(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
-        FTIT_checkpoint* FTI_Ckpt, int source, int postFlag) {
+static int FTI_OpenExchange(FTIT_configuration* FTI_Conf,
+        FTIT_metadata* meta, int postFlag, FTIT_pipeStream* st) {
+    char lfn[FTI_BUFS], pfn[FTI_BUFS], str[FTI_BUFS];
+    snprintf(lfn, FTI_BUFS, "%s/%s", FTI_Conf->lTmpDir, meta->ckptFile);
+
+    // PostFlag is set to 0 if Post-processing is inline and set to
+    // processes nodeID if Post-processing done by head
+    if (postFlag) {
+        snprintf(str, FTI_BUFS,
+         "L2 trying to access process's %d ckpt. file (%s).", postFlag, lfn);
+    } else {
+        snprintf(str, FTI_BUFS,
+         "L2 trying to access local ckpt. file (%s).", lfn);
+    }
+    FTI_Print(str, FTI_DBUG);
+
     // heads need to use ckptFile to get ckptId and rank
     int ckptId, rank;
-    sscanf(FTI_Exec->ckptMeta.ckptFile, "Ckpt%d-Rank%d.%s", &ckptId, &rank,
+    sscanf(meta->ckptFile, "Ckpt%d-Rank%d.%s", &ckptId, &rank,
      FTI_Conf->suffix);
-
-    char pfn[FTI_BUFS], str[FTI_BUFS];
     snprintf(pfn, FTI_BUFS, "%s/Ckpt%d-Pcof%d.%s", FTI_Conf->lTmpDir, ckptId,
      rank, FTI_Conf->suffix);
     snprintf(str, FTI_BUFS, "L2 trying to access Ptner file (%s).", pfn);
     FTI_Print(str, FTI_DBUG);
 
-    FILE* pfd = fopen(pfn, "wb");
-    if (pfd == NULL) {
-        FTI_Print("FTI failed to open L2 ptner file.", FTI_DBUG);
+    st->lfd = fopen(lfn, "rb");
+    if (st->lfd == NULL) {
+        FTI_Print("FTI failed to open L2 Ckpt. file.", FTI_DBUG);
         return FTI_NSCS;
     }
-
-    char* buffer = talloc(char, FTI_Conf->blockSize);
-    uint32_t toRecv = FTI_Exec->ckptMeta.pfs;
-    // remaining data to receive
-    while (toRecv > 0) {
-        int recvSize = (toRecv > FTI_Conf->blockSize) ?
-         FTI_Conf->blockSize : toRecv;
-        MPI_Recv(buffer, recvSize, MPI_CHAR, source, FTI_Conf->generalTag,
-         FTI_Exec->groupComm, MPI_STATUS_IGNORE);
-        size_t wbytes;
-        FWRITE(FTI_NSCS, wbytes, buffer, sizeof(char), recvSize, pfd, "p",
-         buffer);
-        toRecv -= recvSize;
+    st->pfd = fopen(pfn, "wb");
+    if (st->pfd == NULL) {
+        FTI_Print("FTI failed to open L2 ptner file.", FTI_DBUG);
+        fclose(st->lfd);
+        st->lfd = NULL;
+        return FTI_NSCS;
     }
-
-    free(buffer);
-    fclose(pfd);
-
+    st->toSend = meta->fs;
+    st->toRecv = meta->pfs;
     return FTI_SCES;
 }
 
@@ -182,355 +349,587 @@ int FTI_RecvPtner(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
 
   This function copies the checkpoint files into the partner node. It
   follows a ring, where the ring size is the group size given in the FTI
-  configuration file.
+  configuration file. Each process sends its file to the right and
+  receives the file of the left partner at the same time. A head exchanges
+  the files of 'head_threads' application processes at once, each one on
+  its own MPI tag.
 
  **/
 /*-------------------------------------------------------------------------*/
 int FTI_Ptner(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt) {
     FTI_Print("Starting checkpoint post-processing L2", FTI_DBUG);
-    int startProc, endProc;
-    if (FTI_Topo->amIaHead) {  // post-processing for every process in the node
-        startProc = 1;
-        endProc = FTI_Topo->nodeSize;
-    } else {  // post-processing only for itself
-        startProc = 0;
-        endProc = 1;
+    int startProc, nbProc;
+    FTIT_metadata* meta = FTI_LoadPostMeta(FTI_Conf, FTI_Exec, FTI_Topo,
+     FTI_Ckpt, &startProc, &nbProc);
+    if (meta == NULL) {
+        return FTI_NSCS;
     }
+    int width = FTI_PostWidth(FTI_Conf, FTI_Topo, nbProc);
+    FTIT_pipeStream* st = talloc(FTIT_pipeStream, width);
 
     int source = FTI_Topo->left;  // receive Ckpt file from this process
     int destination = FTI_Topo->right;  // send Ckpt file to this process
-    int i;
-    for (i = startProc; i < endProc; i++) {
-        if (FTI_Topo->amIaHead) {
-            int res = FTI_Try(FTI_LoadMetaPostprocessing(FTI_Conf, FTI_Exec,
-             FTI_Topo, FTI_Ckpt, i), "load temporary metadata.");
-            if (res != FTI_SCES) {
-                return FTI_NSCS;
-            }
+    int res = FTI_SCES;
+    int first, k;
+    for (first = 0; first < nbProc && res == FTI_SCES; first += width) {
+        int n = (nbProc - first < width) ? nbProc - first : width;
+        memset(st, 0, sizeof(FTIT_pipeStream) * n);
+        for (k = 0; k < n && res == FTI_SCES; k++) {
+            res = FTI_OpenExchange(FTI_Conf, &meta[first + k],
+             startProc + first + k, &st[k]);
+            st[k].tag = FTI_Conf->generalTag + k;
         }
-        if (FTI_Topo->groupRank % 2) {  // first send, then receive
-            int res = FTI_SendCkpt(FTI_Conf, FTI_Exec, FTI_Ckpt, destination,
-             i);
-            if (res != FTI_SCES) {
-                return FTI_NSCS;
-            }
-            res = FTI_RecvPtner(FTI_Conf, FTI_Exec, FTI_Ckpt, source, i);
-            if (res != FTI_SCES) {
-                return FTI_NSCS;
-            }
-        } else {  // first receive, then send
-            int res = FTI_RecvPtner(FTI_Conf, FTI_Exec, FTI_Ckpt, source, i);
-            if (res != FTI_SCES) {
-                return FTI_NSCS;
+        if (res == FTI_SCES) {
+            res = FTI_PipeFiles(FTI_Conf, FTI_Exec, st, n, destination,
+             source);
+        }
+        for (k = 0; k < n; k++) {
+            if (st[k].lfd != NULL) {
+                fclose(st[k].lfd);
             }
-            res = FTI_SendCkpt(FTI_Conf, FTI_Exec, FTI_Ckpt, destination, i);
-            if (res != FTI_SCES) {
-                return FTI_NSCS;
+            if (st[k].pfd != NULL && fclose(st[k].pfd) != 0) {
+                FTI_Print("FTI failed to close L2 ptner file.", FTI_EROR);
+                res = FTI_NSCS;
             }
         }
     }
-    return FTI_SCES;
+    free(st);
+    free(meta);
+    return res;
 }
 
 /*-------------------------------------------------------------------------*/
 /**
-  @brief      It performs RS encoding with the ckpt. files in to the group.
-  @param      FTI_Conf        Configuration metadata.
-  @param      FTI_Exec        Execution metadata.
-  @param      FTI_Topo        Topology metadata.
-  @param      FTI_Ckpt        Checkpoint metadata.
+  @brief      Reads one message of the local ckpt. file (zero padded).
+  @param      lfd             Local ckpt. file.
+  @param      buf             Message buffer.
+  @param      size            Bytes to read.
+  @param      bufSize         Size of the buffer.
   @return     integer         FTI_SCES if successful.
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_RSReadMsg(FILE* lfd, char* buf, int64_t size,
+        int64_t bufSize) {
+    size_t bytes = fread(buf, sizeof(char), size, lfd);
+    memset(buf + bytes, 0, bufSize - bytes);
+    if (bytes != size) {
+        FTI_Print("L3 cannot read the checkpoint file.", FTI_EROR);
+        return FTI_NSCS;
+    }
+    return FTI_SCES;
+}
 
-  This function performs the Reed-Solomon encoding for a given group. The
-  checkpoint files are padded to the maximum size of the largest checkpoint
-  file in the group +- the extra space to be a multiple of block size.
+/** @typedef    FTIT_rsStream
+ *  @brief      State of the L3 encoding of one ckpt. file.
+ */
+typedef struct FTIT_rsStream {
+    FTIT_metadata* meta;        /**< metadata of the ckpt. file            */
+    char lfn[FTI_BUFS];         /**< local ckpt. file name                 */
+    int ckptId;                 /**< ckpt. ID of the file                  */
+    int rank;                   /**< global rank owning the file           */
+    FILE* lfd;                  /**< local ckpt. file (padded to maxFs)    */
+    FILE* efd;                  /**< encoded ckpt. file                    */
+    int64_t nbMsgs;             /**< number of messages of the file        */
+    int64_t size;               /**< bytes of the current message          */
+    char* own[2];               /**< own data, double buffered             */
+    char* data[2];              /**< received data, double buffered        */
+    char* coding;               /**< coding of the current message         */
+    char* in;                   /**< data encoded in this step (or NULL)   */
+    FTIT_integrity md5;         /**< Digest of the encoded file            */
+    int res;                    /**< FTI_NSCS after a read or write error  */
+} FTIT_rsStream;
+
+/** Work shared by the encoding threads for one step of all streams. */
+typedef struct FTIT_rsEncodeJob {
+    FTIT_rsStream* st;          /**< streams of the batch                  */
+    FTIT_gf16Table* table;      /**< coefficient of the step               */
+    int add;                    /**< 0 to start the coding, 1 to add       */
+    int64_t ms;                 /**< message size                          */
+    int64_t msg;                /**< message read by FTI_RSReadJob         */
+} FTIT_rsEncodeJob;
 
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Reads message 'msg' of streams [first,last) (hash engine job).
  **/
 /*-------------------------------------------------------------------------*/
-int FTI_RSenc(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
-        FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt) {
-    FTI_Print("Starting checkpoint post-processing L3", FTI_DBUG);
-    int startProc, endProc;
-    if (FTI_Topo->amIaHead) {
-        startProc = 1;
-        endProc = FTI_Topo->nodeSize;
-    } else {
-        startProc = 0;
-        endProc = 1;
+static void FTI_RSReadJob(void* ctx, int64_t first, int64_t last) {
+    FTIT_rsEncodeJob* job = (FTIT_rsEncodeJob*) ctx;
+    int64_t k;
+    for (k = first; k < last; k++) {
+        FTIT_rsStream* st = &job->st[k];
+        if (job->msg >= st->nbMsgs) {
+            continue;
+        }
+        int64_t left = st->meta->maxFs - job->msg * job->ms;
+        if (FTI_RSReadMsg(st->lfd, st->own[job->msg % 2],
+         (left < job->ms) ? left : job->ms, job->ms) != FTI_SCES) {
+            st->res = FTI_NSCS;
+        }
     }
+}
 
-    int proc;
-    for (proc = startProc; proc < endProc; proc++) {
-        if (FTI_Topo->amIaHead) {
-            int res = FTI_Try(FTI_LoadMetaPostprocessing(FTI_Conf, FTI_Exec,
-             FTI_Topo, FTI_Ckpt, proc), "load temporary metadata.");
-            if (res != FTI_SCES) {
-                return FTI_NSCS;
-            }
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Encodes the data of this step for streams [first,last).
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_RSEncodeJob(void* ctx, int64_t first, int64_t last) {
+    FTIT_rsEncodeJob* job = (FTIT_rsEncodeJob*) ctx;
+    int64_t k;
+    for (k = first; k < last; k++) {
+        FTIT_rsStream* st = &job->st[k];
+        if (st->in == NULL) {
+            continue;
+        }
+        size_t wBytes = (st->size + 1) & ~((int64_t) 1);
+        if (wBytes > st->size) {
+            st->in[st->size] = 0;
         }
-        int ckptId, rank;
-        sscanf(FTI_Exec->ckptMeta.ckptFile, "Ckpt%d-Rank%d.%s", &ckptId, &rank,
-         FTI_Conf->suffix);
-        char lfn[FTI_BUFS], efn[FTI_BUFS];
+        FTI_Gf16RegionMultiply(job->table, st->in, st->coding, wBytes,
+         job->add);
+    }
+}
 
-        snprintf(lfn, FTI_BUFS, "%s/%s", FTI_Conf->lTmpDir,
-         FTI_Exec->ckptMeta.ckptFile);
-        snprintf(efn, FTI_BUFS, "%s/Ckpt%d-RSed%d.%s", FTI_Conf->lTmpDir,
-         ckptId, rank, FTI_Conf->suffix);
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Writes the coding of the current message of [first,last).
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_RSWriteJob(void* ctx, int64_t first, int64_t last) {
+    FTIT_rsEncodeJob* job = (FTIT_rsEncodeJob*) ctx;
+    int64_t k;
+    for (k = first; k < last; k++) {
+        FTIT_rsStream* st = &job->st[k];
+        if (st->size == 0) {
+            continue;
+        }
+        if (fwrite(st->coding, sizeof(char), st->size, st->efd) !=
+         st->size) {
+            FTI_Print("L3 cannot write the encoded file.", FTI_EROR);
+            st->res = FTI_NSCS;
+        }
+        FTI_IntegrityUpdate(&st->md5, st->coding, st->size);
+    }
+}
 
-        char str[FTI_BUFS];
-        snprintf(str, FTI_BUFS, "L3 trying to access local ckpt. file (%s).",
-         lfn);
-        FTI_Print(str, FTI_DBUG);
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Posts the ring transfers of step s of message m.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+  @param      st              Streams of the batch.
+  @param      nbStreams       Number of streams.
+  @param      req             Two requests per stream.
+  @param      m               Message index.
+  @param      s               Ring step (1 <= s < groupSize).
+  @param      slot            Receive buffer to use.
+  @param      ms              Message size.
 
-        // all files in group must have the same size
-        int32_t maxFs = FTI_Exec->ckptMeta.maxFs;  // max file size in group
+  Step s sends the own data to member groupRank-s and receives the data of
+  member groupRank+s. Stream k uses the tag 'generalTag + k'.
 
-        // determine file size in order to write at the end of the elongated
-        // file (i.e. write at the end of file after 'truncate(..., maxFs)'.
-        struct stat st_;
-        if (FTI_Conf->ioMode == FTI_IO_FTIFF) {
-            stat(lfn, &st_);
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_RSPostStep(FTIT_configuration* FTI_Conf,
+        FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo,
+        FTIT_rsStream* st, int nbStreams, MPI_Request* req, int64_t m,
+        int s, int slot, int64_t ms) {
+    int gs = FTI_Topo->groupSize;
+    int me = FTI_Topo->groupRank;
+    int k;
+    for (k = 0; k < nbStreams; k++) {
+        if (m >= st[k].nbMsgs) {
+            continue;
         }
+        int64_t left = st[k].meta->maxFs - m * ms;
+        int size = (left < ms) ? left : ms;
+        MPI_Isend(st[k].own[m % 2], size, MPI_CHAR, (me + gs - s) % gs,
+         FTI_Conf->generalTag + k, FTI_Exec->groupComm, &req[2 * k]);
+        MPI_Irecv(st[k].data[slot], size, MPI_CHAR, (me + s) % gs,
+         FTI_Conf->generalTag + k, FTI_Exec->groupComm, &req[2 * k + 1]);
+    }
+}
 
-        if (truncate(lfn, maxFs) == -1) {
-            FTI_Print("Error with truncate on checkpoint file", FTI_WARN);
-            return FTI_NSCS;
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It computes the RS encoding of several local ckpt. files.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+  @param      st              Streams to encode (opened files).
+  @param      nbStreams       Number of streams.
+  @return     integer         FTI_SCES if successful.
+
+  The files are processed in messages of FTI_RS_BLOCKS_PER_MSG blocks. For
+  every message, the data of the group members travels around the ring
+  (step s receives the data of member groupRank+s) and is multiplied into
+  the coding with the split-table GF(2^16) kernels. The transfer of the
+  next step, or of the first step of the next message, is posted before
+  the current data is encoded, so communication and encoding overlap. The
+  encoded bytes are the same as with one block per message, thus
+  FTI_Decode is not affected.
+
+  All streams advance in lockstep: the transfers of a step are posted for
+  every file at once, and reading, encoding and writing are spread over
+  the worker pool, one file per task. A read or write error does not stop
+  the ring, otherwise the other members would wait forever; it is reported
+  once the files are encoded.
+
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_RSEncodeFiles(FTIT_configuration* FTI_Conf,
+        FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo,
+        FTIT_rsStream* st, int nbStreams) {
+    int gs = FTI_Topo->groupSize;
+    int me = FTI_Topo->groupRank;
+    int64_t ms = (int64_t) FTI_RS_BLOCKS_PER_MSG * FTI_Conf->blockSize;
+
+    // own data and received data are double buffered
+    char* buffer = talloc(char, (size_t) 5 * ms * nbStreams);
+    FTIT_gf16Table* tables = talloc(FTIT_gf16Table, gs);
+    MPI_Request* req = talloc(MPI_Request, 2 * nbStreams);
+    if (buffer == NULL || tables == NULL || req == NULL) {
+        FTI_Print("L3 cannot allocate the encoding buffers.", FTI_EROR);
+        free(buffer);
+        free(tables);
+        free(req);
+        return FTI_NSCS;
+    }
+    int64_t nbMsgs = 0;
+    int k;
+    for (k = 0; k < nbStreams; k++) {
+        char* base = buffer + (size_t) 5 * ms * k;
+        st[k].own[0] = base;
+        st[k].own[1] = base + ms;
+        st[k].data[0] = base + 2 * ms;
+        st[k].data[1] = base + 3 * ms;
+        st[k].coding = base + 4 * ms;
+        st[k].nbMsgs = (st[k].meta->maxFs + ms - 1) / ms;
+        st[k].res = FTI_SCES;
+        req[2 * k] = MPI_REQUEST_NULL;
+        req[2 * k + 1] = MPI_REQUEST_NULL;
+        if (st[k].nbMsgs > nbMsgs) {
+            nbMsgs = st[k].nbMsgs;
         }
+    }
 
-        // write file size at the end of elongated file to recover original
-        // size during restart. The file size, thus,  will be included in the
-        // encoded data and will be available at recovery before the re
-        // truncation to the original file size. [Depends on the correct value
-        // assigned to maxFs inside 'FTIFF_CreateMetadata'. The value has
-        // to be the maximum file size of the group PLUS 'sizeof(off_t)']
-        if (FTI_Conf->ioMode == FTI_IO_FTIFF) {
-            int lftmp_ = open(lfn, O_WRONLY);
-            if (lftmp_ == -1) {
-                FTI_Print("FTI_RSenc: (FTIFF) Unable to open file!", FTI_EROR);
-                return FTI_NSCS;
+    // row groupRank of the Cauchy matrix, column j weights member j
+    int j;
+    for (j = 0; j < gs; j++) {
+        FTI_Gf16InitTable(&tables[j], galois_single_divide(1,
+         me ^ (gs + j), FTI_Conf->l3WordSize));
+    }
+    char str[FTI_BUFS];
+    snprintf(str, FTI_BUFS, "L3 encoding %d files, up to %ld messages of %ld"
+     " bytes (%s).", nbStreams, nbMsgs, ms, FTI_Gf16KernelName());
+    FTI_Print(str, FTI_DBUG);
+
+    FTIT_rsEncodeJob job;
+    job.st = st;
+    job.ms = ms;
+    int slot = 0;  // data buffer of the step in flight
+    int64_t m;
+    for (m = 0; m < nbMsgs; m++) {
+        for (k = 0; k < nbStreams; k++) {
+            int64_t left = st[k].meta->maxFs - m * ms;
+            st[k].size = (m >= st[k].nbMsgs) ? 0 : (left < ms) ? left : ms;
+            st[k].in = (m >= st[k].nbMsgs) ? NULL : st[k].own[m % 2];
+        }
+        if (m == 0 || gs == 1) {
+            job.msg = m;
+            FTI_HashParallel(FTI_RSReadJob, &job, nbStreams, FTI_POOL_HEAD);
+            if (gs > 1) {
+                FTI_RSPostStep(FTI_Conf, FTI_Exec, FTI_Topo, st, nbStreams,
+                 req, m, 1, slot, ms);
             }
-            if (lseek( lftmp_, -sizeof(off_t), SEEK_END ) == -1) {
-                FTI_Print("FTI_RSenc: (FTIFF) Unable to seek in file!",
-                 FTI_EROR);
-                return FTI_NSCS;
+        }
+        job.table = &tables[me];
+        job.add = 0;
+        FTI_HashParallel(FTI_RSEncodeJob, &job, nbStreams, FTI_POOL_HEAD);
+
+        int s;
+        for (s = 1; s < gs; s++) {
+            MPI_Waitall(2 * nbStreams, req, MPI_STATUSES_IGNORE);
+            for (k = 0; k < nbStreams; k++) {
+                st[k].in = (m >= st[k].nbMsgs) ? NULL : st[k].data[slot];
             }
-            if (write(lftmp_, &st_.st_size, sizeof(off_t) ) == -1) {
-                FTI_Print("FTI_RSenc: (FTIFF) Unable to write "
-                    "meta data in file!", FTI_EROR);
-                return FTI_NSCS;
+            slot = 1 - slot;
+
+            // post the next transfers before encoding the received data
+            if (s + 1 < gs) {
+                FTI_RSPostStep(FTI_Conf, FTI_Exec, FTI_Topo, st, nbStreams,
+                 req, m, s + 1, slot, ms);
+            } else if (m + 1 < nbMsgs) {
+                job.msg = m + 1;
+                FTI_HashParallel(FTI_RSReadJob, &job, nbStreams, FTI_POOL_HEAD);
+                FTI_RSPostStep(FTI_Conf, FTI_Exec, FTI_Topo, st, nbStreams,
+                 req, m + 1, 1, slot, ms);
             }
-            close(lftmp_);
-        }
 
-        FILE* lfd = fopen(lfn, "rb");
-        if (lfd == NULL) {
-            FTI_Print("FTI failed to open L3 checkpoint file.", FTI_EROR);
-            return FTI_NSCS;
+            job.table = &tables[(me + s) % gs];
+            job.add = 1;
+            FTI_HashParallel(FTI_RSEncodeJob, &job, nbStreams, FTI_POOL_HEAD);
         }
 
-        FILE* efd = fopen(efn, "wb");
-        if (efd == NULL) {
-            FTI_Print("FTI failed to open encoded ckpt. file.", FTI_EROR);
-
-            fclose(lfd);
+        FTI_HashParallel(FTI_RSWriteJob, &job, nbStreams, FTI_POOL_HEAD);
+    }
 
-            return FTI_NSCS;
+    int res = FTI_SCES;
+    for (k = 0; k < nbStreams; k++) {
+        if (st[k].res != FTI_SCES) {
+            res = FTI_NSCS;
         }
+    }
+    free(req);
+    free(tables);
+    free(buffer);
+    return res;
+}
 
-        int bs = FTI_Conf->blockSize;
-        char* myData = talloc(char, bs);
-        char* coding = talloc(char, bs);
-        char* data = talloc(char, 2 * bs);
-        int* matrix = talloc(int, FTI_Topo->groupSize* FTI_Topo->groupSize);
-
-        int i;
-        for (i = 0; i < FTI_Topo->groupSize; i++) {
-            int j;
-            for (j = 0; j < FTI_Topo->groupSize; j++) {
-                matrix[i * FTI_Topo->groupSize + j] = galois_single_divide(1,
-                 i ^ (FTI_Topo->groupSize + j), FTI_Conf->l3WordSize);
-            }
-        }
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It prepares a local ckpt. file for the RS encoding.
+  @param      FTI_Conf        Configuration metadata.
+  @param      st              Stream of the file (meta already set).
+  @return     integer         FTI_SCES if successful.
 
+  The checkpoint file is padded to the maximum size of the largest
+  checkpoint file in the group, and the local and encoded files are opened.
 
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_RSOpenFile(FTIT_configuration* FTI_Conf, FTIT_rsStream* st) {
+    sscanf(st->meta->ckptFile, "Ckpt%d-Rank%d.%s", &st->ckptId, &st->rank,
+     FTI_Conf->suffix);
+    char efn[FTI_BUFS];
 
-        int remBsize = bs;
-        int32_t ps = ((maxFs / bs)) * bs;
-        if (ps < maxFs) {
-            ps = ps + bs;
-        }
+    snprintf(st->lfn, FTI_BUFS, "%s/%s", FTI_Conf->lTmpDir,
+     st->meta->ckptFile);
+    snprintf(efn, FTI_BUFS, "%s/Ckpt%d-RSed%d.%s", FTI_Conf->lTmpDir,
+     st->ckptId, st->rank, FTI_Conf->suffix);
 
-        // for MD5 checksum
-        MD5_CTX mdContext;
-        MD5_Init(&mdContext);
+    char str[FTI_BUFS];
+    snprintf(str, FTI_BUFS, "L3 trying to access local ckpt. file (%s).",
+     st->lfn);
+    FTI_Print(str, FTI_DBUG);
 
-        // For each block
-        int32_t pos = 0;
-        while (pos < ps) {
-            if ((maxFs - pos) < bs) {
-                remBsize = maxFs - pos;
-            }
+    // all files in group must have the same size
+    int64_t maxFs = st->meta->maxFs;  // max file size in group
 
-            // Reading checkpoint files
-            bzero(coding, bs);
-            bzero(myData, bs);
-            bzero(data, 2*bs);
-            size_t bytes;
-            FREAD(FTI_NSCS, bytes, myData, sizeof(char), remBsize, lfd,
-             "ppppf", data, matrix, coding, myData, efd);
-            int dest = FTI_Topo->groupRank;
-            i = FTI_Topo->groupRank;
-            int offset = 0;
-            int init = 0;
-            int cnt = 0;
-
-            // For each encoding
-            MPI_Request reqSend, reqRecv;
-            // used between iterations in while loop
-            while (cnt < FTI_Topo->groupSize) {
-                if (cnt == 0) {
-                    memcpy(&(data[offset * bs]), myData, sizeof(char) * bytes);
-                } else {
-                    MPI_Wait(&reqSend, MPI_STATUS_IGNORE);
-                    MPI_Wait(&reqRecv, MPI_STATUS_IGNORE);
-                }
+    // determine file size in order to write at the end of the elongated
+    // file (i.e. write at the end of file after 'truncate(..., maxFs)'.
+    struct stat st_;
+    if (FTI_Conf->ioMode == FTI_IO_FTIFF) {
+        stat(st->lfn, &st_);
+    }
 
-                // At every loop *but* the last one we send the data
-                if (cnt != FTI_Topo->groupSize - 1) {
-                    dest = (dest + FTI_Topo->groupSize - 1) %
-                     FTI_Topo->groupSize;
-                    int src = (i + 1) % FTI_Topo->groupSize;
-                    MPI_Isend(myData, bytes, MPI_CHAR, dest,
-                     FTI_Conf->generalTag, FTI_Exec->groupComm, &reqSend);
-                    MPI_Irecv(&(data[(1 - offset) * bs]), bs,
-                     MPI_CHAR, src, FTI_Conf->generalTag,
-                      FTI_Exec->groupComm, &reqRecv);
-                }
+    if (truncate(st->lfn, maxFs) == -1) {
+        FTI_Print("Error with truncate on checkpoint file", FTI_WARN);
+        return FTI_NSCS;
+    }
 
-                int matVal = matrix[FTI_Topo->groupRank *
-                 FTI_Topo->groupSize + i];
-                // First copy or xor any data that does not need
-                // to be multiplied by a factor
-                if (matVal == 1) {
-                    if (init == 0) {
-                        memcpy(coding, &(data[offset * bs]), bs);
-                        init = 1;
-                    } else {
-                        galois_region_xor(&(data[offset * bs]), coding, bs);
-                    }
-                }
+    // write file size at the end of elongated file to recover original
+    // size during restart. The file size, thus,  will be included in the
+    // encoded data and will be available at recovery before the re
+    // truncation to the original file size. [Depends on the correct value
+    // assigned to maxFs inside 'FTIFF_CreateMetadata'. The value has
+    // to be the maximum file size of the group PLUS 'sizeof(off_t)']
+    if (FTI_Conf->ioMode == FTI_IO_FTIFF) {
+        int lftmp_ = open(st->lfn, O_WRONLY);
+        if (lftmp_ == -1) {
+            FTI_Print("FTI_RSenc: (FTIFF) Unable to open file!", FTI_EROR);
+            return FTI_NSCS;
+        }
+        if (lseek( lftmp_, -sizeof(off_t), SEEK_END ) == -1) {
+            FTI_Print("FTI_RSenc: (FTIFF) Unable to seek in file!",
+             FTI_EROR);
+            close(lftmp_);
+            return FTI_NSCS;
+        }
+        if (write(lftmp_, &st_.st_size, sizeof(off_t) ) == -1) {
+            FTI_Print("FTI_RSenc: (FTIFF) Unable to write "
+                "meta data in file!", FTI_EROR);
+            close(lftmp_);
+            return FTI_NSCS;
+        }
+        close(lftmp_);
+    }
 
-                // Then the data that needs to be multiplied by a factor
-                if (matVal != 0 && matVal != 1) {
-                    galois_w16_region_multiply(&(data[offset * bs]), matVal,
-                     bs, coding, init);
-                    init = 1;
-                }
+    st->lfd = fopen(st->lfn, "rb");
+    if (st->lfd == NULL) {
+        FTI_Print("FTI failed to open L3 checkpoint file.", FTI_EROR);
+        return FTI_NSCS;
+    }
 
-                i = (i + 1) % FTI_Topo->groupSize;
-                offset = 1 - offset;
-                cnt++;
-            }
+    st->efd = fopen(efn, "wb");
+    if (st->efd == NULL) {
+        FTI_Print("FTI failed to open encoded ckpt. file.", FTI_EROR);
+        fclose(st->lfd);
+        st->lfd = NULL;
+        return FTI_NSCS;
+    }
 
-            // Writting encoded checkpoints
-            fwrite(coding, sizeof(char), remBsize, efd);
-            MD5_Update(&mdContext, coding, remBsize);
+    // for the checksum of the encoded file
+    FTI_IntegrityInit(&st->md5);
+    return FTI_SCES;
+}
 
-            // Next block
-            pos = pos + bs;
-        }
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It completes the RS encoding of a local ckpt. file.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+  @param      FTI_Ckpt        Checkpoint metadata.
+  @param      st              Stream of the encoded file.
+  @return     integer         FTI_SCES if successful.
 
-        // create checksum hex-string
-        unsigned char hash[MD5_DIGEST_LENGTH];
-        MD5_Final(hash, &mdContext);
+  Appends the FTI-FF meta data to the encoded file, closes the files,
+  restores the size of the ckpt. file and stores the checksum of the
+  encoded file in the metadata.
 
-        char checksum[MD5_DIGEST_STRING_LENGTH];
-        int ii = 0;
-        for (i = 0; i < MD5_DIGEST_LENGTH; i++) {
-            snprintf(&checksum[ii], sizeof(char[3]), "%02x", hash[i]);
-            ii+=2;
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_RSCloseFile(FTIT_configuration* FTI_Conf,
+        FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo,
+        FTIT_checkpoint* FTI_Ckpt, FTIT_rsStream* st) {
+    char str[FTI_BUFS];
+    FILE* lfd = st->lfd;
+    FILE* efd = st->efd;
+    int64_t maxFs = st->meta->maxFs;
+
+    // create checksum hex-string
+    char checksum[MD5_DIGEST_STRING_LENGTH];
+    FTI_IntegrityFinal(&st->md5, checksum);
+
+    // FTI-FF append meta data to RS file
+    if (FTI_Conf->ioMode == FTI_IO_FTIFF) {
+        FTIFF_metaInfo *FTIFFMeta = malloc(sizeof(FTIFF_metaInfo));
+
+        // get timestamp
+        struct timespec ntime;
+        clock_gettime(CLOCK_REALTIME, &ntime);
+        FTIFFMeta->timestamp = ntime.tv_sec*1000000000 + ntime.tv_nsec;
+
+        FTIFFMeta->fs = maxFs;
+        // although not needed, we have to assign value for unique hash.
+        FTIFFMeta->ptFs = -1;
+        FTIFFMeta->ckptId = st->ckptId;
+        FTIFFMeta->maxFs = maxFs;
+        FTIFFMeta->ckptSize = st->meta->fs;
+        strncpy(FTIFFMeta->checksum, checksum, MD5_DIGEST_STRING_LENGTH);
+
+        // get hash of meta data
+        FTIFF_GetHashMetaInfo(FTIFFMeta->myHash, FTIFFMeta);
+
+        // serialize data block variable meta data
+        // and append to encoded file
+        char* buffer_ser = talloc(char, FTI_filemetastructsize);
+        if (buffer_ser == NULL) {
+            snprintf(str, FTI_BUFS,
+             "FTI_RSenc - failed to allocate %d bytes for 'buffer_ser'",
+              FTI_dbvarstructsize);
+            FTI_Print(str, FTI_EROR);
+            fclose(lfd);
+            fclose(efd);
+            errno = 0;
+            return FTI_NSCS;
         }
-
-        // FTI-FF append meta data to RS file
-        if (FTI_Conf->ioMode == FTI_IO_FTIFF) {
-            FTIFF_metaInfo *FTIFFMeta = malloc(sizeof(FTIFF_metaInfo));
-
-            // get timestamp
-            struct timespec ntime;
-            clock_gettime(CLOCK_REALTIME, &ntime);
-            FTIFFMeta->timestamp = ntime.tv_sec*1000000000 + ntime.tv_nsec;
-
-            FTIFFMeta->fs = maxFs;
-            // although not needed, we have to assign value for unique hash.
-            FTIFFMeta->ptFs = -1;
-            FTIFFMeta->ckptId = ckptId;
-            FTIFFMeta->maxFs = maxFs;
-            FTIFFMeta->ckptSize = FTI_Exec->ckptMeta.fs;
-            strncpy(FTIFFMeta->checksum, checksum, MD5_DIGEST_STRING_LENGTH);
-
-            // get hash of meta data
-            FTIFF_GetHashMetaInfo(FTIFFMeta->myHash, FTIFFMeta);
-
-            // serialize data block variable meta data
-            // and append to encoded file
-            char* buffer_ser = talloc(char, FTI_filemetastructsize);
-            if (buffer_ser == NULL) {
-                snprintf(str, FTI_BUFS,
-                 "FTI_RSenc - failed to allocate %d bytes for 'buffer_ser'",
-                  FTI_dbvarstructsize);
-                FTI_Print(str, FTI_EROR);
-                free(data);
-                free(matrix);
-                free(coding);
-                free(myData);
-                fclose(lfd);
-                fclose(efd);
-                errno = 0;
-                return FTI_NSCS;
-            }
-            if (FTIFF_SerializeFileMeta(FTIFFMeta, buffer_ser) != FTI_SCES) {
-                FTI_Print("FTI_RSenc - failed to serialize 'currentdbvar'",
-                 FTI_EROR);
-                free(buffer_ser);
-                free(data);
-                free(matrix);
-                free(coding);
-                free(myData);
-                fclose(lfd);
-                fclose(efd);
-                errno = 0;
-                return FTI_NSCS;
-            }
-            size_t wBytes = 0;
-            FWRITE(FTI_NSCS, wBytes, buffer_ser, FTI_filemetastructsize, 1,
-             efd, "ppppf", data, matrix, coding, myData, lfd);
+        if (FTIFF_SerializeFileMeta(FTIFFMeta, buffer_ser) != FTI_SCES) {
+            FTI_Print("FTI_RSenc - failed to serialize 'currentdbvar'",
+             FTI_EROR);
             free(buffer_ser);
+            fclose(lfd);
+            fclose(efd);
+            errno = 0;
+            return FTI_NSCS;
         }
+        size_t wBytes = 0;
+        FWRITE(FTI_NSCS, wBytes, buffer_ser, FTI_filemetastructsize, 1,
+         efd, "f", lfd);
+        free(buffer_ser);
+    }
 
-        free(data);
-        free(matrix);
-        free(coding);
-        free(myData);
-        fclose(lfd);
-        fclose(efd);
+    fclose(lfd);
+    fclose(efd);
 
-        int32_t fs = FTI_Exec->ckptMeta.fs;  // ckpt file size
+    int64_t fs = st->meta->fs;  // ckpt file size
 
-        if (truncate(lfn, fs) == -1) {
-            FTI_Print("Error with re-truncate on checkpoint file", FTI_WARN);
-            return FTI_NSCS;
-        }
+    if (truncate(st->lfn, fs) == -1) {
+        FTI_Print("Error with re-truncate on checkpoint file", FTI_WARN);
+        return FTI_NSCS;
+    }
 
-        int res = FTI_WriteRSedChecksum(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt,
-         rank, checksum);
+    return FTI_WriteRSedChecksum(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt,
+     st->rank, checksum);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It performs RS encoding with the ckpt. files in to the group.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+  @param      FTI_Ckpt        Checkpoint metadata.
+  @return     integer         FTI_SCES if successful.
+
+  This function performs the Reed-Solomon encoding for a given group. The
+  checkpoint files are padded to the maximum size of the largest checkpoint
+  file in the group +- the extra space to be a multiple of block size. A
+  head encodes the files of 'head_threads' application processes at once.
+
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_RSenc(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
+        FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt) {
+    FTI_Print("Starting checkpoint post-processing L3", FTI_DBUG);
+    int startProc, nbProc;
+    FTIT_metadata* meta = FTI_LoadPostMeta(FTI_Conf, FTI_Exec, FTI_Topo,
+     FTI_Ckpt, &startProc, &nbProc);
+    if (meta == NULL) {
+        return FTI_NSCS;
+    }
+    int width = FTI_PostWidth(FTI_Conf, FTI_Topo, nbProc);
+    FTIT_rsStream* st = talloc(FTIT_rsStream, width);
+
+    int res = FTI_SCES;
+    int first, k;
+    for (first = 0; first < nbProc && res == FTI_SCES; first += width) {
+        int n = (nbProc - first < width) ? nbProc - first : width;
+        int opened;
+        for (opened = 0; opened < n; opened++) {
+            st[opened].meta = &meta[first + opened];
+            if (FTI_RSOpenFile(FTI_Conf, &st[opened]) != FTI_SCES) {
+                res = FTI_NSCS;
+                break;
+            }
+        }
+        if (res == FTI_SCES) {
+            res = FTI_RSEncodeFiles(FTI_Conf, FTI_Exec, FTI_Topo, st, n);
+        }
         if (res != FTI_SCES) {
-            return FTI_NSCS;
+            for (k = 0; k < opened; k++) {
+                fclose(st[k].lfd);
+                fclose(st[k].efd);
+            }
+            break;
+        }
+        for (k = 0; k < n; k++) {
+            if (res != FTI_SCES) {
+                fclose(st[k].lfd);
+                fclose(st[k].efd);
+            } else if (FTI_RSCloseFile(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt,
+             &st[k]) != FTI_SCES) {
+                res = FTI_NSCS;
+            }
         }
     }
-
-    return FTI_SCES;
+    free(st);
+    free(meta);
+    return res;
 }
 
 
@@ -708,6 +1107,29 @@ int FTI_ArchiveL4Ckpt(FTIT_configuration* FTI_Conf, FTIT_execution *FTI_Exec,
     return FTI_SCES;
 }
 
+/** Files copied by the worker pool during a POSIX L4 flush. */
+typedef struct FTIT_flushJob {
+    FTIT_configuration* FTI_Conf;   /**< Configuration metadata.          */
+    FTIT_metadata* meta;            /**< Metadata per file.               */
+    char* lfn;                      /**< Local file names (FTI_BUFS each). */
+    char* gfn;                      /**< Global file names (FTI_BUFS each).*/
+    int* res;                       /**< Result per file.                 */
+} FTIT_flushJob;
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Copies the files [first,last) to the PFS (hash engine job).
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_FlushPosixJob(void* ctx, int64_t first, int64_t last) {
+    FTIT_flushJob* job = (FTIT_flushJob*) ctx;
+    int64_t i;
+    for (i = first; i < last; i++) {
+        job->res[i] = FTI_CopyFile(job->FTI_Conf, &job->lfn[i * FTI_BUFS],
+         &job->gfn[i * FTI_BUFS], job->meta[i].fs);
+    }
+}
+
 /*-------------------------------------------------------------------------*/
 /**
   @brief      It flushes the local ckpt. files in to the PFS using POSIX.
@@ -718,7 +1140,9 @@ int FTI_ArchiveL4Ckpt(FTIT_configuration* FTI_Conf, FTIT_execution *FTI_Exec,
   @param      level           The level from which ckpt. files are flushed.
   @return     integer         FTI_SCES if successful.
 
-  This function flushes the local checkpoint files in to the PFS.
+  This function flushes the local checkpoint files in to the PFS. A head
+  copies the files of its application processes concurrently on the
+  worker pool ('head_threads').
 
  **/
 /*-------------------------------------------------------------------------*/
@@ -726,90 +1150,103 @@ int FTI_FlushPosix(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt, int level) {
     FTI_Print("Starting checkpoint post-processing L4 using Posix IO.",
      FTI_DBUG);
-    int startProc, endProc, proc;
-    if (FTI_Topo->amIaHead) {
-        startProc = 1;
-        endProc = FTI_Topo->nodeSize;
-    } else {
-        startProc = 0;
-        endProc = 1;
+    int startProc, nbProc;
+    FTIT_metadata* meta = FTI_LoadPostMeta(FTI_Conf, FTI_Exec, FTI_Topo,
+     FTI_Ckpt, &startProc, &nbProc);
+    if (meta == NULL) {
+        return FTI_NSCS;
     }
 
-    for (proc = startProc; proc < endProc; proc++) {
-        if (FTI_Topo->amIaHead) {
-            int res = FTI_Try(FTI_LoadMetaPostprocessing(FTI_Conf, FTI_Exec,
-             FTI_Topo, FTI_Ckpt, proc), "load temporary metadata.");
-            if (res != FTI_SCES) {
-                return FTI_NSCS;
-            }
-        }
+    FTIT_flushJob job;
+    job.FTI_Conf = FTI_Conf;
+    job.meta = meta;
+    job.lfn = talloc(char, (size_t) FTI_BUFS * nbProc);
+    job.gfn = talloc(char, (size_t) FTI_BUFS * nbProc);
+    job.res = talloc(int, nbProc);
+
+    int i;
+    for (i = 0; i < nbProc; i++) {
+        int proc = startProc + i;
         char str[FTI_BUFS];
+        char* lfn = &job.lfn[i * FTI_BUFS];
+        char* gfn = &job.gfn[i * FTI_BUFS];
         snprintf(str, FTI_BUFS, "Post-processing for proc %d started.", proc);
         FTI_Print(str, FTI_DBUG);
-        char lfn[FTI_BUFS], gfn[FTI_BUFS];
         if ( FTI_Ckpt[4].isDcp ) {
             snprintf(gfn, FTI_BUFS, "%s/%s", FTI_Ckpt[4].dcpDir,
-             FTI_Exec->ckptMeta.ckptFile);
+             meta[i].ckptFile);
         } else {
             snprintf(gfn, FTI_BUFS, "%s/%s", FTI_Conf->gTmpDir,
-             FTI_Exec->ckptMeta.ckptFile);
+             meta[i].ckptFile);
         }
         snprintf(str, FTI_BUFS, "Global temporary file name for proc %d: %s",
          proc, gfn);
         FTI_Print(str, FTI_DBUG);
-        FILE* gfd = fopen(gfn, "wb");
-
-        if (gfd == NULL) {
-            FTI_Print("L4 cannot open ckpt. file in the PFS.", FTI_EROR);
-            return FTI_NSCS;
-        }
-
         if (level == 0) {
             if ( FTI_Ckpt[4].isDcp ) {
                 snprintf(lfn, FTI_BUFS, "%s/%s", FTI_Ckpt[1].dcpDir,
-                 FTI_Exec->ckptMeta.ckptFile);
+                 meta[i].ckptFile);
             } else {
                 snprintf(lfn, FTI_BUFS, "%s/%s", FTI_Conf->lTmpDir,
-                 FTI_Exec->ckptMeta.ckptFile);
+                 meta[i].ckptFile);
             }
         } else {
             snprintf(lfn, FTI_BUFS, "%s/%s", FTI_Ckpt[level].dir,
-             FTI_Exec->ckptMeta.ckptFile);
+             meta[i].ckptFile);
         }
         snprintf(str, FTI_BUFS, "Local file name for proc %d: %s", proc, lfn);
         FTI_Print(str, FTI_DBUG);
-        // Open local file
-        FILE* lfd = fopen(lfn, "rb");
-        if (lfd == NULL) {
-            FTI_Print("L4 cannot open the checkpoint file.", FTI_EROR);
-            fclose(gfd);
-            return FTI_NSCS;
+        snprintf(str, FTI_BUFS, "Local file size for proc %d: %ld", proc,
+         meta[i].fs);
+        FTI_Print(str, FTI_DBUG);
+    }
+
+    // Checkpoint files exchange
+    FTI_HashParallel(FTI_FlushPosixJob, &job, nbProc, FTI_POOL_HEAD);
+
+    int res = FTI_SCES;
+    for (i = 0; i < nbProc; i++) {
+        if (job.res[i] != FTI_SCES) {
+            FTI_Print("L4 cannot flush the checkpoint file to the PFS.",
+             FTI_EROR);
+            res = FTI_NSCS;
         }
+    }
+    free(job.res);
+    free(job.gfn);
+    free(job.lfn);
+    free(meta);
+    return res;
+}
 
-        char *readData = talloc(char, FTI_Conf->transferSize);
-        int32_t bSize = FTI_Conf->transferSize;
-        int32_t fs = FTI_Exec->ckptMeta.fs;
-        snprintf(str, FTI_BUFS, "Local file size for proc %d: %d", proc, fs);
-        FTI_Print(str, FTI_DBUG);
-        int32_t pos = 0;
-        // Checkpoint files exchange
-        while (pos < fs) {
-            if ((fs - pos) < FTI_Conf->transferSize)
-                bSize = fs - pos;
+/** Chunks read by the worker pool during an MPI-IO L4 flush. */
+typedef struct FTIT_flushMpiJob {
+    FILE** lfd;                     /**< Local files of the batch.        */
+    char** buf;                     /**< Chunk buffer per file.           */
+    int64_t* left;                  /**< Bytes left to read per file.     */
+    int* bytes;                     /**< Bytes read per file (-1: error). */
+    int64_t chunk;                  /**< Chunk size.                      */
+} FTIT_flushMpiJob;
 
-            size_t bytes;
-            FREAD(FTI_NSCS, bytes, readData, sizeof(char), bSize, lfd, "pf",
-             readData, gfd);
-            size_t wBytes = 0;
-            FWRITE(FTI_NSCS, wBytes, readData, sizeof(char), bytes, gfd, "pf",
-             readData, lfd);
-            pos = pos + bytes;
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Reads the next chunk of the files [first,last).
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_FlushMpiReadJob(void* ctx, int64_t first, int64_t last) {
+    FTIT_flushMpiJob* job = (FTIT_flushMpiJob*) ctx;
+    int64_t i;
+    for (i = first; i < last; i++) {
+        int64_t size = (job->left[i] < job->chunk) ? job->left[i] :
+         job->chunk;
+        job->bytes[i] = 0;
+        if (size > 0) {
+            size_t bytes = fread(job->buf[i], sizeof(char), size,
+             job->lfd[i]);
+            job->bytes[i] = (bytes == size) ? (int) bytes : -1;
+            job->left[i] -= bytes;
         }
-        free(readData);
-        fclose(lfd);
-        fclose(gfd);
     }
-    return FTI_SCES;
 }
 
 /*-------------------------------------------------------------------------*/
@@ -822,7 +1259,10 @@ int FTI_FlushPosix(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
   @param      level           The level from which ckpt. files are flushed.
   @return     integer         FTI_SCES if successful.
 
-  This function flushes the local checkpoint files in to the PFS.
+  This function flushes the local checkpoint files in to the PFS. A head
+  flushes 'head_threads' files at once: the next chunk of every file is
+  read on the worker pool while the previous chunks are written with
+  non-blocking MPI-I/O.
 
  **/
 /*-------------------------------------------------------------------------*/
@@ -842,43 +1282,17 @@ int FTI_FlushMPI(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     write_info.flag = 'w';
     FTI_MPIOOpen(gfn, &write_info);
 
-    int proc, startProc, endProc;
-    if (FTI_Topo->amIaHead) {
-        startProc = 1;
-        endProc = FTI_Topo->nodeSize;
-    } else {
-        startProc = 0;
-        endProc = 1;
+    int proc, startProc, nbProc;
+    FTIT_metadata* meta = FTI_LoadPostMeta(FTI_Conf, FTI_Exec, FTI_Topo,
+     FTI_Ckpt, &startProc, &nbProc);
+    if (meta == NULL) {
+        FTI_MPIOClose(&write_info);
+        return FTI_NSCS;
     }
-    int nbProc = endProc - startProc;
     MPI_Offset* localFileSizes = talloc(MPI_Offset, nbProc);
-    char* localFileNames = talloc(char, FTI_BUFS * endProc);
-    // rank of process in FTI_COMM_WORLD
-    int* splitRanks = talloc(int, endProc);
-    for (proc = startProc; proc < endProc; proc++) {
-        if (FTI_Topo->amIaHead) {
-            int res = FTI_Try(FTI_LoadMetaPostprocessing(FTI_Conf, FTI_Exec,
-             FTI_Topo, FTI_Ckpt, proc), "load temporary metadata.");
-            if (res != FTI_SCES) {
-                return FTI_NSCS;
-            }
-        }
-        if (level == 0) {
-            snprintf(&localFileNames[proc * FTI_BUFS], FTI_BUFS, "%s/%s",
-             FTI_Conf->lTmpDir, FTI_Exec->ckptMeta.ckptFile);
-        } else {
-            snprintf(&localFileNames[proc * FTI_BUFS], FTI_BUFS, "%s/%s",
-             FTI_Ckpt[level].dir, FTI_Exec->ckptMeta.ckptFile);
-        }
-        if (FTI_Topo->amIaHead) {
-            // determine process splitRank if head
-            splitRanks[proc] = (FTI_Topo->nodeSize - 1) *
-             FTI_Topo->nodeID + proc - 1;
-        } else {
-            splitRanks[proc] = FTI_Topo->splitRank;
-        }
-        // [proc - startProc] to get index from 0
-        localFileSizes[proc - startProc] = FTI_Exec->ckptMeta.fs;
+    MPI_Offset* offsets = talloc(MPI_Offset, nbProc);
+    for (proc = 0; proc < nbProc; proc++) {
+        localFileSizes[proc] = meta[proc].fs;
     }
 
     MPI_Offset* allFileSizes = talloc(MPI_Offset,
@@ -887,59 +1301,124 @@ int FTI_FlushMPI(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
      MPI_OFFSET, FTI_COMM_WORLD);
     free(localFileSizes);
 
-
-    for (proc = startProc; proc < endProc; proc++) {
+    for (proc = 0; proc < nbProc; proc++) {
+        // rank of process in FTI_COMM_WORLD
+        int splitRank = FTI_Topo->splitRank;
         if (FTI_Topo->amIaHead) {
-            int res = FTI_Try(FTI_LoadMetaPostprocessing(FTI_Conf, FTI_Exec,
-             FTI_Topo, FTI_Ckpt, proc), "load temporary metadata.");
-            if (res != FTI_SCES) {
-                return FTI_NSCS;
-            }
+            // determine process splitRank if head
+            splitRank = (FTI_Topo->nodeSize - 1) * FTI_Topo->nodeID +
+             startProc + proc - 1;
         }
         int i;
-        write_info.offset = 0;
-        for (i = 0; i < splitRanks[proc]; i++) {
-            write_info.offset += allFileSizes[i];
+        offsets[proc] = 0;
+        for (i = 0; i < splitRank; i++) {
+            offsets[proc] += allFileSizes[i];
         }
+    }
+    free(allFileSizes);
 
-        FILE* lfd = fopen(&localFileNames[FTI_BUFS * proc], "rb");
-        if (lfd == NULL) {
-            FTI_Print("L4 cannot open the checkpoint file.", FTI_EROR);
-            free(localFileNames);
-            free(allFileSizes);
-            free(splitRanks);
-            return FTI_NSCS;
-        }
+    // the transfer buffer is split among the files of a batch and doubled
+    int width = FTI_PostWidth(FTI_Conf, FTI_Topo, nbProc);
+    int64_t chunk = FTI_Conf->transferSize / width;
+    char* buffer = talloc(char, (size_t) 2 * width * chunk);
+    FILE** lfd = talloc(FILE*, width);
+    char** buf[2] = { talloc(char*, width), talloc(char*, width) };
+    int64_t* left = talloc(int64_t, width);
+    int* bytes[2] = { talloc(int, width), talloc(int, width) };
+    MPI_Request* req = talloc(MPI_Request, width);
+    MPI_Offset* pos = talloc(MPI_Offset, width);
+    int k;
+    for (k = 0; k < width; k++) {
+        buf[0][k] = buffer + (size_t) k * chunk;
+        buf[1][k] = buffer + (size_t) (width + k) * chunk;
+    }
 
-        char* readData = talloc(char, FTI_Conf->transferSize);
-        int32_t bSize = FTI_Conf->transferSize;
-        int32_t fs = FTI_Exec->ckptMeta.fs;
+    FTIT_flushMpiJob job;
+    job.lfd = lfd;
+    job.left = left;
+    job.chunk = chunk;
+
+    int res = FTI_SCES;
+    int first;
+    for (first = 0; first < nbProc && res == FTI_SCES; first += width) {
+        int n = (nbProc - first < width) ? nbProc - first : width;
+        for (k = 0; k < n; k++) {
+            char lfn[FTI_BUFS];
+            if (level == 0) {
+                snprintf(lfn, FTI_BUFS, "%s/%s", FTI_Conf->lTmpDir,
+                 meta[first + k].ckptFile);
+            } else {
+                snprintf(lfn, FTI_BUFS, "%s/%s", FTI_Ckpt[level].dir,
+                 meta[first + k].ckptFile);
+            }
+            lfd[k] = fopen(lfn, "rb");
+            if (lfd[k] == NULL) {
+                FTI_Print("L4 cannot open the checkpoint file.", FTI_EROR);
+                res = FTI_NSCS;
+            }
+            left[k] = meta[first + k].fs;
+            pos[k] = offsets[first + k];
+        }
 
-        int32_t pos = 0;
         // Checkpoint files exchange
-        while (pos < fs) {
-            if ((fs - pos) < FTI_Conf->transferSize) {
-                bSize = fs - pos;
+        int cur = 0;
+        job.buf = buf[cur];
+        job.bytes = bytes[cur];
+        if (res == FTI_SCES) {
+            FTI_HashParallel(FTI_FlushMpiReadJob, &job, n, FTI_POOL_HEAD);
+        }
+        bool more = (res == FTI_SCES);
+        while (more) {
+            more = false;
+            for (k = 0; k < n; k++) {
+                req[k] = MPI_REQUEST_NULL;
+                if (bytes[cur][k] < 0) {
+                    FTI_Print("L4 cannot read the checkpoint file.",
+                     FTI_EROR);
+                    res = FTI_NSCS;
+                } else if (bytes[cur][k] > 0) {
+                    MPI_File_iwrite_at(write_info.pfh, pos[k], buf[cur][k],
+                     bytes[cur][k], MPI_BYTE, &req[k]);
+                    pos[k] += bytes[cur][k];
+                }
+                more = more || left[k] > 0;
             }
+            more = more && res == FTI_SCES;
 
-            size_t bytes;
-            // #warning I also need to close pfh file
-            // but this marcro is not yet ready
-            //                MPI_File_close(&pfh);
-            FREAD(FTI_NSCS, bytes, readData, sizeof(char), bSize, lfd, "pppp",
-                localFileNames, allFileSizes, splitRanks, readData);
-
-            FTI_MPIOWrite(readData, bytes, &write_info);
-            pos = pos + bytes;
+            // read the next chunks while the current ones are written
+            if (more) {
+                job.buf = buf[1 - cur];
+                job.bytes = bytes[1 - cur];
+                FTI_HashParallel(FTI_FlushMpiReadJob, &job, n, FTI_POOL_HEAD);
+            }
+            if (MPI_Waitall(n, req, MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
+                FTI_Print("L4 cannot write the checkpoint file with MPI-IO.",
+                 FTI_EROR);
+                res = FTI_NSCS;
+                more = false;
+            }
+            cur = 1 - cur;
+        }
+        for (k = 0; k < n; k++) {
+            if (lfd[k] != NULL) {
+                fclose(lfd[k]);
+            }
         }
-        free(readData);
-        fclose(lfd);
     }
-    free(localFileNames);
-    free(allFileSizes);
-    free(splitRanks);
+
+    free(pos);
+    free(req);
+    free(bytes[0]);
+    free(bytes[1]);
+    free(left);
+    free(buf[0]);
+    free(buf[1]);
+    free(lfd);
+    free(buffer);
+    free(offsets);
+    free(meta);
     FTI_MPIOClose(&write_info);
-    return FTI_SCES;
+    return res;
 }
 
 /*-------------------------------------------------------------------------*/
@@ -970,7 +1449,7 @@ int FTI_FlushSionlib(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     }
     int nbProc = endProc - startProc;
 
-    int32_t* localFileSizes = talloc(int32_t, nbProc);
+    int64_t* localFileSizes = talloc(int64_t, nbProc);
     char* localFileNames = talloc(char, FTI_BUFS * nbProc);
     int* splitRanks = talloc(int, nbProc);  // rank of process in FTI_COMM_WORLD
     for (proc = startProc; proc < endProc; proc++) {
@@ -1077,9 +1556,9 @@ int FTI_FlushSionlib(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
 
         char *readData = talloc(char, FTI_Conf->transferSize);
         int32_t bSize = FTI_Conf->transferSize;
-        int32_t fs = FTI_Exec->ckptMeta.fs;
+        int64_t fs = FTI_Exec->ckptMeta.fs;
 
-        int32_t pos = 0;
+        int64_t pos = 0;
         // Checkpoint files exchange
         while (pos < fs) {
             if ((fs - pos) < FTI_Conf->transferSize)
@@ -35,325 +35,493 @@
  *  @date   October, 2017
  *  @brief  Post recovery functions for the FTI library.
  */
+#include <sys/mman.h>
 #include <time.h>
 
 #include "postreco.h"
+/** Stripe of a message decoded by one worker (keeps outputs in cache). */
+#define FTI_RS_STRIPE (64 * 1024)
+
+/** Context of a parallel L3 decoding job. */
+typedef struct FTIT_rsDecodeJob {
+    const char* src[FTI_BUFS];          /**< The k surviving blocks.       */
+    int k;                              /**< Number of survivors.          */
+    const FTIT_gf16Table* dataRow;      /**< NULL if data not erased.      */
+    const FTIT_gf16Table* codingRow;    /**< NULL if encoding not erased.  */
+    char* data;                         /**< Regenerated data.             */
+    char* coding;                       /**< Regenerated encoding.         */
+    int64_t nBytes;                     /**< Bytes of the message.         */
+} FTIT_rsDecodeJob;
+
 /*-------------------------------------------------------------------------*/
 /**
-  @brief      It recovers a set of ckpt. files using RS decoding.
+  @brief      Decodes a range of stripes of a message.
+  @param      ctx             Pointer to the FTIT_rsDecodeJob.
+  @param      first           First stripe.
+  @param      last            Stripe after the last one.
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_RSDecodeStripes(void* ctx, int64_t first, int64_t last) {
+    FTIT_rsDecodeJob* job = (FTIT_rsDecodeJob*) ctx;
+    const char* src[FTI_BUFS];
+    int64_t s;
+    int i;
+    for (s = first; s < last; s++) {
+        int64_t off = s * FTI_RS_STRIPE;
+        int64_t len = (job->nBytes - off < FTI_RS_STRIPE) ?
+         job->nBytes - off : FTI_RS_STRIPE;
+        for (i = 0; i < job->k; i++) {
+            src[i] = job->src[i] + off;
+        }
+        if (job->dataRow != NULL) {
+            FTI_Gf16DotProduct(job->dataRow, src, job->k, job->data + off,
+             len);
+        }
+        if (job->codingRow != NULL) {
+            FTI_Gf16DotProduct(job->codingRow, src, job->k,
+             job->coding + off, len);
+        }
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Computes the decoding coefficients of this group member.
   @param      FTI_Conf        Configuration metadata.
-  @param      FTI_Exec        Execution metadata.
   @param      FTI_Topo        Topology metadata.
-  @param      FTI_Ckpt        Checkpoint metadata.
   @param      erased          The array of erasures.
+  @param      survivors       The k surviving file ids (output).
+  @param      rows            2k tables: data row, then encoding row.
   @return     integer         FTI_SCES if successful.
 
-  This function tries to recover the L3 ckpt. files missing using the
-  RS decoding.
+  File id i < k is the ckpt. file of member i, k + i its encoded file.
+  The lost data of member g is row g of the inverse D of the survivor
+  matrix applied to the survivors. A lost encoded file is the row g of
+  the encoding matrix times D, so it is computed from the survivors as
+  well, without gathering the regenerated data first.
 
  **/
 /*-------------------------------------------------------------------------*/
-int FTI_Decode(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
-        FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt, int* erased) {
-    int ckptId, rank;
-    sscanf(FTI_Exec->ckptMeta.ckptFile, "Ckpt%d-Rank%d.%s", &ckptId, &rank,
-     FTI_Conf->suffix);
-    char fn[FTI_BUFS], efn[FTI_BUFS];
-    snprintf(efn, FTI_BUFS, "%s/Ckpt%d-RSed%d.%s", FTI_Ckpt[3].dir, ckptId,
-     rank, FTI_Conf->suffix);
-    snprintf(fn, FTI_BUFS, "%s/%s", FTI_Ckpt[3].dir,
-     FTI_Exec->ckptMeta.ckptFile);
-
-    int bs = FTI_Conf->blockSize;
+static int FTI_RSDecodingRows(FTIT_configuration* FTI_Conf,
+        FTIT_topology* FTI_Topo, int* erased, int* survivors,
+        FTIT_gf16Table* rows) {
     int k = FTI_Topo->groupSize;
-    int m = k;
+    int g = FTI_Topo->groupRank;
+    int w = FTI_Conf->l3WordSize;
+    int* matrix = talloc(int, k * k);
+    int* tmpmat = talloc(int, k * k);
+    int* decMatrix = talloc(int, k * k);
+    int i, j, l;
 
-    int32_t fs = FTI_Exec->ckptMeta.fs;
-
-    char** data = talloc(char*, k);
-    char** coding = talloc(char*, m);
-    char* dataTmp = talloc(char, FTI_Conf->blockSize* k);
-    int* dm_ids = talloc(int, k);
-    int* decMatrix = talloc(int, k* k);
-    int* tmpmat = talloc(int, k* k);
-    int* matrix = talloc(int, k* k);
-    int i, j;
-    for (i = 0; i < FTI_Topo->groupSize; i++) {
-        for (j = 0; j < FTI_Topo->groupSize; j++) {
-            matrix[i * FTI_Topo->groupSize + j] = galois_single_divide(1,
-             i ^ (FTI_Topo->groupSize + j), FTI_Conf->l3WordSize);
+    for (i = 0; i < k; i++) {
+        for (j = 0; j < k; j++) {
+            matrix[i * k + j] = galois_single_divide(1, i ^ (k + j), w);
         }
     }
-    for (i = 0; i < m; i++) {
-        coding[i] = talloc(char, FTI_Conf->blockSize);
-        data[i] = talloc(char, FTI_Conf->blockSize);
-    }
     j = 0;
     for (i = 0; j < k; i++) {
         if (erased[i] == 0) {
-            dm_ids[j] = i;
+            survivors[j] = i;
             j++;
         }
     }
-    // Building the matrix
     for (i = 0; i < k; i++) {
-        if (dm_ids[i] < k) {
-            for (j = 0; j < k; j++) {
-                tmpmat[i * k + j] = 0;
-            }
-            tmpmat[i * k + dm_ids[i]] = 1;
-        } else {
-            for (j = 0; j < k; j++) {
-                tmpmat[i * k + j] = matrix[(dm_ids[i] - k) * k + j];
+        for (j = 0; j < k; j++) {
+            if (survivors[i] < k) {
+                tmpmat[i * k + j] = (j == survivors[i]) ? 1 : 0;
+            } else {
+                tmpmat[i * k + j] = matrix[(survivors[i] - k) * k + j];
             }
         }
     }
 
-    // Inversing the matrix
-    if (jerasure_invert_matrix(tmpmat, decMatrix, k,
-     FTI_Conf->l3WordSize) < 0) {
+    int res = FTI_SCES;
+    if (jerasure_invert_matrix(tmpmat, decMatrix, k, w) < 0) {
         FTI_Print("Error inversing matrix", FTI_DBUG);
-
-        for (i = 0; i < m; i++) {
-            free(coding[i]);
-            free(data[i]);
+        res = FTI_NSCS;
+    } else {
+        for (i = 0; i < k; i++) {
+            int c = 0;
+            for (l = 0; l < k; l++) {
+                c ^= galois_single_multiply(matrix[g * k + l],
+                 decMatrix[l * k + i], w);
+            }
+            FTI_Gf16InitTable(&rows[i], decMatrix[g * k + i]);
+            FTI_Gf16InitTable(&rows[k + i], c);
         }
-        free(tmpmat);
-        free(dm_ids);
-        free(decMatrix);
-        free(matrix);
-        free(data);
-        free(dataTmp);
-        free(coding);
-
-        return FTI_NSCS;
     }
 
-    FILE *fd, *efd;
-    int32_t maxFs = FTI_Exec->ckptMeta.maxFs;
-    int32_t ps = ((maxFs / FTI_Conf->blockSize)) * FTI_Conf->blockSize;
-    if (ps < maxFs) {
-        ps = ps + FTI_Conf->blockSize;  // Calculating padding size
-    }
-    if (erased[FTI_Topo->groupRank] == 0) {  // Resize and open files
-        // determine file size in order to write at the end of the
-        // elongated and padded file (i.e. write at the end of file
-        // after 'truncate(.., maxFs)'
-        struct stat st_;
-        if (FTI_Conf->ioMode == FTI_IO_FTIFF) {
-            stat(fn, &st_);
-        }
+    free(decMatrix);
+    free(tmpmat);
+    free(matrix);
+    return res;
+}
 
-        if (truncate(fn, maxFs) == -1) {
-            FTI_Print("Error with truncate on checkpoint file", FTI_DBUG);
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Maps a surviving local file for reading.
+  @param      fn              File name.
+  @param      size            Bytes to map.
+  @return     char*           The mapping or NULL.
+ **/
+/*-------------------------------------------------------------------------*/
+static char* FTI_RSMapFile(const char* fn, int64_t size) {
+    int fd = open(fn, O_RDONLY);
+    if (fd == -1) {
+        return NULL;
+    }
+    void* map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+    madvise(map, size, MADV_SEQUENTIAL);
+    return (char*) map;
+}
 
-            for (i = 0; i < m; i++) {
-                free(coding[i]);
-                free(data[i]);
-            }
+/** State of the streaming L3 decoder of one group member. */
+typedef struct FTIT_rsDecoder {
+    int k;                              /**< Group size.                   */
+    int* survivors;                     /**< The k surviving file ids.     */
+    bool* needy;                        /**< Members that lost a file.     */
+    char* local[2];                     /**< Mapped local data/encoding.   */
+    char* recv[2];                      /**< Survivors of the messages.    */
+    MPI_Request* req[2];                /**< Transfers of the messages.    */
+    int nbReq[2];                       /**< Number of transfers.          */
+    int64_t msgSize;                    /**< Bytes per message.            */
+    int64_t maxFs;                      /**< Padded file size.             */
+} FTIT_rsDecoder;
 
-            free(tmpmat);
-            free(dm_ids);
-            free(decMatrix);
-            free(matrix);
-            free(data);
-            free(dataTmp);
-            free(coding);
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Posts the transfers of the survivors of a message.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+  @param      dec             Decoder state.
+  @param      msg             Message index.
+  @param      slot            Buffer slot of the message.
 
-            return FTI_NSCS;
-        }
+  The survivors are only sent to the members that lost a file. Local
+  blocks are sent straight from the mapped files. Messages of a pair are
+  posted in survivor order on both sides, so a single tag suffices.
 
-        // after truncation we need to write the filesize into the file
-        // in order to have the same file as at the state we performed
-        // the encoding. In order to do so, we need to determine the
-        // file size with stat, before the truncation!
-        if (FTI_Conf->ioMode == FTI_IO_FTIFF) {
-            int lftmp_ = open(fn, O_RDWR);
-            if (lftmp_ == -1) {
-                FTI_Print("FTI_RSenc: (FTIFF) Unable to open file!", FTI_EROR);
-                return FTI_NSCS;
-            }
-            if (lseek(lftmp_, -sizeof(off_t), SEEK_END) == -1) {
-                FTI_Print("FTI_RSenc: (FTIFF) Unable to seek in file!",
-                 FTI_EROR);
-                return FTI_NSCS;
-            }
-            if (write(lftmp_, &st_.st_size, sizeof(off_t)) == -1) {
-                FTI_Print("FTI_RSenc: (FTIFF) Unable to write meta data"
-                " in file!", FTI_EROR);
-                return FTI_NSCS;
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_RSPostMsg(FTIT_configuration* FTI_Conf,
+        FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo,
+        FTIT_rsDecoder* dec, int64_t msg, int slot) {
+    int64_t pos = msg * dec->msgSize;
+    int64_t size = (dec->maxFs - pos < dec->msgSize) ?
+     dec->maxFs - pos : dec->msgSize;
+    int me = FTI_Topo->groupRank;
+    int i, q;
+    dec->nbReq[slot] = 0;
+    for (i = 0; i < dec->k; i++) {
+        int id = dec->survivors[i];
+        int owner = id % dec->k;
+        if (owner == me) {
+            char* src = dec->local[id / dec->k] + pos;
+            for (q = 0; q < dec->k; q++) {
+                if (q != me && dec->needy[q]) {
+                    MPI_Isend(src, size, MPI_CHAR, q, FTI_Conf->generalTag,
+                     FTI_Exec->groupComm, &dec->req[slot][dec->nbReq[slot]++]);
+                }
             }
-            close(lftmp_);
+        } else if (dec->needy[me]) {
+            MPI_Irecv(dec->recv[slot] + i * dec->msgSize, size, MPI_CHAR,
+             owner, FTI_Conf->generalTag, FTI_Exec->groupComm,
+             &dec->req[slot][dec->nbReq[slot]++]);
         }
-        fd = fopen(fn, "rb");
-    } else {
-        fd = fopen(fn, "wb");
-    }
-
-    if (erased[FTI_Topo->groupRank + FTI_Topo->groupSize] == 0) {
-        efd = fopen(efn, "rb");
-    } else {
-        efd = fopen(efn, "wb");
-    }
-    if (fd == NULL) {
-        FTI_Print("R3 cannot open checkpoint file.", FTI_DBUG);
-
-        if (efd) {
-            fclose(efd);
-        }
-        for (i = 0; i < m; i++) {
-            free(coding[i]);
-            free(data[i]);
-        }
-        free(tmpmat);
-        free(dm_ids);
-        free(decMatrix);
-        free(matrix);
-        free(data);
-        free(dataTmp);
-        free(coding);
-
-        return FTI_NSCS;
     }
+}
 
-    if (efd == NULL) {
-        FTI_Print("R3 cannot open encoded ckpt. file.", FTI_DBUG);
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Regenerates the lost files of this member, message by message.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+  @param      dec             Decoder state (mapped local files set).
+  @param      rows            Decoding rows (FTI_RSDecodingRows).
+  @param      erased          The array of erasures.
+  @param      dfd             Lost ckpt. file or NULL.
+  @param      efd             Lost encoded file or NULL.
+  @param      md5ctx          MD5 context of the regenerated encoding, NULL
+                              if its checksum is not needed.
+  @return     integer         FTI_SCES if successful.
 
-        fclose(fd);
+  The transfers of message n+1 run while message n is decoded by the
+  worker pool (see FTI_HashParallel) and written. A write error does not
+  stop the exchange, the other members would wait forever otherwise.
 
-        for (i = 0; i < m; i++) {
-            free(coding[i]);
-            free(data[i]);
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_RSDecodeFile(FTIT_configuration* FTI_Conf,
+        FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo,
+        FTIT_rsDecoder* dec, FTIT_gf16Table* rows, int* erased,
+        FILE* dfd, FILE* efd, MD5_CTX* md5ctx) {
+    int k = dec->k;
+    int me = FTI_Topo->groupRank;
+    int64_t ms = dec->msgSize;
+    int64_t nbMsgs = (dec->maxFs + ms - 1) / ms;
+    char* buffer = NULL;
+    char* pad = NULL;
+    char* out[2] = { NULL, NULL };
+
+    if (dec->needy[me]) {
+        // receive slots, outputs and zero padded copies of local blocks
+        buffer = talloc(char, (2 * k + 4) * ms);
+        if (buffer == NULL) {
+            FTI_Print("R3 cannot allocate the decoding buffers.", FTI_EROR);
+            return FTI_NSCS;
         }
-        free(tmpmat);
-        free(dm_ids);
-        free(decMatrix);
-        free(matrix);
-        free(data);
-        free(dataTmp);
-        free(coding);
-
-        return FTI_NSCS;
+        dec->recv[0] = buffer;
+        dec->recv[1] = buffer + k * ms;
+        out[0] = buffer + 2 * k * ms;
+        out[1] = out[0] + ms;
+        pad = out[1] + ms;
     }
 
-    // Main loop, block by block
-    int32_t pos = 0;
-    int remBsize = bs;
-
-    MD5_CTX md5ctxRS;
-    MD5_Init(&md5ctxRS);
-    while (pos < ps) {
-        if ((maxFs - pos) < bs) {
-            remBsize = maxFs - pos;
+    FTIT_rsDecodeJob job;
+    job.k = k;
+    job.dataRow = erased[me] ? rows : NULL;
+    job.codingRow = erased[me + k] ? rows + k : NULL;
+    job.data = out[0];
+    job.coding = out[1];
+
+    int res = FTI_SCES;
+    int64_t msg;
+    FTI_RSPostMsg(FTI_Conf, FTI_Exec, FTI_Topo, dec, 0, 0);
+    for (msg = 0; msg < nbMsgs; msg++) {
+        int slot = msg % 2;
+        int64_t pos = msg * ms;
+        int64_t size = (dec->maxFs - pos < ms) ? dec->maxFs - pos : ms;
+        MPI_Waitall(dec->nbReq[slot], dec->req[slot], MPI_STATUSES_IGNORE);
+        if (msg + 1 < nbMsgs) {
+            FTI_RSPostMsg(FTI_Conf, FTI_Exec, FTI_Topo, dec, msg + 1,
+             1 - slot);
+        }
+        if (msg + 2 < nbMsgs) {
+            int i;
+            for (i = 0; i < 2; i++) {
+                if (dec->local[i] != NULL) {
+                    int64_t next = (msg + 2) * ms;
+                    int64_t len = (dec->maxFs - next < ms) ?
+                     dec->maxFs - next : ms;
+                    madvise(dec->local[i] + next, len, MADV_WILLNEED);
+                }
+            }
+        }
+        if (!dec->needy[me]) {
+            continue;
         }
 
-        // Reading the data
-        if (erased[FTI_Topo->groupRank] == 0) {
-            bzero(data[FTI_Topo->groupRank], bs);
-            fread(data[FTI_Topo->groupRank] + 0, sizeof(char), remBsize, fd);
-
-            if (ferror(fd)) {
-                FTI_Print("R3 cannot from the ckpt. file.", FTI_DBUG);
-
-                fclose(fd);
-                fclose(efd);
-
-                for (i = 0; i < m; i++) {
-                    free(coding[i]);
-                    free(data[i]);
+        // words are 16 bit, an odd tail is padded with a zero byte
+        job.nBytes = (size + 1) & ~((int64_t) 1);
+        int i;
+        for (i = 0; i < k; i++) {
+            int id = dec->survivors[i];
+            if (id % k != me) {
+                job.src[i] = dec->recv[slot] + i * ms;
+                if (job.nBytes > size) {
+                    dec->recv[slot][i * ms + size] = 0;
                 }
-                free(tmpmat);
-                free(dm_ids);
-                free(decMatrix);
-                free(matrix);
-                free(data);
-                free(dataTmp);
-                free(coding);
+            } else if (job.nBytes > size) {
+                char* copy = pad + (id / k) * ms;
+                memcpy(copy, dec->local[id / k] + pos, size);
+                copy[size] = 0;
+                job.src[i] = copy;
+            } else {
+                job.src[i] = dec->local[id / k] + pos;
+            }
+        }
+        FTI_HashParallel(FTI_RSDecodeStripes, &job,
+         (job.nBytes + FTI_RS_STRIPE - 1) / FTI_RS_STRIPE, FTI_POOL_L3);
 
-                return FTI_NSCS;
+        if (dfd != NULL && fwrite(out[0], sizeof(char), size, dfd) != size) {
+            FTI_Print("R3 cannot write the checkpoint file.", FTI_EROR);
+            res = FTI_NSCS;
+        }
+        if (efd != NULL) {
+            if (md5ctx != NULL) {
+                MD5_Update(md5ctx, out[1], size);
+            }
+            if (fwrite(out[1], sizeof(char), size, efd) != size) {
+                FTI_Print("R3 cannot write the encoded ckpt. file.",
+                 FTI_EROR);
+                res = FTI_NSCS;
             }
         }
+    }
 
-        if (erased[FTI_Topo->groupRank + FTI_Topo->groupSize] == 0) {
-            bzero(coding[FTI_Topo->groupRank], bs);
-            fread(coding[FTI_Topo->groupRank] + 0, sizeof(char), remBsize, efd);
+    free(buffer);
+    return res;
+}
 
-            if (ferror(efd)) {
-                FTI_Print("R3 cannot from the encoded ckpt. file.", FTI_DBUG);
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It recovers a set of ckpt. files using RS decoding.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+  @param      FTI_Ckpt        Checkpoint metadata.
+  @param      erased          The array of erasures.
+  @return     integer         FTI_SCES if successful.
 
-                fclose(fd);
-                fclose(efd);
+  This function tries to recover the L3 ckpt. files missing using the
+  RS decoding. The surviving local files are memory mapped and their
+  blocks are sent only to the members that lost a file. Those decode
+  the messages on the worker pool (Basic:l3_threads) and stream the
+  regenerated blocks to the recovered files.
 
-                for (i = 0; i < m; i++) {
-                    free(coding[i]);
-                    free(data[i]);
-                }
-                free(tmpmat);
-                free(dm_ids);
-                free(decMatrix);
-                free(matrix);
-                free(data);
-                free(dataTmp);
-                free(coding);
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_Decode(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
+        FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt, int* erased) {
+    int ckptId, rank;
+    sscanf(FTI_Exec->ckptMeta.ckptFile, "Ckpt%d-Rank%d.%s", &ckptId, &rank,
+     FTI_Conf->suffix);
+    char fn[FTI_BUFS], efn[FTI_BUFS], str[FTI_BUFS];
+    snprintf(efn, FTI_BUFS, "%s/Ckpt%d-RSed%d.%s", FTI_Ckpt[3].dir, ckptId,
+     rank, FTI_Conf->suffix);
+    snprintf(fn, FTI_BUFS, "%s/%s", FTI_Ckpt[3].dir,
+     FTI_Exec->ckptMeta.ckptFile);
 
-                return FTI_NSCS;
-            }
-        }
+    int k = FTI_Topo->groupSize;
+    int me = FTI_Topo->groupRank;
+    int64_t fs = FTI_Exec->ckptMeta.fs;
+    int64_t maxFs = FTI_Exec->ckptMeta.maxFs;
+    double t0 = MPI_Wtime();
+    int i;
 
-        MPI_Allgather(data[FTI_Topo->groupRank] + 0, bs, MPI_CHAR, dataTmp, bs,
-         MPI_CHAR, FTI_Exec->groupComm);
-        for (i = 0; i < k; i++) {
-            memcpy(data[i] + 0, &(dataTmp[i * bs]), sizeof(char) * bs);
-        }
+    FTIT_rsDecoder dec;
+    memset(&dec, 0, sizeof(FTIT_rsDecoder));
+    dec.k = k;
+    dec.maxFs = maxFs;
+    dec.msgSize = FTI_Conf->blockSize;
+    dec.survivors = talloc(int, k);
+    dec.needy = talloc(bool, k);
+    dec.req[0] = talloc(MPI_Request, 3 * k);
+    dec.req[1] = talloc(MPI_Request, 3 * k);
+    FTIT_gf16Table* rows = talloc(FTIT_gf16Table, 2 * k);
+    for (i = 0; i < k; i++) {
+        dec.needy[i] = erased[i] || erased[i + k];
+    }
 
-        MPI_Allgather(coding[FTI_Topo->groupRank] + 0, bs, MPI_CHAR, dataTmp,
-         bs, MPI_CHAR, FTI_Exec->groupComm);
-        for (i = 0; i < k; i++) {
-            memcpy(coding[i] + 0, &(dataTmp[i * bs]), sizeof(char) * bs);
-        }
+    int res = FTI_RSDecodingRows(FTI_Conf, FTI_Topo, erased, dec.survivors,
+     rows);
 
-        // Decoding the lost data work
-        if (erased[FTI_Topo->groupRank]) {
-            jerasure_matrix_dotprod(k, FTI_Conf->l3WordSize,
-             decMatrix + (FTI_Topo->groupRank * k), dm_ids,
-             FTI_Topo->groupRank, data, coding, bs);
+    FILE* dfd = NULL;
+    FILE* efd = NULL;
+    if (res == FTI_SCES && erased[me] == 0) {
+        // determine file size in order to write at the end of the
+        // elongated and padded file (i.e. write at the end of file
+        // after 'truncate(.., maxFs)'
+        struct stat st_;
+        if (FTI_Conf->ioMode == FTI_IO_FTIFF) {
+            stat(fn, &st_);
         }
 
-        MPI_Allgather(data[FTI_Topo->groupRank] + 0, bs, MPI_CHAR,
-         dataTmp, bs, MPI_CHAR, FTI_Exec->groupComm);
-        for (i = 0; i < k; i++) {
-            memcpy(data[i] + 0, &(dataTmp[i * bs]), sizeof(char) * bs);
+        if (truncate(fn, maxFs) == -1) {
+            FTI_Print("Error with truncate on checkpoint file", FTI_DBUG);
+            res = FTI_NSCS;
         }
 
-        // Finally, re-encode any erased encoded checkpoint file
-        if (erased[FTI_Topo->groupRank + k]) {
-            jerasure_matrix_dotprod(k, FTI_Conf->l3WordSize,
-             matrix + (FTI_Topo->groupRank * k), NULL, FTI_Topo->groupRank + k,
-              data, coding, bs);
+        // after truncation we need to write the filesize into the file
+        // in order to have the same file as at the state we performed
+        // the encoding. In order to do so, we need to determine the
+        // file size with stat, before the truncation!
+        if (res == FTI_SCES && FTI_Conf->ioMode == FTI_IO_FTIFF) {
+            int lftmp_ = open(fn, O_RDWR);
+            if (lftmp_ == -1 ||
+             lseek(lftmp_, -sizeof(off_t), SEEK_END) == -1 ||
+             write(lftmp_, &st_.st_size, sizeof(off_t)) == -1) {
+                FTI_Print("R3: (FTIFF) Unable to write meta data in "
+                    "checkpoint file!", FTI_EROR);
+                res = FTI_NSCS;
+            }
+            if (lftmp_ != -1) {
+                close(lftmp_);
+            }
         }
-        if (erased[FTI_Topo->groupRank]) {
-            fwrite(data[FTI_Topo->groupRank] + 0, sizeof(char), remBsize, fd);
+        if (res == FTI_SCES) {
+            dec.local[0] = FTI_RSMapFile(fn, maxFs);
+            if (dec.local[0] == NULL) {
+                FTI_Print("R3 cannot map checkpoint file.", FTI_DBUG);
+                res = FTI_NSCS;
+            }
         }
-        if (erased[FTI_Topo->groupRank + k]) {
-            MD5_Update(&md5ctxRS, coding[FTI_Topo->groupRank], remBsize);
-            fwrite(coding[FTI_Topo->groupRank] + 0, sizeof(char),
-             remBsize, efd);
+    } else if (res == FTI_SCES) {
+        dfd = fopen(fn, "wb");
+        if (dfd == NULL) {
+            FTI_Print("R3 cannot open checkpoint file.", FTI_DBUG);
+            res = FTI_NSCS;
         }
+    }
 
-        pos = pos + bs;
+    if (res == FTI_SCES && erased[me + k] == 0) {
+        dec.local[1] = FTI_RSMapFile(efn, maxFs);
+        if (dec.local[1] == NULL) {
+            FTI_Print("R3 cannot map encoded ckpt. file.", FTI_DBUG);
+            res = FTI_NSCS;
+        }
+    } else if (res == FTI_SCES) {
+        efd = fopen(efn, "wb");
+        if (efd == NULL) {
+            FTI_Print("R3 cannot open encoded ckpt. file.", FTI_DBUG);
+            res = FTI_NSCS;
+        }
+    }
+
+    // all members must be ready, the exchange would block otherwise
+    MPI_Allreduce(MPI_IN_PLACE, &res, 1, MPI_INT, MPI_MIN,
+     FTI_Exec->groupComm);
+
+    // only FTI-FF stores the checksum of the regenerated encoding
+    MD5_CTX md5ctxRS;
+    MD5_Init(&md5ctxRS);
+    if (res == FTI_SCES) {
+        res = FTI_RSDecodeFile(FTI_Conf, FTI_Exec, FTI_Topo, &dec, rows,
+         erased, dfd, efd,
+         (FTI_Conf->ioMode == FTI_IO_FTIFF) ? &md5ctxRS : NULL);
     }
     unsigned char hashRS[MD5_DIGEST_LENGTH];
     MD5_Final(hashRS, &md5ctxRS);
 
+    for (i = 0; i < 2; i++) {
+        if (dec.local[i] != NULL) {
+            munmap(dec.local[i], maxFs);
+        }
+    }
+    if (dfd != NULL) {
+        fclose(dfd);
+    }
+    if (efd != NULL) {
+        fclose(efd);
+    }
+    free(rows);
+    free(dec.req[1]);
+    free(dec.req[0]);
+    free(dec.needy);
+    free(dec.survivors);
+    if (res != FTI_SCES) {
+        return FTI_NSCS;
+    }
 
-    // Closing files
-    fclose(fd);
-    fclose(efd);
+    if (erased[me] || erased[me + k]) {
+        double t = MPI_Wtime() - t0;
+        int64_t regen = ((erased[me] ? 1 : 0) + (erased[me + k] ? 1 : 0)) *
+         maxFs;
+        snprintf(str, FTI_BUFS, "L3 decoding regenerated %.2f MB in %.2f "
+            "sec. (%.2f MB/s, %d threads).", regen / (1024.0 * 1024.0), t,
+            (t > 0) ? regen / (1024.0 * 1024.0) / t : 0.0,
+            FTI_HashEngineThreads(FTI_POOL_L3));
+        FTI_Print(str, FTI_INFO);
+    }
 
     // FTI-FF: if file ckpt file deleted, determine fs from recovered file
-    if (FTI_Conf->ioMode == FTI_IO_FTIFF && erased[FTI_Topo->groupRank]) {
-        char str[FTI_BUFS];
-
+    if (FTI_Conf->ioMode == FTI_IO_FTIFF && erased[me]) {
         int ifd = open(fn, O_RDONLY);
         if (ifd == -1) {
             snprintf(str, FTI_BUFS,
@@ -382,15 +550,14 @@ int FTI_Decode(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
             return FTI_NSCS;
         }
 
-        fs = (int32_t) fs_;
+        fs = (int64_t) fs_;
         FTI_Exec->ckptMeta.fs = fs;
 
         close(ifd);
     }
 
     // FTI-FF: if encoded file deleted, append meta data to encoded file
-    if (FTI_Conf->ioMode == FTI_IO_FTIFF && erased[FTI_Topo->groupRank + k]) {
-        char str[FTI_BUFS];
+    if (FTI_Conf->ioMode == FTI_IO_FTIFF && erased[me + k]) {
         FTIFF_metaInfo *FTIFFMeta = malloc(sizeof(FTIFF_metaInfo));
 
         // get timestamp
@@ -444,34 +611,9 @@ int FTI_Decode(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
 
     if (truncate(fn, fs) == -1) {
         FTI_Print("R3 cannot re-truncate checkpoint file.", FTI_WARN);
-
-        for (i = 0; i < m; i++) {
-            free(coding[i]);
-            free(data[i]);
-        }
-        free(tmpmat);
-        free(dm_ids);
-        free(decMatrix);
-        free(matrix);
-        free(data);
-        free(dataTmp);
-        free(coding);
-
         return FTI_NSCS;
     }
 
-    for (i = 0; i < m; i++) {
-        free(coding[i]);
-        free(data[i]);
-    }
-    free(tmpmat);
-    free(dm_ids);
-    free(decMatrix);
-    free(matrix);
-    free(data);
-    free(dataTmp);
-    free(coding);
-
     return FTI_SCES;
 }
 
@@ -536,7 +678,7 @@ int FTI_RecoverL1(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
 /*-------------------------------------------------------------------------*/
 int FTI_SendCkptFileL2(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         FTIT_checkpoint* FTI_Ckpt, int destination, int ptner) {
-    int32_t toSend;  // remaining data to send
+    int64_t toSend;  // remaining data to send
     char filename[FTI_BUFS], str[FTI_BUFS];
     if (ptner) {  // if want to send Ptner file
         int ckptId, rank;
@@ -600,7 +742,7 @@ int FTI_SendCkptFileL2(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
 /*-------------------------------------------------------------------------*/
 int FTI_RecvCkptFileL2(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         FTIT_checkpoint* FTI_Ckpt, int source, int ptner) {
-    int32_t toRecv;  // remaining data to receive
+    int64_t toRecv;  // remaining data to receive
     char filename[FTI_BUFS], str[FTI_BUFS];
     if (ptner) {  // if want to receive Ptner file
         int ckptId, rank;
@@ -887,6 +1029,128 @@ int FTI_RecoverL3(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     return FTI_SCES;
 }
 
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It checks if the L4 ckpt. was written in aggregated files.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+  @param      FTI_Ckpt        Checkpoint metadata.
+  @return     integer         TRUE if all ranks find their aggregated file.
+
+  All application processes must take the same recovery path, the
+  decision is therefore agreed on FTI_COMM_WORLD.
+
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_HasAggregatedL4(FTIT_configuration* FTI_Conf,
+        FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo,
+        FTIT_checkpoint* FTI_Ckpt) {
+    if ((FTI_Exec->aggComm == MPI_COMM_NULL) || FTI_Ckpt[4].recoIsDcp) {
+        return false;
+    }
+    char fn[FTI_BUFS];
+    FTI_AggFileName(FTI_Conf, FTI_Topo, FTI_Ckpt[4].dir, FTI_Exec->ckptId, fn);
+    int found = (access(fn, R_OK) == 0), all;
+    MPI_Allreduce(&found, &all, 1, MPI_INT, MPI_MIN, FTI_COMM_WORLD);
+    return all;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It recovers L4 ckpt. files from aggregated files in the PFS.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+  @param      FTI_Ckpt        Checkpoint metadata.
+  @return     integer         FTI_SCES if successful.
+
+  Every process looks up its extent in the index of the aggregated file of
+  its group and copies it to its local ckpt. file, whose checksum is then
+  verified.
+
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_RecoverL4Agg(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
+        FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt) {
+    FTI_Print("Starting recovery L4 from aggregated files.", FTI_DBUG);
+    if (mkdir(FTI_Ckpt[1].dir, 0777) == -1) {
+        if (errno != EEXIST) {
+            FTI_Print("Directory L1 could NOT be created.", FTI_WARN);
+        }
+    }
+
+    char gfn[FTI_BUFS], lfn[FTI_BUFS];
+    snprintf(FTI_Exec->ckptMeta.ckptFile, FTI_BUFS, "Ckpt%d-Rank%d.%s",
+     FTI_Exec->ckptId, FTI_Topo->myRank, FTI_Conf->suffix);
+    snprintf(lfn, FTI_BUFS, "%s/%s", FTI_Conf->lTmpDir,
+     FTI_Exec->ckptMeta.ckptFile);
+    FTI_AggFileName(FTI_Conf, FTI_Topo, FTI_Ckpt[4].dir, FTI_Exec->ckptId,
+     gfn);
+
+    int gfd = open(gfn, O_RDONLY);
+    if (gfd < 0) {
+        FTI_Print("R4 cannot open the aggregated ckpt. file in the PFS.",
+         FTI_WARN);
+        return FTI_NSCS;
+    }
+    int64_t offset, size, fs = FTI_Exec->ckptMeta.fs;
+    if ((FTI_AggFindExtent(gfd, FTI_Topo->splitRank, &offset, &size) !=
+     FTI_SCES) || (size != fs)) {
+        FTI_Print("Checkpoint file missing at L4.", FTI_WARN);
+        close(gfd);
+        return FTI_NSCS;
+    }
+
+    MKDIR(FTI_Conf->lTmpDir, 0777);
+    FILE* lfd = fopen(lfn, "wb");
+    if (lfd == NULL) {
+        FTI_Print("R4 cannot open the local ckpt. file.", FTI_WARN);
+        close(gfd);
+        return FTI_NSCS;
+    }
+
+    char *readData = talloc(char, FTI_Conf->transferSize);
+    int res = FTI_SCES;
+    int64_t pos = 0;
+    while (pos < fs) {
+        int64_t bSize = fs - pos;
+        if (bSize > FTI_Conf->transferSize) {
+            bSize = FTI_Conf->transferSize;
+        }
+        ssize_t bytes = pread(gfd, readData, bSize, offset + pos);
+        if (bytes <= 0) {
+            FTI_Print("R4 cannot read from the aggregated ckpt. file.",
+             FTI_DBUG);
+            res = FTI_NSCS;
+            break;
+        }
+        fwrite(readData, sizeof(char), bytes, lfd);
+        if (ferror(lfd)) {
+            FTI_Print("R4 cannot write to the local ckpt. file.", FTI_DBUG);
+            res = FTI_NSCS;
+            break;
+        }
+        pos = pos + bytes;
+    }
+
+    free(readData);
+    close(gfd);
+    fclose(lfd);
+
+    if (res == FTI_SCES) {
+        char checksum[MD5_DIGEST_STRING_LENGTH],
+         ptnerChecksum[MD5_DIGEST_STRING_LENGTH],
+         rsChecksum[MD5_DIGEST_STRING_LENGTH];
+        FTI_GetChecksums(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt, checksum,
+         ptnerChecksum, rsChecksum);
+        if (FTI_CheckFile(lfn, fs, checksum)) {
+            res = FTI_NSCS;
+        }
+    }
+    return res;
+}
+
 /*-------------------------------------------------------------------------*/
 /**
   @brief      It recovers L4 ckpt. files from the PFS.
@@ -905,10 +1169,15 @@ int FTI_RecoverL3(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
 int FTI_RecoverL4(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt) {
     switch (FTI_Conf->ioMode) {
+        case FTI_IO_POSIX:
+            if (FTI_HasAggregatedL4(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt)) {
+                return FTI_RecoverL4Agg(FTI_Conf, FTI_Exec, FTI_Topo,
+                 FTI_Ckpt);
+            }
+            return FTI_RecoverL4Posix(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt);
         case FTI_IO_FTIFF:
         case FTI_IO_HDF5:
         case FTI_IO_IME:
-        case FTI_IO_POSIX:
             return FTI_RecoverL4Posix(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt);
         case FTI_IO_MPI:
             return FTI_RecoverL4Mpi(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt);
@@ -923,6 +1192,99 @@ int FTI_RecoverL4(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     }
 }
 
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It copies a L4 ckpt. file from the PFS to the local storage.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      gfn             Path of the file in the PFS.
+  @param      lfn             Path of the local copy.
+  @return     integer         FTI_SCES if successful.
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_CopyL4File(FTIT_configuration* FTI_Conf,
+        FTIT_execution* FTI_Exec, char* gfn, char* lfn) {
+    FILE* gfd = fopen(gfn, "rb");
+    if (gfd == NULL) {
+        FTI_Print("R4 cannot open the ckpt. file in the PFS.", FTI_WARN);
+        return FTI_NSCS;
+    }
+
+    MKDIR(FTI_Conf->lTmpDir, 0777);
+    FILE* lfd = fopen(lfn, "wb");
+    if (lfd == NULL) {
+        FTI_Print("R4 cannot open the local ckpt. file.", FTI_WARN);
+        fclose(gfd);
+        return FTI_NSCS;
+    }
+
+    char *readData = talloc(char, FTI_Conf->transferSize);
+    int32_t bSize = FTI_Conf->transferSize;
+    int64_t fs = FTI_Exec->ckptMeta.fs;
+
+    // with 'verify_on_load', the file is hashed while it is copied
+    bool verify = (FTI_Exec->recoChecksum[0] != '\0');
+    FTIT_integrity ctx;
+    if (verify) {
+        FTI_IntegrityInitFor(&ctx, FTI_Exec->recoChecksum);
+    }
+
+    // Checkpoint files transfer from PFS
+    int64_t pos = 0;
+    while (pos < fs) {
+        if ((fs - pos) < FTI_Conf->transferSize) {
+            bSize = fs - pos;
+        }
+
+        size_t bytes = fread(readData, sizeof(char), bSize, gfd);
+
+        if (ferror(gfd)) {
+            FTI_Print("R4 cannot read from the ckpt. file in the PFS.",
+             FTI_DBUG);
+
+            free(readData);
+
+            fclose(gfd);
+            fclose(lfd);
+
+            return  FTI_NSCS;
+        }
+
+        if (verify) {
+            FTI_IntegrityUpdate(&ctx, readData, bytes);
+        }
+        fwrite(readData, sizeof(char), bytes, lfd);
+        if (ferror(lfd)) {
+            FTI_Print("R4 cannot write to the local ckpt. file.", FTI_DBUG);
+
+            free(readData);
+
+            fclose(gfd);
+            fclose(lfd);
+
+            return  FTI_NSCS;
+        }
+
+        pos = pos + bytes;
+    }
+
+    free(readData);
+
+    fclose(gfd);
+    fclose(lfd);
+
+    if (verify) {
+        if (FTI_VerifyHash(gfn, &ctx, FTI_Exec->recoChecksum) != FTI_SCES) {
+            unlink(lfn);
+            return FTI_NSCS;
+        }
+        // the local copy is loaded without verification
+        FTI_Exec->recoChecksum[0] = '\0';
+    }
+
+    return FTI_SCES;
+}
+
 /*-------------------------------------------------------------------------*/
 /**
   @brief      It recovers L4 ckpt. files from the PFS using POSIX.
@@ -1000,66 +1362,15 @@ int FTI_RecoverL4Posix(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
          FTI_Exec->ckptMeta.ckptFile);
     }
 
-    FILE* gfd = fopen(gfn, "rb");
-    if (gfd == NULL) {
-        FTI_Print("R4 cannot open the ckpt. file in the PFS.", FTI_WARN);
-        return FTI_NSCS;
-    }
-
-    MKDIR(FTI_Conf->lTmpDir, 0777);
-    FILE* lfd = fopen(lfn, "wb");
-    if (lfd == NULL) {
-        FTI_Print("R4 cannot open the local ckpt. file.", FTI_WARN);
-        fclose(gfd);
-        return FTI_NSCS;
-    }
-
-    char *readData = talloc(char, FTI_Conf->transferSize);
-    int32_t bSize = FTI_Conf->transferSize;
-    int32_t fs = FTI_Exec->ckptMeta.fs;
-
-    // Checkpoint files transfer from PFS
-    int32_t pos = 0;
-    while (pos < fs) {
-        if ((fs - pos) < FTI_Conf->transferSize) {
-            bSize = fs - pos;
-        }
-
-        size_t bytes = fread(readData, sizeof(char), bSize, gfd);
-
-        if (ferror(gfd)) {
-            FTI_Print("R4 cannot read from the ckpt. file in the PFS.",
-             FTI_DBUG);
-
-            free(readData);
-
-            fclose(gfd);
-            fclose(lfd);
-
-            return  FTI_NSCS;
-        }
-
-        fwrite(readData, sizeof(char), bytes, lfd);
-        if (ferror(lfd)) {
-            FTI_Print("R4 cannot write to the local ckpt. file.", FTI_DBUG);
-
-            free(readData);
-
-            fclose(gfd);
-            fclose(lfd);
-
-            return  FTI_NSCS;
-        }
-
-        pos = pos + bytes;
+    int res = FTI_CopyL4File(FTI_Conf, FTI_Exec, gfn, lfn);
+    if (res != FTI_SCES && FTI_Ckpt[4].localReplica == 1) {
+        // the local replica may be corrupted, try the PFS
+        snprintf(gfn, FTI_BUFS, "%s/%s", FTI_Ckpt[4].dir,
+         FTI_Exec->ckptMeta.ckptFile);
+        FTI_Ckpt[4].localReplica = 0;
+        res = FTI_CopyL4File(FTI_Conf, FTI_Exec, gfn, lfn);
     }
-
-    free(readData);
-
-    fclose(gfd);
-    fclose(lfd);
-
-    return FTI_SCES;
+    return res;
 }
 
 /*-------------------------------------------------------------------------*/
@@ -1122,10 +1433,10 @@ int FTI_RecoverL4Mpi(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     }
 
     // collect chunksizes of other ranks
-    int32_t* chunkSizes = talloc(int32_t,
+    int64_t* chunkSizes = talloc(int64_t,
      FTI_Topo->nbApprocs*FTI_Topo->nbNodes);
-    MPI_Allgather(&FTI_Exec->ckptMeta.fs, 1, MPI_INT32_T, chunkSizes, 1,
-     MPI_INT32_T, FTI_COMM_WORLD);
+    MPI_Allgather(&FTI_Exec->ckptMeta.fs, 1, MPI_INT64_T, chunkSizes, 1,
+     MPI_INT64_T, FTI_COMM_WORLD);
 
     MPI_Offset offset = 0;
     // set file offset
@@ -1143,10 +1454,10 @@ int FTI_RecoverL4Mpi(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         return FTI_NSCS;
     }
 
-    int32_t fs = FTI_Exec->ckptMeta.fs;
+    int64_t fs = FTI_Exec->ckptMeta.fs;
     char *readData = talloc(char, FTI_Conf->transferSize);
     int32_t bSize = FTI_Conf->transferSize;
-    int32_t pos = 0;
+    int64_t pos = 0;
     // Checkpoint files transfer from PFS
     while (pos < fs) {
         if ((fs - pos) < FTI_Conf->transferSize) {
@@ -1307,10 +1618,10 @@ int FTI_RecoverL4Sionlib(FTIT_configuration* FTI_Conf,
 
     // Checkpoint files transfer from PFS
     while (!sion_feof(sid)) {
-        int32_t fs = FTI_Exec->ckptMeta.fs;
+        int64_t fs = FTI_Exec->ckptMeta.fs;
         char *readData = talloc(char, FTI_Conf->transferSize);
         int32_t bSize = FTI_Conf->transferSize;
-        int32_t pos = 0;
+        int64_t pos = 0;
         // Checkpoint files transfer from PFS
         while (pos < fs) {
             if ((fs - pos) < FTI_Conf->transferSize) {
@@ -51,7 +51,7 @@
 
  **/
 /*-------------------------------------------------------------------------*/
-int FTI_CheckFile(char* fn, int32_t fs, char* checksum) {
+int FTI_CheckFile(char* fn, int64_t fs, char* checksum) {
     char str[FTI_BUFS];
     if (access(fn, F_OK) == 0) {
         struct stat fileStatus;
@@ -105,9 +105,9 @@ int FTI_CheckErasures(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt,
         int *erased) {
     int level = FTI_Exec->ckptMeta.level;
-    int32_t fs = FTI_Exec->ckptMeta.fs;
-    int32_t pfs = FTI_Exec->ckptMeta.pfs;
-    int32_t maxFs = FTI_Exec->ckptMeta.maxFs;
+    int64_t fs = FTI_Exec->ckptMeta.fs;
+    int64_t pfs = FTI_Exec->ckptMeta.pfs;
+    int64_t maxFs = FTI_Exec->ckptMeta.maxFs;
     char ckptFile[FTI_BUFS];
     strncpy(ckptFile, FTI_Exec->ckptMeta.ckptFile, FTI_BUFS);
 
@@ -123,7 +123,7 @@ int FTI_CheckErasures(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     char fn[FTI_BUFS];  // Path to the checkpoint/partner file name
     int buf;
     int ckptId, rank;  // Variables for proper partner file name
-    int (*consistency)(char *, int32_t , char*);
+    int (*consistency)(char *, int64_t , char*);
 #ifdef ENABLE_HDF5
     if (FTI_Conf->ioMode == FTI_IO_HDF5) {
         consistency = &FTI_CheckHDF5File;
@@ -146,16 +146,25 @@ int FTI_CheckErasures(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
 #endif
     FTI_Ckpt[4].localReplica = 0;
 
+    // with 'verify_on_load', only the size of the ckpt. file is checked
+    // here, its checksum is verified when the file is loaded
+    char* ckptChecksum = checksum;
+    FTI_Exec->recoChecksum[0] = '\0';
+    if (FTI_Exec->recoDeferred && consistency == &FTI_CheckFile) {
+        strncpy(FTI_Exec->recoChecksum, checksum, MD5_DIGEST_STRING_LENGTH);
+        ckptChecksum = "";
+    }
+
     switch (level) {
         case 1:
             snprintf(fn, FTI_BUFS, "%s/%s", FTI_Ckpt[1].dir, ckptFile);
-            buf = consistency(fn, fs, checksum);
+            buf = consistency(fn, fs, ckptChecksum);
             MPI_Allgather(&buf, 1, MPI_INT, erased, 1, MPI_INT,
              FTI_Exec->groupComm);
             break;
         case 2:
             snprintf(fn, FTI_BUFS, "%s/%s", FTI_Ckpt[2].dir, ckptFile);
-            buf = consistency(fn, fs, checksum);
+            buf = consistency(fn, fs, ckptChecksum);
             MPI_Allgather(&buf, 1, MPI_INT, erased, 1, MPI_INT,
              FTI_Exec->groupComm);
 
@@ -169,7 +178,7 @@ int FTI_CheckErasures(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
             break;
         case 3:
             snprintf(fn, FTI_BUFS, "%s/%s", FTI_Ckpt[3].dir, ckptFile);
-            buf = consistency(fn, fs, checksum);
+            buf = consistency(fn, fs, ckptChecksum);
             MPI_Allgather(&buf, 1, MPI_INT, erased, 1, MPI_INT,
              FTI_Exec->groupComm);
 
@@ -185,15 +194,15 @@ int FTI_CheckErasures(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
             if (FTI_Ckpt[FTI_Exec->ckptMeta.level].recoIsDcp &&
              FTI_Conf->dcpPosix) {
                 snprintf(fn, FTI_BUFS, "%s/%s", FTI_Ckpt[4].dcpDir, ckptFile);
-              buf = consistency(fn, fs, checksum);
+              buf = consistency(fn, fs, ckptChecksum);
             } else {
                 snprintf(fn, FTI_BUFS, "%s/%s",
                         FTI_Ckpt[4].L4Replica, ckptFile);
-                buf = consistency(fn, fs, checksum);
+                buf = consistency(fn, fs, ckptChecksum);
                 FTI_Ckpt[4].localReplica = 1;
                 if (buf) {
                     snprintf(fn, FTI_BUFS, "%s/%s", FTI_Ckpt[4].dir, ckptFile);
-                    buf = consistency(fn, fs, checksum);
+                    buf = consistency(fn, fs, ckptChecksum);
                     FTI_Ckpt[4].localReplica = 0;
                 }
             }
@@ -204,6 +213,100 @@ int FTI_CheckErasures(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     return FTI_SCES;
 }
 
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It recovers the files of the checkpoint in FTI_Exec->ckptMeta.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+  @param      FTI_Ckpt        Checkpoint metadata.
+  @param      ckptId          ID of the recovered checkpoint.
+  @return     integer         FTI_SCES if successful on all ranks.
+
+  This function is collective over the application processes, the heads
+  are not involved.
+
+ **/
+/*-------------------------------------------------------------------------*/
+static int FTI_RecoverCkpt(FTIT_configuration* FTI_Conf,
+        FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo,
+        FTIT_checkpoint* FTI_Ckpt, int* ckptId) {
+    int level = FTI_Exec->ckptMeta.level;
+    if (FTI_Conf->ioMode != FTI_IO_FTIFF) {
+        sscanf(FTI_Exec->ckptMeta.ckptFile, "Ckpt%d", ckptId);
+
+        // Temporary for Recover functions
+        FTI_Exec->ckptMeta.level = level;
+        FTI_Exec->ckptId = *ckptId;
+    } else {
+        *ckptId = FTI_Exec->ckptId;
+        FTI_Exec->ckptMeta.level = level;
+    }
+    FTI_Exec->recoChecksum[0] = '\0';
+
+    char str[FTI_BUFS];
+    snprintf(str, FTI_BUFS,
+     "Trying recovery with Ckpt. %d at level %d.", *ckptId, level);
+    FTI_Print(str, FTI_DBUG);
+
+    FTI_Try(FTI_LoadMetaDcp(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt),
+     "load dcp metadata");
+
+    int res;
+    switch (level) {
+        case 4:
+            if (FTI_Ckpt[4].recoIsDcp) {
+                res = FTI_RecoverL4(FTI_Conf, FTI_Exec, FTI_Topo,
+                 FTI_Ckpt);
+                if (FTI_Conf->dcpFtiff) FTI_Ckpt[4].recoIsDcp = false;
+                if (res == FTI_SCES) {
+                    break;
+                } else {
+                    snprintf(str, FTI_BUFS,
+                     "Recover failed from level %d_dCP with Ckpt. %d.",
+                      level, *ckptId);
+                    FTI_Print(str, FTI_INFO);
+                }
+            }
+            res = FTI_RecoverL4(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt);
+            break;
+        case 3:
+            res = FTI_RecoverL3(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt);
+            break;
+        case 2:
+            res = FTI_RecoverL2(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt);
+            break;
+        case 1:
+            res = FTI_RecoverL1(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt);
+            break;
+    }
+    int allRes;
+
+    MPI_Allreduce(&res, &allRes, 1, MPI_INT, MPI_SUM, FTI_COMM_WORLD);
+    if (allRes != FTI_SCES) {
+        snprintf(str, FTI_BUFS,
+         "Recover failed from level %d with Ckpt. %d.", level, *ckptId);
+        FTI_Print(str, FTI_INFO);
+        return FTI_NSCS;
+    }
+
+    // FTI-FF: ckptId is already set properly
+    if ((FTI_Conf->ioMode == FTI_IO_FTIFF) ||
+     (FTI_Ckpt[4].recoIsDcp && FTI_Conf->dcpPosix)) {
+        *ckptId = FTI_Exec->ckptId;
+    }
+
+    if (level == 4 && !FTI_Ckpt[4].recoIsDcp) {
+        FTI_Clean(FTI_Conf, FTI_Topo, FTI_Ckpt, 1);
+        MPI_Barrier(FTI_COMM_WORLD);
+        if (!(FTI_Topo->nodeRank - FTI_Topo->nbHeads)) {
+            RENAME(FTI_Conf->lTmpDir, FTI_Ckpt[1].dir);
+        }
+        MPI_Barrier(FTI_COMM_WORLD);
+    }
+    return FTI_SCES;
+}
+
 /*-------------------------------------------------------------------------*/
 /**
   @brief      It decides wich action take depending on the restart level.
@@ -266,81 +369,23 @@ int FTI_RecoverFiles(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
             }
         }
 
+        // the checksums are verified by FTI_Recover with 'verify_on_load'
+        FTI_Exec->recoDeferred = FTI_Conf->verifyOnLoad &&
+         FTI_Conf->ioMode != FTI_IO_FTIFF && FTI_Conf->ioMode != FTI_IO_HDF5;
+
         while (!FTI_Exec->mqueue.empty(&FTI_Exec->mqueue)) {
             FTI_Exec->mqueue.pop(&FTI_Exec->mqueue, &FTI_Exec->ckptMeta);
 
             int level = FTI_Exec->ckptMeta.level;
             int ckptId;
-            if (FTI_Conf->ioMode != FTI_IO_FTIFF) {
-                sscanf(FTI_Exec->ckptMeta.ckptFile, "Ckpt%d", &ckptId);
-
-                // Temporary for Recover functions
-                FTI_Exec->ckptMeta.level = level;
-                FTI_Exec->ckptId = ckptId;
-            } else {
-                ckptId = FTI_Exec->ckptId;
-                FTI_Exec->ckptMeta.level = level;
-            }
-
-            char str[FTI_BUFS];
-            snprintf(str, FTI_BUFS,
-             "Trying recovery with Ckpt. %d at level %d.", ckptId, level);
-            FTI_Print(str, FTI_DBUG);
-
-            FTI_Try(FTI_LoadMetaDcp(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt),
-             "load dcp metadata");
-
-            int res;
-            switch (level) {
-                case 4:
-                    if (FTI_Ckpt[4].recoIsDcp) {
-                        res = FTI_RecoverL4(FTI_Conf, FTI_Exec, FTI_Topo,
-                         FTI_Ckpt);
-                        if (FTI_Conf->dcpFtiff) FTI_Ckpt[4].recoIsDcp = false;
-                        if (res == FTI_SCES) {
-                            break;
-                        } else {
-                            snprintf(str, FTI_BUFS,
-                             "Recover failed from level %d_dCP with Ckpt. %d.",
-                              level, ckptId);
-                            FTI_Print(str, FTI_INFO);
-                        }
-                    }
-                    res = FTI_RecoverL4(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt);
-                    break;
-                case 3:
-                    res = FTI_RecoverL3(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt);
-                    break;
-                case 2:
-                    res = FTI_RecoverL2(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt);
-                    break;
-                case 1:
-                    res = FTI_RecoverL1(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt);
-                    break;
-            }
-            int allRes;
-
-            MPI_Allreduce(&res, &allRes, 1, MPI_INT, MPI_SUM, FTI_COMM_WORLD);
-            if (allRes == FTI_SCES) {
+            if (FTI_RecoverCkpt(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt,
+             &ckptId) == FTI_SCES) {
                 // Inform heads that recovered successfully
+                int res = FTI_SCES, allRes;
                 MPI_Allreduce(&res, &allRes, 1, MPI_INT, MPI_SUM,
                  FTI_Exec->globalComm);
 
-                // FTI-FF: ckptId is already set properly
-                if ((FTI_Conf->ioMode == FTI_IO_FTIFF) ||
-                 (FTI_Ckpt[4].recoIsDcp && FTI_Conf->dcpPosix)) {
-                    ckptId = FTI_Exec->ckptId;
-                }
-
-                if (level == 4 && !FTI_Ckpt[4].recoIsDcp) {
-                    FTI_Clean(FTI_Conf, FTI_Topo, FTI_Ckpt, 1);
-                    MPI_Barrier(FTI_COMM_WORLD);
-                    if (!(FTI_Topo->nodeRank - FTI_Topo->nbHeads)) {
-                        RENAME(FTI_Conf->lTmpDir, FTI_Ckpt[1].dir);
-                    }
-                    MPI_Barrier(FTI_COMM_WORLD);
-                }
-
+                char str[FTI_BUFS];
                 snprintf(str, FTI_BUFS, "Recovering successfully from level"
                 " %d with Ckpt. %d.", level, ckptId);
                 FTI_Print(str, FTI_INFO);
@@ -360,7 +405,10 @@ int FTI_RecoverFiles(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
                         FTI_Ckpt[4].hasCkpt = true;
                     }
                 }
-                FTI_Exec->mqueue.clear(&FTI_Exec->mqueue);
+                // the older checkpoints are kept until the data is verified
+                if (!FTI_Exec->recoDeferred) {
+                    FTI_Exec->mqueue.clear(&FTI_Exec->mqueue);
+                }
 
                 // Update ckptId and ckptLevel and lastCkptLvel
                 FTI_Exec->ckptId = ckptId;
@@ -368,14 +416,11 @@ int FTI_RecoverFiles(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
                 FTI_Exec->lastCkptLvel = level;
 
                 return FTI_SCES;  // Recovered successfully
-            } else {
-                snprintf(str, FTI_BUFS,
-                 "Recover failed from level %d with Ckpt. %d.", level, ckptId);
-                FTI_Print(str, FTI_INFO);
             }
         }
         // Looped all levels with no success
         FTI_Print("Cannot recover from any checkpoint level.", FTI_INFO);
+        FTI_Exec->recoDeferred = false;
 
         // Inform heads that cannot recover
         int res = FTI_NSCS, allRes;
@@ -409,3 +454,54 @@ int FTI_RecoverFiles(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         return FTI_SCES;
     }
 }
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It recovers the files again after a failed verification.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+  @param      FTI_Ckpt        Checkpoint metadata.
+  @return     integer         FTI_SCES if successful.
+
+  With 'verify_on_load', the checksum of a ckpt. file is verified when it
+  is loaded by FTI_Recover. If it does not match on some rank, the files
+  of the checkpoint are recovered again with their checksums verified, so
+  that the corrupted files are rebuilt from the partner copies or the RS
+  encoding. If this is not possible, the older checkpoints are tried.
+  This function is collective over the application processes, the heads
+  are not involved.
+
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_RecoverFallback(FTIT_configuration* FTI_Conf,
+        FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo,
+        FTIT_checkpoint* FTI_Ckpt) {
+    FTI_Exec->recoDeferred = false;
+    FTI_Exec->ckptMeta.level = FTI_Exec->ckptLvel;
+
+    int ckptId;
+    int res = FTI_RecoverCkpt(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt,
+     &ckptId);
+    while (res != FTI_SCES && !FTI_Exec->mqueue.empty(&FTI_Exec->mqueue)) {
+        FTI_Exec->mqueue.pop(&FTI_Exec->mqueue, &FTI_Exec->ckptMeta);
+        res = FTI_RecoverCkpt(FTI_Conf, FTI_Exec, FTI_Topo, FTI_Ckpt,
+         &ckptId);
+    }
+    FTI_Exec->mqueue.clear(&FTI_Exec->mqueue);
+    if (res != FTI_SCES) {
+        FTI_Print("Cannot recover from any checkpoint level.", FTI_INFO);
+        return FTI_NSCS;
+    }
+
+    char str[FTI_BUFS];
+    int level = FTI_Exec->ckptMeta.level;
+    snprintf(str, FTI_BUFS, "Recovering successfully from level %d with"
+     " Ckpt. %d.", level, ckptId);
+    FTI_Print(str, FTI_INFO);
+    FTI_Exec->ckptId = ckptId;
+    FTI_Exec->ckptCnt = ckptId + 1;
+    FTI_Exec->ckptLvel = level;
+    FTI_Exec->lastCkptLvel = level;
+    return FTI_SCES;
+}
@@ -10,11 +10,14 @@
 
 #include "interface.h"
 
-int FTI_CheckFile(char *fn, int32_t fs, char* checksum);
+int FTI_CheckFile(char *fn, int64_t fs, char* checksum);
 int FTI_CheckErasures(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt,
         int *erased);
 int FTI_RecoverFiles(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         FTIT_topology* FTI_Topo, FTIT_checkpoint* FTI_Ckpt);
+int FTI_RecoverFallback(FTIT_configuration* FTI_Conf,
+        FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo,
+        FTIT_checkpoint* FTI_Ckpt);
 
 #endif  // FTI_SRC_RECOVER_H_
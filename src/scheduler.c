@@ -0,0 +1,275 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  FTI - A multi-level checkpointing library for C/C++/Fortran applications
+ *
+ *  Revision 1.0 : Fault Tolerance Interface (FTI)
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *  list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors
+ *  may be used to endorse or promote products derived from this software without
+ *  specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  @file   scheduler.c
+ *  @date   October, 2026
+ *  @brief  Adaptive checkpoint interval scheduler.
+ */
+
+#include <math.h>
+
+#include "scheduler.h"
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It initializes the adaptive checkpoint scheduler.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+
+  No checkpoint cost is known at start. In adaptive mode, the first
+  checks are done every FTI_SCHED_MIN_TICK seconds to measure the levels
+  early, the fixed mode checks once per minute.
+
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_SchedInit(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec) {
+    FTIT_schedInfo* sched = &FTI_Exec->sched;
+    int i;
+    for (i = 0; i < 5; i++) {
+        sched->cost[i] = -1;
+        sched->intv[i] = -1;
+        sched->clock[i] = 0;
+    }
+    sched->dcpClock = 0;
+    sched->lastIcnt = 0;
+    sched->tick = (FTI_Conf->ckptSched == FTI_SCHED_ADAPTIVE) ?
+     FTI_SCHED_MIN_TICK : FTI_SCHED_MAX_TICK;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It updates the mean cost of the level just checkpointed.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Ckpt        Checkpoint metadata.
+  @param      cost            Time the application spent in the checkpoint.
+
+  The cost is the time the application was blocked by the checkpoint,
+  i.e. the Wt, Wr and Ps times reported by FTI_Checkpoint. dCP checkpoints
+  are not accounted, their cost depends on the amount of dirty data.
+
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_SchedRecordCost(FTIT_configuration* FTI_Conf,
+        FTIT_execution* FTI_Exec, FTIT_checkpoint* FTI_Ckpt, double cost) {
+    FTIT_schedInfo* sched = &FTI_Exec->sched;
+    int level = FTI_Exec->ckptMeta.level;
+
+    if (FTI_Conf->ckptSched != FTI_SCHED_ADAPTIVE || level < 1 || level > 4
+     || (level == 4 && FTI_Ckpt[4].isDcp)) {
+        return;
+    }
+    if (sched->cost[level] < 0) {
+        sched->cost[level] = cost;
+    } else {
+        sched->cost[level] = FTI_SCHED_WEIGHT * cost +
+         (1.0 - FTI_SCHED_WEIGHT) * sched->cost[level];
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It computes the optimal checkpoint interval.
+  @param      cost            Checkpoint cost in seconds.
+  @param      mtbf            Mean time between failures in seconds.
+  @return     double          Compute time between two checkpoints.
+
+  Daly's higher order estimate of the optimum checkpoint interval. It
+  extends Young's sqrt(2 * cost * mtbf) to costs that are not negligible
+  compared to the MTBF.
+
+ **/
+/*-------------------------------------------------------------------------*/
+double FTI_SchedInterval(double cost, double mtbf) {
+    if (cost <= 0) {
+        return 0;
+    }
+    if (cost >= 2 * mtbf) {
+        return mtbf;
+    }
+    double ratio = cost / (2 * mtbf);
+    return sqrt(2 * cost * mtbf) * (1 + sqrt(ratio) / 3 + ratio / 9) - cost;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It plans the checkpoint intervals of all levels.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Ckpt        Checkpoint metadata.
+  @return     integer         FTI_SCES if successful.
+
+  The MTBF of a level ('mtbf_lN') is the mean time between the failures
+  that destroy the checkpoints of the lower levels but not the ones of
+  this level. A level checkpoint also covers all lower level failures, so
+  its interval is computed from the cost it adds to the level below. The
+  interval is then rounded to a multiple of the lower level interval, every
+  n-th lower level checkpoint is promoted to this level. Levels without
+  MTBF keep the interval given by 'ckpt_lN', levels without measured cost
+  are taken at the next check. The costs of the slowest process are used,
+  so that all processes agree on the plan. This function is collective.
+
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_SchedPlan(FTIT_execution* FTI_Exec, FTIT_checkpoint* FTI_Ckpt) {
+    FTIT_schedInfo* sched = &FTI_Exec->sched;
+    char str[FTI_BUFS];
+    double cost[5], intv[5];
+    double tick = FTI_SCHED_MAX_TICK;
+    int i, prev = 0, changed = 0;
+
+    if (MPI_Allreduce(sched->cost + 1, cost + 1, 4, MPI_DOUBLE, MPI_MAX,
+     FTI_COMM_WORLD) != MPI_SUCCESS) {
+        FTI_Print("Could not exchange the checkpoint costs.", FTI_WARN);
+        return FTI_NSCS;
+    }
+
+    for (i = 1; i < 5; i++) {
+        if (FTI_Ckpt[i].mtbf <= 0) {
+            intv[i] = (FTI_Ckpt[i].ckptIntv > 0) ?
+             FTI_Ckpt[i].ckptIntv * 60.0 : -1;
+        } else if (cost[i] < 0) {
+            intv[i] = 0;
+        } else {
+            double delta = cost[i];
+            if (prev > 0 && cost[prev] >= 0) {
+                delta -= cost[prev];
+            }
+            intv[i] = FTI_SchedInterval(delta, FTI_Ckpt[i].mtbf * 60.0);
+            if (prev > 0 && intv[prev] > 0) {
+                double n = rint(intv[i] / intv[prev]);
+                intv[i] = intv[prev] * ((n > 1) ? n : 1);
+            }
+        }
+        if (intv[i] < 0) {
+            continue;
+        }
+        if (intv[i] / 2 < tick) {
+            tick = intv[i] / 2;
+        }
+        if (intv[i] != sched->intv[i]) {
+            changed = 1;
+        }
+        prev = i;
+    }
+    if (FTI_Ckpt[4].ckptDcpIntv > 0 && FTI_Ckpt[4].ckptDcpIntv * 30.0 < tick) {
+        tick = FTI_Ckpt[4].ckptDcpIntv * 30.0;
+    }
+    sched->tick = (tick > FTI_SCHED_MIN_TICK) ? tick : FTI_SCHED_MIN_TICK;
+
+    if (changed) {
+        int len = snprintf(str, FTI_BUFS, "Ckpt. plan:");
+        for (i = 1; i < 5; i++) {
+            if (intv[i] < 0) {
+                continue;
+            }
+            len += snprintf(str + len, FTI_BUFS - len, " L%d every %.1fs"
+             " (cost %.2fs),", i, intv[i], cost[i]);
+            if (len >= FTI_BUFS) {
+                break;
+            }
+        }
+        if (len < FTI_BUFS) {
+            snprintf(str + len, FTI_BUFS - len, " check every %.1fs.",
+             sched->tick);
+        }
+        FTI_Print(str, FTI_DBUG);
+    }
+    for (i = 1; i < 5; i++) {
+        sched->intv[i] = intv[i];
+    }
+    return FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It decides which level is checkpointed at the current check.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Ckpt        Checkpoint metadata.
+  @return     integer         Checkpoint level or -1 if none is due.
+
+  The compute time since the last check is added to the clock of every
+  level, using the global mean iteration time so that all processes take
+  the same decision. The highest level whose interval ends before the
+  next check is taken and the clocks of all levels it covers are reset. L4 dCP keeps
+  the interval given by 'dcp_l4' and has precedence over the levels 1 to
+  3, as in the fixed mode. The number of iterations until the next check
+  is adapted to the planned intervals. This function is collective.
+
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_SchedLevel(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
+        FTIT_checkpoint* FTI_Ckpt) {
+    FTIT_schedInfo* sched = &FTI_Exec->sched;
+    double elapsed = (FTI_Exec->ckptIcnt - sched->lastIcnt) *
+     FTI_Exec->globMeanIter;
+    int i, level = -1;
+
+    sched->lastIcnt = FTI_Exec->ckptIcnt;
+    if (FTI_SchedPlan(FTI_Exec, FTI_Ckpt) != FTI_SCES) {
+        return -1;
+    }
+
+    for (i = 1; i < 5; i++) {
+        sched->clock[i] += elapsed;
+        // take the level at the check closest to the end of its interval
+        if (sched->intv[i] >= 0 &&
+         sched->clock[i] + sched->tick / 2 >= sched->intv[i]) {
+            level = i;
+        }
+    }
+    sched->dcpClock += elapsed;
+    if (level != 4 && FTI_Ckpt[4].ckptDcpIntv > 0 &&
+     sched->dcpClock + sched->tick / 2 >= FTI_Ckpt[4].ckptDcpIntv * 60.0) {
+        // dCP level is level + 4
+        level = 8;
+    }
+    if (level != -1) {
+        int top = (level > 4) ? 4 : level;
+        for (i = 1; i <= top; i++) {
+            sched->clock[i] = 0;
+        }
+        if (top == 4) {
+            sched->dcpClock = 0;
+        }
+    }
+
+    if (FTI_Exec->globMeanIter > sched->tick) {
+        FTI_Exec->ckptIntv = 1;
+    } else if (FTI_Exec->globMeanIter > 0) {
+        FTI_Exec->ckptIntv = rint(sched->tick / FTI_Exec->globMeanIter);
+        FTI_Exec->ckptIntv = ceil((double)FTI_Exec->ckptIntv /
+         FTI_Exec->fastForward);
+    }
+    return level;
+}
@@ -0,0 +1,30 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  @file   scheduler.h
+ */
+
+#ifndef FTI_SRC_SCHEDULER_H_
+#define FTI_SRC_SCHEDULER_H_
+
+#include "interface.h"
+
+#define FTI_SCHED_FIXED 0
+#define FTI_SCHED_ADAPTIVE 1
+
+/** weight of the last measurement in the mean checkpoint cost            */
+#define FTI_SCHED_WEIGHT 0.5
+/** bounds of the time between two scheduling checks in seconds           */
+#define FTI_SCHED_MIN_TICK 1.0
+#define FTI_SCHED_MAX_TICK 60.0
+
+void FTI_SchedInit(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec);
+void FTI_SchedRecordCost(FTIT_configuration* FTI_Conf,
+        FTIT_execution* FTI_Exec, FTIT_checkpoint* FTI_Ckpt, double cost);
+double FTI_SchedInterval(double cost, double mtbf);
+int FTI_SchedPlan(FTIT_execution* FTI_Exec, FTIT_checkpoint* FTI_Ckpt);
+int FTI_SchedLevel(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
+        FTIT_checkpoint* FTI_Ckpt);
+
+#endif  // FTI_SRC_SCHEDULER_H_
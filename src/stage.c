@@ -48,10 +48,6 @@
  * @par
  * (2)  add flag to FTI_SendFile(..., FTI_SI_RM) that indicates if the
  * local file shall be deleted at success or failure.
- * @par
- * (3)  implement an interrupt for the staging process of the heads in
- * order to allow the heads to process the checkpoints as soon as
- * requested.
  **/
 
 /* @note 
@@ -99,7 +95,10 @@ static uint32_t *idxRequest;
  * request staging). However, the field is exposed to all the ranks on
  * the common node using a shared memory MPI window. Since the staging
  * is supposed to operate asynchronously, this allows the dedicated
- * process to set the proper status 'remotely'.     
+ * process to set the proper status 'remotely'. The window holds a second
+ * region of 'FTI_SI_MAX_NUM' 8 bit fields after the status fields, with
+ * the progress of the copy of 'ID' in percent at 'status[FTI_SI_MAX_NUM
+ * + ID]'.
  **/
 static uint8_t *status;
 
@@ -135,8 +134,9 @@ int FTI_InitStage(FTIT_execution *FTI_Exec, FTIT_configuration *FTI_Conf,
     MPI_Type_contiguous(2*FTI_BUFS + sizeof(int), MPI_BYTE, &buf_t);
     MPI_Type_commit(&buf_t);
 
-    // memory window size
-    size_t win_size = FTI_SI_MAX_NUM * sizeof(uint8_t) * !(FTI_Topo->amIaHead);
+    // memory window size (status and progress fields)
+    size_t win_size = 2 * FTI_SI_MAX_NUM * sizeof(uint8_t) *
+     !(FTI_Topo->amIaHead);
 
     // requestIdx array size
     size_t arr_size = FTI_SI_MAX_NUM * sizeof(uint32_t);
@@ -350,6 +350,8 @@ int FTI_InitStageRequestApp(FTIT_execution *FTI_Exec, FTIT_topology *FTI_Topo,
 
     FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_PEND, FTI_SIF_VAL,
      FTI_Topo->nodeRank);
+    FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, 0, FTI_SIF_PRG,
+     FTI_Topo->nodeRank);
     FTI_SetRequestField(ID, FTI_SI_IALL, FTI_SIF_ALL);
     FTI_SetRequestField(ID, idx, FTI_SIF_IDX);
 
@@ -400,8 +402,8 @@ int FTI_InitStageRequestHead(char* lpath, char *rpath,
 
     strncpy(FTI_SI_HPTR(si->request)[idx].lpath, lpath, FTI_BUFS);
     strncpy(FTI_SI_HPTR(si->request)[idx].rpath, rpath, FTI_BUFS);
-    FTI_SI_HPTR(si->request)[idx].offset = 0;
-    FTI_SI_HPTR(si->request)[idx].size = 0;
+    FTI_CopyStreamInit(&FTI_SI_HPTR(si->request)[idx].copy, -1, -1, 0);
+    FTI_SI_HPTR(si->request)[idx].res = FTI_SCES;
     FTI_SI_HPTR(si->request)[idx].ID = ID;
 
     FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_ACTV, FTI_SIF_VAL,
@@ -504,7 +506,7 @@ int FTI_FreeStageRequest(FTIT_execution *FTI_Exec, FTIT_topology *FTI_Topo,
         int idx;
         // locate idx, heads do not have a look-up table
         for (idx=0; idx < nbRequest; ++idx) {
-            if (ptr->ID == ID) {
+            if (ptr[idx].ID == ID) {
                 break;
             }
         }
@@ -577,51 +579,29 @@ int FTI_GetRequestIdx(int ID) {
 
 /*-------------------------------------------------------------------------*/
 /**
-  @brief      This function synchronously stages the local file to the PFS.
+  @brief      Opens the local and the remote file of a stage request.
   @param      string          'lpath', absolute path of local file
   @param      string          'rpath', absolute path of remote file
-  @param      FTI_Exec        Execution metadata.
-  @param      FTI_Topo        Topology metadata.
-  @param      FTI_Conf        Configuration metadata.
-  @param      integer         'ID' of staging request
-  @return     'FTI_SCES' on success, 'FTI_NSCS' else.  
+  @param      cs              Copy stream of the request.
+  @return     'FTI_SCES' on success, 'FTI_NSCS' else.
 
-  This function should be called only if the staging feature is enabled
-  without the head process being enabled. 
+  The local file must be a regular file and the directory of the remote
+  file must exist. The remote file is created or truncated, the copy
+  stream is then ready to copy the local file.
  **/
 /*-------------------------------------------------------------------------*/
-int FTI_SyncStage(char* lpath, char *rpath, FTIT_execution *FTI_Exec,
-        FTIT_topology *FTI_Topo, FTIT_configuration *FTI_Conf, uint32_t ID) {
-    if (!FTI_SI_ENABLED) {
-        FTI_Print("Staging disabled, invalid call to 'FTI_SyncStage'",
-         FTI_WARN);
-        return FTI_NSCS;
-    }
-
+static int FTI_StageOpen(char* lpath, char *rpath, FTIT_copyStream *cs) {
     char errstr[FTI_BUFS];
 
-    int source = FTI_Topo->nodeRank;
-
-    // for consistency
-    FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_ACTV, FTI_SIF_VAL,
-     source);
-
-    // set buffer size for the file data transfer
-    size_t bs = FTI_Conf->transferSize;
-
     // check local file and get file size
     struct stat st;
     if (stat(lpath, &st) == -1) {
-        FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL, FTI_SIF_VAL,
-         source);
         snprintf(errstr, FTI_BUFS,
-         "Could not stat the local file ('%s') for staging", lpath);
+         "Could not stat the local file ('%s') for staging.", lpath);
         FTI_Print(errstr, FTI_EROR);
         return FTI_NSCS;
     }
     if (!S_ISREG(st.st_mode)) {
-        FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL, FTI_SIF_VAL,
-         source);
         snprintf(errstr, FTI_BUFS,
          "'%s' is not a regular file, staging failed.", lpath);
         FTI_Print(errstr, FTI_EROR);
@@ -634,10 +614,8 @@ int FTI_SyncStage(char* lpath, char *rpath, FTIT_execution *FTI_Exec,
     // duplicate rpath (dirname modifies its argument!)
     char *dirc = strdup(rpath);
     if (dirc == NULL) {
-        FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL, FTI_SIF_VAL,
-         source);
-        FTI_Print("failed to allocate memory for 'dirc' in "
-            "'FTI_HandleStageRequest'", FTI_EROR);
+        FTI_Print("failed to allocate memory for 'dirc' "
+            "in 'FTI_StageOpen'", FTI_EROR);
         return FTI_NSCS;
     }
     char *dir_name = dirname(dirc);
@@ -645,28 +623,22 @@ int FTI_SyncStage(char* lpath, char *rpath, FTIT_execution *FTI_Exec,
     // check if remote directory exists
     if (stat(dir_name, &st) != 0) {
         if (errno == ENOENT) {
-            FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL,
-             FTI_SIF_VAL, source);
             snprintf(errstr, FTI_BUFS,
              "The directory '%s' does not exist, staging failed.", dir_name);
-            FTI_Print(errstr, FTI_EROR);
-            return FTI_NSCS;
         } else {
-            FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL,
-             FTI_SIF_VAL, source);
             snprintf(errstr, FTI_BUFS, "Failed to stat '%s', abort staging.",
              dir_name);
-            FTI_Print(errstr, FTI_EROR);
-            return FTI_NSCS;
         }
+        FTI_Print(errstr, FTI_EROR);
+        free(dirc);
+        return FTI_NSCS;
     }
     // check if it is indeed a directory
     if (!S_ISDIR(st.st_mode)) {
-        FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL, FTI_SIF_VAL,
-         source);
         snprintf(errstr, FTI_BUFS, "'%s' is not a directory, abort staging.",
          dir_name);
         FTI_Print(errstr, FTI_EROR);
+        free(dirc);
         return FTI_NSCS;
     }
 
@@ -681,72 +653,111 @@ int FTI_SyncStage(char* lpath, char *rpath, FTIT_execution *FTI_Exec,
             FTI_Print(warnstr, FTI_WARN);
         }
     }
+
     // open local file
     int fd_local = open(lpath, O_RDONLY);
     if (fd_local == -1) {
-        FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL, FTI_SIF_VAL,
-         source);
         FTI_Print("Could not open the local file for staging", FTI_EROR);
         return FTI_NSCS;
     }
     // open file on remote fs
-    int fd_global = open(rpath, O_WRONLY|O_CREAT, (mode_t) 0600);
+    int fd_global = open(rpath, O_WRONLY|O_CREAT|O_TRUNC, (mode_t) 0600);
     if (fd_global == -1) {
-        FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL, FTI_SIF_VAL,
-         source);
         FTI_Print("Could not open the destination file for staging", FTI_EROR);
         close(fd_local);
         return FTI_NSCS;
     }
-    // allocate buffer
-    char *buf = (char*) malloc(bs);
+    posix_fadvise(fd_local, 0, eof, POSIX_FADV_SEQUENTIAL);
+
+    FTI_CopyStreamInit(cs, fd_local, fd_global, eof);
+
+    return FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Closes the files of a stage request.
+  @param      cs              Copy stream of the request.
+  @param      bool            'sync', TRUE to flush the remote file.
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_StageClose(FTIT_copyStream *cs, bool sync) {
+    FTI_CopyStreamFree(cs);
+    close(cs->sfd);
+    if (sync) {
+        fsync(cs->dfd);
+    }
+    close(cs->dfd);
+    cs->sfd = -1;
+    cs->dfd = -1;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Returns the progress of a stage request in percent.
+  @param      cs              Copy stream of the request.
+  @return     Copied part of the file in percent.
+ **/
+/*-------------------------------------------------------------------------*/
+static uint8_t FTI_StageProgress(FTIT_copyStream *cs) {
+    return (cs->size > 0) ? (uint8_t)((100 * cs->pos) / cs->size) : 100;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      This function synchronously stages the local file to the PFS.
+  @param      string          'lpath', absolute path of local file
+  @param      string          'rpath', absolute path of remote file
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+  @param      FTI_Conf        Configuration metadata.
+  @param      integer         'ID' of staging request
+  @return     'FTI_SCES' on success, 'FTI_NSCS' else.  
+
+  This function should be called only if the staging feature is enabled
+  without the head process being enabled. 
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_SyncStage(char* lpath, char *rpath, FTIT_execution *FTI_Exec,
+        FTIT_topology *FTI_Topo, FTIT_configuration *FTI_Conf, uint32_t ID) {
+    if (!FTI_SI_ENABLED) {
+        FTI_Print("Staging disabled, invalid call to 'FTI_SyncStage'",
+         FTI_WARN);
+        return FTI_NSCS;
+    }
+
+    char errstr[FTI_BUFS];
+
+    int source = FTI_Topo->nodeRank;
+
+    // for consistency
+    FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_ACTV, FTI_SIF_VAL,
+     source);
+
+    FTIT_copyStream cs;
+    if (FTI_StageOpen(lpath, rpath, &cs) != FTI_SCES) {
+        FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL, FTI_SIF_VAL,
+         source);
+        return FTI_NSCS;
+    }
 
     // move file to destination
-    off_t pos = 0;
-    ssize_t read_bytes, write_bytes;
-    size_t buf_bytes;
-    while (pos < eof) {
-        buf_bytes = ((eof - pos) < bs) ? eof - pos : bs;
-        // for the case we have written less then we have read
-        if (lseek(fd_local, pos, SEEK_SET) == -1) {
-            snprintf(errstr, FTI_BUFS, "unable to seek in '%s'.", lpath);
-            FTI_Print(errstr, FTI_EROR);
-            errno = 0;
-            free(buf);
-            close(fd_local);
-            close(fd_global);
-            return FTI_NSCS;
-        }
-        if ((read_bytes = read(fd_local, buf, buf_bytes)) == -1) {
+    while (cs.pos < cs.size) {
+        if (FTI_CopyStep(FTI_Conf, &cs) != FTI_SCES) {
             FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL,
              FTI_SIF_VAL, source);
-            snprintf(errstr, FTI_BUFS, "unable to read from '%s'.", lpath);
+            snprintf(errstr, FTI_BUFS, "unable to stage '%s' to '%s'.", lpath,
+             rpath);
             FTI_Print(errstr, FTI_EROR);
             errno = 0;
-            free(buf);
-            close(fd_local);
-            close(fd_global);
+            FTI_StageClose(&cs, false);
             return FTI_NSCS;
         }
-        if ((write_bytes = write(fd_global, buf, read_bytes)) == -1) {
-            FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL,
-             FTI_SIF_VAL, source);
-            snprintf(errstr, FTI_BUFS, "unable to write to '%s'.", rpath);
-            FTI_Print(errstr, FTI_EROR);
-            errno = 0;
-            free(buf);
-            close(fd_local);
-            close(fd_global);
-            return FTI_NSCS;
-        }
-        pos += write_bytes;
+        FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_StageProgress(&cs),
+         FTI_SIF_PRG, source);
     }
 
-    // deallocate buffer and close file descriptors
-    free(buf);
-    close(fd_local);
-    fsync(fd_global);
-    close(fd_global);
+    FTI_StageClose(&cs, true);
 
     if (remove(lpath) == -1) {
         snprintf(errstr, FTI_BUFS, "Could not remove local file '%s'.", lpath);
@@ -755,6 +766,7 @@ int FTI_SyncStage(char* lpath, char *rpath, FTIT_execution *FTI_Exec,
         return FTI_NSCS;
     }
 
+    FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, 100, FTI_SIF_PRG, source);
     FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_SCES, FTI_SIF_VAL,
      source);
 
@@ -816,14 +828,16 @@ int FTI_AsyncStage(char *lpath, char *rpath, FTIT_configuration *FTI_Conf,
 
 /*-------------------------------------------------------------------------*/
 /**            
-  @brief      This function asynchronously stages the local file to the PFS.
-  @param      string          'lpath', absolute path of local file.
-  @param      string          'rpath', absolute path of remote file.
+  @brief      This function queues a stage request on the head.
+  @param      FTI_Conf        Configuration metadata.
   @param      FTI_Exec        Execution metadata.
   @param      FTI_Topo        Topology metadata.
-  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Ckpt        Checkpoint metadata.
   @param      integer         'source', application rank of stage request.
   @return     'FTI_SCES' on success, 'FTI_NSCS' else.  
+
+  The files of the request are opened and the request becomes active, the
+  file is then copied chunk by chunk by 'FTI_ProgressStage'.
  **/
 /*-------------------------------------------------------------------------*/
 int FTI_HandleStageRequest(FTIT_configuration* FTI_Conf,
@@ -835,8 +849,6 @@ int FTI_HandleStageRequest(FTIT_configuration* FTI_Conf,
         return FTI_NSCS;
     }
 
-    char errstr[FTI_BUFS];
-
     size_t buf_ser_size = 2*FTI_BUFS + sizeof(int);
     void *buf_ser = malloc(buf_ser_size);
     if (buf_ser == NULL) {
@@ -869,177 +881,128 @@ int FTI_HandleStageRequest(FTIT_configuration* FTI_Conf,
         return FTI_NSCS;
     }
 
-    // set buffer size for the file data transfer
-    size_t bs = FTI_Conf->transferSize;
-
-    // check local file and get file size
-    struct stat st;
-    if (stat(lpath, &st) == -1) {
-        FTI_FreeStageRequest(FTI_Exec, FTI_Topo, ID, source);
-        FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL, FTI_SIF_VAL,
-         source);
-        snprintf(errstr, FTI_BUFS,
-         "Could not stat the local file ('%s') for staging.", lpath);
-        FTI_Print(errstr, FTI_EROR);
-         return FTI_NSCS;
-    }
-    if (!S_ISREG(st.st_mode)) {
-        FTI_FreeStageRequest(FTI_Exec, FTI_Topo, ID, source);
-        FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL, FTI_SIF_VAL,
-         source);
-        snprintf(errstr, FTI_BUFS,
-         "'%s' is not a regular file, staging failed.", lpath);
-        FTI_Print(errstr, FTI_EROR);
-        return FTI_NSCS;
-    }
-
-    off_t eof = st.st_size;
-
-    // duplicate rpath (dirname modifies its argument!)
-    char *dirc = strdup(rpath);
-    if (dirc == NULL) {
+    FTIT_StageInfo *si = &(FTI_Exec->stageInfo[source-1]);
+    FTIT_StageHeadInfo *req = &(FTI_SI_HPTR(si->request)[si->nbRequest-1]);
+    if (FTI_StageOpen(lpath, rpath, &req->copy) != FTI_SCES) {
         FTI_FreeStageRequest(FTI_Exec, FTI_Topo, ID, source);
         FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL, FTI_SIF_VAL,
          source);
-        FTI_Print("failed to allocate memory for 'dirc' "
-            "in 'FTI_HandleStageRequest'", FTI_EROR);
         return FTI_NSCS;
     }
-    char *dir_name = dirname(dirc);
 
-    // check if remote directory exists
-    if (stat(dir_name, &st) != 0) {
-        if (errno == ENOENT) {
-            FTI_FreeStageRequest(FTI_Exec, FTI_Topo, ID, source);
-            FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL,
-             FTI_SIF_VAL, source);
-            snprintf(errstr, FTI_BUFS,
-             "The directory '%s' does not exist, staging failed.", dir_name);
-            FTI_Print(errstr, FTI_EROR);
-            return FTI_NSCS;
-        } else {
-            FTI_FreeStageRequest(FTI_Exec, FTI_Topo, ID, source);
-            FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL,
-                FTI_SIF_VAL, source);
-            snprintf(errstr, FTI_BUFS, "Failed to stat '%s', abort staging.",
-             dir_name);
-            FTI_Print(errstr, FTI_EROR);
-            return FTI_NSCS;
-        }
-    }
-    // check if it is indeed a directory
-    if (!S_ISDIR(st.st_mode)) {
-        FTI_FreeStageRequest(FTI_Exec, FTI_Topo, ID, source);
-        FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL, FTI_SIF_VAL,
-         source);
-        snprintf(errstr, FTI_BUFS, "'%s' is not a directory, abort staging.",
-         dir_name);
-        FTI_Print(errstr, FTI_EROR);
-        return FTI_NSCS;
-    }
+    return FTI_SCES;
+}
 
-    free(dirc);
+/** Stage requests copied in one round of 'FTI_ProgressStage'. */
+typedef struct FTIT_stageJob {
+    FTIT_configuration* FTI_Conf;   /**< Configuration metadata.        */
+    FTIT_StageHeadInfo** req;       /**< Requests of the round.         */
+} FTIT_stageJob;
 
-    // check if remote file already exist
-    if (stat(rpath, &st) == 0) {
-        if (S_ISREG(st.st_mode)) {
-            char warnstr[FTI_BUFS];
-            snprintf(warnstr, FTI_BUFS,
-             "remote file '%s' already exists, attempt to overwrite.", rpath);
-            FTI_Print(warnstr, FTI_WARN);
-        }
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Copies the next chunk of the requests of [first,last).
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_StageCopyJob(void* ctx, int64_t first, int64_t last) {
+    FTIT_stageJob* job = (FTIT_stageJob*) ctx;
+    int64_t k;
+    for (k = first; k < last; k++) {
+        job->req[k]->res = FTI_CopyStep(job->FTI_Conf, &job->req[k]->copy);
     }
+}
 
+/*-------------------------------------------------------------------------*/
+/**            
+  @brief      Copies the next chunk of the active stage requests.
+  @param      FTI_Conf        Configuration metadata.
+  @param      FTI_Exec        Execution metadata.
+  @param      FTI_Topo        Topology metadata.
+  @return     Number of stage requests still active.
 
-    // open local file
-    int fd_local = open(lpath, O_RDONLY);
-    if (fd_local == -1) {
-        FTI_FreeStageRequest(FTI_Exec, FTI_Topo, ID, source);
-        FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL, FTI_SIF_VAL,
-         source);
-        FTI_Print("Could not open the local file for staging", FTI_EROR);
-        return FTI_NSCS;
-    }
-    // open file on remote fs
-    int fd_global = open(rpath, O_WRONLY|O_CREAT, (mode_t) 0600);
-    if (fd_global == -1) {
-        FTI_FreeStageRequest(FTI_Exec, FTI_Topo, ID, source);
-        FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL, FTI_SIF_VAL,
-         source);
-        FTI_Print("Could not open the destination file for staging", FTI_EROR);
-        close(fd_local);
-        return FTI_NSCS;
+  Up to 'head_threads' requests copy one chunk of 'transfer_size' bytes
+  each, in parallel on the worker pool of the head. The requests are
+  served in turn and a request is completed once its last chunk is
+  copied. The head calls this function between the probes for new
+  messages, so that a checkpoint request waits for one chunk at most.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_ProgressStage(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
+        FTIT_topology* FTI_Topo) {
+    // first request of the next round
+    static int next = 0;
+
+    char str[FTI_BUFS];
+    int nbActive = 0, i, j, k;
+    for (i = 0; i < FTI_Topo->nbApprocs; i++) {
+        nbActive += FTI_Exec->stageInfo[i].nbRequest;
     }
-    // allocate buffer
-    char *buf = (char*)malloc(bs);
-    if (buf == NULL) {
-        close(fd_local);
-        close(fd_global);
-        FTI_FreeStageRequest(FTI_Exec, FTI_Topo, ID, source);
-        FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL, FTI_SIF_VAL,
-         source);
-        FTI_Print("failed to allocate memory for 'buf' in"
-        " 'FTI_HandleStageRequest'", FTI_EROR);
-        return FTI_NSCS;
+    if (nbActive == 0) {
+        return 0;
     }
 
-    // move file to destination
-    off_t pos = 0;
-    ssize_t read_bytes, write_bytes;
-    size_t buf_bytes;
-    while (pos < eof) {
-        buf_bytes = ((eof - pos) < bs) ? eof - pos : bs;
-        // for the case we have written less then we have read
-        if (lseek(fd_local, pos, SEEK_SET) == -1) {
-            FTI_FreeStageRequest(FTI_Exec, FTI_Topo, ID, source);
-            FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL,
-             FTI_SIF_VAL, source);
-            snprintf(errstr, FTI_BUFS, "unable to seek in '%s'.", lpath);
-            FTI_Print(errstr, FTI_EROR);
-            errno = 0;
-            free(buf);
-            close(fd_local);
-            close(fd_global);
-            return FTI_NSCS;
-        }
-        if ((read_bytes = read(fd_local, buf, buf_bytes)) == -1) {
-            FTI_FreeStageRequest(FTI_Exec, FTI_Topo, ID, source);
-            FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL,
-             FTI_SIF_VAL, source);
-            snprintf(errstr, FTI_BUFS, "unable to read from '%s'.", lpath);
-            FTI_Print(errstr, FTI_EROR);
-            errno = 0;
-            free(buf);
-            close(fd_local);
-            close(fd_global);
-            return FTI_NSCS;
+    int nbStreams = (FTI_Conf->headThreads < nbActive) ?
+        FTI_Conf->headThreads : nbActive;
+    FTIT_StageHeadInfo** req = talloc(FTIT_StageHeadInfo*, nbStreams);
+    int* source = talloc(int, nbStreams);
+
+    // the requests are numbered rank after rank
+    next %= nbActive;
+    for (k = 0; k < nbStreams; k++) {
+        int n = (next + k) % nbActive;
+        for (i = 0; n >= FTI_Exec->stageInfo[i].nbRequest; i++) {
+            n -= FTI_Exec->stageInfo[i].nbRequest;
         }
-        if ((write_bytes = write(fd_global, buf, read_bytes)) == -1) {
-            FTI_FreeStageRequest(FTI_Exec, FTI_Topo, ID, source);
-            FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_FAIL,
-             FTI_SIF_VAL, source);
-            snprintf(errstr, FTI_BUFS, "unable to write to '%s'.", rpath);
-            FTI_Print(errstr, FTI_EROR);
-            errno = 0;
-            free(buf);
-            close(fd_local);
-            close(fd_global);
-            return FTI_NSCS;
+        req[k] = &(FTI_SI_HPTR(FTI_Exec->stageInfo[i].request)[n]);
+        source[k] = i + 1;
+    }
+
+    FTIT_stageJob job;
+    job.FTI_Conf = FTI_Conf;
+    job.req = req;
+    FTI_HashParallel(FTI_StageCopyJob, &job, nbStreams, FTI_POOL_HEAD);
+
+    // freeing a request moves the others, the IDs are kept instead
+    int* done = talloc(int, nbStreams);
+    int nbDone = 0;
+    for (k = 0; k < nbStreams; k++) {
+        FTIT_StageHeadInfo *r = req[k];
+        if (r->res != FTI_SCES) {
+            snprintf(str, FTI_BUFS, "unable to stage '%s' to '%s'.",
+             r->lpath, r->rpath);
+            FTI_Print(str, FTI_EROR);
+            FTI_StageClose(&r->copy, false);
+            FTI_SetStatusField(FTI_Exec, FTI_Topo, r->ID, FTI_SI_FAIL,
+             FTI_SIF_VAL, source[k]);
+        } else if (r->copy.pos == r->copy.size) {
+            FTI_StageClose(&r->copy, true);
+            FTI_SetStatusField(FTI_Exec, FTI_Topo, r->ID, 100, FTI_SIF_PRG,
+             source[k]);
+            FTI_SetStatusField(FTI_Exec, FTI_Topo, r->ID, FTI_SI_SCES,
+             FTI_SIF_VAL, source[k]);
+            snprintf(str, FTI_BUFS, "Staged '%s' (%ld bytes).", r->rpath,
+             r->copy.size);
+            FTI_Print(str, FTI_DBUG);
+        } else {
+            FTI_SetStatusField(FTI_Exec, FTI_Topo, r->ID,
+             FTI_StageProgress(&r->copy), FTI_SIF_PRG, source[k]);
+            continue;
         }
-        pos += write_bytes;
+        source[nbDone] = source[k];
+        done[nbDone++] = r->ID;
+    }
+    for (j = 0; j < nbDone; j++) {
+        FTI_FreeStageRequest(FTI_Exec, FTI_Topo, done[j], source[j]);
     }
 
-    // deallocate buffer and close file descriptors
-    free(buf);
-    close(fd_local);
-    fsync(fd_global);
-    close(fd_global);
+    // the completed requests were served in this round
+    next += nbStreams - nbDone;
 
-    FTI_SetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SI_SCES, FTI_SIF_VAL,
-     source);
-    FTI_FreeStageRequest(FTI_Exec, FTI_Topo, ID, source);
+    free(done);
+    free(source);
+    free(req);
 
-    return FTI_SCES;
+    return nbActive - nbDone;
 }
 
 /*-------------------------------------------------------------------------*/
@@ -1157,7 +1120,7 @@ int FTI_GetStatusField(FTIT_execution *FTI_Exec, FTIT_topology *FTI_Topo,
         return FTI_NSCS;
     }
 
-    if ((val < 0) || (val > FTI_SIF_VAL)) {
+    if ((val < 0) || (val > FTI_SIF_PRG)) {
         FTI_Print("invalid argument for 'FTI_GetStatusField'", FTI_WARN);
         return FTI_NSCS;
     }
@@ -1170,7 +1133,7 @@ int FTI_GetStatusField(FTIT_execution *FTI_Exec, FTIT_topology *FTI_Topo,
     MPI_Win_shared_query(stageWin, source, &size, &disp, &(status));
     uint8_t status_cpy = status[ID];
 
-    int query;
+    int query = 0;
 
     switch (val) {
         case FTI_SIF_VAL:
@@ -1179,6 +1142,9 @@ int FTI_GetStatusField(FTIT_execution *FTI_Exec, FTIT_topology *FTI_Topo,
         case FTI_SIF_AVL:
             query = ((int)(status_cpy & avl_mask));
             break;
+        case FTI_SIF_PRG:
+            query = (int)status[FTI_SI_MAX_NUM + ID];
+            break;
     }
 
     return query;
@@ -1204,7 +1170,7 @@ int FTI_SetStatusField(FTIT_execution *FTI_Exec, FTIT_topology *FTI_Topo,
         return FTI_NSCS;
     }
 
-    if ((val < 0) || (val > FTI_SIF_VAL)) {
+    if ((val < 0) || (val > FTI_SIF_PRG)) {
         FTI_Print("invalid argument for 'FTI_GetStatusField'", FTI_WARN);
         return FTI_NSCS;
     }
@@ -1238,6 +1204,16 @@ int FTI_SetStatusField(FTIT_execution *FTI_Exec, FTIT_topology *FTI_Topo,
             }
             status_cpy = entry | ((~avl_mask) & status_cpy);
             break;
+        case FTI_SIF_PRG:
+            if (entry > 100) {
+                FTI_Print("invalid argument for 'FTI_SetStatusField'",
+                 FTI_WARN);
+                ierr = FTI_NSCS;
+                break;
+            }
+            // the progress has its own field
+            status[FTI_SI_MAX_NUM + ID] = entry;
+            return ierr;
     }
 
     if (ierr == FTI_SCES) {
@@ -1345,7 +1321,11 @@ void FTI_PrintStageStatus(FTIT_execution *FTI_Exec, FTIT_topology *FTI_Topo,
             snprintf(valstr, FTI_BUFS, "not valid ('%d')", val);
     }
 
-    printf("[rank(g|l):%d|%d][ID:%d] status is 'avl:%s', 'idx:%s', 'val:%s'\n",
-     FTI_Topo->myRank, FTI_Topo->nodeRank, ID, avlstr, idxstr, valstr);
+    // get progress value
+    val = FTI_GetStatusField(FTI_Exec, FTI_Topo, ID, FTI_SIF_PRG, source);
+
+    printf("[rank(g|l):%d|%d][ID:%d] status is 'avl:%s', 'idx:%s', 'val:%s',"
+     " 'prg:%d%%'\n", FTI_Topo->myRank, FTI_Topo->nodeRank, ID, avlstr,
+     idxstr, valstr, val);
 }
 
@@ -45,7 +45,7 @@
 #include "interface.h"
 
 /** Maximum amount of concurrent active staging requests                   
-  @note leads to 2.5MB for the application processes as minimum memory
+  @note leads to 3MB for the application processes as minimum memory
   allocated
  **/
 #define FTI_SI_MAX_NUM (512L*1024L)
@@ -74,6 +74,7 @@
 typedef enum {
     FTI_SIF_AVL = 0,
     FTI_SIF_VAL,
+    FTI_SIF_PRG,
 } FTIT_StatusField;
 
 /** @typedef    FTIT_RequestField
@@ -93,8 +94,8 @@ typedef enum {
 typedef struct FTIT_StageHeadInfo {
     char lpath[FTI_BUFS];           /**< file path                      */
     char rpath[FTI_BUFS];           /**< file name                      */
-    size_t offset;                  /**< current offset of file pointer */
-    size_t size;                    /**< file size                      */
+    FTIT_copyStream copy;           /**< progress of the file copy      */
+    int res;                        /**< result of the last chunk copy  */
     int ID;                         /**< ID of request                  */
 } FTIT_StageHeadInfo;
 
@@ -122,6 +123,8 @@ int FTI_SyncStage(char* lpath, char *rpath, FTIT_execution *FTI_Exec,
 int FTI_HandleStageRequest(FTIT_configuration* FTI_Conf,
         FTIT_execution* FTI_Exec, FTIT_topology* FTI_Topo,
         FTIT_checkpoint* FTI_Ckpt, int source);
+int FTI_ProgressStage(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
+        FTIT_topology* FTI_Topo);
 int FTI_GetStatusField(FTIT_execution *FTI_Exec, FTIT_topology *FTI_Topo,
  int ID, FTIT_StatusField val, int source);
 int FTI_SetStatusField(FTIT_execution *FTI_Exec, FTIT_topology *FTI_Topo,
@@ -357,6 +357,13 @@ int FTI_CreateComms(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
         }
     }
     MPI_Comm_rank(FTI_COMM_WORLD, &FTI_Topo->splitRank);
+    // Consecutive application ranks share an aggregated L4 file
+    FTI_Exec->aggComm = MPI_COMM_NULL;
+    if (!FTI_Topo->amIaHead && FTI_Conf->l4Aggregation > 1) {
+        MPI_Comm_split(FTI_COMM_WORLD,
+         FTI_Topo->splitRank / FTI_Conf->l4Aggregation, FTI_Topo->splitRank,
+         &FTI_Exec->aggComm);
+    }
     int buf = FTI_Topo->sectorID * FTI_Topo->groupSize;
     int group[FTI_BUFS];  // FTI_BUFS > Max. group size
     int i;
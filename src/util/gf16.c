@@ -0,0 +1,371 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  FTI - A multi-level checkpointing library for C/C++/Fortran applications
+ *
+ *  Revision 1.0 : Fault Tolerance Interface (FTI)
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *  list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors
+ *  may be used to endorse or promote products derived from this software without
+ *  specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  @file   gf16.c
+ *  @date   October, 2026
+ *  @brief  GF(2^16) region kernels for the L3 Reed-Solomon coding.
+ *
+ *  The region multiplication uses the split-table method: a 16 bit word is
+ *  cut into four nibbles, and c * w is the XOR of four 16-entry table
+ *  lookups. With SSSE3/AVX2 the lookups are PSHUFB instructions working
+ *  on 16/32 words at a time. The kernel is selected at run time, so the
+ *  library stays usable on CPUs without these extensions. The field and
+ *  word layout are the ones of jerasure (w = 16, native byte order), thus
+ *  the encoded data can be decoded with jerasure as before.
+ */
+
+#include "../interface.h"
+#include "gf16.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#   include <immintrin.h>
+#   define FTI_GF16_X86
+#endif
+
+typedef size_t (*FTIT_gf16Kernel)(const FTIT_gf16Table*, const uint8_t*,
+ uint8_t*, size_t, int);
+typedef size_t (*FTIT_gfXorKernel)(const uint8_t*, uint8_t*, size_t);
+
+static pthread_once_t gf16Once = PTHREAD_ONCE_INIT;
+static FTIT_gf16Kernel gf16Kernel = NULL;
+static FTIT_gfXorKernel gfXorKernel = NULL;
+static const char* gf16KernelName = "scalar";
+
+#ifdef FTI_GF16_X86
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      SSSE3 split-table region multiplication (32 bytes per step).
+  @param      t               Tables of the constant.
+  @param      src             Source region.
+  @param      dst             Destination region.
+  @param      n               Number of bytes.
+  @param      add             If not 0, the product is XORed into dst.
+  @return     size_t          Number of bytes processed.
+ **/
+/*-------------------------------------------------------------------------*/
+__attribute__((target("ssse3")))
+static size_t FTI_Gf16MulSsse3(const FTIT_gf16Table* t, const uint8_t* src,
+ uint8_t* dst, size_t n, int add) {
+    __m128i tlo[4], thi[4];
+    int i;
+    for (i = 0; i < 4; i++) {
+        tlo[i] = _mm_load_si128((const __m128i*) t->lo[i]);
+        thi[i] = _mm_load_si128((const __m128i*) t->hi[i]);
+    }
+    const __m128i nib = _mm_set1_epi8(0x0f);
+    const __m128i low = _mm_set1_epi16(0x00ff);
+    size_t done;
+    for (done = 0; done + 32 <= n; done += 32) {
+        __m128i v0 = _mm_loadu_si128((const __m128i*)(src + done));
+        __m128i v1 = _mm_loadu_si128((const __m128i*)(src + done + 16));
+        // separate low and high bytes of the 16 words
+        __m128i l = _mm_packus_epi16(_mm_and_si128(v0, low),
+         _mm_and_si128(v1, low));
+        __m128i h = _mm_packus_epi16(_mm_srli_epi16(v0, 8),
+         _mm_srli_epi16(v1, 8));
+        __m128i n0 = _mm_and_si128(l, nib);
+        __m128i n1 = _mm_and_si128(_mm_srli_epi16(l, 4), nib);
+        __m128i n2 = _mm_and_si128(h, nib);
+        __m128i n3 = _mm_and_si128(_mm_srli_epi16(h, 4), nib);
+        __m128i rl = _mm_xor_si128(
+         _mm_xor_si128(_mm_shuffle_epi8(tlo[0], n0),
+          _mm_shuffle_epi8(tlo[1], n1)),
+         _mm_xor_si128(_mm_shuffle_epi8(tlo[2], n2),
+          _mm_shuffle_epi8(tlo[3], n3)));
+        __m128i rh = _mm_xor_si128(
+         _mm_xor_si128(_mm_shuffle_epi8(thi[0], n0),
+          _mm_shuffle_epi8(thi[1], n1)),
+         _mm_xor_si128(_mm_shuffle_epi8(thi[2], n2),
+          _mm_shuffle_epi8(thi[3], n3)));
+        // interleave the bytes back into words
+        __m128i o0 = _mm_unpacklo_epi8(rl, rh);
+        __m128i o1 = _mm_unpackhi_epi8(rl, rh);
+        if (add) {
+            o0 = _mm_xor_si128(o0,
+             _mm_loadu_si128((const __m128i*)(dst + done)));
+            o1 = _mm_xor_si128(o1,
+             _mm_loadu_si128((const __m128i*)(dst + done + 16)));
+        }
+        _mm_storeu_si128((__m128i*)(dst + done), o0);
+        _mm_storeu_si128((__m128i*)(dst + done + 16), o1);
+    }
+    return done;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      AVX2 split-table region multiplication (64 bytes per step).
+  @param      t               Tables of the constant.
+  @param      src             Source region.
+  @param      dst             Destination region.
+  @param      n               Number of bytes.
+  @param      add             If not 0, the product is XORed into dst.
+  @return     size_t          Number of bytes processed.
+
+  Pack and unpack work on each 128 bit lane separately, which keeps the
+  words of both lanes in order.
+ **/
+/*-------------------------------------------------------------------------*/
+__attribute__((target("avx2")))
+static size_t FTI_Gf16MulAvx2(const FTIT_gf16Table* t, const uint8_t* src,
+ uint8_t* dst, size_t n, int add) {
+    __m256i tlo[4], thi[4];
+    int i;
+    for (i = 0; i < 4; i++) {
+        tlo[i] = _mm256_broadcastsi128_si256(
+         _mm_load_si128((const __m128i*) t->lo[i]));
+        thi[i] = _mm256_broadcastsi128_si256(
+         _mm_load_si128((const __m128i*) t->hi[i]));
+    }
+    const __m256i nib = _mm256_set1_epi8(0x0f);
+    const __m256i low = _mm256_set1_epi16(0x00ff);
+    size_t done;
+    for (done = 0; done + 64 <= n; done += 64) {
+        __m256i v0 = _mm256_loadu_si256((const __m256i*)(src + done));
+        __m256i v1 = _mm256_loadu_si256((const __m256i*)(src + done + 32));
+        __m256i l = _mm256_packus_epi16(_mm256_and_si256(v0, low),
+         _mm256_and_si256(v1, low));
+        __m256i h = _mm256_packus_epi16(_mm256_srli_epi16(v0, 8),
+         _mm256_srli_epi16(v1, 8));
+        __m256i n0 = _mm256_and_si256(l, nib);
+        __m256i n1 = _mm256_and_si256(_mm256_srli_epi16(l, 4), nib);
+        __m256i n2 = _mm256_and_si256(h, nib);
+        __m256i n3 = _mm256_and_si256(_mm256_srli_epi16(h, 4), nib);
+        __m256i rl = _mm256_xor_si256(
+         _mm256_xor_si256(_mm256_shuffle_epi8(tlo[0], n0),
+          _mm256_shuffle_epi8(tlo[1], n1)),
+         _mm256_xor_si256(_mm256_shuffle_epi8(tlo[2], n2),
+          _mm256_shuffle_epi8(tlo[3], n3)));
+        __m256i rh = _mm256_xor_si256(
+         _mm256_xor_si256(_mm256_shuffle_epi8(thi[0], n0),
+          _mm256_shuffle_epi8(thi[1], n1)),
+         _mm256_xor_si256(_mm256_shuffle_epi8(thi[2], n2),
+          _mm256_shuffle_epi8(thi[3], n3)));
+        __m256i o0 = _mm256_unpacklo_epi8(rl, rh);
+        __m256i o1 = _mm256_unpackhi_epi8(rl, rh);
+        if (add) {
+            o0 = _mm256_xor_si256(o0,
+             _mm256_loadu_si256((const __m256i*)(dst + done)));
+            o1 = _mm256_xor_si256(o1,
+             _mm256_loadu_si256((const __m256i*)(dst + done + 32)));
+        }
+        _mm256_storeu_si256((__m256i*)(dst + done), o0);
+        _mm256_storeu_si256((__m256i*)(dst + done + 32), o1);
+    }
+    return done;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      AVX2 region XOR (32 bytes per step).
+  @param      src             Source region.
+  @param      dst             Destination region (dst ^= src).
+  @param      n               Number of bytes.
+  @return     size_t          Number of bytes processed.
+ **/
+/*-------------------------------------------------------------------------*/
+__attribute__((target("avx2")))
+static size_t FTI_GfXorAvx2(const uint8_t* src, uint8_t* dst, size_t n) {
+    size_t done;
+    for (done = 0; done + 32 <= n; done += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(src + done));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(dst + done));
+        _mm256_storeu_si256((__m256i*)(dst + done), _mm256_xor_si256(a, b));
+    }
+    return done;
+}
+#endif
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Region XOR on 64 bit words.
+  @param      src             Source region.
+  @param      dst             Destination region (dst ^= src).
+  @param      n               Number of bytes.
+  @return     size_t          Number of bytes processed.
+ **/
+/*-------------------------------------------------------------------------*/
+static size_t FTI_GfXorWords(const uint8_t* src, uint8_t* dst, size_t n) {
+    size_t done;
+    for (done = 0; done + 8 <= n; done += 8) {
+        uint64_t a, b;
+        memcpy(&a, src + done, 8);
+        memcpy(&b, dst + done, 8);
+        b ^= a;
+        memcpy(dst + done, &b, 8);
+    }
+    return done;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Selects the fastest kernels supported by the CPU.
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_InitGf16() {
+    gfXorKernel = FTI_GfXorWords;
+#ifdef FTI_GF16_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        gf16Kernel = FTI_Gf16MulAvx2;
+        gfXorKernel = FTI_GfXorAvx2;
+        gf16KernelName = "avx2";
+    } else if (__builtin_cpu_supports("ssse3")) {
+        gf16Kernel = FTI_Gf16MulSsse3;
+        gf16KernelName = "ssse3";
+    }
+#endif
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Builds the split multiplication tables of a constant.
+  @param      table           Tables to fill.
+  @param      multby          The GF(2^16) constant.
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_Gf16InitTable(FTIT_gf16Table* table, int multby) {
+    int i, x;
+    for (i = 0; i < 4; i++) {
+        for (x = 0; x < 16; x++) {
+            int p = galois_single_multiply(x << (4 * i), multby, 16);
+            table->full[i][x] = (uint16_t) p;
+            table->lo[i][x] = (uint8_t)(p & 0xff);
+            table->hi[i][x] = (uint8_t)(p >> 8);
+        }
+    }
+    table->multby = multby;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Multiplies a region of 16 bit words by a constant.
+  @param      table           Tables of the constant (FTI_Gf16InitTable).
+  @param      src             Source region.
+  @param      dest            Destination region.
+  @param      nBytes          Number of bytes (multiple of 2).
+  @param      add             If not 0, the product is XORed into dest.
+
+  Same result as galois_w16_region_multiply(src, multby, nBytes, dest, add).
+  Constants 0 and 1 are handled without multiplication.
+
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_Gf16RegionMultiply(const FTIT_gf16Table* table, const char* src,
+ char* dest, size_t nBytes, int add) {
+    if (table->multby == 1) {
+        if (add) {
+            FTI_GfRegionXor(src, dest, nBytes);
+        } else {
+            memcpy(dest, src, nBytes);
+        }
+        return;
+    }
+    if (table->multby == 0) {
+        if (!add) {
+            memset(dest, 0, nBytes);
+        }
+        return;
+    }
+    pthread_once(&gf16Once, FTI_InitGf16);
+    const uint8_t* s = (const uint8_t*) src;
+    uint8_t* d = (uint8_t*) dest;
+    size_t done = 0;
+    if (gf16Kernel != NULL) {
+        done = gf16Kernel(table, s, d, nBytes, add);
+    }
+    for (; done + 2 <= nBytes; done += 2) {
+        uint16_t w, p;
+        memcpy(&w, s + done, 2);
+        p = table->full[0][w & 0xf] ^ table->full[1][(w >> 4) & 0xf] ^
+            table->full[2][(w >> 8) & 0xf] ^ table->full[3][w >> 12];
+        if (add) {
+            uint16_t o;
+            memcpy(&o, d + done, 2);
+            p ^= o;
+        }
+        memcpy(d + done, &p, 2);
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      XORs a region into another (dest ^= src).
+  @param      src             Source region.
+  @param      dest            Destination region.
+  @param      nBytes          Number of bytes.
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_GfRegionXor(const char* src, char* dest, size_t nBytes) {
+    pthread_once(&gf16Once, FTI_InitGf16);
+    size_t done = gfXorKernel((const uint8_t*) src, (uint8_t*) dest, nBytes);
+    for (; done < nBytes; done++) {
+        dest[done] ^= src[done];
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Computes a linear combination of regions.
+  @param      row             Tables of the n coefficients.
+  @param      src             The n source regions.
+  @param      n               Number of sources.
+  @param      dest            Destination region.
+  @param      nBytes          Number of bytes (multiple of 2).
+
+  dest = row[0] * src[0] + ... + row[n-1] * src[n-1]. Callers should keep
+  nBytes small enough for dest to stay in cache (e.g. 64 KiB).
+
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_Gf16DotProduct(const FTIT_gf16Table* row, const char* const* src,
+ int n, char* dest, size_t nBytes) {
+    int i;
+    for (i = 0; i < n; i++) {
+        FTI_Gf16RegionMultiply(&row[i], src[i], dest, nBytes, i > 0);
+    }
+    if (n == 0) {
+        memset(dest, 0, nBytes);
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Returns the name of the selected multiplication kernel.
+  @return     const char*     "avx2", "ssse3" or "scalar".
+ **/
+/*-------------------------------------------------------------------------*/
+const char* FTI_Gf16KernelName() {
+    pthread_once(&gf16Once, FTI_InitGf16);
+    return gf16KernelName;
+}
@@ -0,0 +1,62 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  FTI - A multi-level checkpointing library for C/C++/Fortran applications
+ *
+ *  Revision 1.0 : Fault Tolerance Interface (FTI)
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *  list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors
+ *  may be used to endorse or promote products derived from this software without
+ *  specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  @file   gf16.h
+ *  @date   October, 2026
+ *  @brief  GF(2^16) region kernels for the L3 Reed-Solomon coding.
+ */
+
+#ifndef FTI_SRC_UTIL_GF16_H_
+#define FTI_SRC_UTIL_GF16_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Split (4-bit) multiplication tables for one GF(2^16) constant.
+    lo[i][x] and hi[i][x] are the low and high byte of c * (x << 4i).     **/
+typedef struct FTIT_gf16Table {
+    uint8_t lo[4][16] __attribute__((aligned(16)));
+    uint8_t hi[4][16] __attribute__((aligned(16)));
+    uint16_t full[4][16];   /**< 16 bit products for the scalar kernel. **/
+    int multby;             /**< The constant c.                        **/
+} FTIT_gf16Table;
+
+void FTI_Gf16InitTable(FTIT_gf16Table* table, int multby);
+void FTI_Gf16RegionMultiply(const FTIT_gf16Table* table, const char* src,
+ char* dest, size_t nBytes, int add);
+void FTI_Gf16DotProduct(const FTIT_gf16Table* row, const char* const* src,
+ int n, char* dest, size_t nBytes);
+void FTI_GfRegionXor(const char* src, char* dest, size_t nBytes);
+const char* FTI_Gf16KernelName();
+
+#endif  // FTI_SRC_UTIL_GF16_H_
@@ -124,7 +124,7 @@ int FTI_KeyMapPushBack(void* new_item, int key) {
              self._size + FTI_MAX_REALLOC : self._size * 2;
         }
 
-        void* alloc = realloc(self._data, new_size * self._type_size);
+        void* alloc = realloc(self._data, (size_t) new_size * self._type_size);
 
         if (!alloc) {
             FTI_Print("Failed to extent keymap size", FTI_EROR);
@@ -134,7 +134,8 @@ int FTI_KeyMapPushBack(void* new_item, int key) {
         self._data = alloc;
     }
 
-    memcpy(self._data + self._used*self._type_size, new_item, self._type_size);
+    memcpy(self._data + (size_t) self._used*self._type_size, new_item,
+     self._type_size);
 
     self._key[key] = self._used;
     self._used = new_used;
@@ -188,7 +189,7 @@ int FTI_KeyMapGet(FTIT_dataset** data, int key) {
         return FTI_SCES;
     }
 
-    *data = self._data + check_pos * self._type_size;
+    *data = self._data + (size_t) check_pos * self._type_size;
 
     return FTI_SCES;
 }
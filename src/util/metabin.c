@@ -0,0 +1,519 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  FTI - A multi-level checkpointing library for C/C++/Fortran applications
+ *
+ *  Revision 1.0 : Fault Tolerance Interface (FTI)
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *  list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors
+ *  may be used to endorse or promote products derived from this software without
+ *  specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  @file   metabin.c
+ *  @brief  reading, writing and conversion of binary meta data files.
+ */
+
+#include <limits.h>
+
+#include "../interface.h"
+
+/** Rounds 'n' up to a multiple of 8 bytes. */
+#define FTI_METABIN_ALIGN(n) ((((uint64_t)(n)) + 7) & ~((uint64_t)7))
+
+/** Byte size of the sections of a binary meta data file. */
+typedef struct FTIT_metaBinLayout {
+    uint64_t    procs;
+    uint64_t    vars;
+    uint64_t    layers;
+    uint64_t    index;
+    uint64_t    dims;
+} FTIT_metaBinLayout;
+
+typedef struct FTIT_metaBinName {
+    const char* name;
+    uint32_t    var;
+} FTIT_metaBinName;
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Computes the section sizes for the counts in the header.
+  @param      head            Header of the meta data.
+  @param      layout          Section sizes (out).
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_MetaBinLayout(FTIT_metaBinHead* head,
+ FTIT_metaBinLayout* layout) {
+    uint64_t nbRecords = (uint64_t)head->groupSize * head->nbVar;
+    layout->procs = (uint64_t)head->groupSize * sizeof(FTIT_metaBinProc);
+    layout->vars = nbRecords * sizeof(FTIT_metaBinVar);
+    layout->layers = (uint64_t)head->groupSize * head->nbLayer *
+     sizeof(FTIT_metaBinLayer);
+    layout->index = FTI_METABIN_ALIGN(nbRecords * sizeof(uint32_t));
+    layout->dims = head->nbDims * sizeof(uint64_t);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Sets the section pointers into the meta data buffer.
+  @param      meta            Binary meta data.
+  @param      part            Sections present in the buffer.
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_MetaBinMap(FTIT_metaBin* meta, FTIT_metaBinPart part) {
+    FTIT_metaBinLayout layout;
+    char* ptr = meta->buffer;
+
+    meta->head = (FTIT_metaBinHead*) ptr;
+    FTI_MetaBinLayout(meta->head, &layout);
+    ptr += sizeof(FTIT_metaBinHead);
+    meta->procs = (FTIT_metaBinProc*) ptr;
+    ptr += layout.procs;
+
+    if (part == FTI_METABIN_PROCS) {
+        meta->vars = NULL;
+        meta->layers = NULL;
+        meta->index = NULL;
+        meta->dims = NULL;
+        meta->strings = NULL;
+        return;
+    }
+
+    meta->vars = (FTIT_metaBinVar*) ptr;
+    ptr += layout.vars;
+    meta->layers = (FTIT_metaBinLayer*) ptr;
+    ptr += layout.layers;
+    meta->index = (uint32_t*) ptr;
+    ptr += layout.index;
+    meta->dims = (uint64_t*) ptr;
+    ptr += layout.dims;
+    meta->strings = ptr;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Computes both checksums of a meta data buffer.
+  @param      meta            Binary meta data (all sections).
+  @param      headCrc         Checksum of header and procs (out).
+  @param      dataCrc         Checksum of the other sections (out, or NULL).
+ **/
+/*-------------------------------------------------------------------------*/
+static void FTI_MetaBinCrc(FTIT_metaBin* meta, uint32_t* headCrc,
+ uint32_t* dataCrc) {
+    FTIT_metaBinLayout layout;
+    FTI_MetaBinLayout(meta->head, &layout);
+
+    FTIT_metaBinHead head = *meta->head;
+    head.headCrc = 0;
+    head.dataCrc = 0;
+    *headCrc = FTI_Crc32c(0, (unsigned char*) &head, sizeof(head));
+    *headCrc = FTI_Crc32c(*headCrc, (unsigned char*) meta->procs,
+     layout.procs);
+
+    if (dataCrc != NULL) {
+        uint64_t size = layout.vars + layout.layers + layout.index +
+         layout.dims + meta->head->stringSize;
+        *dataCrc = FTI_Crc32c(0, (unsigned char*) meta->vars, size);
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Allocates empty binary meta data.
+  @param      meta            Binary meta data (out).
+  @param      groupSize       Number of processes in the group.
+  @param      nbVar           Protected variables per process.
+  @param      nbLayer         dCP layers per process.
+  @param      nbDims          Total number of dimensions of all variables.
+  @param      stringSize      Total size of all strings (with '\0').
+  @return     integer         FTI_SCES if successful.
+
+  All strings are added with \ref FTI_MetaBinAddString. The string section
+  starts with an empty string at offset 0, which is returned for strings
+  that do not fit anymore.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_MetaBinInit(FTIT_metaBin* meta, int groupSize, int nbVar,
+ int nbLayer, uint64_t nbDims, uint64_t stringSize) {
+    FTIT_metaBinHead head;
+    memset(&head, 0x0, sizeof(head));
+    memcpy(head.magic, FTI_METABIN_MAGIC, sizeof(FTI_METABIN_MAGIC));
+    head.version = FTI_METABIN_VERSION;
+    head.procSize = sizeof(FTIT_metaBinProc);
+    head.varSize = sizeof(FTIT_metaBinVar);
+    head.layerSize = sizeof(FTIT_metaBinLayer);
+    head.groupSize = groupSize;
+    head.nbVar = nbVar;
+    head.nbLayer = nbLayer;
+    head.nbDims = nbDims;
+    head.stringSize = stringSize + 1;
+
+    FTIT_metaBinLayout layout;
+    FTI_MetaBinLayout(&head, &layout);
+    uint64_t size = sizeof(head) + layout.procs + layout.vars +
+     layout.layers + layout.index + layout.dims + head.stringSize;
+
+    meta->buffer = calloc(1, size);
+    if (meta->buffer == NULL) {
+        FTI_Print("Failed to allocate the binary meta data.", FTI_EROR);
+        return FTI_NSCS;
+    }
+    memcpy(meta->buffer, &head, sizeof(head));
+    FTI_MetaBinMap(meta, FTI_METABIN_FULL);
+    meta->stringUsed = 1;
+    meta->dimUsed = 0;
+
+    int64_t i;
+    for (i = 0; i < (int64_t)groupSize * nbVar; i++) {
+        meta->vars[i].id = -1;
+        meta->index[i] = i % (nbVar ? nbVar : 1);
+    }
+
+    return FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Appends a string to the string section.
+  @param      meta            Binary meta data.
+  @param      str             String to store (at most FTI_BUFS bytes).
+  @return     uint64_t        Offset of the string in the string section.
+ **/
+/*-------------------------------------------------------------------------*/
+uint64_t FTI_MetaBinAddString(FTIT_metaBin* meta, const char* str) {
+    uint64_t len = strnlen(str, FTI_BUFS - 1);
+    if (len == 0 || meta->stringUsed + len + 1 > meta->head->stringSize) {
+        return 0;
+    }
+    uint64_t off = meta->stringUsed;
+    memcpy(&meta->strings[off], str, len);
+    meta->strings[off + len] = '\0';
+    meta->stringUsed += len + 1;
+    return off;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Size of the packed variable records of a process.
+  @param      nbVar           Protected variables of the process.
+  @param      nbDims          Total number of dimensions of the variables.
+  @param      stringSize      Size of the strings (with the empty string).
+  @return     uint64_t        Size of the \ref FTIT_metaBinSection in bytes.
+ **/
+/*-------------------------------------------------------------------------*/
+uint64_t FTI_MetaBinSectionSize(int nbVar, uint64_t nbDims,
+ uint64_t stringSize) {
+    return sizeof(FTIT_metaBinSection) + nbVar * sizeof(FTIT_metaBinVar) +
+     nbDims * sizeof(uint64_t) + stringSize;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Copies the packed variable records of a process.
+  @param      meta            Binary meta data.
+  @param      proc            Group rank of the process.
+  @param      section         Packed variable records of the process.
+  @return     integer         FTI_SCES if successful.
+
+  The dimensions and strings are appended to the sections of the meta
+  data and the offsets of the records are moved accordingly. The file
+  positions of the records are left to the caller.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_MetaBinAddSection(FTIT_metaBin* meta, int proc,
+ const FTIT_metaBinSection* section) {
+    if (section->nbVar > meta->head->nbVar ||
+     meta->dimUsed + section->nbDims > meta->head->nbDims ||
+     meta->stringUsed + section->stringSize > meta->head->stringSize) {
+        FTI_Print("Variable records do not fit in the meta data.", FTI_WARN);
+        return FTI_NSCS;
+    }
+
+    uint64_t dimBase = meta->dimUsed;
+    uint64_t stringBase = meta->stringUsed;
+    memcpy(&meta->dims[dimBase], FTI_MetaBinSectionDims(section),
+     section->nbDims * sizeof(uint64_t));
+    memcpy(&meta->strings[stringBase], FTI_MetaBinSectionStrings(section),
+     section->stringSize);
+    meta->dimUsed += section->nbDims;
+    meta->stringUsed += section->stringSize;
+
+    FTIT_metaBinVar* vars = FTI_MetaBinSectionVars(section);
+    int i;
+    for (i = 0; i < section->nbVar; i++) {
+        FTIT_metaBinVar* var = FTI_MetaBinVarOf(meta, proc, i);
+        *var = vars[i];
+        var->name += stringBase;
+        var->idChar += stringBase;
+        var->dims += dimBase;
+    }
+
+    return FTI_SCES;
+}
+
+static int FTI_MetaBinCompareName(const void* a, const void* b) {
+    return strcmp(((const FTIT_metaBinName*) a)->name,
+     ((const FTIT_metaBinName*) b)->name);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Builds the name index of all processes.
+  @param      meta            Binary meta data (all sections).
+
+  Must be called after the variable records are complete.
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_MetaBinIndex(FTIT_metaBin* meta) {
+    int nbVar = meta->head->nbVar;
+    if (nbVar == 0) return;
+
+    FTIT_metaBinName* names = talloc(FTIT_metaBinName, nbVar);
+    int p, k;
+    for (p = 0; p < meta->head->groupSize; p++) {
+        for (k = 0; k < nbVar; k++) {
+            names[k].name = FTI_MetaBinString(meta,
+             FTI_MetaBinVarOf(meta, p, k)->idChar);
+            names[k].var = k;
+        }
+        qsort(names, nbVar, sizeof(FTIT_metaBinName), FTI_MetaBinCompareName);
+        for (k = 0; k < nbVar; k++) {
+            meta->index[(int64_t)p * nbVar + k] = names[k].var;
+        }
+    }
+    free(names);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Looks up a variable of a process by its name.
+  @param      meta            Binary meta data (all sections).
+  @param      proc            Group rank of the process.
+  @param      name            Dataset name (idChar).
+  @return     integer         Position of the variable or -1 if not found.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_MetaBinFind(FTIT_metaBin* meta, int proc, const char* name) {
+    uint32_t* index = &meta->index[(int64_t)proc * meta->head->nbVar];
+    int lo = 0, hi = meta->head->nbVar - 1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        int cmp = strcmp(name, FTI_MetaBinString(meta,
+         FTI_MetaBinVarOf(meta, proc, index[mid])->idChar));
+        if (cmp == 0) {
+            return index[mid];
+        } else if (cmp < 0) {
+            hi = mid - 1;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return -1;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Checks whether a meta data file is in the binary format.
+  @param      fn              Path to the meta data file.
+  @return     bool            true if the file starts with the magic.
+ **/
+/*-------------------------------------------------------------------------*/
+bool FTI_MetaBinIsBinary(const char* fn) {
+    char magic[sizeof(FTI_METABIN_MAGIC)];
+    FILE* fd = fopen(fn, "rb");
+    if (fd == NULL) {
+        return false;
+    }
+    size_t n = fread(magic, 1, sizeof(magic), fd);
+    fclose(fd);
+    return (n == sizeof(magic)) &&
+     (memcmp(magic, FTI_METABIN_MAGIC, sizeof(magic)) == 0);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Writes binary meta data to a file.
+  @param      meta            Binary meta data (all sections).
+  @param      fn              Path to the meta data file.
+  @return     integer         FTI_SCES if successful.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_MetaBinStore(FTIT_metaBin* meta, const char* fn) {
+    char str[FTI_BUFS];
+
+    // only the used part of the string section is written
+    meta->head->stringSize = meta->stringUsed;
+    FTI_MetaBinCrc(meta, &meta->head->headCrc, &meta->head->dataCrc);
+
+    uint64_t size = (meta->strings + meta->stringUsed) -
+     (char*) meta->buffer;
+
+    FILE* fd = fopen(fn, "wb");
+    if (fd == NULL) {
+        snprintf(str, FTI_BUFS, "Unable to create meta data file (%s).", fn);
+        FTI_Print(str, FTI_EROR);
+        return FTI_NSCS;
+    }
+    if (fwrite(meta->buffer, 1, size, fd) != size) {
+        snprintf(str, FTI_BUFS, "Unable to write meta data file (%s).", fn);
+        FTI_Print(str, FTI_EROR);
+        fclose(fd);
+        return FTI_NSCS;
+    }
+    if (fclose(fd) != 0) {
+        snprintf(str, FTI_BUFS, "Unable to close meta data file (%s).", fn);
+        FTI_Print(str, FTI_EROR);
+        return FTI_NSCS;
+    }
+
+    return FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Rewrites header and process records of a meta data file.
+  @param      meta            Binary meta data (at least the procs).
+  @param      fn              Path to the existing meta data file.
+  @return     integer         FTI_SCES if successful.
+
+  Used to update the file checksums of the group in place.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_MetaBinStoreProcs(FTIT_metaBin* meta, const char* fn) {
+    char str[FTI_BUFS];
+
+    FTI_MetaBinCrc(meta, &meta->head->headCrc, NULL);
+    uint64_t size = sizeof(FTIT_metaBinHead) +
+     (uint64_t)meta->head->groupSize * sizeof(FTIT_metaBinProc);
+
+    FILE* fd = fopen(fn, "r+b");
+    if (fd == NULL) {
+        snprintf(str, FTI_BUFS, "Unable to open meta data file (%s).", fn);
+        FTI_Print(str, FTI_EROR);
+        return FTI_NSCS;
+    }
+    if (fwrite(meta->buffer, 1, size, fd) != size) {
+        snprintf(str, FTI_BUFS, "Unable to write meta data file (%s).", fn);
+        FTI_Print(str, FTI_EROR);
+        fclose(fd);
+        return FTI_NSCS;
+    }
+    if (fclose(fd) != 0) {
+        snprintf(str, FTI_BUFS, "Unable to close meta data file (%s).", fn);
+        FTI_Print(str, FTI_EROR);
+        return FTI_NSCS;
+    }
+
+    return FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Reads and verifies a binary meta data file.
+  @param      meta            Binary meta data (out).
+  @param      fn              Path to the meta data file.
+  @param      part            Sections to read.
+  @return     integer         FTI_SCES if successful.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_MetaBinLoad(FTIT_metaBin* meta, const char* fn,
+ FTIT_metaBinPart part) {
+    char str[FTI_BUFS];
+    FTIT_metaBinHead head;
+
+    meta->buffer = NULL;
+
+    FILE* fd = fopen(fn, "rb");
+    if (fd == NULL) {
+        snprintf(str, FTI_BUFS, "Unable to open meta data file (%s).", fn);
+        FTI_Print(str, FTI_DBUG);
+        return FTI_NSCS;
+    }
+
+    if (fread(&head, sizeof(head), 1, fd) != 1 ||
+     memcmp(head.magic, FTI_METABIN_MAGIC, sizeof(FTI_METABIN_MAGIC)) != 0 ||
+     head.version != FTI_METABIN_VERSION ||
+     head.procSize != sizeof(FTIT_metaBinProc) ||
+     head.varSize != sizeof(FTIT_metaBinVar) ||
+     head.layerSize != sizeof(FTIT_metaBinLayer) ||
+     head.groupSize < 0 || head.nbVar < 0 || head.nbLayer < 0) {
+        snprintf(str, FTI_BUFS, "Invalid meta data file header (%s).", fn);
+        FTI_Print(str, FTI_WARN);
+        fclose(fd);
+        return FTI_NSCS;
+    }
+
+    FTIT_metaBinLayout layout;
+    FTI_MetaBinLayout(&head, &layout);
+    uint64_t size = sizeof(head) + layout.procs;
+    if (part == FTI_METABIN_FULL) {
+        size += layout.vars + layout.layers + layout.index + layout.dims +
+         head.stringSize;
+    }
+
+    meta->buffer = malloc(size);
+    if (meta->buffer == NULL) {
+        FTI_Print("Failed to allocate the binary meta data.", FTI_EROR);
+        fclose(fd);
+        return FTI_NSCS;
+    }
+    memcpy(meta->buffer, &head, sizeof(head));
+
+    uint64_t rest = size - sizeof(head);
+    if (fread((char*) meta->buffer + sizeof(head), 1, rest, fd) != rest) {
+        snprintf(str, FTI_BUFS, "Meta data file is truncated (%s).", fn);
+        FTI_Print(str, FTI_WARN);
+        fclose(fd);
+        FTI_MetaBinFree(meta);
+        return FTI_NSCS;
+    }
+    fclose(fd);
+
+    FTI_MetaBinMap(meta, part);
+    meta->stringUsed = head.stringSize;
+
+    uint32_t headCrc, dataCrc;
+    FTI_MetaBinCrc(meta, &headCrc,
+     (part == FTI_METABIN_FULL) ? &dataCrc : NULL);
+    if (headCrc != head.headCrc ||
+     (part == FTI_METABIN_FULL && dataCrc != head.dataCrc)) {
+        snprintf(str, FTI_BUFS, "Meta data file is corrupted (%s).", fn);
+        FTI_Print(str, FTI_WARN);
+        FTI_MetaBinFree(meta);
+        return FTI_NSCS;
+    }
+
+    return FTI_SCES;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      Releases binary meta data.
+  @param      meta            Binary meta data.
+ **/
+/*-------------------------------------------------------------------------*/
+void FTI_MetaBinFree(FTIT_metaBin* meta) {
+    free(meta->buffer);
+    meta->buffer = NULL;
+}
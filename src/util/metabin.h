@@ -0,0 +1,192 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  FTI - A multi-level checkpointing library for C/C++/Fortran applications
+ *
+ *  Revision 1.0 : Fault Tolerance Interface (FTI)
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *  list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors
+ *  may be used to endorse or promote products derived from this software without
+ *  specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  @file   metabin.h
+ *  @brief  binary, indexed layout of the per group checkpoint meta data.
+ *
+ *  A binary meta data file is a fixed header followed by the packed
+ *  sections of the group:
+ *
+ *      header | procs[groupSize] | vars[groupSize*nbVar] |
+ *      layers[groupSize*nbLayer] | index[groupSize*nbVar] |
+ *      dims[nbDims] | strings[stringSize]
+ *
+ *  The header and the process records are covered by 'headCrc', all the
+ *  remaining sections by 'dataCrc' (both CRC32C). The process records are
+ *  self-contained, so the file information of the group (names, sizes and
+ *  checksums) can be read and updated without touching the variables.
+ */
+
+#ifndef FTI_METABIN_H_
+#define FTI_METABIN_H_
+
+#include <stdint.h>
+
+#define FTI_META_INI 0  /**< per variable keys in an ini file        */
+#define FTI_META_BIN 1  /**< packed records, see \ref FTIT_metaBinHead */
+
+#define FTI_METABIN_MAGIC "FTIMETA"
+#define FTI_METABIN_VERSION 2
+
+/** Which sections \ref FTI_MetaBinLoad reads from the file. */
+typedef enum FTIT_metaBinPart {
+    FTI_METABIN_PROCS,  /**< header and process records only         */
+    FTI_METABIN_FULL,   /**< all sections                             */
+} FTIT_metaBinPart;
+
+typedef struct FTIT_metaBinHead {
+    char        magic[8];       /**< FTI_METABIN_MAGIC                  */
+    uint32_t    version;        /**< FTI_METABIN_VERSION                */
+    uint32_t    headCrc;        /**< CRC32C of header and procs         */
+    uint32_t    dataCrc;        /**< CRC32C of the remaining sections   */
+    uint32_t    procSize;       /**< sizeof(FTIT_metaBinProc)           */
+    uint32_t    varSize;        /**< sizeof(FTIT_metaBinVar)            */
+    uint32_t    layerSize;      /**< sizeof(FTIT_metaBinLayer)          */
+    int32_t     ckptId;         /**< Checkpoint ID                      */
+    int32_t     isDcp;          /**< 1 if POSIX dCP checkpoint          */
+    int32_t     groupSize;      /**< Number of processes in the group   */
+    int32_t     nbVar;          /**< Protected variables per process    */
+    int32_t     nbLayer;        /**< dCP layers per process             */
+    int32_t     reserved;
+    int64_t     maxFs;          /**< Maximum file size in the group     */
+    uint64_t    nbDims;         /**< Entries in the dimension section   */
+    uint64_t    stringSize;     /**< Bytes in the string section        */
+} FTIT_metaBinHead;
+
+typedef struct FTIT_metaBinProc {
+    int64_t     fs;                                 /**< File size      */
+    char        fileName[FTI_BUFS];                 /**< File name      */
+    char        checksum[MD5_DIGEST_STRING_LENGTH]; /**< Ckpt checksum  */
+    char        rsChecksum[MD5_DIGEST_STRING_LENGTH]; /**< RS checksum  */
+} FTIT_metaBinProc;
+
+typedef struct FTIT_metaBinVar {
+    int64_t     size;       /**< Size of the dataset in bytes           */
+    int64_t     pos;        /**< Position in the checkpoint file        */
+    int32_t     id;         /**< Dataset ID                             */
+    int32_t     typeId;     /**< Primitive type ID or -1                */
+    int32_t     typeSize;   /**< Size of the data type                  */
+    int32_t     ndims;      /**< Number of dimensions                   */
+    uint64_t    name;       /**< String offset of the attribute name    */
+    uint64_t    idChar;     /**< String offset of the dataset name      */
+    uint64_t    dims;       /**< First entry in the dimension section   */
+    int64_t     fileSize;   /**< Bytes in the file if compressed        */
+    int32_t     codec;      /**< Compression codec, 0 if not compressed */
+    int32_t     reserved;   /**< Padding                                */
+} FTIT_metaBinVar;
+
+typedef struct FTIT_metaBinLayer {
+    uint64_t    size;                               /**< Layer size     */
+    char        hash[MD5_DIGEST_STRING_LENGTH];     /**< Layer hash     */
+} FTIT_metaBinLayer;
+
+/**--------------------------------------------------------------------------
+
+
+  @brief        Variable records of one process.
+
+  Packed form in which a group member sends its variables to the group
+  rank 0. The header is followed by 'nbVar' records, 'nbDims' dimensions
+  and 'stringSize' bytes of strings, which start with an empty string.
+  The name and dimension offsets of the records are relative to the
+  sections of the process, the file positions are not set.
+
+
+--------------------------------------------------------------------------**/
+typedef struct FTIT_metaBinSection {
+    int32_t     nbVar;          /**< Protected variables of the process */
+    int32_t     reserved;
+    uint64_t    nbDims;         /**< Entries in the dimension section   */
+    uint64_t    stringSize;     /**< Bytes in the string section        */
+    uint64_t    size;           /**< Size of the packed records         */
+} FTIT_metaBinSection;
+
+/**--------------------------------------------------------------------------
+
+
+  @brief        Binary meta data of one group.
+
+  The sections point into one contiguous buffer that has the layout of the
+  file. 'index' holds, for every process, the positions of its variable
+  records sorted by dataset name.
+
+
+--------------------------------------------------------------------------**/
+typedef struct FTIT_metaBin {
+    FTIT_metaBinHead*   head;
+    FTIT_metaBinProc*   procs;
+    FTIT_metaBinVar*    vars;
+    FTIT_metaBinLayer*  layers;
+    uint32_t*           index;
+    uint64_t*           dims;
+    char*               strings;
+    uint64_t            stringUsed; /**< Bytes of the string section used */
+    uint64_t            dimUsed;    /**< Entries of the dimensions used   */
+    void*               buffer;
+} FTIT_metaBin;
+
+int FTI_MetaBinInit(FTIT_metaBin* meta, int groupSize, int nbVar,
+ int nbLayer, uint64_t nbDims, uint64_t stringSize);
+uint64_t FTI_MetaBinAddString(FTIT_metaBin* meta, const char* str);
+uint64_t FTI_MetaBinSectionSize(int nbVar, uint64_t nbDims,
+ uint64_t stringSize);
+int FTI_MetaBinAddSection(FTIT_metaBin* meta, int proc,
+ const FTIT_metaBinSection* section);
+void FTI_MetaBinIndex(FTIT_metaBin* meta);
+int FTI_MetaBinFind(FTIT_metaBin* meta, int proc, const char* name);
+bool FTI_MetaBinIsBinary(const char* fn);
+int FTI_MetaBinStore(FTIT_metaBin* meta, const char* fn);
+int FTI_MetaBinStoreProcs(FTIT_metaBin* meta, const char* fn);
+int FTI_MetaBinLoad(FTIT_metaBin* meta, const char* fn,
+ FTIT_metaBinPart part);
+void FTI_MetaBinFree(FTIT_metaBin* meta);
+
+/** Record of variable 'var' of group rank 'proc'. */
+#define FTI_MetaBinVarOf(meta, proc, var) \
+    (&(meta)->vars[(int64_t)(proc) * (meta)->head->nbVar + (var)])
+/** dCP layer 'layer' of group rank 'proc'. */
+#define FTI_MetaBinLayerOf(meta, proc, layer) \
+    (&(meta)->layers[(int64_t)(proc) * (meta)->head->nbLayer + (layer)])
+/** Variable records of a packed \ref FTIT_metaBinSection. */
+#define FTI_MetaBinSectionVars(section) \
+    ((FTIT_metaBinVar*)((char*)(section) + sizeof(FTIT_metaBinSection)))
+/** Dimensions of a packed \ref FTIT_metaBinSection. */
+#define FTI_MetaBinSectionDims(section) \
+    ((uint64_t*)(FTI_MetaBinSectionVars(section) + (section)->nbVar))
+/** Strings of a packed \ref FTIT_metaBinSection. */
+#define FTI_MetaBinSectionStrings(section) \
+    ((char*)(FTI_MetaBinSectionDims(section) + (section)->nbDims))
+/** String stored at offset 'off' of the string section. */
+#define FTI_MetaBinString(meta, off) (&(meta)->strings[(off)])
+
+#endif  // FTI_METABIN_H_
@@ -95,7 +95,7 @@ int FTI_InitExecVars(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
     FTI_filemetastructsize
         = MD5_DIGEST_STRING_LENGTH
         + MD5_DIGEST_LENGTH
-        + 7*sizeof(int32_t)
+        + 7*sizeof(int64_t)
         + sizeof(int);
 
     // TODO(leobago) RS L3 only works for even file sizes.
@@ -105,13 +105,13 @@ int FTI_InitExecVars(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
 
     FTI_dbstructsize
         = sizeof(int)               /* numvars */
-        + sizeof(int32_t);             /* dbsize */
+        + sizeof(int64_t);             /* dbsize */
 
     FTI_dbvarstructsize
         = 2*sizeof(int)               /* numvars */
         + 2*sizeof(bool)
         + 2*sizeof(uintptr_t)
-        + 2*sizeof(int32_t)
+        + 2*sizeof(int64_t)
         + MD5_DIGEST_LENGTH;
 
     //
@@ -143,21 +143,14 @@ int FTI_InitExecVars(FTIT_configuration* FTI_Conf, FTIT_execution* FTI_Exec,
   @param      checksum        Checksum that is calculated.
   @return     integer         FTI_SCES if successful.
 
-  This function calculates checksum of the checkpoint file based on
-  MD5 algorithm and saves it in checksum.
+  This function copies the checksum of the checkpoint file, computed
+  while the file was written, in checksum.
 
  **/
 /*-------------------------------------------------------------------------*/
 int FTI_Checksum(FTIT_execution* FTI_Exec, FTIT_keymap* FTI_Data,
         FTIT_configuration* FTI_Conf, char* checksum) {
-    int i;
-    int ii = 0;
-
-    for (i = 0; i < MD5_DIGEST_LENGTH; i++) {
-        int rest = MD5_DIGEST_STRING_LENGTH-ii;
-        snprintf(&checksum[ii], rest, "%02x", FTI_Exec->integrity[i]);
-        ii += 2;
-    }
+    strncpy(checksum, FTI_Exec->integrity, MD5_DIGEST_STRING_LENGTH);
     return FTI_SCES;
 }
 
@@ -168,9 +161,9 @@ int FTI_Checksum(FTIT_execution* FTI_Exec, FTIT_keymap* FTI_Data,
   @param      checksumToCmp   Checksum to compare.
   @return     integer         FTI_SCES if successful.
 
-  This function calculates checksum of the checkpoint file based on
-  MD5 algorithm. It compares calculated hash value with the one saved
-  in the file.
+  This function calculates checksum of the checkpoint file with the
+  integrity scheme of the checksum saved in the metadata (MD5 or tree
+  hash) and compares them.
 
  **/
 /*-------------------------------------------------------------------------*/
@@ -184,25 +177,40 @@ int FTI_VerifyChecksum(char* fileName, char* checksumToCmp) {
         return FTI_NSCS;
     }
 
-    MD5_CTX mdContext;
-    MD5_Init(&mdContext);
+    FTIT_integrity ctx;
+    FTI_IntegrityInitFor(&ctx, checksumToCmp);
 
-    int bytes;
-    unsigned char data[CHUNK_SIZE];
-    while ((bytes = fread(data, 1, CHUNK_SIZE, fd)) != 0) {
-        MD5_Update(&mdContext, data, bytes);
+    // the tree hash digests several chunks of a read at once
+    size_t batch = FTI_IntegrityBatch(&ctx);
+    unsigned char* data = malloc(batch);
+    if (data == NULL) {
+        FTI_Print("Cannot allocate the buffer to calculate checksum.",
+         FTI_WARN);
+        fclose(fd);
+        return FTI_NSCS;
+    }
+    size_t bytes;
+    while ((bytes = fread(data, 1, batch, fd)) != 0) {
+        FTI_IntegrityUpdate(&ctx, data, bytes);
     }
-    unsigned char hash[MD5_DIGEST_LENGTH];
-    MD5_Final(hash, &mdContext);
+    free(data);
+    fclose(fd);
 
-    int i;
+    return FTI_VerifyHash(fileName, &ctx, checksumToCmp);
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief      It completes the digest of a file and compares it.
+  @param      fileName        Filename of the checkpoint.
+  @param      ctx             Digest of the file.
+  @param      checksumToCmp   Checksum to compare.
+  @return     integer         FTI_SCES if successful.
+ **/
+/*-------------------------------------------------------------------------*/
+int FTI_VerifyHash(char* fileName, FTIT_integrity* ctx, char* checksumToCmp) {
     char checksum[MD5_DIGEST_STRING_LENGTH];  // calculated checksum
-    int ii = 0;
-    for (i = 0; i < MD5_DIGEST_LENGTH; i++) {
-        int rest = MD5_DIGEST_STRING_LENGTH-ii;
-        snprintf(&checksum[ii], rest, "%02x", hash[i]);
-        ii += 2;
-    }
+    FTI_IntegrityFinal(ctx, checksum);
 
     if (strcmp(checksum, checksumToCmp) != 0) {
         char str[FTI_BUFS];
@@ -210,14 +218,9 @@ int FTI_VerifyChecksum(char* fileName, char* checksumToCmp) {
          "TOOLS: Checksum do not match. \"%s\" file is corrupted. %s != %s",
           fileName, checksum, checksumToCmp);
         FTI_Print(str, FTI_WARN);
-
-        fclose(fd);
-
         return FTI_NSCS;
     }
 
-    fclose(fd);
-
     return FTI_SCES;
 }
 
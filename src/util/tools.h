@@ -18,6 +18,7 @@ void FTI_Print(char *msg, int priority);
 int FTI_Checksum(FTIT_execution* FTI_Exec, FTIT_keymap* FTI_Data,
       FTIT_configuration* FTI_Conf, char* checksum);
 int FTI_VerifyChecksum(char* fileName, char* checksumToCmp);
+int FTI_VerifyHash(char* fileName, FTIT_integrity* ctx, char* checksumToCmp);
 int FTI_Try(int result, char* message);
 void FTI_FreeTypesAndGroups(FTIT_execution* FTI_Exec);
 int FTI_InitGroupsAndTypes(FTIT_execution* FTI_Exec);
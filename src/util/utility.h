@@ -39,8 +39,10 @@
 #ifndef FTI_UTILITY_H_
 #define FTI_UTILITY_H_
 
+#include <sys/uio.h>
 #include <fti.h>
 #include "../deps/md5/md5.h"
+#include "../IO/integrity.h"
 
 typedef struct {
     FTIT_configuration* FTI_Conf;   // Configuration of the FTI
@@ -52,22 +54,41 @@ typedef struct {
     MPI_File pfh;                   // File descriptor
     char flag;                      // Flags used to open the file
     MD5_CTX integrity;              // integrity of the file
+    bool collective;                // Datasets written at close
+    struct iovec *iov;              // Datasets pending for the close
+    int nbIov;                      // Number of pending datasets
 } WriteMPIInfo_t;
 
 typedef struct {
     FILE *f;                        // Posix file descriptor
     size_t offset;                  // offset in the file
     char flag;                      // flags to open the file
-    MD5_CTX integrity;              // integrity of the file
+    FTIT_integrity integrity;       // integrity of the file
 }WritePosixInfo_t;
 
+typedef struct {
+    FTIT_configuration *FTI_Conf;   // FTI Configuration
+    FTIT_execution *FTI_Exec;       // FTI execution options
+    FTIT_topology *FTI_Topo;        // FTI node topology
+    char *buf[2];                   // staging buffers of transferSize bytes
+    int cur;                        // staging buffer being filled
+    size_t fill;                    // bytes in the current staging buffer
+    MPI_Request req;                // pending send of the other buffer
+    int isAgg;                      // TRUE on the first rank of the group
+    int file;                       // aggregated file, on the aggregator
+    int64_t base;                   // position of the aggregator data
+    size_t size;                    // bytes written by the rank
+    int failed;                     // TRUE if the data is incomplete
+    FTIT_integrity integrity;       // integrity of the rank data
+}WriteAggInfo_t;
+
 #ifdef ENABLE_IME_NATIVE
 typedef struct {
     int f;                          // IME native file descriptor
     size_t offset;                  // offset in the file
     int flag;                       // flags to open the file
     mode_t mode;                    // mode the file has been opened
-    MD5_CTX integrity;              // integrity of the file
+    FTIT_integrity integrity;       // integrity of the file
 }WriteIMEInfo_t;
 #endif
 
@@ -77,19 +98,27 @@ typedef struct {
     FTIT_checkpoint *FTI_Ckpt;      // FTI Checkpoint options
     FTIT_execution *FTI_Exec;       // FTI execution options
     FTIT_topology *FTI_Topo;        // FTI node topology
+    FTIT_keymap *FTI_Data;          // FTI dataset metadata
     size_t layerSize;               // size of the dcp layer
+    size_t layerStart;              // size of the file before the layer
+    int failed;                     // TRUE if a dataset was not written
 }WriteDCPPosixInfo_t;
 
 typedef struct {
     FILE *f;                        // Posix file descriptor
     size_t offset;                  // offset in the file
     char flag;                      // flags to open the file
-    MD5_CTX integrity;              // integrity of the file
+    FTIT_integrity integrity;       // integrity of the file
     FTIT_configuration *FTI_Conf;   // FTI Configuration
     FTIT_checkpoint *FTI_Ckpt;      // FTI Checkpoint options
     FTIT_execution *FTI_Exec;       // FTI execution options
     FTIT_topology *FTI_Topo;        // FTI node topology
     FTIT_keymap *FTI_Data;
+    struct iovec *iov;              // pending runs of the data block
+    int nbIov;                      // number of pending runs
+    size_t batchPos;                // file offset of the pending runs
+    size_t batchSize;               // bytes of the pending runs
+    int failed;                     // TRUE if a dataset was not written
 }WriteFTIFFInfo_t;
 
 #ifdef ENABLE_HDF5
@@ -99,6 +128,7 @@ typedef struct {
     FTIT_topology *FTI_Topo;         // FTI Data
     FTIT_configuration *FTI_Conf;         // FTI Data
     hid_t file_id;                  // File Id
+    int failed;                     // TRUE if a dataset was not written
 }WriteHDF5Info_t;
 
 int FTI_HDF5Open(char *fn, void *fileDesc);
@@ -133,6 +163,7 @@ size_t FTI_GetSionFilePos(void *fileDesc);
 // Wrappers around MPIO
 int FTI_MPIOOpen(char *fn, void *fileDesc);
 int FTI_MPIOClose(void *fileDesc);
+int FTI_MPIOCkptClose(void *fileDesc);
 int FTI_MPIOWrite(void *src, size_t size, void *fileDesc);
 int FTI_MPIORead(void *src, size_t size, void *fileDesc);
 size_t FTI_GetMPIOFilePos(void *fileDesc);
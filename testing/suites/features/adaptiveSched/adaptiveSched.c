@@ -0,0 +1,63 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  @file   adaptiveSched.c
+ *  @date   October, 2026
+ *  @brief  FTI testing program for the adaptive checkpoint scheduler.
+ *
+ *	The program takes three arguments:
+ *	  - arg1: FTI configuration file
+ *	  - arg2: Number of iterations
+ *	  - arg3: Duration of an iteration in milliseconds
+ *
+ * Every iteration calls FTI_Snapshot, which decides when to checkpoint and
+ * at which level. FTI reports the level of every checkpoint taken.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "fti.h"
+#include "mpi.h"
+
+#define N 131072
+#define SNAPSHOT_FAILED 40
+
+int main(int argc, char *argv[]) {
+  int rank, i, j;
+
+  MPI_Init(&argc, &argv);
+  FTI_Init(argv[1], MPI_COMM_WORLD);
+  int nbIter = atoi(argv[2]);
+  int iterMs = atoi(argv[3]);
+
+  MPI_Comm_rank(FTI_COMM_WORLD, &rank);
+
+  double *array = (double *)malloc(N * sizeof(double));
+  for (j = 0; j < N; j++) {
+    array[j] = rank;
+  }
+  FTI_Protect(0, &i, 1, FTI_INTG);
+  FTI_Protect(1, array, N, FTI_DBLE);
+
+  for (i = 0; i < nbIter; i++) {
+    int res = FTI_Snapshot();
+    if (res == FTI_DONE && rank == 0) {
+      printf("Checkpoint made i = %d\n", i);
+    } else if (res != FTI_SCES && res != FTI_DONE) {
+      printf("%d: Snapshot failed! Returned %d.\n", rank, res);
+      exit(SNAPSHOT_FAILED);
+    }
+    for (j = 0; j < N; j++) {
+      array[j] += 1;
+    }
+    usleep(iterMs * 1000);
+  }
+
+  free(array);
+  FTI_Finalize();
+  MPI_Finalize();
+  return 0;
+}
@@ -0,0 +1,125 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  @file   asyncCkpt.c
+ *  @date   October, 2026
+ *  @brief  FTI testing program for asynchronous checkpoints.
+ *
+ *	The program takes three arguments and an optional fourth:
+ *	  - arg1: FTI configuration file
+ *	  - arg2: Interrupt yes/no (1/0)
+ *	  - arg3: Checkpoint level (1, 2, 3, 4)
+ *	  - arg4: Re-protect yes/no (1/0), default 0
+ *
+ * On the first run the program takes a checkpoint and overwrites the
+ * protected buffer while the background writer is active. With arg4, the
+ * odd ranks protect a larger buffer and a new variable before the
+ * checkpoint is completed, and all ranks reduce a value in between. On
+ * restart, the recovered buffer must contain the values from the time of
+ * FTI_Checkpoint.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../../../src/deps/iniparser/dictionary.h"
+#include "../../../../src/deps/iniparser/iniparser.h"
+#include "fti.h"
+#include "mpi.h"
+
+#define N 1000000
+#define CNTRLD_EXIT 10
+#define RECOVERY_FAILED 20
+#define DATA_CORRUPT 30
+#define CKPT_FAILED 40
+#define KEEP 2
+#define RESTART 1
+#define INIT 0
+
+int main(int argc, char *argv[]) {
+  int rank, crash, level, state, i;
+  int correct = 1;
+
+  MPI_Init(&argc, &argv);
+  if (FTI_Init(argv[1], MPI_COMM_WORLD) == FTI_NREC) {
+    exit(RECOVERY_FAILED);
+  }
+
+  crash = atoi(argv[2]);
+  level = atoi(argv[3]);
+  int reprotect = (argc > 4) ? atoi(argv[4]) : 0;
+
+  MPI_Comm_rank(FTI_COMM_WORLD, &rank);
+  dictionary *ini = iniparser_load(argv[1]);
+  int grank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &grank);
+  int nbHeads = (int)iniparser_getint(ini, "Basic:head", -1);
+  int finalTag = (int)iniparser_getint(ini, "Advanced:final_tag", 3107);
+  int nodeSize = (int)iniparser_getint(ini, "Basic:node_size", -1);
+  int headRank = grank - grank % nodeSize;
+
+  if ((nbHeads < 0) || (nodeSize < 0)) {
+    printf("wrong configuration (for head or node-size settings)!\n");
+    MPI_Abort(MPI_COMM_WORLD, -1);
+  }
+
+  long *array = (long *)malloc(sizeof(long) * N);
+  FTI_Protect(0, array, N, FTI_LONG);
+
+  state = FTI_Status();
+  if (state == INIT) {
+    for (i = 0; i < N; i++) array[i] = (long)rank * N + i;
+    FTI_Checkpoint(1, level);
+    // The snapshot is taken, the buffer may be modified right away
+    for (i = 0; i < N; i++) array[i] = -1;
+    long *extra = NULL;
+    if (reprotect) {
+      // The layout changes on some ranks only, the checkpoint still
+      // holds the snapshot and is committed collectively by FTI_WaitCkpt
+      if (rank % 2) {
+        array = (long *)realloc(array, sizeof(long) * 2 * N);
+        extra = (long *)malloc(sizeof(long) * N);
+        FTI_Protect(0, array, 2 * N, FTI_LONG);
+        FTI_Protect(1, extra, N, FTI_LONG);
+      }
+      int one = 1, sum = 0, size;
+      MPI_Allreduce(&one, &sum, 1, MPI_INT, MPI_SUM, FTI_COMM_WORLD);
+      MPI_Comm_size(FTI_COMM_WORLD, &size);
+      if (sum != size) {
+        exit(CKPT_FAILED);
+      }
+    }
+    if (FTI_WaitCkpt() != FTI_DONE) {
+      exit(CKPT_FAILED);
+    }
+    if (crash) {
+      if (nbHeads > 0) {
+        int value = FTI_ENDW;
+        MPI_Send(&value, 1, MPI_INT, headRank, finalTag, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+      }
+      MPI_Finalize();
+      exit(0);
+    }
+    free(extra);
+  } else if (state == RESTART || state == KEEP) {
+    if (FTI_Recover() != FTI_SCES) {
+      exit(RECOVERY_FAILED);
+    }
+    for (i = 0; i < N; i++) {
+      correct &= (array[i] == (long)rank * N + i);
+    }
+    MPI_Barrier(FTI_COMM_WORLD);
+  }
+
+  if (rank == 0 && (state == RESTART || state == KEEP)) {
+    printf(correct ? "[SUCCESSFUL]\n" : "[NOT SUCCESSFUL]\n");
+  }
+
+  FTI_Finalize();
+  MPI_Finalize();
+  free(array);
+
+  return (correct) ? 0 : DATA_CORRUPT;
+}
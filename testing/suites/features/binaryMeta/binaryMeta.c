@@ -0,0 +1,151 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  @file   binaryMeta.c
+ *  @date   October, 2026
+ *  @brief  FTI testing program for checkpoints with many protected variables.
+ *
+ *	The program takes four arguments:
+ *	  - arg1: FTI configuration file
+ *	  - arg2: Interrupt yes/no (1/0)
+ *	  - arg3: Checkpoint level (1, 2, 3, 4)
+ *	  - arg4: Number of protected variables per rank
+ *
+ * Every variable is registered by name with FTI_setIDFromString and has a
+ * different size. The first checkpoint protects a different number of
+ * variables on odd and even ranks, the last two protect all of them and
+ * only differ in the data. After the restart, the names must resolve to
+ * the same IDs and the data of the last checkpoint must be recovered.
+ * Rank 0 reports the time spent in the last FTI_Checkpoint and FTI_Init,
+ * both dominated by the group metadata when many variables are protected.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../../../src/deps/iniparser/dictionary.h"
+#include "../../../../src/deps/iniparser/iniparser.h"
+#include "fti.h"
+#include "mpi.h"
+
+#define CNTRLD_EXIT 10
+#define RECOVERY_FAILED 20
+#define DATA_CORRUPT 30
+#define CKPT_FAILED 40
+#define KEEP 2
+#define RESTART 1
+#define INIT 0
+
+static int count(int i) { return i % 7 + 1; }
+
+static int value(int rank, int i, int j) { return rank * 1000003 + i * 7 + j; }
+
+int main(int argc, char *argv[]) {
+  int rank, crash, level, state, nbVar;
+  int correct = 1;
+  char name[64];
+
+  MPI_Init(&argc, &argv);
+  double t = MPI_Wtime();
+  if (FTI_Init(argv[1], MPI_COMM_WORLD) == FTI_NREC) {
+    exit(RECOVERY_FAILED);
+  }
+  t = MPI_Wtime() - t;
+
+  crash = atoi(argv[2]);
+  level = atoi(argv[3]);
+  nbVar = atoi(argv[4]);
+
+  MPI_Comm_rank(FTI_COMM_WORLD, &rank);
+  dictionary *ini = iniparser_load(argv[1]);
+  int grank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &grank);
+  int nbHeads = (int)iniparser_getint(ini, "Basic:head", -1);
+  int finalTag = (int)iniparser_getint(ini, "Advanced:final_tag", 3107);
+  int nodeSize = (int)iniparser_getint(ini, "Basic:node_size", -1);
+  int headRank = grank - grank % nodeSize;
+  iniparser_freedict(ini);
+
+  if ((nbHeads < 0) || (nodeSize < 0)) {
+    printf("wrong configuration (for head or node-size settings)!\n");
+    MPI_Abort(MPI_COMM_WORLD, -1);
+  }
+
+  int **array = (int **)malloc(nbVar * sizeof(int *));
+  int *ids = (int *)malloc(nbVar * sizeof(int));
+  int i, j;
+  for (i = 0; i < nbVar; i++) {
+    array[i] = (int *)malloc(count(i) * sizeof(int));
+  }
+
+  state = FTI_Status();
+  if (state == INIT) {
+    int k;
+    for (k = 0; k < 3; k++) {
+      int nb = (k == 0) ? nbVar - 1 - rank % 2 : nbVar;
+      for (i = 0; i < nb; i++) {
+        snprintf(name, sizeof(name), "var-%d", nbVar - i);
+        ids[i] = FTI_setIDFromString(name);
+        for (j = 0; j < count(i); j++) array[i][j] = value(rank, i, j) - 2 + k;
+        FTI_Protect(ids[i], array[i], count(i), FTI_INTG);
+      }
+      MPI_Barrier(FTI_COMM_WORLD);
+      t = MPI_Wtime();
+      if (FTI_Checkpoint(k + 1, level) != FTI_DONE) {
+        exit(CKPT_FAILED);
+      }
+      t = MPI_Wtime() - t;
+    }
+    if (rank == 0) {
+      printf("checkpoint L%d of %d variables in %.3f s\n", level, nbVar, t);
+    }
+    if (crash) {
+      if (nbHeads > 0) {
+        int val = FTI_ENDW;
+        MPI_Send(&val, 1, MPI_INT, headRank, finalTag, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+      }
+      MPI_Finalize();
+      exit(0);
+    }
+  } else if (state == RESTART || state == KEEP) {
+    if (rank == 0) {
+      printf("restart L%d of %d variables, FTI_Init took %.3f s\n", level,
+             nbVar, t);
+    }
+    for (i = 0; i < nbVar; i++) {
+      snprintf(name, sizeof(name), "var-%d", nbVar - i);
+      ids[i] = FTI_getIDFromString(name);
+      if (ids[i] != i) {
+        printf("%d: '%s' has ID %d, expected %d\n", rank, name, ids[i], i);
+        exit(RECOVERY_FAILED);
+      }
+      for (j = 0; j < count(i); j++) array[i][j] = -1;
+      FTI_Protect(ids[i], array[i], count(i), FTI_INTG);
+    }
+    if (FTI_Recover() != FTI_SCES) {
+      exit(RECOVERY_FAILED);
+    }
+    for (i = 0; i < nbVar; i++) {
+      correct &= (FTI_GetStoredSize(ids[i]) == count(i) * sizeof(int));
+      for (j = 0; j < count(i); j++) {
+        correct &= (array[i][j] == value(rank, i, j));
+      }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &correct, 1, MPI_INT, MPI_LAND,
+                  FTI_COMM_WORLD);
+  }
+
+  if (rank == 0 && (state == RESTART || state == KEEP)) {
+    printf(correct ? "[SUCCESSFUL]\n" : "[NOT SUCCESSFUL]\n");
+  }
+
+  FTI_Finalize();
+  MPI_Finalize();
+  for (i = 0; i < nbVar; i++) free(array[i]);
+  free(array);
+  free(ids);
+
+  return (correct) ? 0 : DATA_CORRUPT;
+}
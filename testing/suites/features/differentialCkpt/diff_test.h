@@ -24,6 +24,8 @@
 #include <string.h>
 #include <stdint.h>
 #include <unistd.h>
+#include <signal.h>
+#include <sys/resource.h>
 #include "../../../../src/deps/iniparser/dictionary.h"
 #include "../../../../src/deps/iniparser/iniparser.h"
 
@@ -120,6 +122,8 @@ typedef struct _dcp_info {
     uint32_t *oldsize;
     int nbuffer;
     int test_mode;
+    int fail_id;  // checkpoint whose write fails on rank 1 (FAIL_CKPT_ID)
+    bool reread;  // buffer 0 is read(2) after checkpoints (UNTRACKED_READ)
     unsigned char **hash;
     xor_info_t xor_info[NUM_DCKPT];
 } dcp_info_t;
@@ -146,5 +150,9 @@ double get_share_ratio();
 bool valid(dcp_info_t * info);
 void protect_buffers(dcp_info_t *info);
 void checkpoint(dcp_info_t *info, int ID, int level);
+/*
+ * write buffer 0 to a file and read(2) it back
+*/
+void reread_buffer(dcp_info_t *info);
 void deallocate_buffers(dcp_info_t * info);
 #endif  // TESTING_SUITES_FEATURES_DIFFERENTIALCKPT_DIFF_TEST_H_
@@ -89,6 +89,11 @@ void init(char *fti_cfgfile, dcp_info_t * info, uint32_t alloc_size) {
         INFO_MSG("TEST MODE -> NOICP");
     }
 
+    env = getenv("FAIL_CKPT_ID");
+    info->fail_id = (env) ? atoi(env) : 0;
+    env = getenv("UNTRACKED_READ");
+    info->reread = (env) ? atoi(env) : false;
+
     // DBG_MSG_APP("alloc_size: %lu",0,alloc_size);
     init_share();
 
@@ -148,6 +153,27 @@ void protect_buffers(dcp_info_t *info) {
     for (idx=0; idx < info->nbuffer; ++idx) {
         FTI_Protect(idx, info->buffer[idx], info->size[idx], FTI_CHAR);
     }
+    // the kernel writes to buffer 0, its pages must stay writable
+    if (info->reread) {
+        FTIT_attribute attribute;
+        attribute.untracked = true;
+        FTI_SetAttribute(0, attribute, FTI_ATTRIBUTE_DCP_TRACK);
+    }
+}
+
+void reread_buffer(dcp_info_t *info) {
+    FILE* f = tmpfile();
+    if (f == NULL) {
+        EXIT_STD_ERR("cannot create the file to reread buffer 0");
+    }
+    int fd = fileno(f);
+    ssize_t size = info->size[0];
+    if (write(fd, info->buffer[0], size) != size ||
+     lseek(fd, 0, SEEK_SET) != 0 ||
+     read(fd, info->buffer[0], size) != size) {
+        EXIT_STD_ERR("cannot reread buffer 0");
+    }
+    fclose(f);
 }
 
 void checkpoint(dcp_info_t *info, int ID, int level) {
@@ -164,11 +190,30 @@ void checkpoint(dcp_info_t *info, int ID, int level) {
         FTI_FinalizeICP();
         INFO_MSG("ICP: END CKPT");
     }
+    // rank 1 cannot write the checkpoint files, the checkpoint must fail
+    // on every rank
+    struct rlimit limit, noFiles;
+    bool fail = (ID == info->fail_id) && (grank == 1);
+    if (fail) {
+        signal(SIGXFSZ, SIG_IGN);
+        getrlimit(RLIMIT_FSIZE, &limit);
+        noFiles = limit;
+        noFiles.rlim_cur = 0;
+        setrlimit(RLIMIT_FSIZE, &noFiles);
+    }
     if (info->test_mode == TEST_NOICP) {
         INFO_MSG("NOICP: START CKPT");
-        FTI_Checkpoint(ID, level);
+        if (FTI_Checkpoint(ID, level) != FTI_DONE) {
+            INFO_MSG("NOICP: CKPT %d FAILED", ID);
+        }
         INFO_MSG("NOICP: END CKPT");
     }
+    if (fail) {
+        setrlimit(RLIMIT_FSIZE, &limit);
+    }
+    if (info->reread) {
+        reread_buffer(info);
+    }
 }
 
 void deallocate_buffers(dcp_info_t * info) {
@@ -0,0 +1,76 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  @file   headIdle.c
+ *  @date   October, 2026
+ *  @brief  FTI testing program for the slowdown caused by idle heads.
+ *
+ *	The program takes three arguments:
+ *	  - arg1: FTI configuration file
+ *	  - arg2: Number of iterations
+ *	  - arg3: Checkpoint level (0 for no checkpoint)
+ *
+ * Every iteration streams through arrays larger than the caches, so that
+ * the time of the loop is sensitive to the cores and the memory bandwidth
+ * taken by the heads. A checkpoint is taken after half of the iterations,
+ * the heads are idle for the rest of the time. The longest loop time of
+ * the application processes is reported.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fti.h"
+#include "mpi.h"
+
+#define N 1048576
+#define CKPT_FAILED 40
+
+int main(int argc, char *argv[]) {
+  int rank, i, j;
+
+  MPI_Init(&argc, &argv);
+  FTI_Init(argv[1], MPI_COMM_WORLD);
+  int nbIter = atoi(argv[2]);
+  int level = atoi(argv[3]);
+
+  MPI_Comm_rank(FTI_COMM_WORLD, &rank);
+
+  double *a = (double *)malloc(N * sizeof(double));
+  double *b = (double *)malloc(N * sizeof(double));
+  double *c = (double *)malloc(N * sizeof(double));
+  for (j = 0; j < N; j++) {
+    a[j] = 0;
+    b[j] = rank;
+    c[j] = j;
+  }
+  FTI_Protect(0, &i, 1, FTI_INTG);
+  FTI_Protect(1, a, N, FTI_DBLE);
+
+  MPI_Barrier(FTI_COMM_WORLD);
+  double t = MPI_Wtime();
+  for (i = 0; i < nbIter; i++) {
+    if (level > 0 && i == nbIter / 2) {
+      if (FTI_Checkpoint(i + 1, level) != FTI_DONE) {
+        exit(CKPT_FAILED);
+      }
+    }
+    for (j = 0; j < N; j++) {
+      a[j] = b[j] + 0.5 * c[j];
+    }
+    b[i % N] = a[(i + 1) % N];
+  }
+  t = MPI_Wtime() - t;
+  MPI_Allreduce(MPI_IN_PLACE, &t, 1, MPI_DOUBLE, MPI_MAX, FTI_COMM_WORLD);
+  if (rank == 0) {
+    printf("Loop time: %.3f sec.\n", t);
+  }
+
+  free(a);
+  free(b);
+  free(c);
+  FTI_Finalize();
+  MPI_Finalize();
+  return 0;
+}
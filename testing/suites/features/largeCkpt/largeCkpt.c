@@ -0,0 +1,134 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  @file   largeCkpt.c
+ *  @date   October, 2026
+ *  @brief  FTI testing program and benchmark for large datasets.
+ *
+ *	The program takes four arguments:
+ *	  - arg1: FTI configuration file
+ *	  - arg2: Interrupt yes/no (1/0)
+ *	  - arg3: Checkpoint level (1, 2, 3, 4)
+ *	  - arg4: Size of the protected dataset per rank in MiB
+ *
+ * Every rank protects a single dataset of 'arg4' MiB as FTI_CHAR, so the
+ * element count equals the size in bytes. Sizes above 4096 MiB exercise
+ * the 64-bit size paths of the writers and of the post-processing. Rank 0
+ * reports the time of FTI_Checkpoint and FTI_Recover and the resulting
+ * bandwidth per rank.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../../../src/deps/iniparser/dictionary.h"
+#include "../../../../src/deps/iniparser/iniparser.h"
+#include "fti.h"
+#include "mpi.h"
+
+#define CNTRLD_EXIT 10
+#define RECOVERY_FAILED 20
+#define DATA_CORRUPT 30
+#define CKPT_FAILED 40
+#define KEEP 2
+#define RESTART 1
+#define INIT 0
+
+static uint64_t pattern(int rank, int64_t i) {
+  return ((uint64_t)rank << 48) ^ ((uint64_t)i * 0x9E3779B97F4A7C15ULL);
+}
+
+static void report(int rank, const char *what, int level, double t,
+                   int64_t size) {
+  if (rank == 0) {
+    printf("%s L%d: %ld bytes per rank in %.3f s (%.2f MiB/s per rank)\n",
+           what, level, size, t, (size / (1024.0 * 1024.0)) / t);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  int rank, crash, level, state;
+  int correct = 1;
+
+  MPI_Init(&argc, &argv);
+  if (FTI_Init(argv[1], MPI_COMM_WORLD) == FTI_NREC) {
+    exit(RECOVERY_FAILED);
+  }
+
+  crash = atoi(argv[2]);
+  level = atoi(argv[3]);
+  int64_t size = atol(argv[4]) * 1024 * 1024;
+  int64_t nbWords = size / sizeof(uint64_t);
+
+  MPI_Comm_rank(FTI_COMM_WORLD, &rank);
+  dictionary *ini = iniparser_load(argv[1]);
+  int grank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &grank);
+  int nbHeads = (int)iniparser_getint(ini, "Basic:head", -1);
+  int finalTag = (int)iniparser_getint(ini, "Advanced:final_tag", 3107);
+  int nodeSize = (int)iniparser_getint(ini, "Basic:node_size", -1);
+  int headRank = grank - grank % nodeSize;
+  iniparser_freedict(ini);
+
+  if ((nbHeads < 0) || (nodeSize < 0)) {
+    printf("wrong configuration (for head or node-size settings)!\n");
+    MPI_Abort(MPI_COMM_WORLD, -1);
+  }
+
+  uint64_t *array = (uint64_t *)malloc(size);
+  if (array == NULL) {
+    printf("unable to allocate %ld bytes!\n", size);
+    MPI_Abort(MPI_COMM_WORLD, -1);
+  }
+  FTI_Protect(0, array, size, FTI_CHAR);
+
+  int64_t i;
+  double t;
+  state = FTI_Status();
+  if (state == INIT) {
+    for (i = 0; i < nbWords; i++) array[i] = pattern(rank, i);
+    MPI_Barrier(FTI_COMM_WORLD);
+    t = MPI_Wtime();
+    if (FTI_Checkpoint(1, level) != FTI_DONE) {
+      exit(CKPT_FAILED);
+    }
+    MPI_Barrier(FTI_COMM_WORLD);
+    report(rank, "checkpoint", level, MPI_Wtime() - t, size);
+    if (crash) {
+      if (nbHeads > 0) {
+        int value = FTI_ENDW;
+        MPI_Send(&value, 1, MPI_INT, headRank, finalTag, MPI_COMM_WORLD);
+        MPI_Barrier(MPI_COMM_WORLD);
+      }
+      MPI_Finalize();
+      exit(0);
+    }
+  } else if (state == RESTART || state == KEEP) {
+    for (i = 0; i < nbWords; i++) array[i] = 0;
+    t = MPI_Wtime();
+    if (FTI_Recover() != FTI_SCES) {
+      exit(RECOVERY_FAILED);
+    }
+    report(rank, "recovery", level, MPI_Wtime() - t, size);
+    if (FTI_GetStoredSize(0) != size) {
+      correct = 0;
+    }
+    for (i = 0; i < nbWords; i++) {
+      correct &= (array[i] == pattern(rank, i));
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &correct, 1, MPI_INT, MPI_LAND,
+                  FTI_COMM_WORLD);
+  }
+
+  if (rank == 0 && (state == RESTART || state == KEEP)) {
+    printf(correct ? "[SUCCESSFUL]\n" : "[NOT SUCCESSFUL]\n");
+  }
+
+  FTI_Finalize();
+  MPI_Finalize();
+  free(array);
+
+  return (correct) ? 0 : DATA_CORRUPT;
+}
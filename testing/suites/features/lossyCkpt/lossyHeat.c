@@ -0,0 +1,239 @@
+/**
+ *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
+ *  All rights reserved
+ *
+ *  @file   lossyHeat.c
+ *  @date   October, 2026
+ *  @brief  FTI testing program for the lossy compression of checkpoints.
+ *
+ *	The program takes five arguments:
+ *	  - arg1: FTI configuration file
+ *	  - arg2: Checkpoint level (1, 2, 3, 4)
+ *	  - arg3: Error mode (1 absolute, 2 relative)
+ *	  - arg4: Error bound
+ *	  - arg5: Number of iterations after the restart
+ *
+ * The heat distribution grids are protected with a lossy compression
+ * attribute. The first execution checkpoints after ITER_CKPT iterations and
+ * stops without finalizing FTI. The second execution recovers the grids and
+ * compares them with a reference computed again from the initial data, every
+ * element must be within the error bound. The solver then continues from the
+ * recovered grids, which must not increase the error of the solution.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../../../src/deps/iniparser/dictionary.h"
+#include "../../../../src/deps/iniparser/iniparser.h"
+#include "fti.h"
+#include "mpi.h"
+
+#define ITER_CKPT 500
+#define WORKTAG 50
+#define RECOVERY_FAILED 20
+#define DATA_CORRUPT 30
+#define CKPT_FAILED 40
+#define KEEP 2
+#define RESTART 1
+#define INIT 0
+
+static void initData(int nbLines, int M, int rank, double *h) {
+  int i, j;
+  for (i = 0; i < nbLines; i++) {
+    for (j = 0; j < M; j++) {
+      h[(i * M) + j] = 0;
+    }
+  }
+  if (rank == 0) {
+    for (j = (M * 0.1); j < (M * 0.9); j++) {
+      h[j] = 100;
+    }
+  }
+}
+
+static double doWork(int numprocs, int rank, int M, int nbLines, double *g,
+                     double *h) {
+  int i, j;
+  MPI_Request req1[2], req2[2];
+  double localerror = 0;
+  for (i = 0; i < nbLines; i++) {
+    for (j = 0; j < M; j++) {
+      h[(i * M) + j] = g[(i * M) + j];
+    }
+  }
+  if (rank > 0) {
+    MPI_Isend(g + M, M, MPI_DOUBLE, rank - 1, WORKTAG, FTI_COMM_WORLD,
+              &req1[0]);
+    MPI_Irecv(h, M, MPI_DOUBLE, rank - 1, WORKTAG, FTI_COMM_WORLD, &req1[1]);
+  }
+  if (rank < numprocs - 1) {
+    MPI_Isend(g + ((nbLines - 2) * M), M, MPI_DOUBLE, rank + 1, WORKTAG,
+              FTI_COMM_WORLD, &req2[0]);
+    MPI_Irecv(h + ((nbLines - 1) * M), M, MPI_DOUBLE, rank + 1, WORKTAG,
+              FTI_COMM_WORLD, &req2[1]);
+  }
+  if (rank > 0) {
+    MPI_Waitall(2, req1, MPI_STATUSES_IGNORE);
+  }
+  if (rank < numprocs - 1) {
+    MPI_Waitall(2, req2, MPI_STATUSES_IGNORE);
+  }
+  for (i = 1; i < (nbLines - 1); i++) {
+    for (j = 1; j < (M - 1); j++) {
+      g[(i * M) + j] = 0.25 * (h[((i - 1) * M) + j] + h[((i + 1) * M) + j] +
+                               h[(i * M) + j - 1] + h[(i * M) + j + 1]);
+      if (localerror < fabs(g[(i * M) + j] - h[(i * M) + j])) {
+        localerror = fabs(g[(i * M) + j] - h[(i * M) + j]);
+      }
+    }
+  }
+  if (rank == (numprocs - 1)) {
+    for (j = 0; j < M; j++) {
+      g[((nbLines - 1) * M) + j] = g[((nbLines - 2) * M) + j];
+    }
+  }
+  return localerror;
+}
+
+/* Largest difference between the arrays, and value range of the reference */
+static double maxError(const double *x, const double *ref, int64_t n,
+                       double *range) {
+  double err = 0, min = ref[0], max = ref[0];
+  int64_t i;
+  for (i = 0; i < n; i++) {
+    double d = fabs(x[i] - ref[i]);
+    err = (d > err) ? d : err;
+    min = (ref[i] < min) ? ref[i] : min;
+    max = (ref[i] > max) ? ref[i] : max;
+  }
+  *range = max - min;
+  return err;
+}
+
+int main(int argc, char *argv[]) {
+  int rank, nbProcs, nbLines, M, i, state, level, nbIter;
+  int correct = 1;
+  double *h, *g, errorBound, err = 0, globalerror;
+  FTIT_attribute attribute;
+
+  MPI_Init(&argc, &argv);
+  if (FTI_Init(argv[1], MPI_COMM_WORLD) == FTI_NREC) {
+    exit(RECOVERY_FAILED);
+  }
+
+  level = atoi(argv[2]);
+  attribute.compression.codec = FTI_CODEC_DEFAULT;
+  attribute.compression.level = 0;
+  attribute.compression.shuffle = 1;
+  attribute.compression.errorMode = atoi(argv[3]);
+  attribute.compression.errorBound = atof(argv[4]);
+  errorBound = attribute.compression.errorBound;
+  nbIter = atoi(argv[5]);
+
+  MPI_Comm_size(FTI_COMM_WORLD, &nbProcs);
+  MPI_Comm_rank(FTI_COMM_WORLD, &rank);
+  dictionary *ini = iniparser_load(argv[1]);
+  int grank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &grank);
+  int nbHeads = (int)iniparser_getint(ini, "Basic:head", -1);
+  int finalTag = (int)iniparser_getint(ini, "Advanced:final_tag", 3107);
+  int nodeSize = (int)iniparser_getint(ini, "Basic:node_size", -1);
+  int headRank = grank - grank % nodeSize;
+  iniparser_freedict(ini);
+
+  M = (int)sqrt((double)(1024.0 * 512.0 * nbProcs) / sizeof(double));
+  nbLines = (M / nbProcs) + 3;
+  int64_t n = (int64_t)M * nbLines;
+  h = (double *)malloc(sizeof(double) * n);
+  g = (double *)malloc(sizeof(double) * n);
+  initData(nbLines, M, rank, g);
+  initData(nbLines, M, rank, h);
+
+  FTI_Protect(0, &i, 1, FTI_INTG);
+  FTI_Protect(1, h, n, FTI_DBLE);
+  FTI_Protect(2, g, n, FTI_DBLE);
+  if (FTI_SetAttribute(1, attribute, FTI_ATTRIBUTE_COMPRESSION) != FTI_SCES ||
+      FTI_SetAttribute(2, attribute, FTI_ATTRIBUTE_COMPRESSION) != FTI_SCES) {
+    exit(CKPT_FAILED);
+  }
+
+  state = FTI_Status();
+  if (state == INIT) {
+    for (i = 0; i < ITER_CKPT; i++) {
+      doWork(nbProcs, rank, M, nbLines, g, h);
+    }
+    if (FTI_Checkpoint(1, level) != FTI_DONE) {
+      exit(CKPT_FAILED);
+    }
+    if (nbHeads > 0) {
+      int val = FTI_ENDW;
+      MPI_Send(&val, 1, MPI_INT, headRank, finalTag, MPI_COMM_WORLD);
+      MPI_Barrier(MPI_COMM_WORLD);
+    }
+    MPI_Finalize();
+    exit(0);
+  } else if (state == RESTART || state == KEEP) {
+    if (FTI_Recover() != FTI_SCES || i != ITER_CKPT) {
+      exit(RECOVERY_FAILED);
+    }
+    // The reference takes the same path as the checkpointed run
+    double *rh = (double *)malloc(sizeof(double) * n);
+    double *rg = (double *)malloc(sizeof(double) * n);
+    initData(nbLines, M, rank, rg);
+    for (i = 0; i < ITER_CKPT; i++) {
+      doWork(nbProcs, rank, M, nbLines, rg, rh);
+    }
+    double rangeH, rangeG;
+    double errH = maxError(h, rh, n, &rangeH);
+    double errG = maxError(g, rg, n, &rangeG);
+    int rel = (attribute.compression.errorMode == FTI_ERROR_REL);
+    double boundH = rel ? errorBound * rangeH : errorBound;
+    double boundG = rel ? errorBound * rangeG : errorBound;
+    if (errH > boundH || errG > boundG) {
+      printf("%d: error %g/%g exceeds the bound %g/%g\n", rank, errH, errG,
+             boundH, boundG);
+      correct = 0;
+    }
+    err = (errH > errG) ? errH : errG;
+
+    // The solver must reach the same precision from the recovered grids
+    double refError = 0;
+    globalerror = 0;
+    for (i = 0; i < nbIter; i++) {
+      double e = doWork(nbProcs, rank, M, nbLines, g, h);
+      double r = doWork(nbProcs, rank, M, nbLines, rg, rh);
+      if (i == nbIter - 1) {
+        globalerror = e;
+        refError = r;
+      }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &globalerror, 1, MPI_DOUBLE, MPI_MAX,
+                  FTI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &refError, 1, MPI_DOUBLE, MPI_MAX,
+                  FTI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &err, 1, MPI_DOUBLE, MPI_MAX, FTI_COMM_WORLD);
+    if (fabs(globalerror - refError) > 4 * err) {
+      if (rank == 0) {
+        printf("solver error %g, %g without compression\n", globalerror,
+               refError);
+      }
+      correct = 0;
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &correct, 1, MPI_INT, MPI_LAND,
+                  FTI_COMM_WORLD);
+    if (rank == 0) {
+      printf("maximum recovery error %g\n", err);
+      printf(correct ? "[SUCCESSFUL]\n" : "[NOT SUCCESSFUL]\n");
+    }
+    free(rh);
+    free(rg);
+  }
+
+  FTI_Finalize();
+  MPI_Finalize();
+  free(h);
+  free(g);
+  return (correct) ? 0 : DATA_CORRUPT;
+}
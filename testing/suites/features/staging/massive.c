@@ -2,6 +2,12 @@
  *  Copyright (c) 2017 Leonardo A. Bautista-Gomez
  *  All rights reserved
  *
+ *  The program takes up to five arguments:
+ *    - arg1: FTI configuration file
+ *    - arg2: Size of the staged files in bytes (default 1KB)
+ *    - arg3: Number of iterations (default 100)
+ *    - arg4: Number of files staged per iteration (default 10)
+ *    - arg5: Level of a checkpoint taken at every iteration (default 0, none)
  */
 
 #include <assert.h>
@@ -41,6 +47,7 @@ uint32_t num_files;
 
 uint32_t NUM_ITER = 100;
 uint32_t FILES_PER_ITER = 10;
+off_t fileSize = FILE_SIZE;
 
 int main(int argc, char* argv[]) {
     if (argc < 1) {
@@ -54,6 +61,17 @@ int main(int argc, char* argv[]) {
     MPI_Comm_rank(FTI_COMM_WORLD, &rank);
     MPI_Comm_size(FTI_COMM_WORLD, &size);
 
+    int ckptLevel = 0;
+    if (argc > 2) fileSize = atol(argv[2]);
+    if (argc > 3) NUM_ITER = atoi(argv[3]);
+    if (argc > 4) FILES_PER_ITER = atoi(argv[4]);
+    if (argc > 5) ckptLevel = atoi(argv[5]);
+
+    // checkpointed while the files are staged
+    int ckptSize = 1024*1024;
+    int *ckptData = (int*) calloc(ckptSize, sizeof(int));
+    FTI_Protect(0, ckptData, ckptSize, FTI_INTG);
+
     // total number of staged files
     num_files = ((uint32_t)size)*FILES_PER_ITER*NUM_ITER;
 
@@ -106,6 +124,12 @@ int main(int argc, char* argv[]) {
             }
             request_counter++;
         }
+        if (ckptLevel > 0) {
+            ckptData[0] = i;
+            if (FTI_Checkpoint(i+1, ckptLevel) != FTI_DONE) {
+                EXIT_FAIL("Checkpoint failed while staging.");
+            }
+        }
         if (i%CLEAN_FREQ == 0) {
             check_status(request_counter, reqID, true);
         }
@@ -121,6 +145,13 @@ int main(int argc, char* argv[]) {
         for (; j < FILES_PER_ITER; ++j) {
             snprintf(filename[j], F_BUFF, F_FORM, rank, i, j);
             snprintf(rfile[j], F_BUFF, "%s/%s", rdir, filename[j]);
+            struct stat st;
+            if (stat(rfile[j], &st) == 0 && st.st_size != fileSize) {
+                char msg[F_BUFF];
+                snprintf(msg, F_BUFF, "Staged file %s has %ld bytes.",
+                 filename[j], (long)st.st_size);
+                EXIT_FAIL(msg);
+            }
             errno = 0;
             if (remove(rfile[j]) != 0) {
                 if (errno != ENOENT) {
@@ -133,6 +164,7 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    free(ckptData);
     MPI_Finalize();
 
     return EXIT_SUCCESS;
@@ -142,7 +174,7 @@ void createFile(char *fn) {
     FILE *fstream = fopen(fn, "wb+");
     fsync(fileno(fstream));
     fclose(fstream);
-    truncate(fn, FILE_SIZE);
+    truncate(fn, fileSize);
 }
 
 bool check_status(uint32_t request_counter, int *reqID, bool printout) {